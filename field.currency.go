@@ -13,17 +13,16 @@ import (
 // Currency fields are 8-byte fixed-point values with 4 decimal places
 type CurrencyField struct {
 	baseField
-	cField *C.FIELD4
 }
 
 // newCurrencyField creates a new CurrencyField instance
 func newCurrencyField(field *C.FIELD4, data *Vulpo, def *FieldDef) *CurrencyField {
 	return &CurrencyField{
 		baseField: baseField{
-			def:  def,
-			data: data,
+			def:    def,
+			data:   data,
+			cField: field,
 		},
-		cField: field,
 	}
 }
 
@@ -59,14 +58,14 @@ func (f *CurrencyField) AsInt() (int, error) {
 
 // AsFloat returns the field value as a float64
 func (f *CurrencyField) AsFloat() (float64, error) {
-	if err := f.checkActive(); err != nil {
+	raw, err := f.raw()
+	if err != nil {
 		return 0, err
 	}
 
 	// Currency fields in DBF are stored as 8-byte fixed-point values
-	// Use f4double() to get the currency value from CodeBase
-	currencyVal := float64(C.f4double(f.cField))
-	return currencyVal, nil
+	// scaled by 10000, decoded straight from the record buffer
+	return decodeCurrency(raw), nil
 }
 
 // AsBool returns true if the currency value is not zero
@@ -84,15 +83,6 @@ func (f *CurrencyField) AsTime() (time.Time, error) {
 	return time.Time{}, NewConversionError("currency", "time")
 }
 
-// IsNull returns true if the field is null
-func (f *CurrencyField) IsNull() (bool, error) {
-	if err := f.checkActive(); err != nil {
-		return false, err
-	}
-
-	return C.f4null(f.cField) != 0, nil
-}
-
 // Field interface methods are inherited from baseField
 
 // String returns a string representation of the currency field
@@ -108,17 +98,38 @@ func (f *CurrencyField) String() string {
 // AsCents returns the currency value as integer cents (multiplied by 10000)
 // This is useful for precise monetary calculations
 func (f *CurrencyField) AsCents() (int64, error) {
-	currencyVal, err := f.AsFloat()
+	raw, err := f.raw()
 	if err != nil {
 		return 0, err
 	}
 
-	// Convert to cents (multiply by 10000 since currency has 4 decimal places)
-	return int64(currencyVal * 10000), nil
+	// The stored value already is the amount scaled by 10000
+	return decodeCurrencyUnits(raw), nil
 }
 
-// FromCents sets a currency value from integer cents
-// Note: This would be used for writing, but this is a read-only implementation
+// FromCents converts integer cents (multiplied by 10000), as AsCents returns
+// them, to the monetary amount. Use SetCents to write them exactly
 func (f *CurrencyField) FromCents(cents int64) float64 {
 	return float64(cents) / 10000.0
 }
+
+// SetCents assigns integer cents (multiplied by 10000), as AsCents returns
+// them, to the field of the current record. Unlike SetFloat it keeps every
+// digit of amounts beyond 2^53 / 10000.
+//
+// Parameters:
+//   - cents: the amount multiplied by 10000
+//
+// Returns:
+//   - error: if the table is not open or the field cannot be written
+//
+// Example:
+//
+//	price := v.FieldByName("PRICE").(*vulpo.CurrencyField)
+//	price.SetCents(12345678) // 1234.5678
+func (f *CurrencyField) SetCents(cents int64) error {
+	if err := f.checkWritable(); err != nil {
+		return err
+	}
+	return f.assign(encodeCurrencyUnits(cents))
+}
@@ -6,10 +6,10 @@ package vulpo
 */
 import "C"
 import (
-	"errors"
 	"fmt"
 	"strconv"
 	"time"
+	"unsafe"
 )
 
 const blankDateValue = "        "
@@ -17,17 +17,16 @@ const blankDateValue = "        "
 // DateField represents a DBF date field (type 'D')
 type DateField struct {
 	baseField
-	cField *C.FIELD4
 }
 
 // newDateField creates a new DateField instance
 func newDateField(field *C.FIELD4, data *Vulpo, def *FieldDef) *DateField {
 	return &DateField{
 		baseField: baseField{
-			def:  def,
-			data: data,
+			def:    def,
+			data:   data,
+			cField: field,
 		},
-		cField: field,
 	}
 }
 
@@ -38,22 +37,17 @@ func (f *DateField) Value() (interface{}, error) {
 
 // AsString returns the date as a string in YYYYMMDD format
 func (f *DateField) AsString() (string, error) {
-	if err := f.checkActive(); err != nil {
+	raw, err := f.raw()
+	if err != nil {
 		return "", err
 	}
 
-	ptr := C.f4ptr(f.cField)
-	if ptr == nil {
-		return "", errors.New("failed to get field pointer")
-	}
-
 	// DBF date fields are stored as 8-character strings in YYYYMMDD format
-	length := C.f4len(f.cField)
-	if length != 8 {
-		return "", fmt.Errorf("invalid date field length: %d", length)
+	if len(raw) != 8 {
+		return "", fmt.Errorf("invalid date field length: %d", len(raw))
 	}
 
-	dateStr := C.GoStringN(ptr, 8)
+	dateStr := string(raw)
 
 	// Check if the date is blank (all spaces)
 	if dateStr == blankDateValue || dateStr == "" {
@@ -65,32 +59,22 @@ func (f *DateField) AsString() (string, error) {
 
 // AsInt returns the date as a long integer (Julian day number)
 func (f *DateField) AsInt() (int, error) {
-	if err := f.checkActive(); err != nil {
+	raw, err := f.raw()
+	if err != nil {
 		return 0, err
 	}
 
-	ptr := C.f4ptr(f.cField)
-	if ptr == nil {
-		return 0, errors.New("failed to get field pointer")
-	}
-
-	// Check if the field is blank
-	dateStr := C.GoStringN(ptr, 8)
-	if dateStr == blankDateValue || dateStr == "" {
-		return 0, nil
-	}
+	// Blank dates convert to 0, invalid ones to -1, as with date4long
+	return decodeDateJulian(raw), nil
+}
 
-	// Use CodeBase date4long function to convert to long integer
-	longVal := C.date4long(ptr)
-	if longVal == 0 {
-		// Could be a valid date (January 1, 1900) or an error
-		// We need to check if the input was valid
-		if dateStr != "19000101" {
-			return 0, fmt.Errorf("invalid date format: %s", dateStr)
-		}
+// date4long converts an 8-byte D field with CodeBase's date4long, for values
+// the Go decoder rejects (see decodeDateJulian).
+func date4long(raw []byte) int {
+	if len(raw) < 8 {
+		return -1
 	}
-
-	return int(longVal), nil
+	return int(C.date4long((*C.char)(unsafe.Pointer(&raw[0]))))
 }
 
 // AsFloat returns the date as a float64 (Julian day number)
@@ -155,15 +139,6 @@ func (f *DateField) AsTime() (time.Time, error) {
 	return time.Date(year, time.Month(month), day, 0, 0, 0, 0, time.UTC), nil
 }
 
-// IsNull returns true if the date field is blank
-func (f *DateField) IsNull() (bool, error) {
-	if err := f.checkActive(); err != nil {
-		return false, err
-	}
-
-	return C.f4null(f.cField) != 0, nil
-}
-
 // Field interface methods are inherited from baseField
 
 // String returns a string representation of the date field
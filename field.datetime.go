@@ -5,27 +5,24 @@ package vulpo
 */
 import "C"
 import (
-	"encoding/binary"
 	"fmt"
 	"time"
-	"unsafe"
 )
 
 // DateTimeField represents a DBF datetime field (type 'T')
 // DateTime fields store both date and time information
 type DateTimeField struct {
 	baseField
-	cField *C.FIELD4
 }
 
 // newDateTimeField creates a new DateTimeField instance
 func newDateTimeField(field *C.FIELD4, data *Vulpo, def *FieldDef) *DateTimeField {
 	return &DateTimeField{
 		baseField: baseField{
-			def:  def,
-			data: data,
+			def:    def,
+			data:   data,
+			cField: field,
 		},
-		cField: field,
 	}
 }
 
@@ -94,42 +91,20 @@ func (f *DateTimeField) AsBool() (bool, error) {
 
 // AsTime returns the field value as a time.Time
 func (f *DateTimeField) AsTime() (time.Time, error) {
-	if err := f.checkActive(); err != nil {
+	raw, err := f.raw()
+	if err != nil {
 		return time.Time{}, err
 	}
 
-	// Get the raw binary data
-	ptr := C.f4ptr(f.cField)
-	if ptr == nil {
-		return time.Time{}, nil // Return zero time for null field
-	}
-
-	length := C.f4len(f.cField)
-	if length == 8 {
+	if len(raw) == 8 {
 		// DateTime fields are stored as 8 bytes:
 		// First 4 bytes: Julian day number (little-endian)
 		// Last 4 bytes: milliseconds since midnight (little-endian)
-		bytes := C.GoBytes(unsafe.Pointer(ptr), 8)
-
-		// Extract Julian day and milliseconds using proper format
-		jdays := binary.LittleEndian.Uint32(bytes[:4])
-		jmsec := binary.LittleEndian.Uint32(bytes[4:])
-		jsec := jmsec / 1000
-
-		// Check for null/zero datetime
-		if jdays == 0 && jmsec == 0 {
-			return time.Time{}, nil
-		}
-
-		// Convert Julian day to Gregorian date using proper algorithm
-		y, m, d := JulianToYMD(int(jdays))
-
-		// Return the proper datetime
-		return time.Date(y, time.Month(m), d, 0, 0, int(jsec), 0, time.UTC), nil
+		return decodeDateTime(raw), nil
 	}
 
 	// Try parsing as string instead
-	dateTimeStr := C.GoStringN(ptr, C.int(length))
+	dateTimeStr := string(raw)
 
 	// Handle empty/blank datetime
 	if dateTimeStr == "" || len(dateTimeStr) == 0 {
@@ -171,26 +146,13 @@ func (f *DateTimeField) AsTime() (time.Time, error) {
 
 // Raw returns the raw bytes of the datetime field
 func (f *DateTimeField) Raw() []byte {
-	if err := f.checkActive(); err != nil {
-		return nil
-	}
-
-	ptr := C.f4ptr(f.cField)
-	if ptr == nil {
+	raw, err := f.raw()
+	if err != nil {
 		return nil
 	}
 
-	length := C.f4len(f.cField)
-	return C.GoBytes(unsafe.Pointer(ptr), C.int(length))
-}
-
-// IsNull returns true if the field is null
-func (f *DateTimeField) IsNull() (bool, error) {
-	if err := f.checkActive(); err != nil {
-		return false, err
-	}
-
-	return C.f4null(f.cField) != 0, nil
+	// Copy so the result stays valid after the cursor moves
+	return append([]byte(nil), raw...)
 }
 
 // Field interface methods are inherited from baseField
@@ -0,0 +1,312 @@
+package vulpo
+
+import (
+	"bytes"
+	"encoding/binary"
+	"math"
+	"strconv"
+	"time"
+)
+
+// Pure-Go field decoding.
+//
+// Every field occupies a fixed byte range of the record buffer. The range is
+// computed once from FIELD4.offset/len when the field definitions are read, so
+// values can be decoded straight from a record image (the live CodeBase record
+// buffer or a RecordBatch) without a cgo call per field.
+
+// bytes returns the field's slice of the record image, or nil if the record is
+// too short to contain the field.
+func (fd *FieldDef) bytes(rec []byte) []byte {
+	end := fd.offset + fd.length
+	if fd.length <= 0 || end > len(rec) {
+		return nil
+	}
+	return rec[fd.offset:end]
+}
+
+// isNullIn reports whether the field is null in the record image. Only
+// nullable (Visual FoxPro) fields can be null; the state lives in a bit of the
+// hidden _NullFlags field.
+func (fd *FieldDef) isNullIn(rec []byte) bool {
+	if !fd.nullable || fd.nullOffset < 0 {
+		return false
+	}
+
+	pos := fd.nullOffset + fd.nullBit/8
+	if pos >= len(rec) {
+		return false
+	}
+	return rec[pos]&(1<<(fd.nullBit%8)) != 0
+}
+
+// decodeCharacter decodes a C field: the value stops at the first NUL byte and
+// surrounding blanks are trimmed.
+func decodeCharacter(raw []byte) string {
+	if i := bytes.IndexByte(raw, 0); i >= 0 {
+		raw = raw[:i]
+	}
+	return string(bytes.TrimSpace(raw))
+}
+
+// decodeNumeric decodes an ASCII N or F field. Like CodeBase's c4atod it
+// accepts leading blanks, parses the longest valid numeric prefix and returns 0
+// for blank or unparseable content.
+func decodeNumeric(raw []byte) float64 {
+	start := 0
+	for start < len(raw) && (raw[start] == ' ' || raw[start] == 0) {
+		start++
+	}
+	raw = raw[start:]
+	if len(raw) == 0 {
+		return 0
+	}
+
+	// Plain decimals, the usual content, are converted without strconv
+	if val, ok := parseDecimal(raw); ok {
+		return val
+	}
+
+	// Fast path for well-formed, right-aligned values
+	if val, err := strconv.ParseFloat(string(raw), 64); err == nil {
+		return val
+	}
+
+	end := numericPrefixLen(raw)
+	if end == 0 {
+		return 0
+	}
+	val, err := strconv.ParseFloat(string(raw[:end]), 64)
+	if err != nil {
+		return 0
+	}
+	return val
+}
+
+// exactPow10 holds the powers of ten that are exactly representable as float64.
+var exactPow10 = [...]float64{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+}
+
+// parseDecimal converts [+-]digits[.digits] followed only by blanks or NULs
+// directly from the bytes. It reports false, leaving the value to strconv,
+// when the text has any other form or when the mantissa or the number of
+// decimals is too large for the single division below to be correctly
+// rounded.
+func parseDecimal(raw []byte) (float64, bool) {
+	i := 0
+	neg := false
+	if i < len(raw) && (raw[i] == '+' || raw[i] == '-') {
+		neg = raw[i] == '-'
+		i++
+	}
+
+	var mantissa uint64
+	scale := 0
+	digits := false
+	dot := false
+	for ; i < len(raw); i++ {
+		ch := raw[i]
+		if ch == '.' && !dot {
+			dot = true
+			continue
+		}
+		if ch < '0' || ch > '9' {
+			break
+		}
+		digits = true
+		mantissa = mantissa*10 + uint64(ch-'0')
+		if mantissa >= 1<<53 {
+			return 0, false
+		}
+		if dot {
+			scale++
+		}
+	}
+	if !digits || scale >= len(exactPow10) {
+		return 0, false
+	}
+
+	for ; i < len(raw); i++ {
+		if raw[i] != ' ' && raw[i] != 0 {
+			return 0, false
+		}
+	}
+
+	val := float64(mantissa) / exactPow10[scale]
+	if neg {
+		val = -val
+	}
+	return val, true
+}
+
+// numericPrefixLen returns the length of the longest prefix of raw that forms
+// a decimal number: [+-]digits[.digits][(e|E)[+-]digits].
+func numericPrefixLen(raw []byte) int {
+	i := 0
+	if i < len(raw) && (raw[i] == '+' || raw[i] == '-') {
+		i++
+	}
+
+	digits := 0
+	for i < len(raw) && raw[i] >= '0' && raw[i] <= '9' {
+		i++
+		digits++
+	}
+	if i < len(raw) && raw[i] == '.' {
+		i++
+		for i < len(raw) && raw[i] >= '0' && raw[i] <= '9' {
+			i++
+			digits++
+		}
+	}
+	if digits == 0 {
+		return 0
+	}
+
+	if i < len(raw) && (raw[i] == 'e' || raw[i] == 'E') {
+		j := i + 1
+		if j < len(raw) && (raw[j] == '+' || raw[j] == '-') {
+			j++
+		}
+		expStart := j
+		for j < len(raw) && raw[j] >= '0' && raw[j] <= '9' {
+			j++
+		}
+		if j > expStart {
+			i = j
+		}
+	}
+
+	return i
+}
+
+// decodeInteger decodes a 4-byte little-endian I field.
+func decodeInteger(raw []byte) int32 {
+	if len(raw) < 4 {
+		return 0
+	}
+	return int32(binary.LittleEndian.Uint32(raw))
+}
+
+// decodeCurrencyUnits decodes a Y field as its raw 64-bit integer, which holds
+// the amount scaled by 10000.
+func decodeCurrencyUnits(raw []byte) int64 {
+	if len(raw) < 8 {
+		return 0
+	}
+	return int64(binary.LittleEndian.Uint64(raw))
+}
+
+// decodeCurrency decodes a Y field as a float64.
+func decodeCurrency(raw []byte) float64 {
+	return float64(decodeCurrencyUnits(raw)) / 10000.0
+}
+
+// decodeDouble decodes an 8-byte little-endian IEEE 754 B field.
+func decodeDouble(raw []byte) float64 {
+	if len(raw) < 8 {
+		return 0
+	}
+	return math.Float64frombits(binary.LittleEndian.Uint64(raw))
+}
+
+// decodeLogical decodes an L field: T, t, Y and y are true, anything else is false.
+func decodeLogical(raw []byte) bool {
+	if len(raw) == 0 {
+		return false
+	}
+	switch raw[0] {
+	case 'T', 't', 'Y', 'y':
+		return true
+	default:
+		return false
+	}
+}
+
+// isBlankDate reports whether a D field holds no date.
+func isBlankDate(raw []byte) bool {
+	for _, b := range raw {
+		if b != ' ' && b != 0 {
+			return false
+		}
+	}
+	return true
+}
+
+// decodeDateJulian decodes a CCYYMMDD D field into a Julian day number, with
+// the same results as CodeBase's date4long: 0 for an all-blank date and -1
+// for an invalid one. Like date4long it takes blank-padded parts, where a
+// part ends at the first blank after its digits, and year 0.
+func decodeDateJulian(raw []byte) int {
+	if len(raw) < 8 {
+		return -1
+	}
+	raw = raw[:8]
+	if string(raw) == blankDateValue {
+		return 0
+	}
+	for _, b := range raw {
+		if b != ' ' && (b < '0' || b > '9') {
+			return -1
+		}
+	}
+
+	year, month, day := parseDatePart(raw[0:4]), parseDatePart(raw[4:6]), parseDatePart(raw[6:8])
+	if month < 1 || month > 12 || day < 1 || day > daysIn(year, month) {
+		return -1
+	}
+
+	// Days before the year as date4long counts them, with C's truncating
+	// division, which for year 0 differs from YMDToJulian
+	if year == 0 {
+		return 1721425 - 365 + dayOfYear(year, month, day)
+	}
+	return YMDToJulian(year, month, day)
+}
+
+// parseDatePart parses a part of a date the way c4atoi does: leading blanks
+// are skipped and the digits up to the next blank make the value, 0 if there
+// are none. The part holds only digits and blanks.
+func parseDatePart(raw []byte) int {
+	val, digits := 0, 0
+	for _, b := range raw {
+		if b == ' ' {
+			if digits > 0 {
+				break
+			}
+			continue
+		}
+		val = val*10 + int(b-'0')
+		digits++
+	}
+	return val
+}
+
+// dayOfYear returns the day of the year of a date of the Gregorian calendar.
+func dayOfYear(year, month, day int) int {
+	return time.Date(year, time.Month(month), day, 0, 0, 0, 0, time.UTC).YearDay()
+}
+
+// daysIn returns the number of days in the given month of the Gregorian calendar.
+func daysIn(year, month int) int {
+	return time.Date(year, time.Month(month)+1, 0, 0, 0, 0, 0, time.UTC).Day()
+}
+
+// decodeDateTime decodes an 8-byte T field (4-byte Julian day followed by
+// 4-byte milliseconds since midnight). An all-zero value is the zero time.
+func decodeDateTime(raw []byte) time.Time {
+	if len(raw) < 8 {
+		return time.Time{}
+	}
+
+	jdays := binary.LittleEndian.Uint32(raw[:4])
+	jmsec := binary.LittleEndian.Uint32(raw[4:8])
+	if jdays == 0 && jmsec == 0 {
+		return time.Time{}
+	}
+
+	y, m, d := JulianToYMD(int(jdays))
+	return time.Date(y, time.Month(m), d, 0, 0, int(jmsec/1000), 0, time.UTC)
+}
@@ -0,0 +1,291 @@
+package vulpo
+
+import (
+	"encoding/binary"
+	"math"
+	"path/filepath"
+	"strconv"
+	"strings"
+	"testing"
+	"time"
+)
+
+func TestDecodeNumeric(t *testing.T) {
+	tests := []struct {
+		raw      string
+		expected float64
+	}{
+		{"  123.45", 123.45},
+		{"-12.5", -12.5},
+		{"     ", 0},
+		{"", 0},
+		{"*****", 0},
+		{"1.2.3", 1.2},
+		{"12abc", 12},
+		{"  -0.00", 0},
+		{"1e3", 1000},
+		{".5", 0.5},
+		{"-", 0},
+	}
+
+	for _, tt := range tests {
+		if got := decodeNumeric([]byte(tt.raw)); got != tt.expected {
+			t.Errorf("decodeNumeric(%q) = %v, expected %v", tt.raw, got, tt.expected)
+		}
+	}
+}
+
+func TestParseDecimal_MatchesStrconv(t *testing.T) {
+	inputs := []string{
+		"0", "-0", "1", "123.45", "-12.5", "0.1", "0.3", "+7", "1.", ".25", "-.125",
+		"9007199254740991", "900719925474099.1", "0.000000000000000000001",
+		"3.14159265358979", "123456789012.34", "42  ", "1.5\x00\x00",
+	}
+
+	for _, input := range inputs {
+		got, ok := parseDecimal([]byte(input))
+		if !ok {
+			t.Errorf("parseDecimal(%q) was rejected", input)
+			continue
+		}
+		want, _ := strconv.ParseFloat(strings.TrimRight(input, " \x00"), 64)
+		if got != want || math.Signbit(got) != math.Signbit(want) {
+			t.Errorf("parseDecimal(%q) = %v, strconv gives %v", input, got, want)
+		}
+	}
+
+	// Left to strconv
+	for _, input := range []string{"", "-", ".", "1e3", "1.2.3", "12abc", "9007199254740993", "1 2", "inf"} {
+		if _, ok := parseDecimal([]byte(input)); ok {
+			t.Errorf("parseDecimal(%q) should be rejected", input)
+		}
+	}
+}
+
+func TestDecodeCharacter(t *testing.T) {
+	tests := []struct {
+		raw      string
+		expected string
+	}{
+		{"JOHN      ", "JOHN"},
+		{"  padded  ", "padded"},
+		{"cut\x00here", "cut"},
+		{"          ", ""},
+	}
+
+	for _, tt := range tests {
+		if got := decodeCharacter([]byte(tt.raw)); got != tt.expected {
+			t.Errorf("decodeCharacter(%q) = %q, expected %q", tt.raw, got, tt.expected)
+		}
+	}
+}
+
+func TestDecodeDateJulian(t *testing.T) {
+	tests := []struct {
+		raw      string
+		expected int
+	}{
+		{"19000101", 2415021},
+		{"20000101", 2451545},
+		{"        ", 0},
+		{"20231301", -1},
+		{"20230229", -1},
+		{"abcdefgh", -1},
+		{"2023 1 1", 2459946},
+		{"2023013 ", 2459948},
+	}
+
+	for _, tt := range tests {
+		if got := decodeDateJulian([]byte(tt.raw)); got != tt.expected {
+			t.Errorf("decodeDateJulian(%q) = %d, expected %d", tt.raw, got, tt.expected)
+		}
+	}
+
+	// Round trip through JulianToYMD
+	for _, jd := range []int{2415021, 2451545, 2460000} {
+		y, m, d := JulianToYMD(jd)
+		if got := YMDToJulian(y, m, d); got != jd {
+			t.Errorf("YMDToJulian(JulianToYMD(%d)) = %d", jd, got)
+		}
+	}
+}
+
+func TestDecodeDateJulian_MatchesDate4long(t *testing.T) {
+	inputs := []string{
+		"20230101", "2023 1 1", "202301 1", "2023013 ", "201 0101", "20 30101", "2 0 0101",
+		"   20101", "    1231", "00000101", "0000 229", "00000230", "99991231", "        ",
+		"20231301", "20230229", "20240229", "20230 01", "2023  01", "2023 1  ", "0000    ",
+		"2023-1-1", "+2020101", "202a0101", "20 a0101", "2023.101", "2023011a", "abcdefgh",
+		"2023\x00101", "2023013\x00", "\x00\x00\x00\x00\x00\x00\x00\x00", "2023 1\t1",
+	}
+
+	for _, input := range inputs {
+		if got, want := decodeDateJulian([]byte(input)), date4long([]byte(input)); got != want {
+			t.Errorf("decodeDateJulian(%q) = %d, date4long gives %d", input, got, want)
+		}
+	}
+}
+
+func TestDecodeBinaryTypes(t *testing.T) {
+	raw := make([]byte, 8)
+
+	binary.LittleEndian.PutUint32(raw, uint32(0xFFFFFFFE))
+	if got := decodeInteger(raw[:4]); got != -2 {
+		t.Errorf("decodeInteger = %d, expected -2", got)
+	}
+
+	binary.LittleEndian.PutUint64(raw, uint64(1234567))
+	if got := decodeCurrency(raw); got != 123.4567 {
+		t.Errorf("decodeCurrency = %v, expected 123.4567", got)
+	}
+	if got := decodeCurrencyUnits(raw); got != 1234567 {
+		t.Errorf("decodeCurrencyUnits = %d, expected 1234567", got)
+	}
+
+	binary.LittleEndian.PutUint64(raw, math.Float64bits(-2.5))
+	if got := decodeDouble(raw); got != -2.5 {
+		t.Errorf("decodeDouble = %v, expected -2.5", got)
+	}
+
+	binary.LittleEndian.PutUint32(raw[:4], uint32(YMDToJulian(2023, 12, 1)))
+	binary.LittleEndian.PutUint32(raw[4:], uint32((13*3600+14*60+15)*1000))
+	expected := time.Date(2023, 12, 1, 13, 14, 15, 0, time.UTC)
+	if got := decodeDateTime(raw); !got.Equal(expected) {
+		t.Errorf("decodeDateTime = %v, expected %v", got, expected)
+	}
+
+	if !decodeDateTime(make([]byte, 8)).IsZero() {
+		t.Error("Expected zero time for all-zero datetime")
+	}
+
+	for _, b := range []byte("TtYy") {
+		if !decodeLogical([]byte{b}) {
+			t.Errorf("decodeLogical(%q) = false, expected true", b)
+		}
+	}
+	for _, b := range []byte("FfNn ?") {
+		if decodeLogical([]byte{b}) {
+			t.Errorf("decodeLogical(%q) = true, expected false", b)
+		}
+	}
+}
+
+// TestRecord_MatchesFieldReaders checks that values decoded from batch record
+// images agree with the field readers positioned on the same record.
+func TestRecord_MatchesFieldReaders(t *testing.T) {
+	files, _ := filepath.Glob("testdata/fieldtests/*.dbf")
+	files = append(files, "testdata/idcharsdate.dbf", "testdata/intcharsnumeric.dbf", "testdata/logictime.dbf", testDBFWithIndexPath)
+
+	for _, file := range files {
+		t.Run(file, func(t *testing.T) {
+			v := &Vulpo{}
+			if err := v.Open(file); err != nil {
+				t.Skipf("Cannot open %s: %v", file, err)
+			}
+			defer v.Close()
+
+			if err := v.First(); err != nil {
+				t.Fatalf("Failed to go to first record: %v", err)
+			}
+			batch, err := v.ReadBatch(1000)
+			if err != nil {
+				t.Fatalf("ReadBatch failed: %v", err)
+			}
+
+			for i := 0; i < batch.Len(); i++ {
+				rec := batch.At(i)
+				if err := v.Goto(rec.RecordNumber()); err != nil {
+					t.Fatalf("Goto(%d) failed: %v", rec.RecordNumber(), err)
+				}
+
+				for j := 0; j < v.FieldCount(); j++ {
+					field := v.Field(j)
+					if field.Type() == FTMemo {
+						continue
+					}
+
+					want, err := field.Value()
+					if err != nil {
+						continue
+					}
+					got, err := rec.Value(j)
+					if err != nil {
+						t.Errorf("Record %d field %s: Value failed: %v", rec.RecordNumber(), field.Name(), err)
+						continue
+					}
+					if got != want {
+						t.Errorf("Record %d field %s: expected %v, got %v", rec.RecordNumber(), field.Name(), want, got)
+					}
+				}
+			}
+		})
+	}
+}
+
+func TestRecord_InvalidAccess(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open("testdata/fieldtests/dates.dbf"); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	_ = v.First()
+	batch, err := v.ReadBatch(1)
+	if err != nil || batch.Len() == 0 {
+		t.Fatalf("ReadBatch failed: %v", err)
+	}
+	rec := batch.At(0)
+
+	if _, err := rec.Float(0); err == nil {
+		t.Error("Expected conversion error reading a date field as float")
+	}
+	if _, err := rec.String(99); err == nil {
+		t.Error("Expected error for out-of-range field index")
+	}
+	if rec.Bytes(99) != nil {
+		t.Error("Expected nil bytes for out-of-range field index")
+	}
+	if idx := v.FieldDefs().Index("DATES"); idx != 0 {
+		t.Errorf("Expected field index 0, got %d", idx)
+	}
+	if idx := v.FieldDefs().Index("missing"); idx != -1 {
+		t.Errorf("Expected field index -1, got %d", idx)
+	}
+}
+
+func TestField_IsNull_NullFlags(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open("testdata/nulls.dbf"); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	if err := v.First(); err != nil {
+		t.Fatalf("Failed to go to first record: %v", err)
+	}
+	batch, err := v.ReadBatch(100)
+	if err != nil || batch.Len() != 12 {
+		t.Fatalf("ReadBatch = %v records, %v, want 12", batch.Len(), err)
+	}
+
+	// Field j of record r is null when (r+j)%3 == 0, counting fields from
+	// 1, as CodeBase wrote the table and f4null read it back; ID is not
+	// nullable
+	for i := 0; i < batch.Len(); i++ {
+		rec := batch.At(i)
+		r := rec.RecordNumber()
+		if err := v.Goto(r); err != nil {
+			t.Fatalf("Goto(%d) failed: %v", r, err)
+		}
+		for j := 0; j < v.FieldCount(); j++ {
+			want := j > 0 && (r+j+1)%3 == 0
+			field := v.Field(j)
+			if got, err := field.IsNull(); err != nil || got != want {
+				t.Errorf("Record %d field %s: IsNull = %v, %v, want %v", r, field.Name(), got, err, want)
+			}
+			if got := rec.IsNull(j); got != want {
+				t.Errorf("Record %d field %s: Record.IsNull = %v, want %v", r, field.Name(), got, want)
+			}
+		}
+	}
+}
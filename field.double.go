@@ -13,17 +13,16 @@ import (
 // Double fields provide double precision floating point numbers
 type DoubleField struct {
 	baseField
-	cField *C.FIELD4
 }
 
 // newDoubleField creates a new DoubleField instance
 func newDoubleField(field *C.FIELD4, data *Vulpo, def *FieldDef) *DoubleField {
 	return &DoubleField{
 		baseField: baseField{
-			def:  def,
-			data: data,
+			def:    def,
+			data:   data,
+			cField: field,
 		},
-		cField: field,
 	}
 }
 
@@ -58,11 +57,17 @@ func (f *DoubleField) AsInt() (int, error) {
 
 // AsFloat returns the field value as a float64
 func (f *DoubleField) AsFloat() (float64, error) {
-	if err := f.checkActive(); err != nil {
+	raw, err := f.raw()
+	if err != nil {
 		return 0, err
 	}
 
-	// Use f4double() to get the double value from CodeBase
+	// Binary 8-byte doubles are decoded straight from the record buffer;
+	// any other layout still goes through f4double()
+	if len(raw) == 8 {
+		return decodeDouble(raw), nil
+	}
+
 	doubleVal := float64(C.f4double(f.cField))
 	return doubleVal, nil
 }
@@ -82,15 +87,6 @@ func (f *DoubleField) AsTime() (time.Time, error) {
 	return time.Time{}, NewConversionError("double", "time")
 }
 
-// IsNull returns true if the field is null
-func (f *DoubleField) IsNull() (bool, error) {
-	if err := f.checkActive(); err != nil {
-		return false, err
-	}
-
-	return C.f4null(f.cField) != 0, nil
-}
-
 // Field interface methods are inherited from baseField
 
 // String returns a string representation of the double field
@@ -0,0 +1,138 @@
+package vulpo
+
+import (
+	"encoding/binary"
+	"math"
+	"strconv"
+	"strings"
+	"time"
+)
+
+// The encoders below are the inverse of the decoders in field.decode.go:
+// they build the bytes of a field from a Go value, for the setters to
+// assign.
+
+// encodeNumeric formats an N or F field of the given width and decimals,
+// right-aligned as CodeBase writes it. It fails when the value does not fit.
+func encodeNumeric(val float64, length, decimals int) ([]byte, bool) {
+	if math.IsNaN(val) || math.IsInf(val, 0) {
+		return nil, false
+	}
+	text := strconv.AppendFloat(nil, val, 'f', decimals, 64)
+	if len(text) > length {
+		return nil, false
+	}
+
+	raw := make([]byte, length)
+	pad := length - len(text)
+	for i := 0; i < pad; i++ {
+		raw[i] = ' '
+	}
+	copy(raw[pad:], text)
+	return raw, true
+}
+
+// encodeInteger encodes a 4-byte little-endian I field.
+func encodeInteger(val int32) []byte {
+	return binary.LittleEndian.AppendUint32(nil, uint32(val))
+}
+
+// encodeCurrencyUnits encodes a Y field from the amount scaled by 10000.
+func encodeCurrencyUnits(units int64) []byte {
+	return binary.LittleEndian.AppendUint64(nil, uint64(units))
+}
+
+// currencyUnits returns an amount scaled by 10000 and rounded, as a Y field
+// holds it. It fails when the amount is out of range.
+func currencyUnits(val float64) (int64, bool) {
+	units := math.Round(val * 10000)
+	if math.IsNaN(units) || units < math.MinInt64 || units >= math.MaxInt64 {
+		return 0, false
+	}
+	return int64(units), true
+}
+
+// parseCurrencyUnits parses a decimal amount such as "-1234.5678" straight
+// to the amount scaled by 10000, rounding further decimals half away from
+// zero as currencyUnits does, without going through a float64. It fails on
+// anything but digits with an optional sign and decimal point, and when the
+// amount is out of range.
+func parseCurrencyUnits(text string) (int64, bool) {
+	negative := false
+	if text != "" && (text[0] == '-' || text[0] == '+') {
+		negative = text[0] == '-'
+		text = text[1:]
+	}
+	whole, frac, _ := strings.Cut(text, ".")
+	if whole == "" && frac == "" {
+		return 0, false
+	}
+	for _, digits := range []string{whole, frac} {
+		for i := 0; i < len(digits); i++ {
+			if digits[i] < '0' || digits[i] > '9' {
+				return 0, false
+			}
+		}
+	}
+
+	round := len(frac) > 4 && frac[4] >= '5'
+	if len(frac) > 4 {
+		frac = frac[:4]
+	}
+	units, err := strconv.ParseInt(whole+frac+strings.Repeat("0", 4-len(frac)), 10, 64)
+	if err != nil {
+		return 0, false
+	}
+	if round {
+		if units == math.MaxInt64 {
+			return 0, false
+		}
+		units++
+	}
+	if negative {
+		units = -units
+	}
+	return units, true
+}
+
+// encodeDouble encodes an 8-byte little-endian IEEE 754 B field.
+func encodeDouble(val float64) []byte {
+	return binary.LittleEndian.AppendUint64(nil, math.Float64bits(val))
+}
+
+// encodeLogical encodes an L field.
+func encodeLogical(val bool) byte {
+	if val {
+		return 'T'
+	}
+	return 'F'
+}
+
+// encodeDate encodes a CCYYMMDD D field; the zero time gives a blank date.
+func encodeDate(t time.Time) ([]byte, bool) {
+	if t.IsZero() {
+		return []byte("        "), true
+	}
+	if t.Year() < 1 || t.Year() > 9999 {
+		return nil, false
+	}
+	return []byte(t.Format("20060102")), true
+}
+
+// encodeDateTime encodes an 8-byte T field (4-byte Julian day followed by
+// 4-byte milliseconds since midnight) to the whole second, as Visual FoxPro
+// keeps it; the zero time gives all zeros.
+func encodeDateTime(t time.Time) ([]byte, bool) {
+	raw := make([]byte, 8)
+	if t.IsZero() {
+		return raw, true
+	}
+	if t.Year() < 1 || t.Year() > 9999 {
+		return nil, false
+	}
+
+	msec := ((t.Hour()*60+t.Minute())*60 + t.Second()) * 1000
+	binary.LittleEndian.PutUint32(raw[:4], uint32(YMDToJulian(t.Year(), int(t.Month()), t.Day())))
+	binary.LittleEndian.PutUint32(raw[4:], uint32(msec))
+	return raw, true
+}
@@ -0,0 +1,128 @@
+package vulpo
+
+import (
+	"math"
+	"testing"
+	"time"
+)
+
+func TestEncodeNumeric(t *testing.T) {
+	tests := []struct {
+		val      float64
+		length   int
+		decimals int
+		expected string
+		ok       bool
+	}{
+		{123.45, 8, 2, "  123.45", true},
+		{-12.5, 6, 1, " -12.5", true},
+		{1234.567, 8, 2, " 1234.57", true},
+		{0, 5, 0, "    0", true},
+		{99999, 5, 0, "99999", true},
+		{100000, 5, 0, "", false},
+		{-1234.5, 6, 2, "", false},
+		{math.NaN(), 10, 2, "", false},
+		{math.Inf(1), 10, 2, "", false},
+	}
+
+	for _, tt := range tests {
+		raw, ok := encodeNumeric(tt.val, tt.length, tt.decimals)
+		if ok != tt.ok || string(raw) != tt.expected {
+			t.Errorf("encodeNumeric(%v, %d, %d) = %q, %v, expected %q, %v", tt.val, tt.length, tt.decimals, raw, ok, tt.expected, tt.ok)
+		}
+		if ok && decodeNumeric(raw) != math.Round(tt.val*math.Pow10(tt.decimals))/math.Pow10(tt.decimals) {
+			t.Errorf("decodeNumeric(%q) = %v, expected %v rounded", raw, decodeNumeric(raw), tt.val)
+		}
+	}
+}
+
+func TestEncode_RoundTrip(t *testing.T) {
+	for _, val := range []int32{0, 1, -1, math.MaxInt32, math.MinInt32} {
+		if got := decodeInteger(encodeInteger(val)); got != val {
+			t.Errorf("decodeInteger(encodeInteger(%d)) = %d", val, got)
+		}
+	}
+
+	for _, val := range []float64{0, 12.34567, -0.0001, 922337203685477} {
+		units, ok := currencyUnits(val)
+		if !ok {
+			t.Errorf("currencyUnits(%v) failed", val)
+			continue
+		}
+		if got := decodeCurrency(encodeCurrencyUnits(units)); got != math.Round(val*10000)/10000 {
+			t.Errorf("decodeCurrency(encodeCurrencyUnits(%v)) = %v", val, got)
+		}
+	}
+	if _, ok := currencyUnits(1e16); ok {
+		t.Error("currencyUnits(1e16) should fail")
+	}
+
+	for _, tt := range []struct {
+		text  string
+		units int64
+		ok    bool
+	}{
+		{"12.34567", 123457, true},
+		{"-0.00005", -1, true},
+		{"+7", 70000, true},
+		{".5", 5000, true},
+		{"3.", 30000, true},
+		{"922337203685477.5807", math.MaxInt64, true},
+		{"922337203685477.58075", 0, false},
+		{"922337203685477.5808", 0, false},
+		{"1e6", 0, false},
+		{"-", 0, false},
+		{"1.2.3", 0, false},
+	} {
+		if units, ok := parseCurrencyUnits(tt.text); units != tt.units || ok != tt.ok {
+			t.Errorf("parseCurrencyUnits(%q) = %d, %v, expected %d, %v", tt.text, units, ok, tt.units, tt.ok)
+		}
+	}
+
+	for _, val := range []float64{0, math.Pi, -1e300, math.Inf(-1)} {
+		if got := decodeDouble(encodeDouble(val)); got != val {
+			t.Errorf("decodeDouble(encodeDouble(%v)) = %v", val, got)
+		}
+	}
+
+	for _, val := range []bool{true, false} {
+		if got := decodeLogical([]byte{encodeLogical(val)}); got != val {
+			t.Errorf("decodeLogical(encodeLogical(%v)) = %v", val, got)
+		}
+	}
+}
+
+func TestEncodeDate(t *testing.T) {
+	raw, ok := encodeDate(time.Date(2024, 3, 15, 10, 20, 30, 0, time.UTC))
+	if !ok || string(raw) != "20240315" {
+		t.Errorf("encodeDate = %q, %v, expected 20240315", raw, ok)
+	}
+	if raw, ok := encodeDate(time.Time{}); !ok || !isBlankDate(raw) {
+		t.Errorf("encodeDate(zero) = %q, %v, expected a blank date", raw, ok)
+	}
+	if _, ok := encodeDate(time.Date(10000, 1, 1, 0, 0, 0, 0, time.UTC)); ok {
+		t.Error("encodeDate should fail for year 10000")
+	}
+}
+
+func TestEncodeDateTime(t *testing.T) {
+	for _, want := range []time.Time{
+		time.Date(2024, 3, 15, 10, 20, 30, 123000000, time.UTC),
+		time.Date(1, 1, 1, 0, 0, 1, 0, time.UTC),
+		time.Date(9999, 12, 31, 23, 59, 59, 999000000, time.UTC),
+	} {
+		raw, ok := encodeDateTime(want)
+		want = want.Truncate(time.Second)
+		if !ok {
+			t.Errorf("encodeDateTime(%v) failed", want)
+			continue
+		}
+		if got := decodeDateTime(raw); !got.Equal(want) {
+			t.Errorf("decodeDateTime(encodeDateTime(%v)) = %v", want, got)
+		}
+	}
+
+	if raw, ok := encodeDateTime(time.Time{}); !ok || !decodeDateTime(raw).IsZero() {
+		t.Errorf("encodeDateTime(zero) = %v, %v, expected zero", raw, ok)
+	}
+}
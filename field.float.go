@@ -12,17 +12,16 @@ import (
 // FloatField represents a DBF float field (type 'F')
 type FloatField struct {
 	baseField
-	cField *C.FIELD4
 }
 
 // newFloatField creates a new FloatField instance
 func newFloatField(field *C.FIELD4, data *Vulpo, def *FieldDef) *FloatField {
 	return &FloatField{
 		baseField: baseField{
-			def:  def,
-			data: data,
+			def:    def,
+			data:   data,
+			cField: field,
 		},
-		cField: field,
 	}
 }
 
@@ -57,13 +56,13 @@ func (f *FloatField) AsInt() (int, error) {
 
 // AsFloat returns the field value as a float64
 func (f *FloatField) AsFloat() (float64, error) {
-	if err := f.checkActive(); err != nil {
+	raw, err := f.raw()
+	if err != nil {
 		return 0, err
 	}
 
-	// Use f4double() to get the float value from CodeBase
-	floatVal := float64(C.f4double(f.cField))
-	return floatVal, nil
+	// Float fields hold ASCII digits, parsed straight from the record buffer
+	return decodeNumeric(raw), nil
 }
 
 // AsBool returns true if the float is not zero
@@ -81,15 +80,6 @@ func (f *FloatField) AsTime() (time.Time, error) {
 	return time.Time{}, NewConversionError("float", "time")
 }
 
-// IsNull returns true if the field is null
-func (f *FloatField) IsNull() (bool, error) {
-	if err := f.checkActive(); err != nil {
-		return false, err
-	}
-
-	return C.f4null(f.cField) != 0, nil
-}
-
 // Field interface methods are inherited from baseField
 
 // String returns a string representation of the float field
@@ -3,11 +3,11 @@ package vulpo
 import "strings"
 
 // Field defines the unified interface for accessing both field definition information
-// and field value reading capabilities. This interface extends FieldReader to provide
+// and field values. This interface extends FieldReader and FieldWriter to provide
 // a complete field access solution.
 //
 // Key Benefits of the Field Interface:
-//   - Unified API: Single interface for both metadata and value access
+//   - Unified API: Single interface for metadata, value access and assignment
 //   - Automatic Creation: Field instances are created automatically at Open() time
 //   - No Manual Management: No need to create or manage FieldReader instances
 //   - Performance: Field readers are cached and reused for optimal performance
@@ -29,8 +29,10 @@ import "strings"
 //	fieldType := nameField.Type()            // Access field definition
 //	fieldSize := nameField.Size()            // Field metadata
 //	isNull, _ := nameField.IsNull()          // Check for null values
+//	nameField.SetString("ACME Ltd")          // Change the current record
 type Field interface {
 	FieldReader
+	FieldWriter
 }
 
 // Fields provides access to the database field collection with both
@@ -12,17 +12,17 @@ import (
 // IntegerField handles integer fields
 type IntegerField struct {
 	baseField
-	cField *C.FIELD4
 }
 
 // Value returns the field's integer value
 func (intf *IntegerField) Value() (interface{}, error) {
-	if err := intf.checkActive(); err != nil {
+	raw, err := intf.raw()
+	if err != nil {
 		return nil, err
 	}
 
-	// Get integer value using f4int()
-	val := int(C.f4int(intf.cField))
+	// Integer fields are stored as 4-byte little-endian values
+	val := int(decodeInteger(raw))
 	return val, nil
 }
 
@@ -66,12 +66,3 @@ func (intf *IntegerField) AsBool() (bool, error) {
 func (intf *IntegerField) AsTime() (time.Time, error) {
 	return time.Time{}, NewConversionError("integer", "time")
 }
-
-// IsNull returns true if the field is null
-func (intf *IntegerField) IsNull() (bool, error) {
-	if err := intf.checkActive(); err != nil {
-		return false, err
-	}
-
-	return C.f4null(intf.cField) != 0, nil
-}
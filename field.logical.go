@@ -11,17 +11,17 @@ import (
 // LogicalField handles logical/boolean fields
 type LogicalField struct {
 	baseField
-	cField *C.FIELD4
 }
 
 // Value returns the field's boolean value
 func (lf *LogicalField) Value() (interface{}, error) {
-	if err := lf.checkActive(); err != nil {
+	raw, err := lf.raw()
+	if err != nil {
 		return nil, err
 	}
 
-	// Get boolean value using f4true() (returns 1 for true, 0 for false)
-	val := C.f4true(lf.cField) != 0
+	// T, t, Y and y are true, anything else is false
+	val := decodeLogical(raw)
 	return val, nil
 }
 
@@ -77,12 +77,3 @@ func (lf *LogicalField) AsBool() (bool, error) {
 func (lf *LogicalField) AsTime() (time.Time, error) {
 	return time.Time{}, NewConversionError("logical", "time")
 }
-
-// IsNull returns true if the field is null
-func (lf *LogicalField) IsNull() (bool, error) {
-	if err := lf.checkActive(); err != nil {
-		return false, err
-	}
-
-	return C.f4null(lf.cField) != 0, nil
-}
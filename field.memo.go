@@ -13,17 +13,16 @@ import (
 // This implementation provides read-only access to memo contents.
 type MemoField struct {
 	baseField
-	cField *C.FIELD4
 }
 
 // newMemoField creates a new MemoField instance
 func newMemoField(field *C.FIELD4, data *Vulpo, def *FieldDef) *MemoField {
 	return &MemoField{
 		baseField: baseField{
-			def:  def,
-			data: data,
+			def:    def,
+			data:   data,
+			cField: field,
 		},
-		cField: field,
 	}
 }
 
@@ -71,12 +70,4 @@ func (f *MemoField) AsTime() (time.Time, error) {
 	return time.Time{}, NewConversionError("memo", "time")
 }
 
-// IsNull returns true if the field is null
-func (f *MemoField) IsNull() (bool, error) {
-	if err := f.checkActive(); err != nil {
-		return false, err
-	}
-	return C.f4null(f.cField) != 0, nil
-}
-
 // Field interface methods are inherited from baseField
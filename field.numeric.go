@@ -12,17 +12,17 @@ import (
 // NumericField handles numeric fields (stored as double in DBF)
 type NumericField struct {
 	baseField
-	cField *C.FIELD4
 }
 
 // Value returns the field's numeric value as float64
 func (nf *NumericField) Value() (interface{}, error) {
-	if err := nf.checkActive(); err != nil {
+	raw, err := nf.raw()
+	if err != nil {
 		return nil, err
 	}
 
-	// Get double value using f4double()
-	val := float64(C.f4double(nf.cField))
+	// Parse the ASCII digits straight from the record buffer
+	val := decodeNumeric(raw)
 	return val, nil
 }
 
@@ -80,12 +80,3 @@ func (nf *NumericField) AsBool() (bool, error) {
 func (nf *NumericField) AsTime() (time.Time, error) {
 	return time.Time{}, NewConversionError("numeric", "time")
 }
-
-// IsNull returns true if the field is null
-func (nf *NumericField) IsNull() (bool, error) {
-	if err := nf.checkActive(); err != nil {
-		return false, err
-	}
-
-	return C.f4null(nf.cField) != 0, nil
-}
@@ -13,17 +13,16 @@ import (
 // StringField handles character/string fields
 type StringField struct {
 	baseField
-	cField *C.FIELD4
 }
 
 // newStringField creates a new StringField instance
 func newStringField(field *C.FIELD4, data *Vulpo, def *FieldDef) *StringField {
 	return &StringField{
 		baseField: baseField{
-			def:  def,
-			data: data,
+			def:    def,
+			data:   data,
+			cField: field,
 		},
-		cField: field,
 	}
 }
 
@@ -33,7 +32,16 @@ func (sf *StringField) Value() (interface{}, error) {
 		return nil, err
 	}
 
-	// Get string value using f4str()
+	// Character data is decoded straight from the record buffer
+	if sf.def.Type() == FTCharacter {
+		raw, err := sf.raw()
+		if err != nil {
+			return nil, err
+		}
+		return decodeCharacter(raw), nil
+	}
+
+	// Other types handled as strings rely on f4str() for their text form
 	cStr := C.f4str(sf.cField)
 	if cStr == nil {
 		return "", nil
@@ -140,15 +148,6 @@ func (sf *StringField) AsTime() (time.Time, error) {
 	return time.Time{}, NewConversionError("character", "time")
 }
 
-// IsNull returns true if the field is null
-func (sf *StringField) IsNull() (bool, error) {
-	if err := sf.checkActive(); err != nil {
-		return false, err
-	}
-
-	return C.f4null(sf.cField) != 0, nil
-}
-
 // Field interface methods are inherited from baseField
 
 // String returns a string representation of the string field
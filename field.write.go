@@ -0,0 +1,431 @@
+package vulpo
+
+/*
+#include "d4all.h"
+*/
+import "C"
+import (
+	"math"
+	"strconv"
+	"strings"
+	"time"
+	"unsafe"
+)
+
+// FieldWriter defines the methods that change a field of the current record.
+//
+// Values are encoded in Go and copied into the CodeBase record buffer, so a
+// setter costs one cgo call. Like CodeBase's f4assign functions they only
+// change the record buffer: the record is written, and its index keys
+// updated, when the table moves to another record or on Flush, or by Append
+// and AppendBatch for new records.
+//
+// Numbers too wide for an N or F field, out of range for an I or Y field,
+// and dates outside years 1 to 9999 are rejected rather than written as
+// overflow markers. Character values longer than the field are truncated.
+type FieldWriter interface {
+	// Set assigns a value of any supported Go type: string, []byte, the
+	// integer and float types, bool, time.Time, or nil for null
+	Set(value interface{}) error
+
+	// SetString assigns a string, parsed as the field's type requires
+	SetString(s string) error
+
+	// SetInt assigns an integer
+	SetInt(i int) error
+
+	// SetFloat assigns a float64
+	SetFloat(f float64) error
+
+	// SetBool assigns a boolean
+	SetBool(b bool) error
+
+	// SetTime assigns a date or date/time; the zero time blanks the field
+	SetTime(t time.Time) error
+
+	// SetNull marks a nullable field as null
+	SetNull() error
+}
+
+// checkWritable verifies a value can be assigned to the field of the current
+// record, which is also the case for a record being appended.
+func (bf *baseField) checkWritable() error {
+	if bf.data == nil || !bf.data.Active() {
+		return NewError("database not open")
+	}
+	if bf.data.appending {
+		return nil
+	}
+	return bf.checkActive()
+}
+
+// isMemo returns true for the fields whose contents live in the memo file.
+func (bf *baseField) isMemo() bool {
+	switch bf.def.Type() {
+	case FTMemo, FTGeneral, FTPicture:
+		return true
+	case FTBlob:
+		// Visual FoxPro stores 8-byte binary doubles as type B
+		return bf.def.length != 8
+	}
+	return false
+}
+
+// isDouble returns true for the fields holding an 8-byte IEEE 754 double.
+func (bf *baseField) isDouble() bool {
+	return bf.def.Type() == FTDouble || (bf.def.Type() == FTBlob && bf.def.length == 8)
+}
+
+// assign copies the encoded bytes of a value into the record buffer.
+func (bf *baseField) assign(raw []byte) error {
+	if len(raw) == 0 {
+		C.f4blank(bf.cField)
+	} else {
+		C.f4assignN(bf.cField, (*C.char)(unsafe.Pointer(&raw[0])), C.uint(len(raw)))
+	}
+	return bf.assigned()
+}
+
+// assigned checks the CodeBase result of an assignment and records the change
+// for an online pack.
+func (bf *baseField) assigned() error {
+	if result := bf.data.codeBase.errorCode; result < 0 {
+		C.error4set(bf.data.codeBase, 0)
+		return NewErrorf("failed to assign field '%s': error code %d", bf.def.Name(), int(result))
+	}
+	bf.data.packing.note(int(C.d4recNo(bf.data.data)))
+	return nil
+}
+
+// assignMemo writes the contents of a memo field.
+func (bf *baseField) assignMemo(raw []byte) error {
+	var ptr *C.char
+	if len(raw) > 0 {
+		ptr = (*C.char)(unsafe.Pointer(&raw[0]))
+	}
+	if result := C.f4memoAssignN(bf.cField, ptr, C.uint(len(raw))); result < 0 {
+		C.error4set(bf.data.codeBase, 0)
+		return NewErrorf("failed to assign memo field '%s': error code %d", bf.def.Name(), int(result))
+	}
+	return bf.assigned()
+}
+
+// rangeError reports a value that does not fit the field.
+func (bf *baseField) rangeError(value interface{}) error {
+	return NewErrorf("value %v does not fit %s field '%s'", value, bf.def.Type().Name(), bf.def.Name())
+}
+
+// Set assigns a value of any supported Go type to the field of the current
+// record. A nil value marks the field as null.
+//
+// Parameters:
+//   - value: string, []byte, int, int8..int64, uint8..uint64, float32,
+//     float64, bool, time.Time or nil
+//
+// Returns:
+//   - error: if the value has an unsupported type or cannot be converted
+//
+// Example:
+//
+//	v.FieldByName("NAME").Set("ACME Ltd")
+//	v.FieldByName("BALANCE").Set(1250.75)
+//	v.FieldByName("OPENED").Set(time.Now())
+func (bf *baseField) Set(value interface{}) error {
+	switch val := value.(type) {
+	case nil:
+		return bf.SetNull()
+	case string:
+		return bf.SetString(val)
+	case []byte:
+		return bf.setBytes(val)
+	case int:
+		return bf.SetInt(val)
+	case int8:
+		return bf.SetInt(int(val))
+	case int16:
+		return bf.SetInt(int(val))
+	case int32:
+		return bf.SetInt(int(val))
+	case int64:
+		return bf.SetInt(int(val))
+	case uint8:
+		return bf.SetInt(int(val))
+	case uint16:
+		return bf.SetInt(int(val))
+	case uint32:
+		return bf.SetInt(int(val))
+	case uint64:
+		if val > math.MaxInt64 {
+			return bf.rangeError(val)
+		}
+		return bf.SetInt(int(val))
+	case float32:
+		return bf.SetFloat(float64(val))
+	case float64:
+		return bf.SetFloat(val)
+	case bool:
+		return bf.SetBool(val)
+	case time.Time:
+		return bf.SetTime(val)
+	default:
+		return NewErrorf("cannot assign %T to %s field '%s'", value, bf.def.Type().Name(), bf.def.Name())
+	}
+}
+
+// setBytes assigns raw bytes to a character, binary or memo field.
+func (bf *baseField) setBytes(raw []byte) error {
+	if err := bf.checkWritable(); err != nil {
+		return err
+	}
+	if bf.isMemo() {
+		return bf.assignMemo(raw)
+	}
+
+	switch bf.def.Type() {
+	case FTCharacter, FTVarchar, FTVarBinary:
+		return bf.assign(raw)
+	}
+	return NewConversionError("bytes", bf.def.Type().Name())
+}
+
+// SetString assigns a string to the field of the current record. Numeric,
+// logical, date and date/time fields parse the string; an empty string
+// blanks them.
+//
+// Parameters:
+//   - s: the value; dates accept "20060102" and "2006-01-02", date/times
+//     RFC 3339, "2006-01-02 15:04:05" and "2006-01-02"; currency fields
+//     take decimal amounts exactly, to four decimals
+//
+// Returns:
+//   - error: if the string cannot be parsed as the field's type
+//
+// Example:
+//
+//	v.FieldByName("NAME").SetString("ACME Ltd")
+//	v.FieldByName("OPENED").SetString("2024-03-15")
+func (bf *baseField) SetString(s string) error {
+	if err := bf.checkWritable(); err != nil {
+		return err
+	}
+	if bf.isMemo() {
+		return bf.assignMemo([]byte(s))
+	}
+
+	typ := bf.def.Type()
+	text := strings.TrimSpace(s)
+	switch {
+	case typ == FTNumeric || typ == FTFloat || typ == FTInteger || typ == FTCurrency || bf.isDouble():
+		if text == "" {
+			return bf.assign(nil)
+		}
+		// Decimal amounts keep every digit; others, such as "1e6", are
+		// parsed as floats
+		if typ == FTCurrency {
+			if units, ok := parseCurrencyUnits(text); ok {
+				return bf.assign(encodeCurrencyUnits(units))
+			}
+		}
+		val, err := strconv.ParseFloat(text, 64)
+		if err != nil {
+			return NewConversionError("string", typ.Name())
+		}
+		return bf.SetFloat(val)
+	case typ == FTLogical:
+		switch strings.ToUpper(text) {
+		case "T", "TRUE", "Y", "YES", "1":
+			return bf.SetBool(true)
+		case "F", "FALSE", "N", "NO", "0":
+			return bf.SetBool(false)
+		case "":
+			return bf.assign(nil)
+		}
+		return NewConversionError("string", typ.Name())
+	case typ == FTDate || typ == FTDateTime:
+		if text == "" {
+			return bf.SetTime(time.Time{})
+		}
+		formats := []string{"20060102", "2006-01-02"}
+		if typ == FTDateTime {
+			formats = []string{time.RFC3339, "2006-01-02 15:04:05", "2006-01-02T15:04:05", "2006-01-02"}
+		}
+		for _, format := range formats {
+			if t, err := time.Parse(format, text); err == nil {
+				return bf.SetTime(t)
+			}
+		}
+		return NewConversionError("string", typ.Name())
+	default:
+		return bf.assign([]byte(s))
+	}
+}
+
+// SetInt assigns an integer to the field of the current record.
+//
+// Parameters:
+//   - i: the value; logical fields store i != 0
+//
+// Returns:
+//   - error: if the value does not fit the field or the field is not numeric
+//
+// Example:
+//
+//	v.FieldByName("QTY").SetInt(12)
+func (bf *baseField) SetInt(i int) error {
+	if err := bf.checkWritable(); err != nil {
+		return err
+	}
+
+	switch typ := bf.def.Type(); {
+	case typ == FTInteger:
+		if i < math.MinInt32 || i > math.MaxInt32 {
+			return bf.rangeError(i)
+		}
+		return bf.assign(encodeInteger(int32(i)))
+	case typ == FTCurrency:
+		if i < math.MinInt64/10000 || i > math.MaxInt64/10000 {
+			return bf.rangeError(i)
+		}
+		return bf.assign(encodeCurrencyUnits(int64(i) * 10000))
+	case (typ == FTNumeric || typ == FTFloat) && bf.def.decimals == 0:
+		// Formatted as an integer so that values beyond 2^53 keep every digit
+		text := strconv.Itoa(i)
+		if len(text) > int(bf.def.length) {
+			return bf.rangeError(i)
+		}
+		return bf.assign([]byte(strings.Repeat(" ", int(bf.def.length)-len(text)) + text))
+	case typ == FTNumeric || typ == FTFloat || bf.isDouble():
+		return bf.SetFloat(float64(i))
+	case typ == FTLogical:
+		return bf.SetBool(i != 0)
+	case typ == FTCharacter:
+		return bf.assign([]byte(strconv.Itoa(i)))
+	}
+	return NewConversionError("integer", bf.def.Type().Name())
+}
+
+// SetFloat assigns a float64 to the field of the current record. N and F
+// fields round it to their decimals, Y fields to four decimals.
+//
+// Parameters:
+//   - f: the value
+//
+// Returns:
+//   - error: if the value does not fit the field or the field is not numeric
+//
+// Example:
+//
+//	v.FieldByName("BALANCE").SetFloat(1250.75)
+func (bf *baseField) SetFloat(f float64) error {
+	if err := bf.checkWritable(); err != nil {
+		return err
+	}
+
+	switch typ := bf.def.Type(); {
+	case typ == FTNumeric || typ == FTFloat:
+		raw, ok := encodeNumeric(f, int(bf.def.length), int(bf.def.decimals))
+		if !ok {
+			return bf.rangeError(f)
+		}
+		return bf.assign(raw)
+	case typ == FTInteger:
+		if f != math.Trunc(f) || f < math.MinInt32 || f > math.MaxInt32 {
+			return bf.rangeError(f)
+		}
+		return bf.assign(encodeInteger(int32(f)))
+	case typ == FTCurrency:
+		units, ok := currencyUnits(f)
+		if !ok {
+			return bf.rangeError(f)
+		}
+		return bf.assign(encodeCurrencyUnits(units))
+	case bf.isDouble():
+		return bf.assign(encodeDouble(f))
+	case typ == FTCharacter:
+		return bf.assign([]byte(strconv.FormatFloat(f, 'f', -1, 64)))
+	}
+	return NewConversionError("float", bf.def.Type().Name())
+}
+
+// SetBool assigns a boolean to a logical field of the current record.
+//
+// Parameters:
+//   - b: the value, stored as 'T' or 'F'
+//
+// Returns:
+//   - error: if the field is not logical
+//
+// Example:
+//
+//	v.FieldByName("ACTIVE").SetBool(true)
+func (bf *baseField) SetBool(b bool) error {
+	if err := bf.checkWritable(); err != nil {
+		return err
+	}
+
+	switch bf.def.Type() {
+	case FTLogical:
+		C.f4assignChar(bf.cField, C.int(encodeLogical(b)))
+		return bf.assigned()
+	case FTCharacter:
+		return bf.assign([]byte{encodeLogical(b)})
+	}
+	return NewConversionError("boolean", bf.def.Type().Name())
+}
+
+// SetTime assigns a date or date/time to the field of the current record.
+// Date fields keep the date only, date/time fields the time to the
+// second; the zero time blanks the field.
+//
+// Parameters:
+//   - t: the value, stored as given without converting its location
+//
+// Returns:
+//   - error: if the year is outside 1 to 9999 or the field is not a date
+//
+// Example:
+//
+//	v.FieldByName("OPENED").SetTime(time.Date(2024, 3, 15, 0, 0, 0, 0, time.UTC))
+func (bf *baseField) SetTime(t time.Time) error {
+	if err := bf.checkWritable(); err != nil {
+		return err
+	}
+
+	var raw []byte
+	var ok bool
+	switch bf.def.Type() {
+	case FTDate:
+		raw, ok = encodeDate(t)
+	case FTDateTime:
+		raw, ok = encodeDateTime(t)
+	default:
+		return NewConversionError("time", bf.def.Type().Name())
+	}
+	if !ok {
+		return bf.rangeError(t)
+	}
+	return bf.assign(raw)
+}
+
+// SetNull marks a nullable field of the current record as null. Assigning
+// any value clears the mark again.
+//
+// Returns:
+//   - error: if the field is not nullable
+//
+// Example:
+//
+//	if field.IsNullable() {
+//		field.SetNull()
+//	}
+func (bf *baseField) SetNull() error {
+	if err := bf.checkWritable(); err != nil {
+		return err
+	}
+	if !bf.def.IsNullable() {
+		return NewErrorf("field '%s' is not nullable", bf.def.Name())
+	}
+
+	C.f4assignNull(bf.cField)
+	return bf.assigned()
+}
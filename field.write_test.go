@@ -0,0 +1,207 @@
+package vulpo
+
+import (
+	"math"
+	"strings"
+	"testing"
+	"time"
+)
+
+func TestField_Set_RoundTrip(t *testing.T) {
+	when := time.Date(2024, 3, 15, 10, 20, 30, 0, time.UTC)
+	long := strings.Repeat("memo text ", 300)
+
+	tests := []struct {
+		name  string
+		table string
+		field string
+		set   func(f Field) error
+		want  interface{}
+	}{
+		{"logical", "testdata/fieldtests/bools.dbf", "bools", func(f Field) error { return f.SetBool(true) }, true},
+		{"logical from string", "testdata/fieldtests/bools.dbf", "bools", func(f Field) error { return f.SetString("n") }, false},
+		{"currency", "testdata/fieldtests/currencies.dbf", "currencies", func(f Field) error { return f.SetFloat(12.34567) }, 12.3457},
+		{"currency from int", "testdata/fieldtests/currencies.dbf", "currencies", func(f Field) error { return f.SetInt(-5) }, -5.0},
+		{"date", "testdata/fieldtests/dates.dbf", "dates", func(f Field) error { return f.SetTime(when) }, time.Date(2024, 3, 15, 0, 0, 0, 0, time.UTC)},
+		{"date from string", "testdata/fieldtests/dates.dbf", "dates", func(f Field) error { return f.SetString("2023-01-02") }, time.Date(2023, 1, 2, 0, 0, 0, 0, time.UTC)},
+		{"blank date", "testdata/fieldtests/dates.dbf", "dates", func(f Field) error { return f.SetTime(time.Time{}) }, time.Time{}},
+		{"datetime", "testdata/fieldtests/datetimes.dbf", "timestamps", func(f Field) error { return f.SetTime(when) }, when},
+		{"integer", "testdata/fieldtests/integers.dbf", "id", func(f Field) error { return f.SetInt(-123456) }, -123456},
+		{"integer from float", "testdata/fieldtests/integers.dbf", "id", func(f Field) error { return f.Set(42.0) }, 42},
+		{"memo", "testdata/fieldtests/memos.dbf", "memos", func(f Field) error { return f.SetString(long) }, long},
+		{"numeric", "testdata/fieldtests/numerics.dbf", "nums", func(f Field) error { return f.SetFloat(1234.567) }, 1234.57},
+		{"numeric from string", "testdata/fieldtests/numerics.dbf", "nums", func(f Field) error { return f.SetString(" -7.5 ") }, -7.5},
+		{"blank numeric", "testdata/fieldtests/numerics.dbf", "nums", func(f Field) error { return f.SetString("") }, 0.0},
+		{"character", "testdata/threenames.dbf", "last", func(f Field) error { return f.SetString("Smith") }, "Smith"},
+		{"character truncated", "testdata/threenames.dbf", "last", func(f Field) error { return f.Set("Alexander the Great") }, "Alexander"},
+	}
+
+	for _, tt := range tests {
+		t.Run(tt.name, func(t *testing.T) {
+			path := copyTable(t, tt.table, t.TempDir(), ".dbf", ".fpt")
+			v := &Vulpo{}
+			if err := v.Open(path); err != nil {
+				t.Fatalf("Failed to open test file: %v", err)
+			}
+			defer v.Close()
+
+			if err := v.Goto(1); err != nil {
+				t.Fatalf("Goto failed: %v", err)
+			}
+			if err := tt.set(v.FieldByName(tt.field)); err != nil {
+				t.Fatalf("Setter failed: %v", err)
+			}
+			if err := v.Flush(); err != nil {
+				t.Fatalf("Flush failed: %v", err)
+			}
+
+			// The value is on disk
+			if err := v.Close(); err != nil {
+				t.Fatalf("Close failed: %v", err)
+			}
+			if err := v.Open(path); err != nil {
+				t.Fatalf("Failed to reopen test file: %v", err)
+			}
+			if err := v.Goto(1); err != nil {
+				t.Fatalf("Goto failed: %v", err)
+			}
+			got, err := v.FieldByName(tt.field).Value()
+			if err != nil {
+				t.Fatalf("Value failed: %v", err)
+			}
+			if want, ok := tt.want.(time.Time); ok {
+				if !got.(time.Time).Equal(want) {
+					t.Errorf("Value = %v, want %v", got, want)
+				}
+			} else if got != tt.want {
+				t.Errorf("Value = %v (%T), want %v (%T)", got, got, tt.want, tt.want)
+			}
+		})
+	}
+}
+
+func TestCurrencyField_SetCents(t *testing.T) {
+	path := copyTable(t, "testdata/fieldtests/currencies.dbf", t.TempDir(), ".dbf")
+	v := &Vulpo{}
+	if err := v.Open(path); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+	field := v.FieldByName("currencies").(*CurrencyField)
+
+	// Amounts beyond 2^53 / 10000 lose digits through a float64
+	tests := []struct {
+		set  func() error
+		want int64
+	}{
+		{func() error { return field.SetCents(math.MaxInt64) }, math.MaxInt64},
+		{func() error { return field.SetString("-922337203685477.5807") }, -math.MaxInt64},
+		{func() error { return field.SetString("900719925474.09931") }, 9007199254740993},
+	}
+	for i, tt := range tests {
+		if err := v.Goto(i + 1); err != nil {
+			t.Fatalf("Goto failed: %v", err)
+		}
+		if err := tt.set(); err != nil {
+			t.Fatalf("Setter %d failed: %v", i, err)
+		}
+	}
+	if err := v.Close(); err != nil {
+		t.Fatalf("Close failed: %v", err)
+	}
+	if err := v.Open(path); err != nil {
+		t.Fatalf("Failed to reopen test file: %v", err)
+	}
+	field = v.FieldByName("currencies").(*CurrencyField)
+	for i, tt := range tests {
+		if err := v.Goto(i + 1); err != nil {
+			t.Fatalf("Goto failed: %v", err)
+		}
+		if got, err := field.AsCents(); err != nil || got != tt.want {
+			t.Errorf("Record %d AsCents() = %d, %v, want %d", i+1, got, err, tt.want)
+		}
+	}
+}
+
+func TestField_Set_Errors(t *testing.T) {
+	path := copyTable(t, "testdata/intcharsnumeric.dbf", t.TempDir(), ".dbf", ".fpt")
+	v := &Vulpo{}
+	if err := v.Open(path); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+	id, numbers := v.FieldByName("id"), v.FieldByName("numbers")
+
+	if err := v.Last(); err != nil {
+		t.Fatalf("Last failed: %v", err)
+	}
+	_ = v.Next()
+	if err := id.SetInt(1); err == nil {
+		t.Error("Expected error for a setter at EOF")
+	}
+
+	if err := v.Goto(1); err != nil {
+		t.Fatalf("Goto failed: %v", err)
+	}
+	before, _ := numbers.AsFloat()
+	errorCases := map[string]error{
+		"integer overflow":   id.SetInt(1 << 40),
+		"fractional integer": id.SetFloat(1.5),
+		"bool to integer":    id.SetBool(true),
+		"time to numeric":    numbers.SetTime(time.Now()),
+		"numeric overflow":   numbers.SetFloat(1e7),
+		"unparsable numeric": numbers.SetString("12abc"),
+		"unsupported type":   numbers.Set(struct{}{}),
+		"not nullable":       numbers.SetNull(),
+	}
+	for name, err := range errorCases {
+		if err == nil {
+			t.Errorf("Expected error for %s", name)
+		}
+	}
+	if after, _ := numbers.AsFloat(); after != before {
+		t.Errorf("Failed setters changed the field from %v to %v", before, after)
+	}
+
+	_ = v.Close()
+	if err := id.SetInt(1); err == nil {
+		t.Error("Expected error for a setter with inactive database")
+	}
+}
+
+func TestField_Set_Navigation(t *testing.T) {
+	// A changed record is written when the table moves on
+	path := copyTable(t, "testdata/idfirstlast18.dbf", t.TempDir(), ".dbf", ".fpt")
+	v := &Vulpo{}
+	if err := v.Open(path); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+	field := v.Field(1)
+
+	for recNo := 1; recNo <= 3; recNo++ {
+		if err := v.Goto(recNo); err != nil {
+			t.Fatalf("Goto failed: %v", err)
+		}
+		if err := field.SetString(strings.Repeat("x", recNo)); err != nil {
+			t.Fatalf("SetString failed: %v", err)
+		}
+	}
+	if err := v.First(); err != nil {
+		t.Fatalf("First failed: %v", err)
+	}
+
+	c, err := v.NewCursor()
+	if err != nil {
+		t.Fatalf("NewCursor failed: %v", err)
+	}
+	defer c.Close()
+	for recNo := 1; recNo <= 3; recNo++ {
+		if err := c.Goto(recNo); err != nil {
+			t.Fatalf("Goto failed: %v", err)
+		}
+		if got, _ := c.Field(1).AsString(); got != strings.Repeat("x", recNo) {
+			t.Errorf("Record %d = %q through a cursor, want %q", recNo, got, strings.Repeat("x", recNo))
+		}
+	}
+}
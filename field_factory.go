@@ -35,34 +35,34 @@ func (v *Vulpo) FieldReaderByIndex(index int) FieldReader {
 	return v.Field(index)
 }
 
-// createFieldReader creates the appropriate FieldReader implementation based on field type
-func (v *Vulpo) createFieldReader(cField *C.FIELD4, fieldDef *FieldDef) FieldReader {
+// createFieldReader creates the appropriate Field implementation based on field type
+func (v *Vulpo) createFieldReader(cField *C.FIELD4, fieldDef *FieldDef) Field {
 	switch fieldDef.Type() {
 	case FTCharacter:
 		return newStringField(cField, v, fieldDef)
 	case FTInteger:
 		return &IntegerField{
 			baseField: baseField{
-				def:  fieldDef,
-				data: v,
+				def:    fieldDef,
+				data:   v,
+				cField: cField,
 			},
-			cField: cField,
 		}
 	case FTNumeric:
 		return &NumericField{
 			baseField: baseField{
-				def:  fieldDef,
-				data: v,
+				def:    fieldDef,
+				data:   v,
+				cField: cField,
 			},
-			cField: cField,
 		}
 	case FTLogical:
 		return &LogicalField{
 			baseField: baseField{
-				def:  fieldDef,
-				data: v,
+				def:    fieldDef,
+				data:   v,
+				cField: cField,
 			},
-			cField: cField,
 		}
 	case FTDate:
 		return newDateField(cField, v, fieldDef)
@@ -74,6 +74,12 @@ func (v *Vulpo) createFieldReader(cField *C.FIELD4, fieldDef *FieldDef) FieldRea
 		return newFloatField(cField, v, fieldDef)
 	case FTDouble:
 		return newDoubleField(cField, v, fieldDef)
+	case FTBlob:
+		// Visual FoxPro stores 8-byte binary doubles as type B
+		if fieldDef.length == 8 {
+			return newDoubleField(cField, v, fieldDef)
+		}
+		return newStringField(cField, v, fieldDef)
 	case FTMemo:
 		return newMemoField(cField, v, fieldDef)
 	default:
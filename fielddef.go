@@ -12,6 +12,12 @@ type FieldDef struct {
 	system    bool
 	nullable  bool
 	binary    bool
+
+	// Byte layout within the record buffer, computed once at Open() time
+	offset     int // offset of the field data (byte 0 is the deletion flag)
+	length     int // field length in bytes
+	nullOffset int // offset of the _NullFlags field, -1 if the table has none
+	nullBit    int // bit within _NullFlags holding this field's null state
 }
 
 type FieldDefs struct {
@@ -30,6 +36,17 @@ func (flds *FieldDefs) ByIndex(idx int) *FieldDef {
 	return flds.fields[idx]
 }
 
+// Index returns the zero-based index of the named field (case-insensitive),
+// or -1 if there is no such field.
+func (flds *FieldDefs) Index(name string) int {
+	flds.checkCreateIndicies()
+	idx, ok := flds.indicies[strings.ToLower(name)]
+	if !ok {
+		return -1
+	}
+	return idx
+}
+
 // FieldDef exported getter methods
 func (fd *FieldDef) Name() string {
 	return fd.fieldname
@@ -73,3 +90,12 @@ func (flds *FieldDefs) ByName(name string) *FieldDef {
 	}
 	return flds.fields[idx]
 }
+
+// setNullFlagsOffset points the fields at the hidden _NullFlags field used
+// by nullable Visual FoxPro fields, at offset in the record as CodeBase has
+// it; -1 means the table has none.
+func (flds *FieldDefs) setNullFlagsOffset(offset int) {
+	for _, fd := range flds.fields {
+		fd.nullOffset = offset
+	}
+}
@@ -1,5 +1,9 @@
 package vulpo
 
+/*
+#include "d4all.h"
+*/
+import "C"
 import "time"
 
 // FieldReader defines the interface that all field types must implement.
@@ -49,8 +53,9 @@ type FieldReader interface {
 
 // baseField provides common functionality for all field types
 type baseField struct {
-	def  *FieldDef
-	data *Vulpo
+	def    *FieldDef
+	data   *Vulpo
+	cField *C.FIELD4
 }
 
 // FieldDef returns the field definition (for backward compatibility)
@@ -93,17 +98,41 @@ func (bf *baseField) checkActive() error {
 		return NewError("database not open")
 	}
 
-	if bf.data.BOF() {
+	if bf.data.atBOF() {
 		return NewError("positioned at beginning of file (BOF)")
 	}
 
-	if bf.data.EOF() {
+	if bf.data.atEOF() {
 		return NewError("positioned at end of file (EOF)")
 	}
 
 	return nil
 }
 
+// raw returns the field's bytes in the current record. The bytes are sliced
+// straight out of the CodeBase record buffer, so no cgo call is made; they are
+// only valid until the cursor moves.
+func (bf *baseField) raw() ([]byte, error) {
+	if err := bf.checkActive(); err != nil {
+		return nil, err
+	}
+
+	raw := bf.def.bytes(bf.data.currentRecord())
+	if raw == nil {
+		return nil, NewErrorf("field '%s' lies outside the record buffer", bf.def.Name())
+	}
+	return raw, nil
+}
+
+// IsNull returns true if the field contains a null value
+func (bf *baseField) IsNull() (bool, error) {
+	if err := bf.checkActive(); err != nil {
+		return false, err
+	}
+
+	return bf.def.isNullIn(bf.data.currentRecord()), nil
+}
+
 // NewConversionError creates a standardized conversion error
 func NewConversionError(fromType, toType string) error {
 	return NewErrorf("cannot convert %s to %s", fromType, toType)
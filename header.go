@@ -9,6 +9,8 @@ type Header struct {
 	hasIndex    bool
 	hasFpt      bool
 	codepage    Codepage
+	headerLen   int // offset of the first record (DATA4HEADER_FULL.headerLen)
+	recordLen   int // record width including the deletion flag (DATA4HEADER_FULL.recordLen)
 }
 
 func (h *Header) RecordCount() uint {
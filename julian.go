@@ -19,3 +19,13 @@ func JulianToYMD(jd int) (year, month, day int) {
 
 	return year, month, day
 }
+
+// YMDToJulian converts a Gregorian Year, Month, Day to a Julian day number.
+// It is the inverse of JulianToYMD and matches the mkfdbf C library's date4long.
+func YMDToJulian(year, month, day int) int {
+	a := (14 - month) / 12
+	y := year + 4800 - a
+	m := month + 12*a - 3
+
+	return day + (153*m+2)/5 + 365*y + y/4 - y/100 + y/400 - 32045
+}
@@ -0,0 +1,416 @@
+package vulpo
+
+import (
+	"bytes"
+	"hash/maphash"
+	"math"
+)
+
+// AggFunc identifies an aggregate function
+type AggFunc int
+
+const (
+	AggCount AggFunc = iota // Number of records, or of non-null values when a field is given
+	AggSum                  // Sum of the field values
+	AggMin                  // Smallest field value
+	AggMax                  // Largest field value
+	AggAvg                  // Mean of the field values
+)
+
+// String returns the SQL-style name of the function.
+func (f AggFunc) String() string {
+	switch f {
+	case AggCount:
+		return "COUNT"
+	case AggSum:
+		return "SUM"
+	case AggMin:
+		return "MIN"
+	case AggMax:
+		return "MAX"
+	case AggAvg:
+		return "AVG"
+	default:
+		return "unknown"
+	}
+}
+
+// AggSpec describes one aggregate column of an Aggregate call
+type AggSpec struct {
+	Func  AggFunc // Aggregate function
+	Field string  // Numeric field to aggregate; may be empty for AggCount
+}
+
+// AggGroup holds the aggregates of one group
+type AggGroup struct {
+	Keys   []interface{} // Group-by values in groupBy order, decoded as by Record.Value (nil if null or undecodable)
+	Count  int           // Number of records in the group
+	Values []float64     // One result per AggSpec, in order
+}
+
+// AggregateResult contains the groups produced by Aggregate
+type AggregateResult struct {
+	GroupBy []string   // The group-by fields used
+	Aggs    []AggSpec  // The aggregates computed
+	Groups  []AggGroup // Groups in order of first appearance
+	Scanned int        // Total records scanned
+}
+
+// Aggregate groups the records by the given fields and computes aggregates
+// over each group in a single pass, like SELECT ... GROUP BY.
+//
+// Parameters:
+//   - groupBy: Fields to group by (case-insensitive); empty for one group
+//     covering every record
+//   - aggs: Aggregates to compute per group
+//   - where: dBASE logical expression selecting the records; empty for all
+//
+// Returns:
+//   - *AggregateResult: The groups and their aggregates
+//   - error: Error if the database is not open, a field is unknown or not
+//     numeric, the expression is invalid or the scan fails
+//
+// Records are streamed once, as by Scan, and never copied. Groups are found in
+// an open-addressing hash table keyed on the raw bytes of the group-by fields,
+// so no value is decoded to group a record; the keys are decoded once per
+// group. N and F values are converted straight from their ASCII digits and I,
+// Y and B values from their binary form. The WHERE expression uses the native
+// evaluator when it is within the compiled subset (see ExprFilter.Compiled).
+//
+// Deleted records are included unless the WHERE expression excludes them
+// (.NOT. DELETED()). Null values of nullable fields are skipped by every
+// function except a COUNT without a field. MIN, MAX and AVG of a group without
+// values are NaN.
+//
+// Example:
+//
+//	result, err := v.Aggregate([]string{"BRANCH"}, []AggSpec{
+//		{Func: AggCount},
+//		{Func: AggSum, Field: "AMOUNT"},
+//		{Func: AggAvg, Field: "AMOUNT"},
+//	}, ".NOT. DELETED() .AND. AMOUNT > 0")
+//	for _, group := range result.Groups {
+//		fmt.Println(group.Keys[0], group.Count, group.Values[1], group.Values[2])
+//	}
+func (v *Vulpo) Aggregate(groupBy []string, aggs []AggSpec, where string) (*AggregateResult, error) {
+	if !v.Active() {
+		return nil, NewError("database not open")
+	}
+
+	agg, err := v.newAggregator(groupBy, aggs)
+	if err != nil {
+		return nil, err
+	}
+
+	result := &AggregateResult{GroupBy: groupBy, Aggs: aggs}
+
+	if where == "" {
+		err = v.Scan(func(rec Record) error {
+			result.Scanned++
+			agg.add(rec)
+			return nil
+		})
+	} else {
+		filter, filterErr := v.NewExprFilter(where)
+		if filterErr != nil {
+			return nil, NewErrorf("failed to create expression filter: %v", filterErr)
+		}
+		defer filter.Free()
+
+		result.Scanned, err = v.eachMatch(filter, false, false, func(rec Record) error {
+			agg.add(rec)
+			return nil
+		})
+	}
+	if err != nil {
+		return nil, err
+	}
+
+	result.Groups = agg.groups()
+	return result, nil
+}
+
+// aggAccumulator holds the running state of one aggregate of one group
+type aggAccumulator struct {
+	sum      float64
+	min, max float64
+	n        int
+}
+
+// aggregator streams records into per-group accumulators
+type aggregator struct {
+	keyDefs   []*FieldDef
+	keyFields []int // field indexes of keyDefs, for decoding the keys
+	specs     []AggSpec
+	valDefs   []*FieldDef // nil for a COUNT without a field
+
+	keyWidth int
+	keyBuf   []byte
+
+	table  aggTable
+	keys   [][]interface{}
+	counts []int
+	accs   []aggAccumulator // len(specs) entries per group
+}
+
+// newAggregator resolves the group-by and aggregate fields.
+func (v *Vulpo) newAggregator(groupBy []string, aggs []AggSpec) (*aggregator, error) {
+	if len(aggs) == 0 {
+		return nil, NewError("no aggregates to compute")
+	}
+
+	agg := &aggregator{specs: aggs}
+
+	for _, name := range groupBy {
+		idx := v.fieldDefs.Index(name)
+		if idx < 0 {
+			return nil, NewErrorf("field '%s' not found", name)
+		}
+		def := v.fieldDefs.ByIndex(idx)
+		if _, ok := columnTypeFor(def); !ok {
+			return nil, NewErrorf("field '%s' of type %s cannot be grouped by", def.Name(), def.Type().Name())
+		}
+
+		agg.keyDefs = append(agg.keyDefs, def)
+		agg.keyFields = append(agg.keyFields, idx)
+		if def.nullable {
+			agg.keyWidth++ // null marker
+		}
+		agg.keyWidth += def.length
+	}
+
+	for _, spec := range aggs {
+		if spec.Func < AggCount || spec.Func > AggAvg {
+			return nil, NewErrorf("unknown aggregate function: %d", int(spec.Func))
+		}
+
+		if spec.Field == "" {
+			if spec.Func != AggCount {
+				return nil, NewErrorf("%s requires a field", spec.Func)
+			}
+			agg.valDefs = append(agg.valDefs, nil)
+			continue
+		}
+
+		idx := v.fieldDefs.Index(spec.Field)
+		if idx < 0 {
+			return nil, NewErrorf("field '%s' not found", spec.Field)
+		}
+		def := v.fieldDefs.ByIndex(idx)
+		if !aggNumeric(def) {
+			return nil, NewErrorf("field '%s' of type %s is not numeric", def.Name(), def.Type().Name())
+		}
+		agg.valDefs = append(agg.valDefs, def)
+	}
+
+	agg.keyBuf = make([]byte, agg.keyWidth)
+	agg.table.init(agg.keyWidth)
+
+	// Without group-by fields there is exactly one group, even with no records
+	if len(agg.keyDefs) == 0 {
+		agg.group(Record{})
+	}
+
+	return agg, nil
+}
+
+// aggNumeric reports whether the field's values can be aggregated.
+func aggNumeric(def *FieldDef) bool {
+	switch def.Type() {
+	case FTNumeric, FTFloat, FTInteger, FTCurrency:
+		return true
+	case FTBlob, FTDouble:
+		return def.length == 8
+	default:
+		return false
+	}
+}
+
+// aggValue decodes a numeric field accepted by aggNumeric.
+func aggValue(def *FieldDef, raw []byte) float64 {
+	switch def.Type() {
+	case FTNumeric, FTFloat:
+		return decodeNumeric(raw)
+	case FTInteger:
+		return float64(decodeInteger(raw))
+	case FTCurrency:
+		return decodeCurrency(raw)
+	default:
+		return decodeDouble(raw)
+	}
+}
+
+// add folds one record into its group.
+func (a *aggregator) add(rec Record) {
+	g := 0
+	if len(a.keyDefs) > 0 {
+		g = a.group(rec)
+	}
+	a.counts[g]++
+
+	accs := a.accs[g*len(a.specs) : (g+1)*len(a.specs)]
+	for i, def := range a.valDefs {
+		acc := &accs[i]
+		if def == nil {
+			acc.n++
+			continue
+		}
+		if def.isNullIn(rec.data) {
+			continue
+		}
+
+		val := aggValue(def, def.bytes(rec.data))
+		if acc.n == 0 || val < acc.min {
+			acc.min = val
+		}
+		if acc.n == 0 || val > acc.max {
+			acc.max = val
+		}
+		acc.sum += val
+		acc.n++
+	}
+}
+
+// group returns the index of the record's group, creating the group if the
+// key has not been seen.
+func (a *aggregator) group(rec Record) int {
+	key := a.keyBuf[:0]
+	for _, def := range a.keyDefs {
+		raw := def.bytes(rec.data)
+		if def.nullable {
+			if def.isNullIn(rec.data) {
+				// All nulls share one key whatever the field bytes hold
+				key = append(key, 1)
+				raw = nil
+			} else {
+				key = append(key, 0)
+			}
+		}
+		if raw == nil {
+			key = appendZeros(key, def.length)
+			continue
+		}
+		key = append(key, raw...)
+	}
+
+	g, inserted := a.table.find(key)
+	if !inserted {
+		return g
+	}
+
+	keys := make([]interface{}, len(a.keyDefs))
+	for i, field := range a.keyFields {
+		if value, err := rec.Value(field); err == nil {
+			keys[i] = value
+		}
+	}
+	a.keys = append(a.keys, keys)
+	a.counts = append(a.counts, 0)
+	a.accs = append(a.accs, make([]aggAccumulator, len(a.specs))...)
+	return g
+}
+
+// appendZeros appends n zero bytes to b.
+func appendZeros(b []byte, n int) []byte {
+	for ; n > 0; n-- {
+		b = append(b, 0)
+	}
+	return b
+}
+
+// groups finalizes the accumulators.
+func (a *aggregator) groups() []AggGroup {
+	groups := make([]AggGroup, len(a.counts))
+	for g := range groups {
+		values := make([]float64, len(a.specs))
+		for i, spec := range a.specs {
+			acc := a.accs[g*len(a.specs)+i]
+			switch {
+			case spec.Func == AggCount:
+				values[i] = float64(acc.n)
+			case spec.Func == AggSum:
+				values[i] = acc.sum
+			case acc.n == 0:
+				values[i] = math.NaN()
+			case spec.Func == AggMin:
+				values[i] = acc.min
+			case spec.Func == AggMax:
+				values[i] = acc.max
+			default:
+				values[i] = acc.sum / float64(acc.n)
+			}
+		}
+		groups[g] = AggGroup{Keys: a.keys[g], Count: a.counts[g], Values: values}
+	}
+	return groups
+}
+
+// aggTable is an open-addressing hash table with linear probing that maps
+// fixed-width keys to dense group indexes. Keys are stored back to back in
+// one slice and slots hold group index + 1, so a lookup touches the slot
+// array and a single key.
+type aggTable struct {
+	seed     maphash.Seed
+	keyWidth int
+	keys     []byte
+	hashes   []uint64
+	slots    []uint32
+	mask     uint64
+}
+
+// aggTableInitialSlots is the initial slot count; it must be a power of two.
+const aggTableInitialSlots = 64
+
+// init prepares an empty table for keys of keyWidth bytes.
+func (t *aggTable) init(keyWidth int) {
+	t.seed = maphash.MakeSeed()
+	t.keyWidth = keyWidth
+	t.slots = make([]uint32, aggTableInitialSlots)
+	t.mask = aggTableInitialSlots - 1
+}
+
+// find returns the group index of key, adding it as a new group (and
+// reporting inserted) if it is not present.
+func (t *aggTable) find(key []byte) (group int, inserted bool) {
+	hash := maphash.Bytes(t.seed, key)
+	for i := hash & t.mask; ; i = (i + 1) & t.mask {
+		slot := t.slots[i]
+		if slot == 0 {
+			break
+		}
+		g := int(slot - 1)
+		if t.hashes[g] == hash && bytes.Equal(t.keys[g*t.keyWidth:(g+1)*t.keyWidth], key) {
+			return g, false
+		}
+	}
+
+	group = len(t.hashes)
+	t.keys = append(t.keys, key...)
+	t.hashes = append(t.hashes, hash)
+
+	// Keep the load factor at or below one half
+	if len(t.hashes)*2 > len(t.slots) {
+		t.resize()
+	} else {
+		t.place(group)
+	}
+	return group, true
+}
+
+// resize doubles the slot array and reinserts every group.
+func (t *aggTable) resize() {
+	t.slots = make([]uint32, len(t.slots)*2)
+	t.mask = uint64(len(t.slots) - 1)
+	for g := range t.hashes {
+		t.place(g)
+	}
+}
+
+// place stores group g in the first free slot of its probe sequence.
+func (t *aggTable) place(g int) {
+	i := t.hashes[g] & t.mask
+	for t.slots[i] != 0 {
+		i = (i + 1) & t.mask
+	}
+	t.slots[i] = uint32(g + 1)
+}
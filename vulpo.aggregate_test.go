@@ -0,0 +1,251 @@
+package vulpo
+
+import (
+	"math"
+	"path/filepath"
+	"testing"
+)
+
+func TestVulpo_Aggregate_NoDatabase(t *testing.T) {
+	v := &Vulpo{}
+
+	if _, err := v.Aggregate(nil, []AggSpec{{Func: AggCount}}, ""); err == nil {
+		t.Error("Expected error for Aggregate with inactive database")
+	}
+}
+
+func TestVulpo_Aggregate_InvalidSpecs(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	tests := []struct {
+		name    string
+		groupBy []string
+		aggs    []AggSpec
+		where   string
+	}{
+		{"no aggregates", nil, nil, ""},
+		{"unknown group field", []string{"NOPE"}, []AggSpec{{Func: AggCount}}, ""},
+		{"unknown value field", nil, []AggSpec{{Func: AggSum, Field: "NOPE"}}, ""},
+		{"non-numeric value field", nil, []AggSpec{{Func: AggSum, Field: "NAME"}}, ""},
+		{"sum without field", nil, []AggSpec{{Func: AggSum}}, ""},
+		{"unknown function", nil, []AggSpec{{Func: AggFunc(42), Field: "AGE"}}, ""},
+		{"invalid where", nil, []AggSpec{{Func: AggCount}}, "AGE >"},
+	}
+
+	for _, tt := range tests {
+		if _, err := v.Aggregate(tt.groupBy, tt.aggs, tt.where); err == nil {
+			t.Errorf("%s: expected an error", tt.name)
+		}
+	}
+}
+
+// aggregateReference computes what Aggregate should return for one group-by
+// field, using Record decoders and a Go map.
+func aggregateReference(t *testing.T, v *Vulpo, keyField int, valueFields []int) (map[string]int, map[string][]float64, map[string]int) {
+	t.Helper()
+
+	counts := map[string]int{}
+	sums := map[string][]float64{}
+	ns := map[string]int{}
+	err := v.Scan(func(rec Record) error {
+		key := "*"
+		if keyField >= 0 {
+			key = string(rec.Bytes(keyField))
+			if rec.IsNull(keyField) {
+				key = "null"
+			}
+		}
+		counts[key]++
+		if sums[key] == nil {
+			sums[key] = make([]float64, 3*len(valueFields))
+		}
+		for i, field := range valueFields {
+			val, err := rec.Float(field)
+			if err != nil {
+				return err
+			}
+			acc := sums[key][3*i : 3*i+3]
+			if ns[key] == 0 || val < acc[1] {
+				acc[1] = val
+			}
+			if ns[key] == 0 || val > acc[2] {
+				acc[2] = val
+			}
+			acc[0] += val
+		}
+		ns[key]++
+		return nil
+	})
+	if err != nil {
+		t.Fatalf("Reference scan failed: %v", err)
+	}
+	return counts, sums, ns
+}
+
+func TestVulpo_Aggregate_MatchesReference(t *testing.T) {
+	files, _ := filepath.Glob("mkfdbflib/data/*.dbf")
+
+	for _, file := range files {
+		t.Run(file, func(t *testing.T) {
+			v := &Vulpo{}
+			if err := v.Open(file); err != nil {
+				t.Skipf("Cannot open %s: %v", file, err)
+			}
+			defer v.Close()
+
+			keyField := -1
+			var valueFields []int
+			for i := 0; i < v.FieldCount(); i++ {
+				def := v.FieldDefs().ByIndex(i)
+				if def.IsNullable() {
+					continue
+				}
+				if aggNumeric(def) {
+					valueFields = append(valueFields, i)
+				} else if _, ok := columnTypeFor(def); ok && keyField < 0 {
+					keyField = i
+				}
+			}
+
+			var groupBy []string
+			if keyField >= 0 {
+				groupBy = []string{v.FieldDefs().ByIndex(keyField).Name()}
+			}
+			aggs := []AggSpec{{Func: AggCount}}
+			for _, field := range valueFields {
+				name := v.FieldDefs().ByIndex(field).Name()
+				aggs = append(aggs,
+					AggSpec{Func: AggSum, Field: name}, AggSpec{Func: AggMin, Field: name},
+					AggSpec{Func: AggMax, Field: name}, AggSpec{Func: AggAvg, Field: name})
+			}
+
+			result, err := v.Aggregate(groupBy, aggs, "")
+			if err != nil {
+				t.Fatalf("Aggregate failed: %v", err)
+			}
+
+			counts, sums, ns := aggregateReference(t, v, keyField, valueFields)
+			header := v.Header()
+			if result.Scanned != int(header.RecordCount()) {
+				t.Errorf("Expected %d records scanned, got %d", header.RecordCount(), result.Scanned)
+			}
+			if keyField >= 0 && len(result.Groups) != len(counts) {
+				t.Fatalf("Expected %d groups, got %d", len(counts), len(result.Groups))
+			}
+
+			seen := 0
+			err = v.Scan(func(rec Record) error {
+				key := "*"
+				if keyField >= 0 {
+					key = string(rec.Bytes(keyField))
+				}
+				if counts[key] < 0 {
+					return nil // group already checked
+				}
+
+				// Groups are reported in order of first appearance
+				group := result.Groups[seen]
+				seen++
+				if keyField >= 0 {
+					want, err := rec.Value(keyField)
+					if err != nil {
+						want = nil // undecodable keys are reported as nil
+					}
+					if group.Keys[0] != want {
+						t.Errorf("Group %d key %v, want %v", seen, group.Keys[0], want)
+					}
+				}
+				if group.Count != counts[key] || group.Values[0] != float64(counts[key]) {
+					t.Errorf("Group %q: count %d/%v, want %d", key, group.Count, group.Values[0], counts[key])
+				}
+				for i := range valueFields {
+					acc := sums[key][3*i : 3*i+3]
+					want := []float64{acc[0], acc[1], acc[2], acc[0] / float64(ns[key])}
+					for j, w := range want {
+						if got := group.Values[1+4*i+j]; math.Abs(got-w) > 1e-9*math.Max(1, math.Abs(w)) {
+							t.Errorf("Group %q: %s = %v, want %v", key, aggs[1+4*i+j].Func, got, w)
+						}
+					}
+				}
+				counts[key] = -1
+				return nil
+			})
+			if err != nil {
+				t.Fatalf("Scan failed: %v", err)
+			}
+			if seen != len(result.Groups) && header.RecordCount() > 0 {
+				t.Errorf("Checked %d of %d groups", seen, len(result.Groups))
+			}
+		})
+	}
+}
+
+func TestVulpo_Aggregate_Where(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	aggs := []AggSpec{{Func: AggCount}, {Func: AggSum, Field: "AGE"}, {Func: AggMin, Field: "AGE"}, {Func: AggAvg, Field: "AGE"}}
+	for _, where := range []string{"AGE > 40", "YEAR(BIRTH_DATE) > 1900 .AND. AGE > 40"} {
+		result, err := v.Aggregate(nil, aggs, where)
+		if err != nil {
+			t.Fatalf("Aggregate(%q) failed: %v", where, err)
+		}
+
+		count, sum, minAge := 0, 0.0, math.Inf(1)
+		err = v.ForEachExpressionRecord(where, func(rec Record) error {
+			age, err := rec.Float(v.FieldDefs().Index("AGE"))
+			count++
+			sum += age
+			minAge = math.Min(minAge, age)
+			return err
+		})
+		if err != nil {
+			t.Fatalf("ForEachExpressionRecord(%q) failed: %v", where, err)
+		}
+
+		if len(result.Groups) != 1 {
+			t.Fatalf("Expected a single group, got %d", len(result.Groups))
+		}
+		group := result.Groups[0]
+		if group.Count != count || group.Values[0] != float64(count) || group.Values[1] != sum ||
+			group.Values[2] != minAge || group.Values[3] != sum/float64(count) {
+			t.Errorf("%q: got %d %v, want count %d sum %v min %v", where, group.Count, group.Values, count, sum, minAge)
+		}
+	}
+
+	// An empty selection still reports the single group
+	result, err := v.Aggregate(nil, aggs, "AGE > 1000")
+	if err != nil {
+		t.Fatalf("Aggregate failed: %v", err)
+	}
+	group := result.Groups[0]
+	if group.Count != 0 || group.Values[0] != 0 || group.Values[1] != 0 || !math.IsNaN(group.Values[2]) || !math.IsNaN(group.Values[3]) {
+		t.Errorf("Expected zero count and sum and NaN min/avg, got %v", group.Values)
+	}
+}
+
+func TestAggTable_Grows(t *testing.T) {
+	var table aggTable
+	table.init(4)
+
+	key := make([]byte, 4)
+	for i := 0; i < 1000; i++ {
+		key[0], key[1] = byte(i), byte(i>>8)
+		if g, inserted := table.find(key); !inserted || g != i {
+			t.Fatalf("Key %d: got group %d, inserted %v", i, g, inserted)
+		}
+	}
+	for i := 0; i < 1000; i++ {
+		key[0], key[1] = byte(i), byte(i>>8)
+		if g, inserted := table.find(key); inserted || g != i {
+			t.Fatalf("Key %d: got group %d on lookup, inserted %v", i, g, inserted)
+		}
+	}
+}
@@ -0,0 +1,524 @@
+package vulpo
+
+/*
+#include "d4all.h"
+#include <stdlib.h>
+#include <string.h>
+
+// VULPO4APPENDTAG holds the entries of one tag for the records of a batch,
+// each a key followed by its record number in big-endian order, as the
+// reindex sorts them.
+typedef struct
+{
+   TAG4 *tag ;
+   unsigned int keyLen ;
+   short unique ;
+   unsigned char *entries ;
+   long n, cap ;
+} VULPO4APPENDTAG ;
+
+// VULPO4APPEND_HOLD is the size of the records held back by a batch and
+// written together.
+#define VULPO4APPEND_HOLD 65536
+
+// VULPO4APPEND is a batch of appends. The table's index list is held here
+// while the batch runs, so that d4append finds no tags to update; the keys
+// of the new records are collected instead, unless the tags are to be
+// rebuilt afterwards. Records are held back and written together, where
+// d4append writes each one and the file header after it.
+typedef struct
+{
+   DATA4 *data ;
+   LIST4 indexes ;
+   int suspended ;   // the tags are detached
+   int collect ;
+   int nTags ;
+   VULPO4APPENDTAG *tags ;
+   char *records ;   // records held back, then a byte for the EOF marker
+   long nRecords, capRecords ;
+} VULPO4APPEND ;
+
+// vulpo4appendBegin prepares a batch of appends to data. The tags are
+// suspended unless a unique tag rejects the appends of duplicate keys, which
+// must then fail record by record; unique tags that keep the first record of
+// a key and skip the rest (r4uniqueContinue, FoxPro's UNIQUE) do the same
+// when the sorted keys are merged. Records are held back when no tag is left
+// to update per record and the table has no memo fields, whose contents
+// d4append writes. Returns NULL when out of memory.
+static VULPO4APPEND *vulpo4appendBegin(DATA4 *data, int collect)
+{
+   VULPO4APPEND *a ;
+   TAG4 *tag ;
+   unsigned recWidth = data->dataFile->recWidth ;
+   int n = 0, suspend = 1 ;
+
+   for ( tag = d4tagNext( data, 0 ) ; tag != 0 ; tag = d4tagNext( data, tag ) )
+   {
+      if ( t4unique( tag ) != 0 && t4unique( tag ) != r4uniqueContinue )
+         suspend = 0 ;
+      n++ ;
+   }
+
+   a = (VULPO4APPEND *)calloc( 1, sizeof( VULPO4APPEND ) ) ;
+   if ( a == 0 )
+      return 0 ;
+   a->data = data ;
+
+   if ( suspend && n > 0 )
+   {
+      a->tags = (VULPO4APPENDTAG *)calloc( n, sizeof( VULPO4APPENDTAG ) ) ;
+      if ( a->tags == 0 )
+      {
+         free( a ) ;
+         return 0 ;
+      }
+      for ( tag = d4tagNext( data, 0 ) ; tag != 0 ; tag = d4tagNext( data, tag ) )
+      {
+         a->tags[a->nTags].tag = tag ;
+         a->tags[a->nTags].keyLen = (unsigned int)tag->tagFile->header.keyLen ;
+         a->tags[a->nTags].unique = t4unique( tag ) ;
+         a->nTags++ ;
+      }
+      a->suspended = 1 ;
+      a->collect = collect ;
+      a->indexes = data->indexes ;
+      memset( &data->indexes, 0, sizeof( LIST4 ) ) ;
+   }
+
+   if ( ( n == 0 || a->suspended ) && data->dataFile->nFieldsMemo == 0 )
+   {
+      a->capRecords = recWidth < VULPO4APPEND_HOLD ? VULPO4APPEND_HOLD / recWidth : 1 ;
+      a->records = (char *)malloc( (size_t)a->capRecords * recWidth + 1 ) ;
+   }
+   return a ;
+}
+
+// vulpo4appendKeys adds the keys of the record in the buffer, to be appended
+// as recNo, to the entries of every tag whose filter it passes, evaluating
+// them as t4addCalc does. Returns 0 or a negative CodeBase error.
+static int vulpo4appendKeys(VULPO4APPEND *a, long recNo)
+{
+   VULPO4APPENDTAG *t ;
+   TAG4FILE *tagFile ;
+   unsigned char *key, *entry ;
+   long cap ;
+   int i, rc ;
+
+   if ( !a->collect )
+      return 0 ;
+
+   for ( i = 0 ; i < a->nTags ; i++ )
+   {
+      t = &a->tags[i] ;
+      tagFile = t->tag->tagFile ;
+      if ( tagFile->filter != 0 )
+      {
+         expr4context( tagFile->filter, a->data ) ;
+         rc = expr4true( tagFile->filter ) ;
+         if ( rc < 0 )
+            return rc ;
+         if ( rc == 0 )
+            continue ;
+      }
+      expr4context( tagFile->expr, a->data ) ;
+      rc = tfile4exprKey( tagFile, &key ) ;
+      if ( rc < 0 )
+         return rc ;
+      if ( (unsigned int)rc != t->keyLen )
+         return e4index ;
+
+      if ( t->n == t->cap )
+      {
+         cap = t->cap == 0 ? 1024 : t->cap * 2 ;
+         entry = (unsigned char *)realloc( t->entries, (size_t)cap * ( t->keyLen + 4 ) ) ;
+         if ( entry == 0 )
+            return e4memory ;
+         t->entries = entry ;
+         t->cap = cap ;
+      }
+      entry = t->entries + (size_t)t->n * ( t->keyLen + 4 ) ;
+      memcpy( entry, key, t->keyLen ) ;
+      entry[t->keyLen] = (unsigned char)( recNo >> 24 ) ;
+      entry[t->keyLen + 1] = (unsigned char)( recNo >> 16 ) ;
+      entry[t->keyLen + 2] = (unsigned char)( recNo >> 8 ) ;
+      entry[t->keyLen + 3] = (unsigned char)recNo ;
+      t->n++ ;
+   }
+   return 0 ;
+}
+
+// vulpo4appendWrite writes the records held back after the last record of
+// the file, as d4append writes one, and updates the file header once.
+// Returns 0 or a negative CodeBase error.
+static int vulpo4appendWrite(VULPO4APPEND *a)
+{
+   DATA4FILE *dataFile = a->data->dataFile ;
+   unsigned len = (unsigned)a->nRecords * dataFile->recWidth ;
+   long count ;
+   int rc ;
+
+   if ( a->nRecords == 0 )
+      return 0 ;
+
+   count = dfile4recCount( dataFile, -2L ) ;
+   if ( count < 0 )
+      return (int)count ;
+
+   // Visual FoxPro tables are written without the EOF marker, as d4append does
+   a->records[len] = 0x1A ;
+   if ( dataFile->version != 0x30 )
+      len++ ;
+   dataFile->fileChanged = 1 ;
+   rc = file4writeInternal( &dataFile->file, dfile4recordPosition( dataFile, count + 1 ), a->records, len ) ;
+   if ( rc < 0 )
+      return rc ;
+
+   count += a->nRecords ;
+   a->nRecords = 0 ;
+   dataFile->numRecs = count ;
+   dataFile->minCount = count ;
+   a->data->recNum = count ;
+   rc = dfile4updateHeader( dataFile, 1, 1 ) ;
+   return rc < 0 ? rc : 0 ;
+}
+
+// vulpo4appendHold collects the keys of the record in the buffer, to be
+// appended as recNo, and holds the record back, writing the records held
+// once there are enough. Returns 0 or a negative CodeBase error.
+static int vulpo4appendHold(VULPO4APPEND *a, long recNo)
+{
+   unsigned recWidth = a->data->dataFile->recWidth ;
+   int rc ;
+
+   rc = vulpo4appendKeys( a, recNo ) ;
+   if ( rc < 0 )
+      return rc ;
+
+   memcpy( a->records + (size_t)a->nRecords * recWidth, a->data->record, recWidth ) ;
+   a->data->recordChanged = 0 ;
+   if ( ++a->nRecords == a->capRecords )
+      return vulpo4appendWrite( a ) ;
+   return 0 ;
+}
+
+// vulpo4appendResume gives the table its tags back.
+static void vulpo4appendResume(VULPO4APPEND *a)
+{
+   if ( a->suspended )
+      a->data->indexes = a->indexes ;
+}
+
+static VULPO4APPENDTAG *vulpo4appendTag(VULPO4APPEND *a, int i)
+{
+   return &a->tags[i] ;
+}
+
+// vulpo4appendMerge adds the n sorted entries of tag i to its tag file, in
+// order, so that consecutive keys land in the same leaf blocks. A unique tag
+// keeps the key of the lowest record number, as d4append would have. Returns
+// 0 or a negative CodeBase error.
+static int vulpo4appendMerge(VULPO4APPEND *a, int i, const unsigned char *entries, long n)
+{
+   VULPO4APPENDTAG *t = &a->tags[i] ;
+   const unsigned char *entry ;
+   long j, recNo ;
+   int rc ;
+
+   for ( j = 0 ; j < n ; j++ )
+   {
+      entry = entries + (size_t)j * ( t->keyLen + 4 ) ;
+      recNo = (long)entry[t->keyLen] << 24 | (long)entry[t->keyLen + 1] << 16 |
+              (long)entry[t->keyLen + 2] << 8 | (long)entry[t->keyLen + 3] ;
+      rc = tfile4add( t->tag->tagFile, entry, recNo, t->unique ) ;
+      if ( rc < 0 )
+         return rc ;
+   }
+   return 0 ;
+}
+
+static void vulpo4appendFree(VULPO4APPEND *a)
+{
+   int i ;
+
+   for ( i = 0 ; i < a->nTags ; i++ )
+      free( a->tags[i].entries ) ;
+   free( a->tags ) ;
+   free( a->records ) ;
+   free( a ) ;
+}
+*/
+import "C"
+import "unsafe"
+
+// Append adds a record to the end of the table. The record starts out blank
+// and fill assigns its fields through the Field setters; the record is then
+// written and its keys added to every open tag. The table is left on the new
+// record.
+//
+// Parameters:
+//   - fill: sets the fields of the new record; returning an error abandons
+//     the record. It must not move the table.
+//
+// Returns:
+//   - error: the error from fill, or if the record cannot be appended
+//
+// Example:
+//
+//	err := v.Append(func() error {
+//		if err := v.FieldByName("NAME").SetString("ACME Ltd"); err != nil {
+//			return err
+//		}
+//		return v.FieldByName("BALANCE").SetFloat(1250.75)
+//	})
+func (v *Vulpo) Append(fill func() error) error {
+	if fill == nil {
+		return NewError("fill function is nil")
+	}
+	_, err := v.appendRecords(1, func(int) error { return fill() }, false)
+	return err
+}
+
+// AppendBatch adds n records to the end of the table, filled in by calling
+// fill with the index of each record in the batch, from 0 to n-1. It is the
+// bulk form of Append.
+//
+// The table stays locked for the whole batch and the open tags are not
+// touched while records are appended. At the end of the batch the keys of
+// the new records are sorted per tag and merged into the index in key order
+// or, when the batch is at least as large as the table was, every tag is
+// rebuilt by Reindex, which is faster than merging that many keys, before
+// the table is unlocked. Tables without memo fields also have their records
+// written to the data file in blocks of about 64KB, with the file header
+// updated once per block rather than once per record. Tables with a unique
+// tag that rejects duplicate keys, which must be caught record by record, are
+// indexed and written as each record is appended.
+//
+// Records appended before fill or an append fails are kept and indexed. The
+// table is left on the last record appended.
+//
+// Parameters:
+//   - n: the number of records to append
+//   - fill: sets the fields of record i of the batch through the Field
+//     setters; returning an error ends the batch without appending record i.
+//     It must not move the table.
+//
+// Returns:
+//   - int: the number of records appended
+//   - error: the error from fill, or if a record cannot be appended or the
+//     tags cannot be updated
+//
+// Example:
+//
+//	name, qty := v.FieldByName("NAME"), v.FieldByName("QTY")
+//	added, err := v.AppendBatch(len(rows), func(i int) error {
+//		if err := name.SetString(rows[i].Name); err != nil {
+//			return err
+//		}
+//		return qty.SetInt(rows[i].Qty)
+//	})
+func (v *Vulpo) AppendBatch(n int, fill func(i int) error) (int, error) {
+	if fill == nil {
+		return 0, NewError("fill function is nil")
+	}
+	if n < 0 {
+		return 0, NewErrorf("invalid batch size: %d", n)
+	}
+	return v.appendRecords(n, fill, true)
+}
+
+// appendRecords appends n records with the table locked, deferring the index
+// maintenance when deferred is true (see AppendBatch).
+func (v *Vulpo) appendRecords(n int, fill func(i int) error, deferred bool) (int, error) {
+	if !v.Active() {
+		return 0, NewError("database not open")
+	}
+	if v.appending {
+		return 0, NewError("cannot append while a record is being appended")
+	}
+
+	// Pending changes to the current record must reach the file first
+	if result := v.keyed(func() C.int { return C.d4updateRecord(v.data, 0) }); result < 0 {
+		C.error4set(v.codeBase, 0)
+		return 0, NewErrorf("failed to update record before appending: error code %d", int(result))
+	}
+	if result := C.d4lockAll(v.data); result != 0 {
+		C.error4set(v.codeBase, 0)
+		if result == C.r4locked {
+			return 0, NewError("failed to append: table is locked by another user")
+		}
+		return 0, NewErrorf("failed to lock table for appending: error code %d", int(result))
+	}
+	v.holdWrites()
+
+	before := int(C.d4recCountDo(v.data))
+	previous := C.d4recNo(v.data)
+	rebuild := n >= before
+	var batch *C.VULPO4APPEND
+	if deferred {
+		collect := C.int(1)
+		if rebuild {
+			collect = 0
+		}
+		batch = C.vulpo4appendBegin(v.data, collect)
+	}
+	suspended := batch != nil && batch.suspended != 0
+
+	appended := 0
+	err := v.appendLoop(n, fill, batch, before, &appended)
+	if batch != nil && batch.records != nil {
+		if rc := C.vulpo4appendWrite(batch); rc < 0 && err == nil {
+			C.error4set(v.codeBase, 0)
+			err = NewErrorf("failed to append records: error code %d", int(rc))
+		}
+		// Records held back when a write failed were never appended, and
+		// the tags are rebuilt rather than given their keys
+		if written := int(C.d4recCountDo(v.data)) - before; written != appended {
+			appended = written
+			rebuild = true
+		}
+	}
+
+	if batch != nil {
+		C.vulpo4appendResume(batch)
+		if suspended && !rebuild && appended > 0 {
+			if mergeErr := v.appendMerge(batch); err == nil {
+				err = mergeErr
+			}
+		}
+		C.vulpo4appendFree(batch)
+	}
+
+	// Rebuilt before unlocking, so that no other program finds the new
+	// records missing from the tags
+	if suspended && rebuild && appended > 0 {
+		if reindexErr := v.Reindex(nil); err == nil {
+			err = reindexErr
+		}
+	}
+	if writeErr := v.writeHeld(); err == nil {
+		err = writeErr
+	}
+	C.d4unlock(v.data)
+
+	// The table is left on the last record appended, or where it was
+	switch {
+	case appended > 0:
+		v.keyed(func() C.int { return C.d4go(v.data, C.long(before+appended)) })
+	case previous > 0:
+		v.keyed(func() C.int { return C.d4go(v.data, previous) })
+	default:
+		v.keyed(func() C.int { return C.d4top(v.data) })
+	}
+	if code := v.codeBase.errorCode; code < 0 {
+		C.error4set(v.codeBase, 0)
+	}
+	return appended, err
+}
+
+// appendLoop fills and appends the records of a batch, collecting their keys
+// into batch when its tags are suspended and holding the records back when
+// batch writes them together. Held records count as appended.
+func (v *Vulpo) appendLoop(n int, fill func(i int) error, batch *C.VULPO4APPEND, before int, appended *int) error {
+	v.appending = true
+	defer func() {
+		v.appending = false
+	}()
+
+	for i := 0; i < n; i++ {
+		if result := C.d4appendStart(v.data, 0); result != 0 {
+			C.error4set(v.codeBase, 0)
+			return NewErrorf("failed to start append: error code %d", int(result))
+		}
+		C.d4blank(v.data)
+
+		if err := fill(i); err != nil {
+			v.data.recordChanged = 0
+			return err
+		}
+
+		// The table is locked, so the record is appended as the next number
+		if batch != nil && batch.records != nil {
+			exprMutex.Lock()
+			rc := C.vulpo4appendHold(batch, C.long(before+*appended+1))
+			exprMutex.Unlock()
+			if rc < 0 {
+				v.data.recordChanged = 0
+				C.error4set(v.codeBase, 0)
+				return NewErrorf("failed to append record: error code %d", int(rc))
+			}
+			*appended++
+			continue
+		}
+		if batch != nil && batch.collect != 0 {
+			exprMutex.Lock()
+			rc := C.vulpo4appendKeys(batch, C.long(before+*appended+1))
+			exprMutex.Unlock()
+			if rc < 0 {
+				v.data.recordChanged = 0
+				C.error4set(v.codeBase, 0)
+				return NewErrorf("failed to evaluate index keys: error code %d", int(rc))
+			}
+		}
+
+		// Tags detached for a batch leave nothing to evaluate
+		if result := v.keyed(func() C.int { return C.d4append(v.data) }); result != 0 {
+			v.data.recordChanged = 0
+			C.error4set(v.codeBase, 0)
+			if result == C.r4unique {
+				return NewError("failed to append: duplicate key in unique tag")
+			}
+			return NewErrorf("failed to append record: error code %d", int(result))
+		}
+		*appended++
+	}
+	return nil
+}
+
+// appendMerge sorts the keys collected for each tag of a batch and adds them
+// to the tags in key order.
+func (v *Vulpo) appendMerge(batch *C.VULPO4APPEND) error {
+	for i := 0; i < int(batch.nTags); i++ {
+		tag := C.vulpo4appendTag(batch, C.int(i))
+		if tag.n == 0 {
+			continue
+		}
+
+		entryLen := int(tag.keyLen) + 4
+		src := unsafe.Slice((*byte)(unsafe.Pointer(tag.entries)), int(tag.n)*entryLen)
+		sorted := make([]byte, len(src))
+		sortReindexEntries(src, sorted, entryLen)
+
+		if rc := C.vulpo4appendMerge(batch, C.int(i), (*C.uchar)(unsafe.Pointer(&sorted[0])), tag.n); rc < 0 {
+			C.error4set(v.codeBase, 0)
+			return NewErrorf("failed to add keys to tag %s: error code %d", C.GoString(C.t4alias(tag.tag)), int(rc))
+		}
+	}
+	return nil
+}
+
+// Flush writes the changes made to the current record through the Field
+// setters, updating its index keys, and flushes the table's buffered data
+// and index blocks to disk. Changes are also written when the table moves to
+// another record.
+//
+// Returns:
+//   - error: if the record or the buffers cannot be written
+//
+// Example:
+//
+//	v.Goto(42)
+//	v.FieldByName("BALANCE").SetFloat(0)
+//	if err := v.Flush(); err != nil {
+//		log.Fatal(err)
+//	}
+func (v *Vulpo) Flush() error {
+	if !v.Active() {
+		return NewError("database not open")
+	}
+
+	if result := v.keyed(func() C.int { return C.d4flush(v.data) }); result < 0 {
+		C.error4set(v.codeBase, 0)
+		return NewErrorf("failed to flush table: error code %d", int(result))
+	}
+	return nil
+}
@@ -0,0 +1,249 @@
+package vulpo
+
+import (
+	"errors"
+	"fmt"
+	"testing"
+	"time"
+)
+
+// tagOrder returns the record numbers of the table in the order of a tag.
+func tagOrder(t *testing.T, v *Vulpo, tag string) []int {
+	t.Helper()
+
+	if err := v.SelectTag(v.TagByName(tag)); err != nil {
+		t.Fatalf("SelectTag(%s) failed: %v", tag, err)
+	}
+	var order []int
+	for err := v.First(); err == nil && !v.EOF(); err = v.Next() {
+		order = append(order, v.Position())
+	}
+	return order
+}
+
+// fillInfo sets the fields of record i of a batch appended to the info table,
+// with the names out of order and repeated ages and birth dates.
+func fillInfo(v *Vulpo, i int) error {
+	if err := v.FieldByName("NAME").SetString(fmt.Sprintf("APPENDED%04d", i*7919%1000)); err != nil {
+		return err
+	}
+	if err := v.FieldByName("AGE").SetInt(i % 90); err != nil {
+		return err
+	}
+	return v.FieldByName("BIRTH_DATE").SetTime(time.Date(1950+i%60, time.Month(1+i%12), 1+i%28, 0, 0, 0, 0, time.UTC))
+}
+
+func TestVulpo_Append_NoDatabase(t *testing.T) {
+	v := &Vulpo{}
+
+	if err := v.Append(func() error { return nil }); err == nil {
+		t.Error("Expected error for Append with inactive database")
+	}
+	if _, err := v.AppendBatch(1, func(int) error { return nil }); err == nil {
+		t.Error("Expected error for AppendBatch with inactive database")
+	}
+	if err := v.Flush(); err == nil {
+		t.Error("Expected error for Flush with inactive database")
+	}
+}
+
+func TestVulpo_Append(t *testing.T) {
+	path := copyTable(t, "testdata/threenames.dbf", t.TempDir(), ".dbf", ".fpt")
+	v := &Vulpo{}
+	if err := v.Open(path); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+	header := v.Header()
+	count := int(header.RecordCount())
+
+	err := v.Append(func() error {
+		if err := v.FieldByName("id").SetInt(99); err != nil {
+			return err
+		}
+		return v.FieldByName("last").SetString("Appended")
+	})
+	if err != nil {
+		t.Fatalf("Append failed: %v", err)
+	}
+	if v.Position() != count+1 {
+		t.Errorf("Append left the table on record %d, want %d", v.Position(), count+1)
+	}
+
+	// A failed fill appends nothing and goes back to the current record
+	if err := v.Goto(1); err != nil {
+		t.Fatalf("Goto failed: %v", err)
+	}
+	failed := errors.New("fill failed")
+	err = v.Append(func() error {
+		_ = v.FieldByName("last").SetString("Abandoned")
+		return failed
+	})
+	if !errors.Is(err, failed) {
+		t.Errorf("Append = %v, want the fill error", err)
+	}
+	if v.Position() != 1 {
+		t.Errorf("Failed Append left the table on record %d, want 1", v.Position())
+	}
+	if err := v.Append(nil); err == nil {
+		t.Error("Expected error for Append with nil fill")
+	}
+
+	if err := v.Close(); err != nil {
+		t.Fatalf("Close failed: %v", err)
+	}
+	if err := v.Open(path); err != nil {
+		t.Fatalf("Failed to reopen test file: %v", err)
+	}
+	if header := v.Header(); int(header.RecordCount()) != count+1 {
+		t.Fatalf("Record count = %d, want %d", header.RecordCount(), count+1)
+	}
+	if err := v.Goto(count + 1); err != nil {
+		t.Fatalf("Goto failed: %v", err)
+	}
+	id, _ := v.FieldByName("id").AsInt()
+	last, _ := v.FieldByName("last").AsString()
+	first, _ := v.FieldByName("first").AsString()
+	if id != 99 || last != "Appended" || first != "" {
+		t.Errorf("Appended record = %d, %q, %q, want 99, Appended and a blank first name", id, last, first)
+	}
+	if err := v.Goto(1); err != nil {
+		t.Fatalf("Goto failed: %v", err)
+	}
+	if last, _ := v.FieldByName("last").AsString(); last == "Abandoned" {
+		t.Error("The abandoned record was written over record 1")
+	}
+}
+
+func TestVulpo_AppendBatch_MatchesAppend(t *testing.T) {
+	// Small batches merge their sorted keys into the tags, batches as large
+	// as the table rebuild them, and the largest write their records in
+	// several goes; all must index the records as appending them one at a
+	// time does, including the unique INF_NAME
+	for _, n := range []int{50, 400, 3000} {
+		t.Run(fmt.Sprintf("Records=%d", n), func(t *testing.T) {
+			batched := &Vulpo{}
+			if err := batched.Open(copyTable(t, testDBFWithIndexPath, t.TempDir(), ".dbf", ".cdx")); err != nil {
+				t.Fatalf("Failed to open test file: %v", err)
+			}
+			defer batched.Close()
+			single := &Vulpo{}
+			if err := single.Open(copyTable(t, testDBFWithIndexPath, t.TempDir(), ".dbf", ".cdx")); err != nil {
+				t.Fatalf("Failed to open test file: %v", err)
+			}
+			defer single.Close()
+			header := batched.Header()
+			count := int(header.RecordCount())
+
+			appended, err := batched.AppendBatch(n, func(i int) error { return fillInfo(batched, i) })
+			if err != nil || appended != n {
+				t.Fatalf("AppendBatch = %d, %v, want %d", appended, err, n)
+			}
+			if batched.Position() != count+n {
+				t.Errorf("AppendBatch left the table on record %d, want %d", batched.Position(), count+n)
+			}
+			for i := 0; i < n; i++ {
+				if err := single.Append(func() error { return fillInfo(single, i) }); err != nil {
+					t.Fatalf("Append failed: %v", err)
+				}
+			}
+
+			for _, tag := range []string{"INF_AGE", "INF_BRTH", "INF_NAME"} {
+				want := tagOrder(t, single, tag)
+				got := tagOrder(t, batched, tag)
+				if fmt.Sprint(got) != fmt.Sprint(want) {
+					t.Errorf("Tag %s holds %d records after AppendBatch, %d after Append, or in another order", tag, len(got), len(want))
+				}
+			}
+		})
+	}
+}
+
+func TestVulpo_AppendBatch_TrimmedKeys(t *testing.T) {
+	// A bulk load large enough for the tags to be rebuilt, and their keys
+	// built natively where they can be; TRIMX must get the keys of the
+	// short names, on record 2 and one appended, from CodeBase
+	v := &Vulpo{}
+	if err := v.Open(shortNameTable(t, 1)); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+	header := v.Header()
+	count := int(header.RecordCount())
+
+	name := v.FieldByName("NAME")
+	appended, err := v.AppendBatch(10000, func(i int) error {
+		if i == 5000 {
+			return name.SetString("SHORT")
+		}
+		return name.SetString(fmt.Sprintf("A%019d", i))
+	})
+	if err != nil || appended != 10000 {
+		t.Fatalf("AppendBatch = %d, %v, want 10000", appended, err)
+	}
+
+	tag := v.TagByName("TRIMX")
+	if n, err := v.CountTagRange(tag, "", ""); err != nil || n != count+10000 {
+		t.Errorf("CountTagRange = %d, %v; want %d", n, err, count+10000)
+	}
+	if n, err := v.CountTagRange(tag, "SHORTX", "SHORTX"); err != nil || n != 2 {
+		t.Errorf("CountTagRange SHORTX = %d, %v; want 2", n, err)
+	}
+	if result, err := v.SeekWithTag(tag, "SHORTX"); err != nil || result != SeekSuccess || v.Position() != 2 {
+		t.Errorf("Seek SHORTX = %v, %v at record %d; want Success at record 2", result, err, v.Position())
+	}
+}
+
+func TestVulpo_AppendBatch_FillError(t *testing.T) {
+	path := copyTable(t, testDBFWithIndexPath, t.TempDir(), ".dbf", ".cdx")
+	v := &Vulpo{}
+	if err := v.Open(path); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+	header := v.Header()
+	count := int(header.RecordCount())
+
+	if _, err := v.AppendBatch(-1, func(int) error { return nil }); err == nil {
+		t.Error("Expected error for a negative batch size")
+	}
+
+	// The records appended before the failure are kept and indexed
+	failed := errors.New("fill failed")
+	appended, err := v.AppendBatch(20, func(i int) error {
+		if i == 10 {
+			return failed
+		}
+		return fillInfo(v, i)
+	})
+	if appended != 10 || !errors.Is(err, failed) {
+		t.Fatalf("AppendBatch = %d, %v, want 10 and the fill error", appended, err)
+	}
+	if v.Position() != count+10 {
+		t.Errorf("AppendBatch left the table on record %d, want %d", v.Position(), count+10)
+	}
+	if got := len(tagOrder(t, v, "INF_AGE")); got != count+10 {
+		t.Errorf("Tag INF_AGE holds %d records, want %d", got, count+10)
+	}
+	_ = v.SelectTag(v.TagByName("INF_NAME"))
+	result, err := v.Seek("APPENDED0000")
+	if err != nil || !result.IsFound() {
+		t.Errorf("Seek(APPENDED0000) = %v, %v, want found", result, err)
+	}
+
+	if err := v.Close(); err != nil {
+		t.Fatalf("Close failed: %v", err)
+	}
+	if err := v.Open(path); err != nil {
+		t.Fatalf("Failed to reopen test file: %v", err)
+	}
+	if header := v.Header(); int(header.RecordCount()) != count+10 {
+		t.Errorf("Record count = %d after reopening, want %d", header.RecordCount(), count+10)
+	}
+	if err := v.Goto(count + 10); err != nil {
+		t.Fatalf("Goto failed: %v", err)
+	}
+	if age, _ := v.FieldByName("AGE").AsInt(); age != 9 {
+		t.Errorf("AGE of the last record appended = %d, want 9", age)
+	}
+}
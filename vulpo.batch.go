@@ -0,0 +1,181 @@
+package vulpo
+
+/*
+#include "d4all.h"
+#include <string.h>
+
+// vulpo4readBatch copies up to n record images, starting at the current
+// record, into buf and advances the cursor past the last record copied.
+// Navigation honors the selected tag. Returns the number of records copied;
+// *status receives the last d4skip result (0, r4eof or a negative error).
+static int vulpo4readBatch(DATA4 *data, char *buf, long *recNos, int n, int *status)
+{
+   unsigned width = data->dataFile->recWidth ;
+   int count = 0 ;
+   int rc = 0 ;
+
+   while ( count < n )
+   {
+      if ( d4eof( data ) || d4bof( data ) )
+         break ;
+
+      memcpy( buf + (size_t)count * width, data->record, width ) ;
+      recNos[count] = d4recNo( data ) ;
+      count++ ;
+
+      rc = d4skip( data, 1L ) ;
+      if ( rc != 0 )
+         break ;
+   }
+
+   *status = rc ;
+   return count ;
+}
+*/
+import "C"
+import "unsafe"
+
+// RecordBatch holds raw record images copied out of the data file by ReadBatch.
+// Each record is Width() bytes long and starts with the deletion flag byte,
+// followed by the field data laid out as described by the field definitions.
+//
+// A RecordBatch owns its memory; the records stay valid after the cursor moves
+// and until the batch is refilled by ReadBatchInto.
+type RecordBatch struct {
+	width  int
+	count  int
+	data   []byte
+	recNos []C.long
+	defs   *FieldDefs
+}
+
+// NewRecordBatch allocates a batch able to hold up to capacity records of the
+// open database. Use it with ReadBatchInto to stream a table without
+// allocating per batch.
+func (v *Vulpo) NewRecordBatch(capacity int) (*RecordBatch, error) {
+	if !v.Active() {
+		return nil, NewError("database not open")
+	}
+
+	if capacity <= 0 {
+		return nil, NewErrorf("invalid batch capacity: %d (must be > 0)", capacity)
+	}
+
+	width := int(v.data.dataFile.recWidth)
+	return &RecordBatch{
+		width:  width,
+		data:   make([]byte, capacity*width),
+		recNos: make([]C.long, capacity),
+		defs:   v.fieldDefs,
+	}, nil
+}
+
+// ReadBatch copies up to n records, starting at the current record, into a
+// new RecordBatch and advances the cursor past the last record copied.
+//
+// Parameters:
+//   - n: Maximum number of records to copy
+//
+// Returns:
+//   - *RecordBatch: The copied records; Len() is 0 once the cursor is at EOF
+//   - error: nil on success, error if the database is not open or navigation fails
+//
+// The whole batch is read with a single cgo call, so a full-table scan costs
+// one C transition per batch instead of several per record. Navigation order
+// follows the selected tag, exactly as repeated Next() calls would.
+//
+// Example:
+//
+//	v.First()
+//	for {
+//		batch, err := v.ReadBatch(1000)
+//		if err != nil || batch.Len() == 0 {
+//			break
+//		}
+//		for i := 0; i < batch.Len(); i++ {
+//			fmt.Println(batch.RecordNumber(i), batch.Deleted(i))
+//		}
+//	}
+func (v *Vulpo) ReadBatch(n int) (*RecordBatch, error) {
+	batch, err := v.NewRecordBatch(n)
+	if err != nil {
+		return nil, err
+	}
+
+	if err := v.ReadBatchInto(batch); err != nil {
+		return nil, err
+	}
+
+	return batch, nil
+}
+
+// ReadBatchInto refills batch with up to Cap() records starting at the current
+// record and advances the cursor past the last record copied. The previous
+// contents of the batch are overwritten.
+func (v *Vulpo) ReadBatchInto(batch *RecordBatch) error {
+	if !v.Active() {
+		return NewError("database not open")
+	}
+
+	if batch == nil || batch.Cap() == 0 {
+		return NewError("record batch is empty")
+	}
+
+	if batch.width != int(v.data.dataFile.recWidth) {
+		return NewErrorf("record batch width %d does not match record width %d", batch.width, int(v.data.dataFile.recWidth))
+	}
+
+	var status C.int
+	count := v.keyed(func() C.int {
+		return C.vulpo4readBatch(v.data, (*C.char)(unsafe.Pointer(&batch.data[0])),
+			&batch.recNos[0], C.int(batch.Cap()), &status)
+	})
+
+	batch.count = int(count)
+	if status < 0 {
+		return NewErrorf("failed to read record batch: error code %d", int(status))
+	}
+
+	return nil
+}
+
+// Len returns the number of records held in the batch.
+func (b *RecordBatch) Len() int {
+	return b.count
+}
+
+// Cap returns the maximum number of records the batch can hold.
+func (b *RecordBatch) Cap() int {
+	return len(b.recNos)
+}
+
+// Width returns the length in bytes of each record image.
+func (b *RecordBatch) Width() int {
+	return b.width
+}
+
+// Record returns the raw record image at index i (0 to Len()-1), or nil if
+// i is out of range. The slice aliases the batch buffer.
+func (b *RecordBatch) Record(i int) []byte {
+	if i < 0 || i >= b.count {
+		return nil
+	}
+	return b.data[i*b.width : (i+1)*b.width]
+}
+
+// RecordNumber returns the 1-indexed physical record number of the record at
+// index i, or -1 if i is out of range.
+func (b *RecordBatch) RecordNumber(i int) int {
+	if i < 0 || i >= b.count {
+		return -1
+	}
+	return int(b.recNos[i])
+}
+
+// Deleted reports whether the record at index i is marked for deletion.
+func (b *RecordBatch) Deleted(i int) bool {
+	if i < 0 || i >= b.count {
+		return false
+	}
+	return b.data[i*b.width] == '*'
+}
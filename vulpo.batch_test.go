@@ -0,0 +1,163 @@
+package vulpo
+
+import (
+	"testing"
+)
+
+func TestVulpo_ReadBatch_NoDatabase(t *testing.T) {
+	v := &Vulpo{}
+
+	if _, err := v.ReadBatch(10); err == nil {
+		t.Error("Expected error for ReadBatch with inactive database")
+	}
+
+	if _, err := v.NewRecordBatch(10); err == nil {
+		t.Error("Expected error for NewRecordBatch with inactive database")
+	}
+}
+
+// collectCursorOrder walks the table with Next() and returns record numbers and deleted flags
+func collectCursorOrder(t *testing.T, v *Vulpo) ([]int, []bool) {
+	t.Helper()
+
+	var recNos []int
+	var deleted []bool
+
+	if err := v.First(); err != nil {
+		t.Fatalf("Failed to go to first record: %v", err)
+	}
+	for !v.EOF() {
+		recNos = append(recNos, v.Position())
+		deleted = append(deleted, v.Deleted())
+		if err := v.Next(); err != nil {
+			break
+		}
+	}
+
+	return recNos, deleted
+}
+
+// collectBatchOrder walks the table with ReadBatch and returns record numbers and deleted flags
+func collectBatchOrder(t *testing.T, v *Vulpo, size int) ([]int, []bool) {
+	t.Helper()
+
+	var recNos []int
+	var deleted []bool
+
+	if err := v.First(); err != nil {
+		t.Fatalf("Failed to go to first record: %v", err)
+	}
+	for {
+		batch, err := v.ReadBatch(size)
+		if err != nil {
+			t.Fatalf("ReadBatch failed: %v", err)
+		}
+		if batch.Len() == 0 {
+			break
+		}
+		if batch.Len() > size {
+			t.Fatalf("Batch returned %d records, capacity %d", batch.Len(), size)
+		}
+		for i := 0; i < batch.Len(); i++ {
+			recNos = append(recNos, batch.RecordNumber(i))
+			deleted = append(deleted, batch.Deleted(i))
+		}
+	}
+
+	return recNos, deleted
+}
+
+func compareOrders(t *testing.T, wantRecs, gotRecs []int, wantDel, gotDel []bool) {
+	t.Helper()
+
+	if len(gotRecs) != len(wantRecs) {
+		t.Fatalf("Expected %d records, got %d", len(wantRecs), len(gotRecs))
+	}
+	for i := range wantRecs {
+		if gotRecs[i] != wantRecs[i] {
+			t.Fatalf("Record %d: expected record number %d, got %d", i, wantRecs[i], gotRecs[i])
+		}
+		if gotDel[i] != wantDel[i] {
+			t.Errorf("Record %d: expected deleted=%v, got %v", wantRecs[i], wantDel[i], gotDel[i])
+		}
+	}
+}
+
+func TestVulpo_ReadBatch_PhysicalOrder(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	wantRecs, wantDel := collectCursorOrder(t, v)
+	if len(wantRecs) == 0 {
+		t.Skip("Test file has no records")
+	}
+
+	for _, size := range []int{1, 7, 1000} {
+		gotRecs, gotDel := collectBatchOrder(t, v, size)
+		compareOrders(t, wantRecs, gotRecs, wantDel, gotDel)
+	}
+}
+
+func TestVulpo_ReadBatch_TagOrder(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	tags := v.ListTags()
+	if len(tags) == 0 {
+		t.Skip("Test file has no tags")
+	}
+
+	for _, tag := range tags {
+		if err := v.SelectTag(tag); err != nil {
+			t.Fatalf("Failed to select tag %s: %v", tag.Name(), err)
+		}
+
+		wantRecs, wantDel := collectCursorOrder(t, v)
+		gotRecs, gotDel := collectBatchOrder(t, v, 5)
+		compareOrders(t, wantRecs, gotRecs, wantDel, gotDel)
+	}
+}
+
+func TestVulpo_ReadBatch_RecordImage(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	batch, err := v.NewRecordBatch(3)
+	if err != nil {
+		t.Fatalf("NewRecordBatch failed: %v", err)
+	}
+
+	if err := v.First(); err != nil {
+		t.Fatalf("Failed to go to first record: %v", err)
+	}
+	if err := v.ReadBatchInto(batch); err != nil {
+		t.Fatalf("ReadBatchInto failed: %v", err)
+	}
+	if batch.Len() == 0 {
+		t.Skip("Test file has no records")
+	}
+
+	// The cursor must sit right after the last copied record
+	if !v.EOF() && v.Position() != batch.RecordNumber(batch.Len()-1)+1 {
+		t.Errorf("Expected cursor at record %d, got %d", batch.RecordNumber(batch.Len()-1)+1, v.Position())
+	}
+
+	if len(batch.Record(0)) != batch.Width() {
+		t.Errorf("Expected record image of %d bytes, got %d", batch.Width(), len(batch.Record(0)))
+	}
+	if batch.Record(-1) != nil || batch.Record(batch.Len()) != nil {
+		t.Error("Expected nil record image for out-of-range index")
+	}
+	if batch.RecordNumber(batch.Len()) != -1 {
+		t.Error("Expected -1 record number for out-of-range index")
+	}
+}
@@ -0,0 +1,92 @@
+package vulpo
+
+import "math/bits"
+
+// Bitmap is a dense, packed bit set indexed from 0. It is used for null masks
+// and logical values in column vectors, and for sets of record numbers.
+type Bitmap []uint64
+
+// Get reports whether bit i is set. Bits beyond the end of the bitmap are unset.
+func (b Bitmap) Get(i int) bool {
+	word := i >> 6
+	if i < 0 || word >= len(b) {
+		return false
+	}
+	return b[word]&(1<<(uint(i)&63)) != 0
+}
+
+// Count returns the number of set bits.
+func (b Bitmap) Count() int {
+	count := 0
+	for _, word := range b {
+		count += bits.OnesCount64(word)
+	}
+	return count
+}
+
+// Next returns the index of the first set bit at or after i, or -1 if there
+// is none.
+func (b Bitmap) Next(i int) int {
+	if i < 0 {
+		i = 0
+	}
+	word := i >> 6
+	if word >= len(b) {
+		return -1
+	}
+
+	// Mask off the bits below i in the first word
+	w := b[word] &^ (1<<(uint(i)&63) - 1)
+	for {
+		if w != 0 {
+			return word<<6 + bits.TrailingZeros64(w)
+		}
+		word++
+		if word >= len(b) {
+			return -1
+		}
+		w = b[word]
+	}
+}
+
+// grow extends the bitmap so that it can hold n bits.
+func (b Bitmap) grow(n int) Bitmap {
+	words := (n + 63) >> 6
+	for len(b) < words {
+		b = append(b, 0)
+	}
+	return b
+}
+
+// set sets bit i, which must be within the bitmap's capacity.
+func (b Bitmap) set(i int) {
+	b[i>>6] |= 1 << (uint(i) & 63)
+}
+
+// unset clears bit i, which must be within the bitmap's capacity.
+func (b Bitmap) unset(i int) {
+	b[i>>6] &^= 1 << (uint(i) & 63)
+}
+
+// nextClear returns the index of the first unset bit at or after i. Bits
+// beyond the end of the bitmap are unset.
+func (b Bitmap) nextClear(i int) int {
+	if i < 0 {
+		i = 0
+	}
+	word := i >> 6
+	if word >= len(b) {
+		return i
+	}
+
+	// Treat the bits below i in the first word as set
+	w := b[word] | (1<<(uint(i)&63) - 1)
+	for w == ^uint64(0) {
+		word++
+		if word >= len(b) {
+			return word << 6
+		}
+		w = b[word]
+	}
+	return word<<6 + bits.TrailingZeros64(^w)
+}
@@ -0,0 +1,852 @@
+package vulpo
+
+/*
+#cgo LDFLAGS: -Wl,--wrap=opt4fileRead -Wl,--wrap=opt4fileWrite
+#include "d4all.h"
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The cache policy lives in the spare byte of the OPT4 (dummyChar), which the
+// library never uses, so the read hook finds it without a lookup.
+#define VULPO4OPT_LRU   0
+#define VULPO4OPT_SCAN  1
+
+// How a file is buffered, as CacheMode.
+#define VULPO4CACHE_DEFAULT    0
+#define VULPO4CACHE_OFF        1
+#define VULPO4CACHE_READ       2
+#define VULPO4CACHE_READWRITE  3
+
+// The cache's block lists in the order of CacheStats: dbfLo, dbfHi,
+// indexLo, indexHi, other.
+#define VULPO4OPT_LISTS 5
+
+// The counters of a cache list, kept by the read and write hooks.
+typedef struct
+{
+   unsigned long long hits ;
+   unsigned long long misses ;
+   unsigned long long evictions ;
+} VULPO4OPTCOUNT ;
+
+// Open allocates every CODE4 as a VULPO4CODE (see newCodeBase), with the
+// counters right behind the CODE4.
+typedef struct
+{
+   CODE4 codeBase ;
+   VULPO4OPTCOUNT count[VULPO4OPT_LISTS] ;
+} VULPO4CODE ;
+
+// The hooks wrap the library for the whole binary, so a FILE4's codeBase is
+// only taken for a VULPO4CODE once it is found in this table of the CODE4s
+// allocated by vulpo4codeNew; any other CODE4 is not counted. The table is
+// open addressed. Slots are taken and given up under the mutex, and read by
+// the hooks without it: a CODE4 is only freed by the goroutine using it, so
+// no hook looks for it while its slot is given up.
+#define VULPO4CODES 4096
+#define VULPO4CODE_GONE ( (CODE4 *)1 )
+
+static CODE4 *vulpo4codes[VULPO4CODES] ;
+static pthread_mutex_t vulpo4codesMutex = PTHREAD_MUTEX_INITIALIZER ;
+
+static unsigned int vulpo4codeHash(const CODE4 *codeBase)
+{
+   return (unsigned int)( ( (uintptr_t)codeBase >> 4 ) * 2654435761u ) % VULPO4CODES ;
+}
+
+// vulpo4code returns codeBase as a VULPO4CODE, or NULL if it was not
+// allocated by vulpo4codeNew.
+static VULPO4CODE *vulpo4code(const CODE4 *codeBase)
+{
+   unsigned int i, n ;
+   CODE4 *slot ;
+
+   for ( i = vulpo4codeHash( codeBase ), n = 0 ; n < VULPO4CODES ; i = ( i + 1 ) % VULPO4CODES, n++ )
+   {
+      slot = __atomic_load_n( &vulpo4codes[i], __ATOMIC_ACQUIRE ) ;
+      if ( slot == codeBase )
+         return (VULPO4CODE *)codeBase ;
+      if ( slot == 0 )
+         return 0 ;
+   }
+   return 0 ;
+}
+
+// vulpo4codeNew allocates a zeroed VULPO4CODE and enters it in the table.
+// With the table full the CODE4 still works, uncounted.
+static CODE4 *vulpo4codeNew(void)
+{
+   VULPO4CODE *code = (VULPO4CODE *)calloc( 1, sizeof( VULPO4CODE ) ) ;
+   unsigned int i, n ;
+
+   if ( code == 0 )
+      return 0 ;
+
+   pthread_mutex_lock( &vulpo4codesMutex ) ;
+   for ( i = vulpo4codeHash( &code->codeBase ), n = 0 ; n < VULPO4CODES ; i = ( i + 1 ) % VULPO4CODES, n++ )
+   {
+      if ( vulpo4codes[i] == 0 || vulpo4codes[i] == VULPO4CODE_GONE )
+      {
+         __atomic_store_n( &vulpo4codes[i], &code->codeBase, __ATOMIC_RELEASE ) ;
+         break ;
+      }
+   }
+   pthread_mutex_unlock( &vulpo4codesMutex ) ;
+   return &code->codeBase ;
+}
+
+// vulpo4codeFree gives up the slot of a CODE4 from vulpo4codeNew and frees it.
+static void vulpo4codeFree(CODE4 *codeBase)
+{
+   unsigned int i, n ;
+
+   pthread_mutex_lock( &vulpo4codesMutex ) ;
+   for ( i = vulpo4codeHash( codeBase ), n = 0 ; n < VULPO4CODES && vulpo4codes[i] != 0 ; i = ( i + 1 ) % VULPO4CODES, n++ )
+   {
+      if ( vulpo4codes[i] == codeBase )
+      {
+         __atomic_store_n( &vulpo4codes[i], VULPO4CODE_GONE, __ATOMIC_RELEASE ) ;
+         break ;
+      }
+   }
+   pthread_mutex_unlock( &vulpo4codesMutex ) ;
+   free( codeBase ) ;
+}
+
+// A cache list's blocks and counters, as returned by vulpo4optStats.
+typedef struct
+{
+   unsigned long long blocks ;
+   unsigned long long bytes ;
+   unsigned long long dirtyBlocks ;
+   unsigned long long dirtyBytes ;
+   unsigned long long hits ;
+   unsigned long long misses ;
+   unsigned long long evictions ;
+} VULPO4OPTSTATS ;
+
+// The read clock and list lengths before a read or write, which tell the
+// blocks it brought in and the lists it took them from.
+typedef struct
+{
+   unsigned long readBefore ;
+   unsigned short nLink[VULPO4OPT_LISTS] ;
+} VULPO4OPTSNAP ;
+
+static OPT4LIST *vulpo4optList(OPT4 *opt, int i)
+{
+   switch ( i )
+   {
+      case 0: return &opt->dbfLo ;
+      case 1: return &opt->dbfHi ;
+      case 2: return &opt->indexLo ;
+      case 3: return &opt->indexHi ;
+      default: return &opt->other ;
+   }
+}
+
+static int vulpo4optListIndex(OPT4 *opt, const OPT4LIST *optList)
+{
+   int i ;
+
+   for ( i = 0 ; i < VULPO4OPT_LISTS ; i++ )
+      if ( vulpo4optList( opt, i ) == optList )
+         return i ;
+   return -1 ;
+}
+
+static OPT4BLOCK *vulpo4optBlock(LINK4 *lruLink)
+{
+   return (OPT4BLOCK *)( (char *)lruLink - offsetof( OPT4BLOCK, lruLink ) ) ;
+}
+
+// vulpo4optCounted reports whether reads and writes of a file go through
+// the cache of a CODE4 with counters, so the hooks can count them.
+static int vulpo4optCounted(const FILE4 *file)
+{
+   return file != 0 && file->codeBase != 0 && file->doBuffer && file->codeBase->opt.numBuffers > 0 && vulpo4code( file->codeBase ) != 0 ;
+}
+
+static void vulpo4optSnap(OPT4 *opt, VULPO4OPTSNAP *snap)
+{
+   int i ;
+
+   snap->readBefore = opt->readTimeCount ;
+   for ( i = 0 ; i < VULPO4OPT_LISTS ; i++ )
+      snap->nLink[i] = vulpo4optList( opt, i )->list.nLink ;
+}
+
+// vulpo4optCount counts the hits and misses of a read of len bytes at pos,
+// and the blocks the read or write evicted. Every block brought in takes the
+// next read time, so a block of the range was a hit if its read time is from
+// before the call and a miss otherwise. The victims leave no trace, but the
+// new blocks are added at the most recently used end of their lists, so a
+// short walk from there finds how many each list gained; whatever a list is
+// short of that was evicted from it.
+static void vulpo4optCount(FILE4 *file, unsigned long pos, unsigned len, const VULPO4OPTSNAP *snap, int lookups)
+{
+   OPT4 *opt = &file->codeBase->opt ;
+   VULPO4OPTCOUNT *count = vulpo4code( file->codeBase )->count ;
+   unsigned long nRead = opt->readTimeCount - snap->readBefore ;
+   unsigned long added[VULPO4OPT_LISTS] = { 0 } ;
+   unsigned long blockPos, end, limit, visited, found ;
+   LIST4 *list ;
+   LINK4 *link, *prev ;
+   OPT4BLOCK *block ;
+   int i, gained ;
+
+   if ( lookups && len > 0 && len <= opt->numBlocks * opt->blockSize )
+   {
+      end = pos + len ;
+      for ( blockPos = pos - pos % opt->blockSize ; blockPos < end ; blockPos += opt->blockSize )
+      {
+         block = opt4fileReturnBlock( file, blockPos, opt4fileHash( opt, file, blockPos ) ) ;
+         if ( block == 0 )
+         {
+            // Not kept, such as a block the read itself evicted again
+            i = file->type == OPT4DBF ? 0 : file->type == OPT4INDEX ? 2 : 4 ;
+            count[i].misses++ ;
+            continue ;
+         }
+         i = vulpo4optListIndex( opt, block->optList ) ;
+         if ( i < 0 )
+            continue ;
+         if ( block->readTime < snap->readBefore )
+            count[i].hits++ ;
+         else
+            count[i].misses++ ;
+      }
+   }
+
+   if ( nRead == 0 )
+      return ;
+   limit = nRead + len / opt->blockSize + opt->bufferSize / opt->blockSize + 2 ;
+   for ( i = 0, found = 0 ; i < VULPO4OPT_LISTS && found < nRead ; i++ )
+   {
+      list = &vulpo4optList( opt, i )->list ;
+      for ( link = list->lastNode, visited = 0 ; link != 0 && found < nRead && visited < limit ; link = prev, visited++ )
+      {
+         prev = link == list->lastNode->n ? 0 : link->p ;
+         if ( vulpo4optBlock( link )->readTime >= snap->readBefore )
+         {
+            added[i]++ ;
+            found++ ;
+         }
+      }
+   }
+   for ( i = 0 ; i < VULPO4OPT_LISTS ; i++ )
+   {
+      gained = (short)( vulpo4optList( opt, i )->list.nLink - snap->nLink[i] ) ;
+      if ( (long)added[i] > gained )
+         count[i].evictions += added[i] - gained ;
+   }
+}
+
+// vulpo4optToFront moves a block's link to the least recently used end of
+// its list. The lists are circular, with the first link after lastNode; the
+// library's l4addBefore searches the list for both links first, which would
+// make every miss of a scan cost a walk over the whole list.
+static void vulpo4optToFront(LIST4 *list, LINK4 *link)
+{
+   LINK4 *last = list->lastNode ;
+
+   if ( last->n == link )
+      return ;
+   if ( list->selected == link )
+      list->selected = link->p ;
+   if ( last == link )
+   {
+      list->lastNode = link->p ;
+      return ;
+   }
+
+   link->p->n = link->n ;
+   link->n->p = link->p ;
+   link->n = last->n ;
+   link->p = last ;
+   last->n->p = link ;
+   last->n = link ;
+}
+
+// vulpo4optProbation puts the nRead blocks of a list read since the read
+// clock stood at readBefore on probation: they move to the least recently
+// used end of the list and look as old as possible. The victim search takes
+// blocks from that end of the first list whose oldest blocks have aged
+// enough, which now are these, so a sequential scan recycles its own blocks
+// instead of pushing out the ones other reads keep coming back to. New
+// blocks are added at the most recently used end, together with the cached
+// blocks of the same read-ahead, so the walk starts there and goes no further
+// than a read-ahead buffer.
+static void vulpo4optProbation(OPT4 *opt, OPT4LIST *optList, unsigned long readBefore, unsigned long nRead)
+{
+   LIST4 *list = &optList->list ;
+   unsigned long limit = nRead + opt->bufferSize / opt->blockSize + 1 ;
+   unsigned long visited ;
+   LINK4 *link, *prev ;
+   OPT4BLOCK *block ;
+
+   for ( link = list->lastNode, visited = 0 ; link != 0 && nRead > 0 && visited < limit ; link = prev, visited++ )
+   {
+      prev = link == list->lastNode->n ? 0 : link->p ;
+      block = vulpo4optBlock( link ) ;
+      if ( block->readTime < readBefore )
+         continue ;
+      nRead-- ;
+
+      block->readTime = 0 ;
+      block->accessTime = 0 ;
+      vulpo4optToFront( list, link ) ;
+   }
+}
+
+unsigned __real_opt4fileRead( FILE4 *, unsigned long, void *, unsigned ) ;
+
+// __wrap_opt4fileRead stands in for opt4fileRead wherever the library calls
+// it. It counts the read for CacheStats, and with the scan resistant policy,
+// data file blocks read by d4skip (while the data file's hiPrio is -1) go on
+// probation: see vulpo4optProbation.
+unsigned __wrap_opt4fileRead( FILE4 *file, unsigned long pos, void *data, unsigned len )
+{
+   VULPO4OPTSNAP snap ;
+   OPT4 *opt ;
+   const DATA4FILE *dataFile ;
+   unsigned rc ;
+
+   if ( !vulpo4optCounted( file ) )
+      return __real_opt4fileRead( file, pos, data, len ) ;
+   opt = &file->codeBase->opt ;
+
+   vulpo4optSnap( opt, &snap ) ;
+   rc = __real_opt4fileRead( file, pos, data, len ) ;
+   vulpo4optCount( file, pos, len, &snap, 1 ) ;
+
+   if ( opt->readTimeCount == snap.readBefore || opt->dummyChar != VULPO4OPT_SCAN )
+      return rc ;
+   if ( file->type != OPT4DBF || file->ownerPtr == 0 )
+      return rc ;
+   dataFile = (const DATA4FILE *)file->ownerPtr ;
+   if ( dataFile->hiPrio == -1 )
+      vulpo4optProbation( opt, &opt->dbfLo, snap.readBefore, opt->readTimeCount - snap.readBefore ) ;
+   return rc ;
+}
+
+int __real_opt4fileWrite( FILE4 *, unsigned long, unsigned, const void *, char ) ;
+
+// __wrap_opt4fileWrite stands in for opt4fileWrite, counting the blocks a
+// buffered write evicts for CacheStats.
+int __wrap_opt4fileWrite( FILE4 *file, unsigned long pos, unsigned len, const void *data, char changed )
+{
+   VULPO4OPTSNAP snap ;
+   int rc ;
+
+   if ( !vulpo4optCounted( file ) )
+      return __real_opt4fileWrite( file, pos, len, data, changed ) ;
+
+   vulpo4optSnap( &file->codeBase->opt, &snap ) ;
+   rc = __real_opt4fileWrite( file, pos, len, data, changed ) ;
+   vulpo4optCount( file, pos, len, &snap, 0 ) ;
+   return rc ;
+}
+
+// vulpo4optFile buffers a file's reads and writes as mode says. type,
+// readSize and owner are what d4optimize passes for the file.
+static int vulpo4optFile(FILE4 *file, int mode, int type, long readSize, const void *owner)
+{
+   int rc ;
+
+   switch ( mode )
+   {
+      case VULPO4CACHE_OFF:
+         rc = file4optimizeWrite( file, OPT4OFF ) ;
+         if ( rc < 0 )
+            return rc ;
+         return file4optimizeLow( file, OPT4OFF, type, readSize, owner ) ;
+      case VULPO4CACHE_READ:
+         rc = file4optimizeLow( file, OPT4ALL, type, readSize, owner ) ;
+         if ( rc < 0 )
+            return rc ;
+         return file4optimizeWrite( file, OPT4OFF ) ;
+      case VULPO4CACHE_READWRITE:
+         rc = file4optimizeLow( file, OPT4ALL, type, readSize, owner ) ;
+         if ( rc < 0 )
+            return rc ;
+         // CodeBase holds writes back in files open exclusively; the table
+         // is open shared, so vulpo4optHold holds them only while locked
+         return file4optimizeWrite( file, OPT4ALL ) ;
+      default:
+         return file4optimizeLow( file, OPT4ALL, type, readSize, owner ) ;
+   }
+}
+
+// vulpo4optHoldFile holds a file's writes back in the cache, if it is in
+// CacheReadWrite, or writes the blocks held back and stops holding them.
+static int vulpo4optHoldFile(FILE4 *file, int hold)
+{
+   int rc ;
+
+   if ( !file->writeBuffer || !file->doBuffer )
+      return 0 ;
+   if ( hold )
+   {
+      file4setWriteOpt( file, 1 ) ;
+      return 0 ;
+   }
+   if ( !file->bufferWrites )
+      return 0 ;
+   rc = opt4fileFlush( file, 0 ) ;
+   file4setWriteOpt( file, 0 ) ;
+   return rc ;
+}
+
+// vulpo4optHold holds the writes of the table's files in CacheReadWrite back
+// while the table is locked, or writes them before it is unlocked, so no
+// other process reads the files while they are stale.
+static int vulpo4optHold(DATA4 *data, int hold)
+{
+   DATA4FILE *dataFile = data->dataFile ;
+   INDEX4FILE *indexFile ;
+   int rc, result ;
+
+   result = vulpo4optHoldFile( &dataFile->file, hold ) ;
+   for ( indexFile = (INDEX4FILE *)l4first( &dataFile->indexes ) ; indexFile != 0 ; indexFile = (INDEX4FILE *)l4next( &dataFile->indexes, indexFile ) )
+   {
+      rc = vulpo4optHoldFile( &indexFile->file, hold ) ;
+      if ( rc < 0 && result == 0 )
+         result = rc ;
+   }
+   if ( dataFile->memoFile.file.hand != INVALID4HANDLE )
+   {
+      rc = vulpo4optHoldFile( &dataFile->memoFile.file, hold ) ;
+      if ( rc < 0 && result == 0 )
+         result = rc ;
+   }
+   return result ;
+}
+
+// vulpo4optStart buffers the table's data, index and memo files as the modes
+// say and starts the buffer cache of codeBase with a policy.
+static int vulpo4optStart(CODE4 *codeBase, DATA4 *data, int policy, int dataMode, int indexMode, int memoMode)
+{
+   DATA4FILE *dataFile = data->dataFile ;
+   INDEX4FILE *indexFile ;
+   int rc ;
+
+   rc = vulpo4optFile( &dataFile->file, dataMode, OPT4DBF, dataFile->recWidth, dataFile ) ;
+   if ( rc < 0 )
+      return rc ;
+   for ( indexFile = (INDEX4FILE *)l4first( &dataFile->indexes ) ; indexFile != 0 ; indexFile = (INDEX4FILE *)l4next( &dataFile->indexes, indexFile ) )
+   {
+      rc = vulpo4optFile( &indexFile->file, indexMode, OPT4INDEX, 0, indexFile ) ;
+      if ( rc < 0 )
+         return rc ;
+   }
+   if ( dataFile->memoFile.file.hand != INVALID4HANDLE )
+   {
+      rc = vulpo4optFile( &dataFile->memoFile.file, memoMode, OPT4OTHER, 0, 0 ) ;
+      if ( rc < 0 )
+         return rc ;
+   }
+
+   rc = code4optStart( codeBase ) ;
+   if ( rc < 0 )
+      return rc ;
+   codeBase->opt.dummyChar = (unsigned char)policy ;
+   return 0 ;
+}
+
+// vulpo4optStats fills stats, one per list, with the blocks each list holds
+// and its counters, which are zero for a CODE4 without them.
+static void vulpo4optStats(CODE4 *codeBase, VULPO4OPTSTATS *stats)
+{
+   static const VULPO4OPTCOUNT none[VULPO4OPT_LISTS] ;
+   OPT4 *opt = &codeBase->opt ;
+   VULPO4CODE *code = vulpo4code( codeBase ) ;
+   const VULPO4OPTCOUNT *count = code == 0 ? none : code->count ;
+   LIST4 *list ;
+   LINK4 *link ;
+   OPT4BLOCK *block ;
+   int i ;
+
+   for ( i = 0 ; i < VULPO4OPT_LISTS ; i++ )
+   {
+      memset( &stats[i], 0, sizeof( stats[i] ) ) ;
+      stats[i].hits = count[i].hits ;
+      stats[i].misses = count[i].misses ;
+      stats[i].evictions = count[i].evictions ;
+
+      list = &vulpo4optList( opt, i )->list ;
+      if ( opt->numBuffers == 0 || list->lastNode == 0 )
+         continue ;
+      link = list->lastNode ;
+      do
+      {
+         link = link->n ;
+         block = vulpo4optBlock( link ) ;
+         stats[i].blocks++ ;
+         stats[i].bytes += block->len ;
+         if ( block->changed )
+         {
+            stats[i].dirtyBlocks++ ;
+            stats[i].dirtyBytes += block->len ;
+         }
+      } while ( link != list->lastNode ) ;
+   }
+}
+*/
+import "C"
+
+// CachePolicy selects how CodeBase's buffer cache chooses the blocks to
+// evict.
+type CachePolicy int
+
+const (
+	// CacheLRU is CodeBase's own policy: blocks are kept on least recently
+	// used lists by file type, and aged by a clock that every block read and
+	// access advances, sequential scans included
+	CacheLRU CachePolicy = iota
+
+	// CacheScanResistant puts the data file blocks read by sequential
+	// navigation (Next, Previous, Skip in record order) on probation: they
+	// are evicted first, before any block that was read another way, unless
+	// they are read again in the meantime. A full table scan then cycles
+	// through a few blocks instead of evicting the index blocks that seeks
+	// depend on
+	CacheScanResistant
+)
+
+// String returns the name of the cache policy.
+func (p CachePolicy) String() string {
+	switch p {
+	case CacheLRU:
+		return "LRU"
+	case CacheScanResistant:
+		return "ScanResistant"
+	default:
+		return "Unknown"
+	}
+}
+
+// CacheMode selects which accesses of a file go through the buffer cache.
+type CacheMode int
+
+const (
+	// CacheDefault buffers the file's reads, and its writes as CodeBase
+	// does by default: only while the table is open exclusively
+	CacheDefault CacheMode = iota
+
+	// CacheOff reads and writes the file directly
+	CacheOff
+
+	// CacheRead buffers the file's reads and writes it directly
+	CacheRead
+
+	// CacheReadWrite buffers reads, and holds writes in the cache while the
+	// table is locked, as AppendBatch does. The blocks held back are written
+	// before the table is unlocked, so other processes never read the file
+	// stale; writes made without the lock go to the file directly
+	CacheReadWrite
+)
+
+// String returns the name of the cache mode.
+func (m CacheMode) String() string {
+	switch m {
+	case CacheDefault:
+		return "Default"
+	case CacheOff:
+		return "Off"
+	case CacheRead:
+		return "Read"
+	case CacheReadWrite:
+		return "ReadWrite"
+	default:
+		return "Unknown"
+	}
+}
+
+// CacheConfig sizes the buffer cache and selects how each of the table's
+// files uses it. The zero value is CodeBase's default cache: 832 blocks of
+// 1024 bytes with reads of every file buffered.
+type CacheConfig struct {
+	// BlockSize is the size of a cache block in bytes, a power of two from
+	// 512 to 65536; 0 means 1024
+	BlockSize int
+
+	// Blocks is the number of blocks to cache. CodeBase allocates blocks in
+	// read buffers of up to 32 KB, so the number is rounded up to whole
+	// buffers, and to at least 4 blocks; 0 means as many blocks as fit in
+	// 832 KB
+	Blocks int
+
+	// Policy selects the blocks to evict
+	Policy CachePolicy
+
+	// Data, Index and Memo select how the data file, its index files and
+	// its memo file use the cache
+	Data  CacheMode
+	Index CacheMode
+	Memo  CacheMode
+}
+
+const (
+	// cacheBufferSize is the largest read buffer (memSizeBuffer) the cache
+	// is split into, CodeBase's default
+	cacheBufferSize = 32768
+
+	// cacheDefaultBytes is the memory CodeBase's default cache holds blocks
+	// in: 26 buffers of 32 KB
+	cacheDefaultBytes = 26 * cacheBufferSize
+)
+
+// validate checks the config's block size, block count, policy and modes.
+func (c *CacheConfig) validate() error {
+	if c.BlockSize != 0 && (c.BlockSize < 512 || c.BlockSize > 65536 || c.BlockSize&(c.BlockSize-1) != 0) {
+		return NewErrorf("invalid cache block size %d: must be a power of two from 512 to 65536", c.BlockSize)
+	}
+	if c.Blocks < 0 {
+		return NewErrorf("invalid number of cache blocks %d", c.Blocks)
+	}
+	if c.Policy != CacheLRU && c.Policy != CacheScanResistant {
+		return NewErrorf("unknown cache policy %d", int(c.Policy))
+	}
+	for _, mode := range []CacheMode{c.Data, c.Index, c.Memo} {
+		if mode < CacheDefault || mode > CacheReadWrite {
+			return NewErrorf("unknown cache mode %d", int(mode))
+		}
+	}
+	return nil
+}
+
+// geometry returns the block size, read buffer size (memSizeBuffer) and
+// memory (memStartMax) for which code4optStart allocates at least
+// c.Blocks blocks. It splits memStartMax into memStartMax/(bufferSize-2)-4
+// read buffers, keeping the other four buffers' worth for its own read and
+// write buffers, and wants at least four.
+func (c *CacheConfig) geometry() (blockSize, bufferSize, memory int) {
+	blockSize = c.BlockSize
+	if blockSize == 0 {
+		blockSize = 1024
+	}
+	blocks := c.Blocks
+	if blocks == 0 {
+		blocks = cacheDefaultBytes / blockSize
+	}
+
+	perBuffer := max(cacheBufferSize/blockSize, 1)
+	if blocks < 4*perBuffer {
+		perBuffer = max(blocks/4, 1)
+	}
+	buffers := max((blocks+perBuffer-1)/perBuffer, 4)
+	bufferSize = perBuffer * blockSize
+	return blockSize, bufferSize, (buffers + 4) * (bufferSize - 2)
+}
+
+// newCodeBase allocates a zeroed CODE4 followed by the counters the cache's
+// read and write hooks keep for CacheStats. It is released by freeCodeBase.
+func newCodeBase() *C.CODE4 {
+	return C.vulpo4codeNew()
+}
+
+// freeCodeBase releases a CODE4 from newCodeBase.
+func freeCodeBase(codeBase *C.CODE4) {
+	C.vulpo4codeFree(codeBase)
+}
+
+// startCache sizes the cache as config says and starts it.
+func (v *Vulpo) startCache(config CacheConfig) error {
+	if err := config.validate(); err != nil {
+		return err
+	}
+
+	blockSize, bufferSize, memory := config.geometry()
+	v.codeBase.memSizeBlock = C.uint(blockSize)
+	v.codeBase.memSizeBuffer = C.uint(bufferSize)
+	v.codeBase.memStartMax = C.long(memory)
+
+	result := C.vulpo4optStart(v.codeBase, v.data, C.int(config.Policy),
+		C.int(config.Data), C.int(config.Index), C.int(config.Memo))
+	if result < 0 {
+		C.error4set(v.codeBase, 0)
+		return NewErrorf("failed to start cache: error code %d", int(result))
+	}
+	v.cache = config
+	return nil
+}
+
+// StartCache starts CodeBase's buffer cache (code4optStart) with the given
+// eviction policy. The cache has the size and file modes of the CacheConfig
+// passed to Open, CodeBase's defaults without one: reads of the table, its
+// index files and memo file are buffered. While the cache runs, calling
+// StartCache again only changes the policy and file modes; StopCache first to
+// resize it.
+//
+// Parameters:
+//   - policy: The eviction policy, CacheLRU or CacheScanResistant
+//
+// Returns:
+//   - error: Error if the database is not open, the policy is unknown or the
+//     cache cannot be started
+//
+// Without StartCache every read goes to the operating system. Once started,
+// repeated reads of the same blocks, such as the upper levels of an index
+// during seeks, are served from memory. Reads stay buffered while the table
+// is shared, so changes made by other processes may be seen late; use
+// StartCache for tables this process reads alone or that do not change
+// underneath it.
+//
+// Example:
+//
+//	if err := v.StartCache(vulpo.CacheScanResistant); err != nil {
+//		log.Fatal(err)
+//	}
+//	defer v.StopCache()
+func (v *Vulpo) StartCache(policy CachePolicy) error {
+	if !v.Active() {
+		return NewError("database not open")
+	}
+
+	config := v.cache
+	config.Policy = policy
+	return v.startCache(config)
+}
+
+// StopCache writes any buffered changes and releases the buffer cache
+// (code4optSuspend). Reads go to the operating system again until the next
+// StartCache.
+//
+// Returns:
+//   - error: Error if the database is not open or the cache cannot be flushed
+//
+// Example:
+//
+//	defer v.StopCache()
+func (v *Vulpo) StopCache() error {
+	if !v.Active() {
+		return NewError("database not open")
+	}
+
+	if result := C.code4optSuspend(v.codeBase); result < 0 {
+		C.error4set(v.codeBase, 0)
+		return NewErrorf("failed to stop cache: error code %d", int(result))
+	}
+	return nil
+}
+
+// holdWrites holds the writes of the table's files in CacheReadWrite back in
+// the cache. The table must be locked, and writeHeld called before it is
+// unlocked.
+func (v *Vulpo) holdWrites() {
+	C.vulpo4optHold(v.data, 1)
+}
+
+// writeHeld writes the blocks held back since holdWrites.
+func (v *Vulpo) writeHeld() error {
+	if result := C.vulpo4optHold(v.data, 0); result < 0 {
+		C.error4set(v.codeBase, 0)
+		return NewErrorf("failed to write cached changes: error code %d", int(result))
+	}
+	return nil
+}
+
+// CacheListStats describes one of the buffer cache's block lists.
+type CacheListStats struct {
+	Blocks      int   // blocks the list holds
+	Bytes       int64 // bytes of file data in those blocks
+	DirtyBlocks int   // blocks changed in memory and not yet written
+	DirtyBytes  int64 // bytes of file data in the dirty blocks
+
+	Hits      uint64 // block reads served from the list
+	Misses    uint64 // block reads that went to the file, counted on the list the block joined; read-ahead may bring more blocks along
+	Evictions uint64 // blocks taken from the list to hold other data
+}
+
+// CacheStats describes the buffer cache of a table. CodeBase keeps the
+// blocks of data files, of index files and of other files such as memo
+// files on separate least recently used lists, with a low and a high
+// priority list each for data and index blocks. The high priority lists,
+// which hold the table header and the index blocks above the leaves among
+// others, are evicted from last.
+type CacheStats struct {
+	Active     bool        // whether the cache is started
+	Policy     CachePolicy // eviction policy
+	BlockSize  int         // bytes per block
+	Blocks     int         // blocks the cache holds in all
+	FreeBlocks int         // blocks not in use yet
+
+	DataLow   CacheListStats // data file blocks
+	DataHigh  CacheListStats // data file blocks kept longer, such as the header
+	IndexLow  CacheListStats // index leaf blocks
+	IndexHigh CacheListStats // index branch blocks
+	Other     CacheListStats // memo and other file blocks
+}
+
+// Total adds up the lists of the cache.
+//
+// Returns:
+//   - CacheListStats: The blocks, bytes and counters of all lists together
+func (s *CacheStats) Total() CacheListStats {
+	var total CacheListStats
+	for _, list := range []*CacheListStats{&s.DataLow, &s.DataHigh, &s.IndexLow, &s.IndexHigh, &s.Other} {
+		total.Blocks += list.Blocks
+		total.Bytes += list.Bytes
+		total.DirtyBlocks += list.DirtyBlocks
+		total.DirtyBytes += list.DirtyBytes
+		total.Hits += list.Hits
+		total.Misses += list.Misses
+		total.Evictions += list.Evictions
+	}
+	return total
+}
+
+// CacheStats reports what the buffer cache holds and how well it works,
+// read from CodeBase's OPT4 structures. Hits, misses and evictions count
+// from Open on, across StopCache and StartCache; the blocks are those held
+// now, none while the cache is stopped.
+//
+// Returns:
+//   - CacheStats: The cache's size, and the blocks and counters of each list
+//   - error: Error if the database is not open
+//
+// Example:
+//
+//	stats, err := v.CacheStats()
+//	if err != nil {
+//		log.Fatal(err)
+//	}
+//	total := stats.Total()
+//	fmt.Printf("hits %d, misses %d, dirty %d bytes\n", total.Hits, total.Misses, total.DirtyBytes)
+func (v *Vulpo) CacheStats() (CacheStats, error) {
+	if !v.Active() {
+		return CacheStats{}, NewError("database not open")
+	}
+
+	var lists [C.VULPO4OPT_LISTS]C.VULPO4OPTSTATS
+	C.vulpo4optStats(v.codeBase, &lists[0])
+
+	opt := &v.codeBase.opt
+	stats := CacheStats{
+		Active: opt.numBuffers > 0,
+		Policy: v.cache.Policy,
+	}
+	if stats.Active {
+		stats.BlockSize = int(opt.blockSize)
+		stats.Blocks = int(opt.numBlocks)
+	}
+	for i, list := range []*CacheListStats{&stats.DataLow, &stats.DataHigh, &stats.IndexLow, &stats.IndexHigh, &stats.Other} {
+		*list = CacheListStats{
+			Blocks:      int(lists[i].blocks),
+			Bytes:       int64(lists[i].bytes),
+			DirtyBlocks: int(lists[i].dirtyBlocks),
+			DirtyBytes:  int64(lists[i].dirtyBytes),
+			Hits:        uint64(lists[i].hits),
+			Misses:      uint64(lists[i].misses),
+			Evictions:   uint64(lists[i].evictions),
+		}
+	}
+	if stats.Active {
+		stats.FreeBlocks = stats.Blocks - stats.Total().Blocks
+	}
+	return stats, nil
+}
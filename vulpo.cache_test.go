@@ -0,0 +1,302 @@
+package vulpo
+
+import (
+	"fmt"
+	"testing"
+)
+
+// distinctNamesTable writes a copy of the test table with every record
+// repeated copies times, as replicateTable does, but with a NAME of its own
+// per record ("N0000000" upwards, spread over the file), and rebuilds its
+// index. It returns the path of the copy and the number of records.
+func distinctNamesTable(t testing.TB, copies int) (string, int) {
+	t.Helper()
+
+	rt := readRawTable(t, replicateTable(t, benchDBFPath, t.TempDir(), copies))
+	for i := 0; i < rt.count; i++ {
+		name := rt.field(t, i+1, "NAME")
+		copy(name, fmt.Sprintf("%-*s", len(name), fmt.Sprintf("N%07d", i*7919%rt.count)))
+	}
+	rt.write(t)
+
+	path, count := rt.path, rt.count
+	v := &Vulpo{}
+	if err := v.Open(path); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+	if err := v.Reindex(nil); err != nil {
+		t.Fatalf("Reindex failed: %v", err)
+	}
+	return path, count
+}
+
+func TestVulpo_StartCache_NoDatabase(t *testing.T) {
+	v := &Vulpo{}
+
+	if err := v.StartCache(CacheLRU); err == nil {
+		t.Error("Expected error for StartCache with inactive database")
+	}
+	if err := v.StopCache(); err == nil {
+		t.Error("Expected error for StopCache with inactive database")
+	}
+}
+
+func TestVulpo_StartCache_UnknownPolicy(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	if err := v.StartCache(CachePolicy(7)); err == nil {
+		t.Error("Expected error for unknown cache policy")
+	}
+}
+
+func TestVulpo_StartCache_Policies(t *testing.T) {
+	path, count := distinctNamesTable(t, 40)
+
+	for _, policy := range []CachePolicy{CacheLRU, CacheScanResistant} {
+		t.Run(policy.String(), func(t *testing.T) {
+			v := &Vulpo{}
+			if err := v.Open(path); err != nil {
+				t.Fatalf("Failed to open test file: %v", err)
+			}
+			defer v.Close()
+
+			if err := v.StartCache(policy); err != nil {
+				t.Fatalf("StartCache failed: %v", err)
+			}
+
+			// Seeks between stretches of a scan find the same records as
+			// without the cache, and the scan sees every record once
+			tag := v.TagByName("INF_NAME")
+			scanned := 0
+			if err := v.First(); err != nil {
+				t.Fatalf("First failed: %v", err)
+			}
+			for round := 0; round < 40; round++ {
+				key := fmt.Sprintf("N%07d", round*97%count)
+				recNos, err := v.SeekMany(tag, []string{key})
+				if err != nil || len(recNos) != 1 {
+					t.Fatalf("SeekMany(%s) = %v, %v", key, recNos, err)
+				}
+				if want := 1 + (round*97%count)*int(inverse7919(count))%count; recNos[0] != want {
+					t.Errorf("SeekMany(%s) found record %d, want %d", key, recNos[0], want)
+				}
+
+				for k := 0; k < 500 && !v.EOF(); k++ {
+					scanned++
+					if err := v.Next(); err != nil && !v.EOF() {
+						t.Fatalf("Next failed: %v", err)
+					}
+				}
+			}
+			for !v.EOF() {
+				scanned++
+				if err := v.Next(); err != nil && !v.EOF() {
+					t.Fatalf("Next failed: %v", err)
+				}
+			}
+			if scanned != count {
+				t.Errorf("Scan visited %d records, want %d", scanned, count)
+			}
+
+			if err := v.StopCache(); err != nil {
+				t.Errorf("StopCache failed: %v", err)
+			}
+		})
+	}
+}
+
+// inverse7919 returns the inverse of 7919 modulo count, which maps the NAME
+// numbers of distinctNamesTable back to record positions.
+func inverse7919(count int) int {
+	for i := 1; i < count; i++ {
+		if i*7919%count == 1 {
+			return i
+		}
+	}
+	return 0
+}
+
+func TestCacheConfig_Geometry(t *testing.T) {
+	tests := []struct {
+		config     CacheConfig
+		blockSize  int
+		bufferSize int
+		buffers    int
+	}{
+		{CacheConfig{}, 1024, 32768, 26},
+		{CacheConfig{Blocks: 4096}, 1024, 32768, 128},
+		{CacheConfig{BlockSize: 4096, Blocks: 100}, 4096, 32768, 13},
+		{CacheConfig{BlockSize: 512, Blocks: 10}, 512, 1024, 5},
+		{CacheConfig{Blocks: 1}, 1024, 1024, 4},
+		{CacheConfig{BlockSize: 65536}, 65536, 65536, 13},
+	}
+
+	for _, tt := range tests {
+		blockSize, bufferSize, memory := tt.config.geometry()
+		if blockSize != tt.blockSize || bufferSize != tt.bufferSize {
+			t.Errorf("%+v: geometry() = %d, %d, want block size %d, buffer size %d",
+				tt.config, blockSize, bufferSize, tt.blockSize, tt.bufferSize)
+			continue
+		}
+		// code4optStart's own split of memStartMax into read buffers
+		if buffers := memory/(bufferSize-2) - 4; buffers != tt.buffers {
+			t.Errorf("%+v: memory %d makes %d buffers, want %d", tt.config, memory, buffers, tt.buffers)
+		}
+	}
+}
+
+func TestVulpo_Open_InvalidCacheConfig(t *testing.T) {
+	configs := []CacheConfig{
+		{BlockSize: 1000},
+		{BlockSize: 256},
+		{Blocks: -1},
+		{Policy: CachePolicy(7)},
+		{Index: CacheMode(9)},
+	}
+
+	for _, config := range configs {
+		v := &Vulpo{}
+		if err := v.Open(testDBFWithIndexPath, &config); err == nil {
+			t.Errorf("Expected error for cache config %+v", config)
+			_ = v.Close()
+		}
+		if v.Active() {
+			t.Errorf("Database active after failed Open with %+v", config)
+		}
+	}
+}
+
+func TestVulpo_CacheStats_NoDatabase(t *testing.T) {
+	v := &Vulpo{}
+
+	if _, err := v.CacheStats(); err == nil {
+		t.Error("Expected error for CacheStats with inactive database")
+	}
+}
+
+func TestVulpo_CacheStats(t *testing.T) {
+	v := &Vulpo{}
+	config := &CacheConfig{BlockSize: 512, Blocks: 64, Policy: CacheScanResistant}
+	if err := v.Open(testDBFWithIndexPath, config); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	stats, err := v.CacheStats()
+	if err != nil {
+		t.Fatalf("CacheStats failed: %v", err)
+	}
+	if !stats.Active || stats.Policy != CacheScanResistant || stats.BlockSize != 512 || stats.Blocks != 64 {
+		t.Fatalf("CacheStats() = %+v, want an active 64 block cache of 512 byte blocks", stats)
+	}
+
+	// The first seek reads the tag's blocks, the same seek again finds
+	// them in the cache
+	if err := v.SelectTag(v.TagByName("INF_AGE")); err != nil {
+		t.Fatalf("SelectTag failed: %v", err)
+	}
+	if _, err := v.Seek("30"); err != nil {
+		t.Fatalf("Seek failed: %v", err)
+	}
+	before, _ := v.CacheStats()
+	if before.Total().Misses == 0 || before.IndexLow.Blocks+before.IndexHigh.Blocks == 0 {
+		t.Errorf("Seek left no index blocks in the cache: %+v", before)
+	}
+	if _, err := v.Seek("30"); err != nil {
+		t.Fatalf("Seek failed: %v", err)
+	}
+	after, _ := v.CacheStats()
+	if after.Total().Hits <= before.Total().Hits {
+		t.Errorf("Repeated seek: hits %d, want more than %d", after.Total().Hits, before.Total().Hits)
+	}
+
+	// A scan over 20 times the 252 records of 32 bytes needs more than the
+	// 64 blocks
+	_ = v.Close()
+	if err := v.Open(replicateTable(t, benchDBFPath, t.TempDir(), 20), config); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	for err := v.First(); err == nil && !v.EOF(); err = v.Next() {
+	}
+	stats, _ = v.CacheStats()
+	total := stats.Total()
+	if total.Evictions == 0 {
+		t.Errorf("Scans evicted no blocks: %+v", stats)
+	}
+	if total.Blocks+stats.FreeBlocks != stats.Blocks || total.DirtyBlocks != 0 {
+		t.Errorf("CacheStats() = %+v, want %d blocks in use or free and none dirty", stats, stats.Blocks)
+	}
+
+	if err := v.StopCache(); err != nil {
+		t.Fatalf("StopCache failed: %v", err)
+	}
+	stopped, _ := v.CacheStats()
+	if stopped.Active || stopped.Total().Blocks != 0 || stopped.Total().Hits != total.Hits {
+		t.Errorf("CacheStats() after StopCache = %+v, want no blocks and the counters kept", stopped)
+	}
+}
+
+func TestVulpo_CacheStats_DirtyBlocks(t *testing.T) {
+	for _, mode := range []CacheMode{CacheRead, CacheReadWrite} {
+		t.Run(mode.String(), func(t *testing.T) {
+			path := copyTable(t, testDBFWithIndexPath, t.TempDir(), ".dbf", ".cdx")
+			v := &Vulpo{}
+			if err := v.Open(path, &CacheConfig{Data: mode, Index: mode}); err != nil {
+				t.Fatalf("Failed to open test file: %v", err)
+			}
+			defer v.Close()
+			count := readRawTable(t, path).count
+
+			// Moving off the record writes it, straight to the file as the
+			// table is not locked
+			if err := v.First(); err != nil {
+				t.Fatalf("First failed: %v", err)
+			}
+			if err := v.Delete(); err != nil {
+				t.Fatalf("Delete failed: %v", err)
+			}
+			if err := v.Next(); err != nil {
+				t.Fatalf("Next failed: %v", err)
+			}
+			if stats, _ := v.CacheStats(); stats.Total().DirtyBlocks != 0 {
+				t.Errorf("Write without the lock left dirty blocks: %+v", stats)
+			}
+			if rt := readRawTable(t, path); rt.record(1)[0] != '*' {
+				t.Error("Deletion not in the file while the table is open")
+			}
+
+			// AppendBatch locks the table, and whatever it held back is
+			// written before the unlock
+			name := v.FieldByName("NAME")
+			appended, err := v.AppendBatch(300, func(i int) error {
+				return name.SetString(fmt.Sprintf("CACHED%04d", i))
+			})
+			if appended != 300 || err != nil {
+				t.Fatalf("AppendBatch = %d, %v, want 300", appended, err)
+			}
+			if stats, _ := v.CacheStats(); stats.Total().DirtyBlocks != 0 {
+				t.Errorf("AppendBatch left dirty blocks after unlocking: %+v", stats)
+			}
+			rt := readRawTable(t, path)
+			if rt.count != count+300 || string(rt.field(t, rt.count, "NAME")[:10]) != "CACHED0299" {
+				t.Errorf("Appended records not in the file while the table is open: %d records", rt.count)
+			}
+
+			// Another handle finds the new keys in the index
+			other := &Vulpo{}
+			if err := other.Open(path); err != nil {
+				t.Fatalf("Failed to open second handle: %v", err)
+			}
+			defer other.Close()
+			_ = other.SelectTag(other.TagByName("INF_NAME"))
+			if result, err := other.Seek("CACHED0299"); err != nil || !result.IsFound() {
+				t.Errorf("Seek(CACHED0299) on a second handle = %v, %v, want found", result, err)
+			}
+		})
+	}
+}
@@ -0,0 +1,331 @@
+package vulpo
+
+import (
+	"bytes"
+	"strings"
+)
+
+// ColumnType identifies the Go representation of a projected column.
+type ColumnType int
+
+const (
+	ColumnFloat64 ColumnType = iota // N, F, Y and B fields
+	ColumnInt64                     // I fields, D fields (Julian day) and T fields (Unix milliseconds)
+	ColumnString                    // C fields, stored as offsets into a shared byte buffer
+	ColumnBool                      // L fields, stored as a packed bitmap
+)
+
+// String returns a string representation of the ColumnType
+func (ct ColumnType) String() string {
+	switch ct {
+	case ColumnFloat64:
+		return "float64"
+	case ColumnInt64:
+		return "int64"
+	case ColumnString:
+		return "string"
+	case ColumnBool:
+		return "bool"
+	default:
+		return "unknown"
+	}
+}
+
+// Column is a typed vector holding one projected field for a run of records.
+// Only the slice matching Type is populated. Null values hold the zero value
+// of the column type and have their bit set in Nulls.
+type Column struct {
+	Name string
+	Type ColumnType
+
+	Float64s []float64 // ColumnFloat64 values
+	Int64s   []int64   // ColumnInt64 values
+	Offsets  []int     // ColumnString: value i is Bytes[Offsets[i]:Offsets[i+1]]
+	Bytes    []byte    // ColumnString: concatenated, blank-trimmed values
+	Bools    Bitmap    // ColumnBool values
+	Nulls    Bitmap    // Null mask, nil unless the field is nullable
+
+	def   *FieldDef
+	count int
+}
+
+// Len returns the number of values in the column.
+func (c *Column) Len() int {
+	return c.count
+}
+
+// IsNull reports whether value i is null.
+func (c *Column) IsNull(i int) bool {
+	return c.Nulls.Get(i)
+}
+
+// StringBytes returns value i of a string column without copying. The slice
+// aliases the column buffer.
+func (c *Column) StringBytes(i int) []byte {
+	if c.Type != ColumnString || i < 0 || i >= c.count {
+		return nil
+	}
+	return c.Bytes[c.Offsets[i]:c.Offsets[i+1]]
+}
+
+// String returns value i of a string column.
+func (c *Column) String(i int) string {
+	return string(c.StringBytes(i))
+}
+
+// Bool returns value i of a bool column.
+func (c *Column) Bool(i int) bool {
+	return c.Bools.Get(i)
+}
+
+// reset empties the column while keeping its buffers for reuse.
+func (c *Column) reset() {
+	c.Float64s = c.Float64s[:0]
+	c.Int64s = c.Int64s[:0]
+	c.Bytes = c.Bytes[:0]
+	if c.Type == ColumnString {
+		c.Offsets = append(c.Offsets[:0], 0)
+	}
+	clear(c.Bools)
+	c.Bools = c.Bools[:0]
+	clear(c.Nulls)
+	c.Nulls = c.Nulls[:0]
+	c.count = 0
+}
+
+// appendFrom decodes the column's field from rec and appends it.
+func (c *Column) appendFrom(rec Record) {
+	raw := c.def.bytes(rec.data)
+	i := c.count
+	c.count++
+
+	if c.def.nullable {
+		c.Nulls = c.Nulls.grow(c.count)
+		if c.def.isNullIn(rec.data) {
+			c.Nulls.set(i)
+			raw = nil
+		}
+	}
+
+	switch c.Type {
+	case ColumnFloat64:
+		val := 0.0
+		if raw != nil {
+			switch c.def.Type() {
+			case FTCurrency:
+				val = decodeCurrency(raw)
+			case FTBlob, FTDouble:
+				val = decodeDouble(raw)
+			default:
+				val = decodeNumeric(raw)
+			}
+		}
+		c.Float64s = append(c.Float64s, val)
+	case ColumnInt64:
+		var val int64
+		if raw != nil {
+			switch c.def.Type() {
+			case FTDate:
+				val = int64(decodeDateJulian(raw))
+			case FTDateTime:
+				if t := decodeDateTime(raw); !t.IsZero() {
+					val = t.UnixMilli()
+				}
+			default:
+				val = int64(decodeInteger(raw))
+			}
+		}
+		c.Int64s = append(c.Int64s, val)
+	case ColumnString:
+		if raw != nil {
+			if end := bytes.IndexByte(raw, 0); end >= 0 {
+				raw = raw[:end]
+			}
+			c.Bytes = append(c.Bytes, bytes.TrimSpace(raw)...)
+		}
+		c.Offsets = append(c.Offsets, len(c.Bytes))
+	case ColumnBool:
+		c.Bools = c.Bools.grow(c.count)
+		if raw != nil && decodeLogical(raw) {
+			c.Bools.set(i)
+		}
+	}
+}
+
+// columnTypeFor returns the column representation for a field type.
+func columnTypeFor(def *FieldDef) (ColumnType, bool) {
+	switch def.Type() {
+	case FTNumeric, FTFloat, FTCurrency:
+		return ColumnFloat64, true
+	case FTBlob, FTDouble:
+		return ColumnFloat64, def.length == 8
+	case FTInteger, FTDate:
+		return ColumnInt64, true
+	case FTDateTime:
+		return ColumnInt64, def.length == 8
+	case FTCharacter:
+		return ColumnString, true
+	case FTLogical:
+		return ColumnBool, true
+	default:
+		return 0, false
+	}
+}
+
+// ColumnScanOptions configures column projection scans
+type ColumnScanOptions struct {
+	BatchSize   int  // Records per batch passed to the callback (0 for the default of 4096)
+	SkipDeleted bool // Leave out records marked for deletion
+}
+
+// ColumnSet holds the projected columns for a run of records, in the order the
+// fields were requested, along with their physical record numbers.
+type ColumnSet struct {
+	Columns       []*Column
+	RecordNumbers []int
+}
+
+// Len returns the number of records in the set.
+func (cs *ColumnSet) Len() int {
+	return len(cs.RecordNumbers)
+}
+
+// Column returns the column with the given name (case-insensitive), or nil.
+func (cs *ColumnSet) Column(name string) *Column {
+	for _, col := range cs.Columns {
+		if strings.EqualFold(col.Name, name) {
+			return col
+		}
+	}
+	return nil
+}
+
+// reset empties every column for the next batch.
+func (cs *ColumnSet) reset() {
+	cs.RecordNumbers = cs.RecordNumbers[:0]
+	for _, col := range cs.Columns {
+		col.reset()
+	}
+}
+
+// append decodes the projected fields of rec onto the columns.
+func (cs *ColumnSet) append(rec Record) {
+	cs.RecordNumbers = append(cs.RecordNumbers, rec.RecordNumber())
+	for _, col := range cs.Columns {
+		col.appendFrom(rec)
+	}
+}
+
+// ScanColumns reads the named fields of every record into typed column vectors.
+//
+// Parameters:
+//   - fields: Names of the fields to project (case-insensitive)
+//   - options: Scan options, nil for defaults
+//
+// Returns:
+//   - *ColumnSet: One column per requested field, holding every scanned record
+//   - error: nil on success, error if a field is unknown or cannot be projected
+//
+// Only the byte ranges of the projected fields are decoded; values are never
+// boxed through interface{}. Records are read as by Scan, so physical order is
+// served from the memory-mapped scanner and a selected tag is honored.
+//
+// Example:
+//
+//	cols, err := v.ScanColumns([]string{"CUSTNO", "AMOUNT"}, &ColumnScanOptions{SkipDeleted: true})
+//	if err != nil {
+//		return err
+//	}
+//	amounts := cols.Column("AMOUNT").Float64s
+func (v *Vulpo) ScanColumns(fields []string, options *ColumnScanOptions) (*ColumnSet, error) {
+	set, err := v.newColumnSet(fields)
+	if err != nil {
+		return nil, err
+	}
+
+	skipDeleted := options != nil && options.SkipDeleted
+	err = v.Scan(func(rec Record) error {
+		if !skipDeleted || !rec.Deleted() {
+			set.append(rec)
+		}
+		return nil
+	})
+	if err != nil {
+		return nil, err
+	}
+
+	return set, nil
+}
+
+// ScanColumnBatches streams the named fields in batches of options.BatchSize
+// records. The ColumnSet passed to fn is reused between calls; fn must copy
+// anything it needs to keep. Returning an error from fn stops the scan.
+func (v *Vulpo) ScanColumnBatches(fields []string, options *ColumnScanOptions, fn func(*ColumnSet) error) error {
+	set, err := v.newColumnSet(fields)
+	if err != nil {
+		return err
+	}
+
+	if options == nil {
+		options = &ColumnScanOptions{}
+	}
+	batchSize := options.BatchSize
+	if batchSize <= 0 {
+		batchSize = defaultColumnBatchSize
+	}
+
+	err = v.Scan(func(rec Record) error {
+		if options.SkipDeleted && rec.Deleted() {
+			return nil
+		}
+		set.append(rec)
+		if set.Len() < batchSize {
+			return nil
+		}
+		err := fn(set)
+		set.reset()
+		return err
+	})
+	if err != nil {
+		return err
+	}
+
+	if set.Len() > 0 {
+		return fn(set)
+	}
+	return nil
+}
+
+// defaultColumnBatchSize is the number of records per ScanColumnBatches batch.
+const defaultColumnBatchSize = 4096
+
+// newColumnSet resolves the projected fields and prepares empty columns.
+func (v *Vulpo) newColumnSet(fields []string) (*ColumnSet, error) {
+	if !v.Active() {
+		return nil, NewError("database not open")
+	}
+
+	if len(fields) == 0 {
+		return nil, NewError("no fields to project")
+	}
+
+	set := &ColumnSet{Columns: make([]*Column, 0, len(fields))}
+	for _, name := range fields {
+		idx := v.fieldDefs.Index(name)
+		if idx < 0 {
+			return nil, NewErrorf("field '%s' not found", name)
+		}
+
+		def := v.fieldDefs.ByIndex(idx)
+		colType, ok := columnTypeFor(def)
+		if !ok {
+			return nil, NewErrorf("field '%s' of type %s cannot be projected", def.Name(), def.Type().Name())
+		}
+
+		col := &Column{Name: def.Name(), Type: colType, def: def}
+		col.reset()
+		set.Columns = append(set.Columns, col)
+	}
+
+	return set, nil
+}
@@ -0,0 +1,209 @@
+package vulpo
+
+import (
+	"errors"
+	"path/filepath"
+	"strings"
+	"testing"
+)
+
+func TestVulpo_ScanColumns_NoDatabase(t *testing.T) {
+	v := &Vulpo{}
+
+	if _, err := v.ScanColumns([]string{"NAME"}, nil); err == nil {
+		t.Error("Expected error for ScanColumns with inactive database")
+	}
+}
+
+func TestVulpo_ScanColumns_MatchesRecords(t *testing.T) {
+	files, _ := filepath.Glob("testdata/fieldtests/*.dbf")
+	files = append(files, "testdata/idcharsdate.dbf", "testdata/intcharsnumeric.dbf", "testdata/logictime.dbf", testDBFWithIndexPath)
+
+	for _, file := range files {
+		t.Run(file, func(t *testing.T) {
+			v := &Vulpo{}
+			if err := v.Open(file); err != nil {
+				t.Skipf("Cannot open %s: %v", file, err)
+			}
+			defer v.Close()
+
+			var names []string
+			for i := 0; i < v.FieldCount(); i++ {
+				if _, ok := columnTypeFor(v.FieldDefs().ByIndex(i)); ok {
+					names = append(names, strings.ToLower(v.FieldDefs().ByIndex(i).Name()))
+				}
+			}
+			if len(names) == 0 {
+				t.Skip("No projectable fields")
+			}
+
+			cols, err := v.ScanColumns(names, nil)
+			if err != nil {
+				t.Fatalf("ScanColumns failed: %v", err)
+			}
+
+			scanner, err := v.NewScanner()
+			if err != nil {
+				t.Fatalf("NewScanner failed: %v", err)
+			}
+			defer scanner.Close()
+
+			if cols.Len() != scanner.Count() {
+				t.Fatalf("Expected %d rows, got %d", scanner.Count(), cols.Len())
+			}
+
+			for _, col := range cols.Columns {
+				if col.Len() != cols.Len() {
+					t.Fatalf("Column %s: expected %d values, got %d", col.Name, cols.Len(), col.Len())
+				}
+				if cols.Column(strings.ToLower(col.Name)) != col {
+					t.Errorf("Column lookup failed for %s", col.Name)
+				}
+
+				field := v.FieldDefs().Index(col.Name)
+				for row, recNo := range cols.RecordNumbers {
+					rec := scanner.Record(recNo)
+					switch col.Type {
+					case ColumnFloat64:
+						want, _ := rec.Float(field)
+						if col.Float64s[row] != want {
+							t.Errorf("Record %d field %s: expected %v, got %v", recNo, col.Name, want, col.Float64s[row])
+						}
+					case ColumnInt64:
+						var want int64
+						switch col.def.Type() {
+						case FTDate:
+							want = int64(decodeDateJulian(rec.Bytes(field)))
+						case FTDateTime:
+							if tm, _ := rec.Time(field); !tm.IsZero() {
+								want = tm.UnixMilli()
+							}
+						default:
+							want, _ = rec.Int(field)
+						}
+						if col.Int64s[row] != want {
+							t.Errorf("Record %d field %s: expected %v, got %v", recNo, col.Name, want, col.Int64s[row])
+						}
+					case ColumnString:
+						want, _ := rec.String(field)
+						if col.String(row) != strings.TrimSpace(want) {
+							t.Errorf("Record %d field %s: expected %q, got %q", recNo, col.Name, want, col.String(row))
+						}
+					case ColumnBool:
+						want, _ := rec.Bool(field)
+						if col.Bool(row) != want {
+							t.Errorf("Record %d field %s: expected %v, got %v", recNo, col.Name, want, col.Bool(row))
+						}
+					}
+				}
+			}
+		})
+	}
+}
+
+func TestVulpo_ScanColumnBatches(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	name := v.FieldDefs().ByIndex(0).Name()
+	all, err := v.ScanColumns([]string{name}, &ColumnScanOptions{SkipDeleted: true})
+	if err != nil {
+		t.Fatalf("ScanColumns failed: %v", err)
+	}
+
+	var recNos []int
+	batches := 0
+	err = v.ScanColumnBatches([]string{name}, &ColumnScanOptions{BatchSize: 7, SkipDeleted: true}, func(cols *ColumnSet) error {
+		if cols.Len() > 7 {
+			t.Errorf("Batch of %d exceeds batch size", cols.Len())
+		}
+		if cols.Columns[0].Len() != cols.Len() {
+			t.Errorf("Column has %d values for %d records", cols.Columns[0].Len(), cols.Len())
+		}
+		batches++
+		recNos = append(recNos, cols.RecordNumbers...)
+		return nil
+	})
+	if err != nil {
+		t.Fatalf("ScanColumnBatches failed: %v", err)
+	}
+
+	if len(recNos) != all.Len() {
+		t.Fatalf("Expected %d records across batches, got %d", all.Len(), len(recNos))
+	}
+	for i := range recNos {
+		if recNos[i] != all.RecordNumbers[i] {
+			t.Fatalf("Position %d: expected record %d, got %d", i, all.RecordNumbers[i], recNos[i])
+		}
+	}
+	if want := (all.Len() + 6) / 7; batches != want {
+		t.Errorf("Expected %d batches, got %d", want, batches)
+	}
+
+	stop := errors.New("stop")
+	err = v.ScanColumnBatches([]string{name}, &ColumnScanOptions{BatchSize: 1}, func(*ColumnSet) error {
+		return stop
+	})
+	if !errors.Is(err, stop) {
+		t.Errorf("Expected callback error, got %v", err)
+	}
+}
+
+func TestVulpo_ScanColumns_InvalidFields(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	if _, err := v.ScanColumns(nil, nil); err == nil {
+		t.Error("Expected error for empty projection")
+	}
+	if _, err := v.ScanColumns([]string{"NO_SUCH_FIELD"}, nil); err == nil {
+		t.Error("Expected error for unknown field")
+	}
+
+	for i := 0; i < v.FieldCount(); i++ {
+		if def := v.FieldDefs().ByIndex(i); def.Type() == FTMemo {
+			if _, err := v.ScanColumns([]string{def.Name()}, nil); err == nil {
+				t.Errorf("Expected error projecting memo field %s", def.Name())
+			}
+		}
+	}
+}
+
+func TestBitmap(t *testing.T) {
+	var b Bitmap
+	b = b.grow(130)
+	b.set(0)
+	b.set(64)
+	b.set(129)
+
+	for _, i := range []int{0, 64, 129} {
+		if !b.Get(i) {
+			t.Errorf("Expected bit %d to be set", i)
+		}
+	}
+	for _, i := range []int{-1, 1, 63, 128, 1000} {
+		if b.Get(i) {
+			t.Errorf("Expected bit %d to be unset", i)
+		}
+	}
+	if b.Count() != 3 {
+		t.Errorf("Expected 3 set bits, got %d", b.Count())
+	}
+
+	var got []int
+	for i := b.Next(-5); i >= 0; i = b.Next(i + 1) {
+		got = append(got, i)
+	}
+	if len(got) != 3 || got[0] != 0 || got[1] != 64 || got[2] != 129 {
+		t.Errorf("Expected Next to visit 0, 64, 129, got %v", got)
+	}
+	if b.Next(130) != -1 || b.Next(1000) != -1 {
+		t.Error("Expected Next past the last bit to return -1")
+	}
+}
@@ -0,0 +1,120 @@
+package vulpo
+
+/*
+#include "d4all.h"
+*/
+import "C"
+
+// Cursor is a second position over a table that is already open. It has the
+// methods of Vulpo: its own current record, record buffer, selected tag and
+// field views, moved by its own First, Next, Seek and so on, while the data
+// file, index files and buffer cache stay those of the table it was made
+// from. Changes written through a cursor are seen by the table and its other
+// cursors once they read the record again.
+//
+// A cursor and the table share one CODE4, whose error state, memory pools
+// and cache are not safe for concurrent use: the table and all its cursors
+// must be used from one goroutine at a time. Goroutines that take turns,
+// such as a producer and a consumer handing over under a mutex, can each keep
+// their own cursor and place in the table. For reads that run at the same
+// time, use Scanner or ParallelScan.
+//
+// Close a cursor when done with it. Closing the table closes its cursors.
+type Cursor struct {
+	Vulpo
+}
+
+// NewCursor opens a cursor over the table (d4openClone). The cursor starts
+// before the first record with no tag selected; position it with First, Goto
+// or a seek before reading fields. Opening a cursor reuses the table's open
+// files and schema, so it costs microseconds instead of a full Open.
+//
+// Returns:
+//   - *Cursor: The new cursor
+//   - error: Error if the database is not open or the clone cannot be opened
+//
+// A cursor made from a cursor is a cursor over the same table.
+//
+// Example:
+//
+//	// Compare each record with the one after it
+//	ahead, err := v.NewCursor()
+//	if err != nil {
+//		log.Fatal(err)
+//	}
+//	defer ahead.Close()
+//
+//	name := v.FieldByName("NAME")
+//	next := ahead.FieldByName("NAME")
+//	ahead.First()
+//	for err := v.First(); err == nil && !v.EOF(); err = v.Next() {
+//		if ahead.Next() != nil || ahead.EOF() {
+//			break
+//		}
+//		a, _ := name.AsString()
+//		b, _ := next.AsString()
+//		fmt.Println(a, b)
+//	}
+func (v *Vulpo) NewCursor() (*Cursor, error) {
+	if !v.Active() {
+		return nil, NewError("database not open")
+	}
+
+	exprMutex.Lock()
+	data := C.d4openClone(v.data)
+	exprMutex.Unlock()
+	if data == nil {
+		result := v.codeBase.errorCode
+		C.error4set(v.codeBase, 0)
+		return nil, NewErrorf("failed to open cursor on %s: error code %d", v.filename, int(result))
+	}
+
+	if v.cursors == nil {
+		v.cursors = make(map[*Vulpo]struct{})
+	}
+	c := &Cursor{Vulpo{
+		filename: v.filename,
+		codeBase: v.codeBase,
+		data:     data,
+		cache:    v.cache,
+		deleted:  v.deleted,
+		packing:  v.packing,
+		cursors:  v.cursors,
+		cursor:   true,
+	}}
+	v.cursors[&c.Vulpo] = struct{}{}
+
+	if err := c.readHeader(); err != nil {
+		_ = c.reset()
+		return nil, err
+	}
+	return c, nil
+}
+
+// Open is not available on a cursor, which always reads the table it was
+// made from.
+//
+// Returns:
+//   - error: Always an error
+func (c *Cursor) Open(filename string, config ...*CacheConfig) error {
+	return NewError("cannot open a table on a cursor")
+}
+
+// Close closes the cursor. The table and its other cursors stay open.
+//
+// Returns:
+//   - error: Error if the cursor is not open or closing it fails
+//
+// Example:
+//
+//	c, err := v.NewCursor()
+//	if err != nil {
+//		return err
+//	}
+//	defer c.Close()
+func (c *Cursor) Close() error {
+	if !c.Active() {
+		return NewError("cursor not open")
+	}
+	return c.reset()
+}
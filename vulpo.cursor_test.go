@@ -0,0 +1,163 @@
+package vulpo
+
+import (
+	"fmt"
+	"testing"
+)
+
+func TestVulpo_NewCursor_NoDatabase(t *testing.T) {
+	v := &Vulpo{}
+
+	if _, err := v.NewCursor(); err == nil {
+		t.Error("Expected error for NewCursor with inactive database")
+	}
+}
+
+func TestVulpo_NewCursor(t *testing.T) {
+	path, count := distinctNamesTable(t, 4)
+	v := &Vulpo{}
+	if err := v.Open(path); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	c, err := v.NewCursor()
+	if err != nil {
+		t.Fatalf("NewCursor failed: %v", err)
+	}
+	defer c.Close()
+
+	if ch, vh := c.Header(), v.Header(); c.FieldCount() != v.FieldCount() || ch.RecordCount() != vh.RecordCount() {
+		t.Errorf("Cursor has %d fields and %d records, want %d and %d",
+			c.FieldCount(), ch.RecordCount(), v.FieldCount(), vh.RecordCount())
+	}
+	if err := c.Open(path); err == nil {
+		t.Error("Expected error for Open on a cursor")
+	}
+
+	// Moving and seeking the cursor leaves the table where it was
+	if err := v.First(); err != nil {
+		t.Fatalf("First failed: %v", err)
+	}
+	if err := c.SelectTag(c.TagByName("INF_NAME")); err != nil {
+		t.Fatalf("SelectTag failed: %v", err)
+	}
+	key := fmt.Sprintf("N%07d", count/2)
+	if result, err := c.Seek(key); err != nil || !result.IsFound() {
+		t.Fatalf("Seek(%s) = %v, %v", key, result, err)
+	}
+	if got, _ := c.FieldByName("NAME").AsString(); got != key {
+		t.Errorf("Cursor NAME = %q, want %q", got, key)
+	}
+	if v.Position() != 1 || v.SelectedTag() != nil {
+		t.Errorf("Table moved to %d with tag %v, want record 1 and no tag", v.Position(), v.SelectedTag())
+	}
+	if got, _ := v.FieldByName("NAME").AsString(); got != "N0000000" {
+		t.Errorf("Table NAME = %q, want N0000000", got)
+	}
+
+	// Both walk the whole table, interleaved
+	if err := c.SelectTag(nil); err != nil {
+		t.Fatalf("SelectTag failed: %v", err)
+	}
+	seen := 0
+	if err := c.First(); err != nil {
+		t.Fatalf("First failed: %v", err)
+	}
+	for !v.EOF() && !c.EOF() {
+		if v.Position() != c.Position() {
+			t.Fatalf("Table at %d, cursor at %d", v.Position(), c.Position())
+		}
+		seen++
+		if err := v.Next(); err != nil && !v.EOF() {
+			t.Fatalf("Next failed: %v", err)
+		}
+		if err := c.Next(); err != nil && !c.EOF() {
+			t.Fatalf("Next failed: %v", err)
+		}
+	}
+	if seen != count || !v.EOF() || !c.EOF() {
+		t.Errorf("Interleaved scans saw %d records, want %d", seen, count)
+	}
+}
+
+func TestVulpo_NewCursor_SharesTable(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(copyTable(t, testDBFWithIndexPath, t.TempDir(), ".dbf", ".cdx")); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+	if err := v.StartCache(CacheLRU); err != nil {
+		t.Fatalf("StartCache failed: %v", err)
+	}
+
+	c, err := v.NewCursor()
+	if err != nil {
+		t.Fatalf("NewCursor failed: %v", err)
+	}
+	defer c.Close()
+
+	// The cursor's reads go through the table's cache
+	before, _ := v.CacheStats()
+	for err := c.First(); err == nil && !c.EOF(); err = c.Next() {
+	}
+	after, _ := v.CacheStats()
+	if after.Total().Hits+after.Total().Misses <= before.Total().Hits+before.Total().Misses {
+		t.Errorf("Cursor scan did not use the table's cache: %+v", after)
+	}
+
+	// A deletion through the cursor is seen by the table
+	if err := c.Goto(3); err != nil {
+		t.Fatalf("Goto failed: %v", err)
+	}
+	if err := c.Delete(); err != nil {
+		t.Fatalf("Delete failed: %v", err)
+	}
+	if err := c.Goto(4); err != nil {
+		t.Fatalf("Goto failed: %v", err)
+	}
+	if err := v.Goto(3); err != nil {
+		t.Fatalf("Goto failed: %v", err)
+	}
+	if !v.Deleted() {
+		t.Error("Deletion through the cursor not seen by the table")
+	}
+}
+
+func TestVulpo_NewCursor_Close(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+
+	first, err := v.NewCursor()
+	if err != nil {
+		t.Fatalf("NewCursor failed: %v", err)
+	}
+	second, err := first.NewCursor()
+	if err != nil {
+		t.Fatalf("NewCursor on a cursor failed: %v", err)
+	}
+
+	// Closing a cursor leaves the table and the other cursor open
+	if err := first.Close(); err != nil {
+		t.Fatalf("Close failed: %v", err)
+	}
+	if err := first.Close(); err == nil {
+		t.Error("Expected error closing a closed cursor")
+	}
+	if err := second.First(); err != nil || !v.Active() {
+		t.Fatalf("Cursor or table closed with another cursor: %v", err)
+	}
+
+	// Closing the table closes its cursors
+	if err := v.Close(); err != nil {
+		t.Fatalf("Close failed: %v", err)
+	}
+	if second.Active() {
+		t.Error("Cursor still open after closing the table")
+	}
+	if err := second.Close(); err == nil {
+		t.Error("Expected error closing a cursor of a closed table")
+	}
+}
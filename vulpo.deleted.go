@@ -7,6 +7,10 @@ package vulpo
 #include <stdlib.h>
 */
 import "C"
+import (
+	"io"
+	"os"
+)
 
 // Deleted returns true if the current record is marked for deletion.
 // Returns false if the database is not active or if at EOF/BOF.
@@ -42,6 +46,8 @@ func (v *Vulpo) Delete() error {
 	}
 
 	C.d4delete(v.data)
+	v.deleted.mark(int(C.d4recNo(v.data)), true)
+	v.packing.note(int(C.d4recNo(v.data)))
 	return nil
 }
 
@@ -59,6 +65,8 @@ func (v *Vulpo) Recall() error {
 	}
 
 	C.d4recall(v.data)
+	v.deleted.mark(int(C.d4recNo(v.data)), false)
+	v.packing.note(int(C.d4recNo(v.data)))
 	return nil
 }
 
@@ -68,6 +76,7 @@ func (v *Vulpo) Recall() error {
 // - Automatically reindexes all open index files
 // - Makes the record buffer and position undefined (call a positioning function after)
 // - Should be done exclusively (no other users) for best performance
+// - Fails while an online pack or a memo compaction is in progress
 //
 // WARNING: This is a destructive operation. Take appropriate backups first.
 // Returns an error if the operation fails.
@@ -75,8 +84,20 @@ func (v *Vulpo) Pack() error {
 	if !v.Active() {
 		return NewError("database not open")
 	}
+	if v.packing.packer != nil {
+		return NewError("cannot pack while an online pack is in progress")
+	}
+	if v.packing.compactor != nil {
+		return NewError("cannot pack while a memo compaction is in progress")
+	}
+
+	// Cursors write their pending changes before the records move
+	if result := v.keyed(func() C.int { return C.code4flush(v.codeBase) }); result < 0 {
+		return NewErrorf("failed to flush database before pack: error code %d", int(result))
+	}
 
-	result := C.d4pack(v.data)
+	result := v.keyed(func() C.int { return C.d4pack(v.data) })
+	v.deleted.invalidate()
 	if result != 0 {
 		return NewErrorf("failed to pack database: error code %d", int(result))
 	}
@@ -85,101 +106,34 @@ func (v *Vulpo) Pack() error {
 }
 
 // CountDeleted counts the total number of records marked for deletion.
-// This scans the entire database and preserves the current position.
+// The deletion flags are read straight from the data file the first time
+// (see DeletedBitmap) and kept up to date afterwards, so later counts take
+// constant time. The current position and selected tag are untouched.
 func (v *Vulpo) CountDeleted() (int, error) {
 	if !v.Active() {
 		return 0, NewError("database not open")
 	}
 
-	// Save original position and tag selection
-	originalPosition := v.Position()
-	originalTag := v.SelectedTag()
-
-	defer func() {
-		// Restore original state
-		_ = v.SelectTag(originalTag)
-		if originalPosition > 0 {
-			_ = v.Goto(originalPosition)
-		}
-	}()
-
-	// Use record ordering (no index) for counting
-	err := v.SelectTag(nil)
+	set, err := v.deletedRecords(true)
 	if err != nil {
 		return 0, err
 	}
-
-	count := 0
-
-	// Go to first record
-	err = v.First()
-	if err != nil {
-		return 0, NewErrorf("failed to go to first record: %v", err)
-	}
-
-	// Scan all records
-	for !v.EOF() {
-		if v.Deleted() {
-			count++
-		}
-
-		// Move to next record
-		err = v.Next()
-		if err != nil {
-			break // End of file or error
-		}
-	}
-
-	return count, nil
+	return set.deleted, nil
 }
 
 // CountActive counts the number of non-deleted (active) records.
-// This scans the entire database and preserves the current position.
+// Like CountDeleted, it scans the data file only the first time. The current
+// position and selected tag are untouched.
 func (v *Vulpo) CountActive() (int, error) {
 	if !v.Active() {
 		return 0, NewError("database not open")
 	}
 
-	// Save original position and tag selection
-	originalPosition := v.Position()
-	originalTag := v.SelectedTag()
-
-	defer func() {
-		// Restore original state
-		_ = v.SelectTag(originalTag)
-		if originalPosition > 0 {
-			_ = v.Goto(originalPosition)
-		}
-	}()
-
-	// Use record ordering (no index) for counting
-	err := v.SelectTag(nil)
+	set, err := v.deletedRecords(true)
 	if err != nil {
 		return 0, err
 	}
-
-	count := 0
-
-	// Go to first record
-	err = v.First()
-	if err != nil {
-		return 0, NewErrorf("failed to go to first record: %v", err)
-	}
-
-	// Scan all records
-	for !v.EOF() {
-		if !v.Deleted() {
-			count++
-		}
-
-		// Move to next record
-		err = v.Next()
-		if err != nil {
-			break // End of file or error
-		}
-	}
-
-	return count, nil
+	return set.count - set.deleted, nil
 }
 
 // DeletedRecordInfo contains information about deleted records
@@ -188,102 +142,61 @@ type DeletedRecordInfo struct {
 	IsDeleted    bool // Always true for records in this structure
 }
 
-// ListDeletedRecords returns information about all deleted records.
-// This preserves the current position.
+// ListDeletedRecords returns information about all deleted records, in
+// physical order, from the set CountDeleted keeps. This preserves the current
+// position.
 func (v *Vulpo) ListDeletedRecords() ([]DeletedRecordInfo, error) {
 	if !v.Active() {
 		return nil, NewError("database not open")
 	}
 
-	// Save original position and tag selection
-	originalPosition := v.Position()
-	originalTag := v.SelectedTag()
-
-	defer func() {
-		// Restore original state
-		_ = v.SelectTag(originalTag)
-		if originalPosition > 0 {
-			_ = v.Goto(originalPosition)
-		}
-	}()
-
-	// Use record ordering (no index) for scanning
-	err := v.SelectTag(nil)
+	set, err := v.deletedRecords(true)
 	if err != nil {
 		return nil, err
 	}
 
-	var deletedRecords []DeletedRecordInfo
-
-	// Go to first record
-	err = v.First()
-	if err != nil {
-		return nil, NewErrorf("failed to go to first record: %v", err)
-	}
-
-	// Scan all records
-	for !v.EOF() {
-		if v.Deleted() {
-			deletedRecords = append(deletedRecords, DeletedRecordInfo{
-				RecordNumber: v.Position(),
-				IsDeleted:    true,
-			})
-		}
-
-		// Move to next record
-		err = v.Next()
-		if err != nil {
-			break // End of file or error
-		}
+	deletedRecords := make([]DeletedRecordInfo, 0, set.deleted)
+	for recNo := set.bits.Next(1); recNo >= 0; recNo = set.bits.Next(recNo + 1) {
+		deletedRecords = append(deletedRecords, DeletedRecordInfo{
+			RecordNumber: recNo,
+			IsDeleted:    true,
+		})
 	}
 
 	return deletedRecords, nil
 }
 
-// ForEachDeletedRecord iterates through all deleted records with a callback.
-// This preserves the current position.
+// ForEachDeletedRecord iterates through all deleted records with a callback,
+// in physical order. The table is positioned on each record before the
+// callback is called, so its fields can be read. This preserves the current
+// position.
 func (v *Vulpo) ForEachDeletedRecord(callback func(recordNumber int) error) error {
 	if !v.Active() {
 		return NewError("database not open")
 	}
 
-	// Save original position and tag selection
-	originalPosition := v.Position()
-	originalTag := v.SelectedTag()
+	set, err := v.deletedRecords(true)
+	if err != nil {
+		return err
+	}
+	// The callback may delete, recall or pack
+	deleted := append(Bitmap(nil), set.bits...)
 
+	// Save original position
+	originalPosition := v.Position()
 	defer func() {
-		// Restore original state
-		_ = v.SelectTag(originalTag)
 		if originalPosition > 0 {
 			_ = v.Goto(originalPosition)
 		}
 	}()
 
-	// Use record ordering (no index) for scanning
-	err := v.SelectTag(nil)
-	if err != nil {
-		return err
-	}
-
-	// Go to first record
-	err = v.First()
-	if err != nil {
-		return NewErrorf("failed to go to first record: %v", err)
-	}
-
-	// Scan all records
-	for !v.EOF() {
-		if v.Deleted() {
-			// Call the callback with the record number
-			if err := callback(v.Position()); err != nil {
-				return err
-			}
+	for recNo := deleted.Next(1); recNo >= 0; recNo = deleted.Next(recNo + 1) {
+		if err := v.Goto(recNo); err != nil {
+			return err
 		}
-
-		// Move to next record
-		err = v.Next()
-		if err != nil {
-			break // End of file or error
+		// Call the callback with the record number
+		if err := callback(recNo); err != nil {
+			return err
 		}
 	}
 
@@ -292,51 +205,154 @@ func (v *Vulpo) ForEachDeletedRecord(callback func(recordNumber int) error) erro
 
 // RecallAllDeleted removes the deletion mark from all deleted records.
 // This "undeletes" all records that were previously marked for deletion.
-// This preserves the current position.
+// Only the deleted records are visited. This preserves the current position.
 func (v *Vulpo) RecallAllDeleted() (int, error) {
 	if !v.Active() {
 		return 0, NewError("database not open")
 	}
 
-	// Save original position and tag selection
-	originalPosition := v.Position()
-	originalTag := v.SelectedTag()
+	set, err := v.deletedRecords(true)
+	if err != nil {
+		return 0, err
+	}
 
+	// Save original position
+	originalPosition := v.Position()
 	defer func() {
-		// Restore original state
-		_ = v.SelectTag(originalTag)
 		if originalPosition > 0 {
 			_ = v.Goto(originalPosition)
 		}
 	}()
 
-	// Use record ordering (no index) for processing
-	err := v.SelectTag(nil)
+	count := 0
+	for recNo := set.bits.Next(1); recNo >= 0; recNo = set.bits.Next(recNo + 1) {
+		if err := v.Goto(recNo); err != nil {
+			return count, err
+		}
+		C.d4recall(v.data) // Recall this record
+		set.mark(recNo, false)
+		v.packing.note(recNo)
+		count++
+	}
+
+	return count, nil
+}
+
+// deletedScanChunk is the amount of the data file the deleted-flag scan reads
+// at once, rounded down to whole groups of 64 records.
+const deletedScanChunk = 1 << 20
+
+// DeletedBitmap returns the records marked for deletion as a bitmap with bit
+// n set when record n is deleted (bit 0 is unused).
+//
+// Returns:
+//   - Bitmap: The deleted record numbers
+//   - error: Error if the database is not open or the data file cannot be read
+//
+// The deletion flags are read straight from the data file in large
+// sequential chunks, after pending changes are written, without moving the
+// current record: the flags of 64 records at a time are gathered into one
+// bitmap word. A scan of a large table is bound by the speed of the disk, not
+// by per-record calls into CodeBase. The table keeps the result and keeps it
+// up to date through Delete and Recall, so only the first call, or the first
+// after Pack, scans the file; records added since the last call are scanned
+// on their own. The returned bitmap is a copy.
+//
+// Example:
+//
+//	deleted, err := v.DeletedBitmap()
+//	if err != nil {
+//		return err
+//	}
+//	fmt.Printf("%d deleted\n", deleted.Count())
+//	for recNo := deleted.Next(1); recNo >= 0; recNo = deleted.Next(recNo + 1) {
+//		fmt.Println(recNo)
+//	}
+func (v *Vulpo) DeletedBitmap() (Bitmap, error) {
+	if !v.Active() {
+		return nil, NewError("database not open")
+	}
+
+	set, err := v.deletedRecords(true)
 	if err != nil {
-		return 0, err
+		return nil, err
 	}
+	return append(Bitmap(nil), set.bits...), nil
+}
 
-	count := 0
+// scanDeleted reads the deletion flags of the records after the first from
+// from the data file into deleted, growing it as needed, and returns the
+// bitmap with the number of records it now covers. from is a multiple of 64;
+// the flags of the first from records are kept.
+func (v *Vulpo) scanDeleted(deleted Bitmap, from int) (Bitmap, int, error) {
+	// Changes pending in the record buffers of cursors count too
+	if result := v.keyed(func() C.int { return C.code4flush(v.codeBase) }); result < 0 {
+		return nil, 0, NewErrorf("failed to flush database before scan: error code %d", int(result))
+	}
+
+	count := int(C.d4recCountDo(v.data))
+	headerLen, recordLen := v.header.headerLen, v.header.recordLen
+	if recordLen <= 0 {
+		return nil, 0, NewErrorf("invalid record length: %d", recordLen)
+	}
+	deleted = deleted.grow(count + 1)
+	deleted[from>>6] &= 1
+	clear(deleted[from>>6+1:])
+	if count <= from {
+		return deleted, count, nil
+	}
 
-	// Go to first record
-	err = v.First()
+	file, err := os.Open(v.filename)
 	if err != nil {
-		return 0, NewErrorf("failed to go to first record: %v", err)
+		return nil, 0, NewErrorf("failed to open data file for scanning: %s", v.filename).SetWrapped(err)
 	}
+	defer file.Close()
 
-	// Scan all records and recall deleted ones
-	for !v.EOF() {
-		if v.Deleted() {
-			C.d4recall(v.data) // Recall this record
-			count++
+	groups := max(1, deletedScanChunk/(64*recordLen))
+	buf := make([]byte, min(groups*64, count-from)*recordLen)
+
+	read := from
+	for read < count {
+		n := min(len(buf)/recordLen, count-read)
+		got, err := file.ReadAt(buf[:n*recordLen], int64(headerLen+read*recordLen))
+		if err != nil && err != io.EOF {
+			return nil, 0, NewErrorf("failed to read data file: %s", v.filename).SetWrapped(err)
 		}
 
-		// Move to next record
-		err = v.Next()
-		if err != nil {
-			break // End of file or error
+		// The file may end before the header's record count says
+		n = got / recordLen
+		if n == 0 {
+			break
 		}
+
+		// Chunks hold whole groups of 64 records, so the flags of records
+		// read+g+1 onwards go to word (read+g)/64 from bit 1, the last
+		// one to bit 0 of the next word
+		for g := 0; g < n; g += 64 {
+			word := deletedWord(buf[g*recordLen:], recordLen, min(64, n-g))
+			k := (read + g) >> 6
+			deleted[k] |= word << 1
+			if high := word >> 63; high != 0 {
+				deleted[k+1] |= high
+			}
+		}
+		read += n
 	}
 
-	return count, nil
+	return deleted, read, nil
+}
+
+// deletedWord returns a word with bit k set for each of the first n records
+// of data, recordLen bytes apart, whose deletion flag is set. n is at most 64.
+func deletedWord(data []byte, recordLen, n int) uint64 {
+	var word uint64
+	_ = data[(n-1)*recordLen]
+	for k, off := 0, 0; k < n; k, off = k+1, off+recordLen {
+		var bit uint64
+		if data[off] == '*' {
+			bit = 1
+		}
+		word |= bit << k
+	}
+	return word
 }
@@ -0,0 +1,79 @@
+package vulpo
+
+/*
+#include "d4all.h"
+*/
+import "C"
+
+// deletedSet is the set of deleted records a table keeps once they have been
+// counted, so that later counts and listings need no scan. It is shared by
+// the table and its cursors. Delete, Recall and RecallAllDeleted keep it up
+// to date; records added to the file are scanned when the record count grows,
+// and Pack, or a record count that shrinks, drops it.
+//
+// Deletions and recalls made by other processes without changing the record
+// count are not seen until the set is dropped.
+type deletedSet struct {
+	bits    Bitmap // bit n set when record n is deleted
+	count   int    // records covered by bits
+	deleted int    // bits set
+	valid   bool
+}
+
+// mark records that record recNo has been deleted or recalled. Records past
+// the end of the set are left to the scan that follows a record count change.
+func (s *deletedSet) mark(recNo int, deleted bool) {
+	if !s.valid || recNo < 1 || recNo > s.count || s.bits.Get(recNo) == deleted {
+		return
+	}
+	if deleted {
+		s.bits.set(recNo)
+		s.deleted++
+	} else {
+		s.bits.unset(recNo)
+		s.deleted--
+	}
+}
+
+// invalidate drops the set; the next count scans the data file again.
+func (s *deletedSet) invalidate() {
+	s.valid = false
+}
+
+// deletedRecords returns the deleted-record set of the table, reading the
+// deletion flags from the data file the first time and after the set has been
+// dropped. With check, the record count is read first: records added since
+// the set was built are scanned, and a file that has fewer records than the
+// set is scanned again from the start. Without check a valid set is returned
+// as is.
+func (v *Vulpo) deletedRecords(check bool) (*deletedSet, error) {
+	set := v.deleted
+	if set.valid {
+		if !check {
+			return set, nil
+		}
+		count := int(C.d4recCountDo(v.data))
+		if count == set.count {
+			return set, nil
+		}
+		if count < set.count {
+			set.invalidate()
+		}
+	}
+
+	bits, from := Bitmap(nil), 0
+	if set.valid {
+		bits, from = set.bits, set.count&^63
+	}
+	bits, count, err := v.scanDeleted(bits, from)
+	if err != nil {
+		set.invalidate()
+		return nil, err
+	}
+
+	set.bits = bits
+	set.count = count
+	set.deleted = bits.Count()
+	set.valid = true
+	return set, nil
+}
@@ -8,14 +8,37 @@ package vulpo
 */
 import "C"
 import (
+	"sync"
 	"unsafe"
 )
 
+// exprMutex serializes expression parsing and evaluation. The CodeBase
+// expression engine keeps its working state in process globals (expr4buf,
+// expr4, expr4ptr, expr4infoPtr, expr4constants), so two EXPR4 handles must
+// never be evaluated at the same time, even on different CODE4 structures.
+// Tables with index files use the engine outside of filters too (see keyed).
+var exprMutex sync.Mutex
+
+// keyed calls op, a CodeBase call on the table, holding exprMutex if the
+// table has index files open: opening them parses the tag expressions,
+// writing a changed record or appending one evaluates the key of every tag,
+// and moving in tag order evaluates the selected tag's key of the current
+// record to find it in the tag.
+func (v *Vulpo) keyed(op func() C.int) C.int {
+	if v.data.indexes.nLink == 0 {
+		return op()
+	}
+	exprMutex.Lock()
+	defer exprMutex.Unlock()
+	return op()
+}
+
 // ExprFilter represents a compiled dBASE expression for filtering records
 type ExprFilter struct {
 	expr     *C.EXPR4
 	vulpo    *Vulpo
 	exprText string
+	compiled *compiledExpr // native evaluator, nil if the expression needs CodeBase
 }
 
 // NewExprFilter creates a new expression filter from a dBASE expression string
@@ -29,17 +52,28 @@ func (v *Vulpo) NewExprFilter(expression string) (*ExprFilter, error) {
 	defer C.free(unsafe.Pointer(cExpr))
 
 	// Parse the expression using CodeBase (use the low-level function directly)
+	exprMutex.Lock()
 	expr := C.expr4parseLow(v.data, cExpr, nil)
+	exprMutex.Unlock()
 	if expr == nil {
-		// Get error information from CodeBase
+		// Clear the error so later calls on this CODE4 are not refused
+		C.error4set(v.codeBase, 0)
 		return nil, NewErrorf("failed to parse expression: %s", expression)
 	}
 
-	return &ExprFilter{
+	filter := &ExprFilter{
 		expr:     expr,
 		vulpo:    v,
 		exprText: expression,
-	}, nil
+	}
+
+	// CodeBase has validated the expression; use the native evaluator when the
+	// expression is within the subset the compiler supports
+	if compiled, err := compileExpr(v.fieldDefs, expression); err == nil {
+		filter.compiled = compiled
+	}
+
+	return filter, nil
 }
 
 // Free releases the memory associated with the expression filter
@@ -56,9 +90,30 @@ func (ef *ExprFilter) Evaluate() (bool, error) {
 		return false, NewError("expression filter is not initialized")
 	}
 
+	if ef.compiled != nil {
+		rec := Record{data: ef.vulpo.currentRecord(), defs: ef.vulpo.fieldDefs}
+		if ef.compiled.usesRecNo {
+			rec.recNo = ef.vulpo.Position()
+		}
+		return ef.compiled.eval(rec), nil
+	}
+
+	return ef.evaluateC(), nil
+}
+
+// evaluateC evaluates the expression for the current record with CodeBase.
+func (ef *ExprFilter) evaluateC() bool {
 	// Evaluate the expression - this should return a logical result
+	exprMutex.Lock()
 	result := C.expr4true(ef.expr)
-	return result != 0, nil
+	exprMutex.Unlock()
+	return result != 0
+}
+
+// Compiled reports whether the expression runs on the native Go evaluator
+// rather than through a CodeBase call per record.
+func (ef *ExprFilter) Compiled() bool {
+	return ef.compiled != nil
 }
 
 // EvaluateAsString evaluates the expression and returns the result as a string
@@ -67,13 +122,18 @@ func (ef *ExprFilter) EvaluateAsString() (string, error) {
 		return "", NewError("expression filter is not initialized")
 	}
 
-	// Get the string result of the expression
+	// Get the string result of the expression; it lives in the shared working
+	// buffer, so copy it out before releasing the lock
+	exprMutex.Lock()
+	defer exprMutex.Unlock()
+
 	cResult := C.expr4str(ef.expr)
 	if cResult == nil {
 		return "", NewError("expression evaluation returned null")
 	}
 
-	return C.GoString(cResult), nil
+	// The result is not NUL-terminated; its length is fixed by the expression
+	return C.GoStringN(cResult, C.int(ef.expr.len)), nil
 }
 
 // EvaluateAsDouble evaluates the expression and returns the result as a float64
@@ -83,11 +143,20 @@ func (ef *ExprFilter) EvaluateAsDouble() (float64, error) {
 	}
 
 	// Get the double result of the expression
+	exprMutex.Lock()
 	result := C.expr4double(ef.expr)
+	exprMutex.Unlock()
 	return float64(result), nil
 }
 
-// ExprSearchOptions contains options for expression-based searching
+// ExprSearchOptions contains options for expression-based searching.
+//
+// With UseIndex set, sub-expressions covered by a tag (for example AGE > 40
+// with a tag on AGE) are resolved from the index by the CodeBase query
+// optimizer, so only candidate records are read. Matches are then returned in
+// record-number order regardless of the selected tag, and TotalScanned counts
+// only the records the query visited. Expressions the optimizer cannot use, and
+// expressions containing .OR., are scanned as usual.
 type ExprSearchOptions struct {
 	MaxResults int  // Maximum number of results to return (0 for unlimited)
 	UseIndex   bool // Whether to try to use indexes for optimization
@@ -107,7 +176,12 @@ type ExprSearchResult struct {
 	TotalMatched int         // Total records that matched
 }
 
-// SearchByExpression searches for records matching a dBASE expression
+// SearchByExpression searches for records matching a dBASE expression.
+//
+// Each match carries a map of field readers. The readers read the record under
+// the cursor, not the matched record, so they are only meaningful while the
+// cursor is on that record; use MatchExpression or ForEachExpressionRecord to
+// read the values of many matches without building a map per row.
 func (v *Vulpo) SearchByExpression(expression string, options *ExprSearchOptions) (*ExprSearchResult, error) {
 	if !v.Active() {
 		return nil, NewError("database not open")
@@ -129,69 +203,30 @@ func (v *Vulpo) SearchByExpression(expression string, options *ExprSearchOptions
 		Matches:    make([]ExprMatch, 0),
 	}
 
-	// Save original position
-	originalPosition := v.Position()
-	defer func() {
-		if originalPosition > 0 {
-			_ = v.Goto(originalPosition) // Ignore error in defer
-		}
-	}()
-
-	// Go to the first record
-	err = v.First()
-	if err != nil {
-		return nil, NewErrorf("failed to go to first record: %v", err)
-	}
+	result.TotalScanned, err = v.eachMatch(filter, options.UseIndex, false, func(rec Record) error {
+		result.Matches = append(result.Matches, ExprMatch{
+			RecordNumber: rec.RecordNumber(),
+			FieldReaders: v.fieldReaderMap(),
+		})
+		result.TotalMatched++
 
-	// Iterate through all records
-	for !v.EOF() {
-		result.TotalScanned++
-
-		// Evaluate the expression for the current record
-		matches, err := filter.Evaluate()
-		if err != nil {
-			return nil, NewErrorf("failed to evaluate expression: %v", err)
-		}
-
-		if matches {
-			// Create field readers for all fields
-			fieldReaders := make(map[string]FieldReader)
-			for i := 0; i < v.FieldCount(); i++ {
-				fieldDef := v.Field(i)
-				if fieldDef != nil {
-					fieldReader, err := v.getFieldReader(fieldDef.Name())
-					if err == nil {
-						fieldReaders[fieldDef.Name()] = fieldReader
-					}
-				}
-			}
-
-			match := ExprMatch{
-				RecordNumber: v.Position(),
-				FieldReaders: fieldReaders,
-			}
-
-			result.Matches = append(result.Matches, match)
-			result.TotalMatched++
-
-			// Check if we've reached the maximum number of results
-			if options.MaxResults > 0 && result.TotalMatched >= options.MaxResults {
-				break
-			}
-		}
-
-		// Move to the next record
-		err = v.Next()
-		if err != nil {
-			break // End of file or error
+		// Check if we've reached the maximum number of results
+		if options.MaxResults > 0 && result.TotalMatched >= options.MaxResults {
+			return errStopScan
 		}
+		return nil
+	})
+	if err != nil && err != errStopScan {
+		return nil, err
 	}
 
 	return result, nil
 }
 
-// CountByExpression counts the number of records matching a dBASE expression
-func (v *Vulpo) CountByExpression(expression string) (int, error) {
+// CountByExpression counts the number of records matching a dBASE expression.
+// An optional ExprSearchOptions with UseIndex set lets tag-covered conditions
+// be answered from the index; MaxResults is ignored.
+func (v *Vulpo) CountByExpression(expression string, options ...*ExprSearchOptions) (int, error) {
 	if !v.Active() {
 		return 0, NewError("database not open")
 	}
@@ -204,56 +239,121 @@ func (v *Vulpo) CountByExpression(expression string) (int, error) {
 	defer filter.Free()
 
 	count := 0
-
-	// Save original position
-	originalPosition := v.Position()
-	defer func() {
-		if originalPosition > 0 {
-			_ = v.Goto(originalPosition) // Ignore error in defer
-		}
-	}()
-
-	// Go to the first record
-	err = v.First()
+	_, err = v.eachMatch(filter, useIndex(options), false, func(Record) error {
+		count++
+		return nil
+	})
 	if err != nil {
-		return 0, NewErrorf("failed to go to first record: %v", err)
+		return 0, err
 	}
 
-	// Iterate through all records
-	for !v.EOF() {
-		// Evaluate the expression for the current record
-		matches, err := filter.Evaluate()
-		if err != nil {
-			return 0, NewErrorf("failed to evaluate expression: %v", err)
-		}
+	return count, nil
+}
 
-		if matches {
-			count++
-		}
+// ForEachExpressionMatch iterates through records matching a dBASE expression.
+// An optional ExprSearchOptions with UseIndex set lets tag-covered conditions
+// be answered from the index; MaxResults is ignored.
+//
+// The callback receives the same map on every call, with the cursor positioned
+// on the matching record; the map must not be retained.
+func (v *Vulpo) ForEachExpressionMatch(expression string, callback func(map[string]FieldReader) error, options ...*ExprSearchOptions) error {
+	if !v.Active() {
+		return NewError("database not open")
+	}
 
-		// Move to the next record
-		err = v.Next()
-		if err != nil {
-			break // End of file or error
-		}
+	// Create expression filter
+	filter, err := v.NewExprFilter(expression)
+	if err != nil {
+		return NewErrorf("failed to create expression filter: %v", err)
 	}
+	defer filter.Free()
 
-	return count, nil
+	// The readers follow the cursor, so one map serves every match
+	var fieldReaders map[string]FieldReader
+
+	_, err = v.eachMatch(filter, useIndex(options), true, func(Record) error {
+		if fieldReaders == nil {
+			fieldReaders = v.fieldReaderMap()
+		}
+		return callback(fieldReaders)
+	})
+	return err
 }
 
-// ForEachExpressionMatch iterates through records matching a dBASE expression
-func (v *Vulpo) ForEachExpressionMatch(expression string, callback func(map[string]FieldReader) error) error {
+// ForEachExpressionRecord calls fn with a Record view of every record matching
+// a dBASE expression, in the current navigation order (record-number order
+// when the index is used). No per-row allocation is made: the view aliases
+// either the memory-mapped file or the CodeBase record buffer and is only
+// valid during the call.
+//
+// Parameters:
+//   - expression: dBASE logical expression
+//   - fn: Callback receiving each matching record; returning an error stops
+//     the iteration and is returned
+//   - options: Optional; UseIndex lets tag-covered conditions be answered from
+//     the index, MaxResults is ignored
+//
+// Returns:
+//   - error: nil on success, the callback's error, or an error if the
+//     expression is invalid or the scan fails
+//
+// The cursor is not guaranteed to be on the matching record during the call;
+// read values from rec. The current position is preserved.
+//
+// Example:
+//
+//	amount := v.FieldDefs().Index("AMOUNT")
+//	total := 0.0
+//	err := v.ForEachExpressionRecord("REGION = 'EU'", func(rec Record) error {
+//		val, err := rec.Float(amount)
+//		total += val
+//		return err
+//	})
+func (v *Vulpo) ForEachExpressionRecord(expression string, fn func(rec Record) error, options ...*ExprSearchOptions) error {
 	if !v.Active() {
 		return NewError("database not open")
 	}
 
-	// Create expression filter
 	filter, err := v.NewExprFilter(expression)
 	if err != nil {
 		return NewErrorf("failed to create expression filter: %v", err)
 	}
 	defer filter.Free()
 
+	_, err = v.eachMatch(filter, useIndex(options), false, fn)
+	return err
+}
+
+// eachMatch calls fn for every record matching filter and returns the number
+// of records visited. With useIndex set, the CodeBase query optimizer is tried
+// first (see queryIndexed). Otherwise compiled filters run over Scan, which
+// does not move the cursor, unless positioned asks for the cursor to be on
+// each match; the remaining filters are evaluated on each record under the
+// cursor. The current position is preserved on every path.
+func (v *Vulpo) eachMatch(filter *ExprFilter, useIndex, positioned bool, fn func(rec Record) error) (int, error) {
+	scanned := 0
+
+	if useIndex {
+		handled, err := v.queryIndexed(filter.exprText, func() error {
+			scanned++
+			return fn(Record{data: v.currentRecord(), recNo: v.Position(), defs: v.fieldDefs})
+		})
+		if handled {
+			return scanned, err
+		}
+	}
+
+	if filter.compiled != nil && !positioned {
+		err := v.Scan(func(rec Record) error {
+			scanned++
+			if !filter.compiled.eval(rec) {
+				return nil
+			}
+			return fn(rec)
+		})
+		return scanned, err
+	}
+
 	// Save original position
 	originalPosition := v.Position()
 	defer func() {
@@ -263,46 +363,34 @@ func (v *Vulpo) ForEachExpressionMatch(expression string, callback func(map[stri
 	}()
 
 	// Go to the first record
-	err = v.First()
-	if err != nil {
-		return NewErrorf("failed to go to first record: %v", err)
+	if err := v.First(); err != nil {
+		return scanned, NewErrorf("failed to go to first record: %v", err)
 	}
 
 	// Iterate through all records
 	for !v.EOF() {
+		scanned++
+
 		// Evaluate the expression for the current record
 		matches, err := filter.Evaluate()
 		if err != nil {
-			return NewErrorf("failed to evaluate expression: %v", err)
+			return scanned, NewErrorf("failed to evaluate expression: %v", err)
 		}
 
 		if matches {
-			// Create field readers for all fields
-			fieldReaders := make(map[string]FieldReader)
-			for i := 0; i < v.FieldCount(); i++ {
-				fieldDef := v.Field(i)
-				if fieldDef != nil {
-					fieldReader, err := v.getFieldReader(fieldDef.Name())
-					if err == nil {
-						fieldReaders[fieldDef.Name()] = fieldReader
-					}
-				}
-			}
-
-			// Call the callback function
-			if err := callback(fieldReaders); err != nil {
-				return err
+			rec := Record{data: v.currentRecord(), recNo: v.Position(), defs: v.fieldDefs}
+			if err := fn(rec); err != nil {
+				return scanned, err
 			}
 		}
 
 		// Move to the next record
-		err = v.Next()
-		if err != nil {
+		if err := v.Next(); err != nil {
 			break // End of file or error
 		}
 	}
 
-	return nil
+	return scanned, nil
 }
 
 // GetExpressionText returns the original expression text
@@ -314,3 +402,23 @@ func (ef *ExprFilter) GetExpressionText() string {
 func (ef *ExprFilter) IsValid() bool {
 	return ef.expr != nil && ef.vulpo != nil
 }
+
+// useIndex reports whether the optional search options ask for index use
+func useIndex(options []*ExprSearchOptions) bool {
+	return len(options) > 0 && options[0] != nil && options[0].UseIndex
+}
+
+// fieldReaderMap returns the field readers for all fields, keyed by name
+func (v *Vulpo) fieldReaderMap() map[string]FieldReader {
+	fieldReaders := make(map[string]FieldReader)
+	for i := 0; i < v.FieldCount(); i++ {
+		fieldDef := v.Field(i)
+		if fieldDef != nil {
+			fieldReader, err := v.getFieldReader(fieldDef.Name())
+			if err == nil {
+				fieldReaders[fieldDef.Name()] = fieldReader
+			}
+		}
+	}
+	return fieldReaders
+}
@@ -0,0 +1,185 @@
+package vulpo
+
+import (
+	"fmt"
+	"sync"
+	"testing"
+)
+
+// exprResults evaluates the logical filter ef and the character expression
+// str on every record of v in physical order.
+func exprResults(t *testing.T, v *Vulpo, ef, str *ExprFilter) ([]bool, []string) {
+	t.Helper()
+
+	header := v.Header()
+	count := int(header.RecordCount())
+	matches := make([]bool, 0, count)
+	values := make([]string, 0, count)
+	for recNo := 1; recNo <= count; recNo++ {
+		if err := v.Goto(recNo); err != nil {
+			t.Errorf("Goto(%d) failed: %v", recNo, err)
+			return nil, nil
+		}
+		match, err := ef.Evaluate()
+		if err != nil {
+			t.Errorf("Evaluate failed: %v", err)
+			return nil, nil
+		}
+		value, err := str.EvaluateAsString()
+		if err != nil {
+			t.Errorf("EvaluateAsString failed: %v", err)
+			return nil, nil
+		}
+		matches = append(matches, match)
+		values = append(values, value)
+	}
+	return matches, values
+}
+
+func TestExprFilter_ConcurrentHandles(t *testing.T) {
+	expressions := []string{
+		"AGE > 40",
+		"UPPER(NAME) > 'M'",
+		"DTOS(BIRTH_DATE) < '19700101'",
+		"AGE < 30 .OR. 'A' $ NAME",
+	}
+
+	type handle struct {
+		v       *Vulpo
+		ef      *ExprFilter
+		str     *ExprFilter
+		matches []bool
+		values  []string
+	}
+
+	handles := make([]*handle, 0, len(expressions))
+	for _, expression := range expressions {
+		v := &Vulpo{}
+		if err := v.Open(testDBFWithIndexPath); err != nil {
+			t.Fatalf("Failed to open test file: %v", err)
+		}
+		defer v.Close()
+
+		ef, err := v.NewExprFilter(expression)
+		if err != nil {
+			t.Fatalf("Failed to parse %q: %v", expression, err)
+		}
+		defer ef.Free()
+
+		str, err := v.NewExprFilter("UPPER(NAME) + DTOS(BIRTH_DATE)")
+		if err != nil {
+			t.Fatalf("Failed to parse character expression: %v", err)
+		}
+		defer str.Free()
+
+		h := &handle{v: v, ef: ef, str: str}
+		h.matches, h.values = exprResults(t, v, ef, str)
+		handles = append(handles, h)
+	}
+
+	var wg sync.WaitGroup
+	for _, h := range handles {
+		wg.Add(1)
+		go func(h *handle) {
+			defer wg.Done()
+			for round := 0; round < 20; round++ {
+				matches, values := exprResults(t, h.v, h.ef, h.str)
+				if matches == nil {
+					return
+				}
+				for i := range h.matches {
+					if matches[i] != h.matches[i] || values[i] != h.values[i] {
+						t.Errorf("%s: record %d evaluated to %v/%q concurrently, %v/%q alone",
+							h.ef.GetExpressionText(), i+1, matches[i], values[i], h.matches[i], h.values[i])
+						return
+					}
+				}
+			}
+		}(h)
+	}
+	wg.Wait()
+}
+
+func TestExprFilter_ConcurrentWrites(t *testing.T) {
+	// A table with tags is written, appended to and walked in tag order
+	// while filters evaluate on other handles: its keys come from the same
+	// expression engine
+	w := &Vulpo{}
+	if err := w.Open(copyTable(t, testDBFWithIndexPath, t.TempDir(), ".dbf", ".cdx")); err != nil {
+		t.Fatalf("Failed to open copy: %v", err)
+	}
+	defer w.Close()
+
+	readers := make([]*Vulpo, 2)
+	filters := make([]*ExprFilter, len(readers))
+	strs := make([]*ExprFilter, len(readers))
+	want := make([][]string, len(readers))
+	for i := range readers {
+		readers[i] = &Vulpo{}
+		if err := readers[i].Open(testDBFWithIndexPath); err != nil {
+			t.Fatalf("Failed to open test file: %v", err)
+		}
+		defer readers[i].Close()
+		var err error
+		if filters[i], err = readers[i].NewExprFilter("AGE < 30 .OR. 'A' $ NAME"); err != nil {
+			t.Fatalf("Failed to parse filter: %v", err)
+		}
+		defer filters[i].Free()
+		if strs[i], err = readers[i].NewExprFilter("UPPER(NAME) + DTOS(BIRTH_DATE)"); err != nil {
+			t.Fatalf("Failed to parse character expression: %v", err)
+		}
+		defer strs[i].Free()
+		_, want[i] = exprResults(t, readers[i], filters[i], strs[i])
+	}
+
+	var wg sync.WaitGroup
+	for i := range readers {
+		wg.Add(1)
+		go func(i int) {
+			defer wg.Done()
+			for round := 0; round < 20; round++ {
+				_, values := exprResults(t, readers[i], filters[i], strs[i])
+				for recNo := range values {
+					if values[recNo] != want[i][recNo] {
+						t.Errorf("Record %d evaluated to %q while writing, %q alone", recNo+1, values[recNo], want[i][recNo])
+						return
+					}
+				}
+			}
+		}(i)
+	}
+	wg.Add(1)
+	go func() {
+		defer wg.Done()
+		if err := w.SelectTag(w.TagByName("INF_NAME")); err != nil {
+			t.Errorf("SelectTag failed: %v", err)
+			return
+		}
+		for round := 0; round < 20; round++ {
+			n := 0
+			for err := w.First(); err == nil && !w.EOF() && n < 50; err = w.Next() {
+				if err := w.FieldByName("NAME").SetString(fmt.Sprintf("WRITTEN%02d%04d", round, n*7919%1000)); err != nil {
+					t.Errorf("SetString failed: %v", err)
+					return
+				}
+				n++
+			}
+			if err := w.Append(func() error { return fillInfo(w, round) }); err != nil {
+				t.Errorf("Append failed: %v", err)
+				return
+			}
+		}
+	}()
+	wg.Wait()
+
+	// The tags hold the keys the records have
+	for _, tag := range w.ListTags() {
+		before := tagOrder(t, w, tag.Name())
+		if err := w.Reindex(nil); err != nil {
+			t.Fatalf("Reindex failed: %v", err)
+		}
+		if after := tagOrder(t, w, tag.Name()); fmt.Sprint(after) != fmt.Sprint(before) {
+			t.Errorf("Tag %s order %v after writes, %v rebuilt", tag.Name(), before, after)
+		}
+	}
+}
@@ -0,0 +1,932 @@
+package vulpo
+
+import (
+	"bytes"
+	"math"
+	"strconv"
+	"strings"
+)
+
+// Native expression compiler.
+//
+// compileExpr translates the common subset of the dBASE expression grammar
+// accepted by expr4parseLow into a tree of Go closures that read field bytes
+// straight from a record image, so filters run without a cgo call per record.
+// Anything outside the subset (aliases, nullable fields, unsupported field
+// types or functions) makes compilation fail, and the ExprFilter keeps using
+// the CodeBase evaluator.
+//
+// The closures reproduce CodeBase's semantics rather than Go's:
+//   - character values have a fixed length; TRIM and ALLTRIM pad with NUL bytes
+//   - string '+' moves the left operand's trailing NUL bytes to the end, so
+//     TRIM(NAME) + 'X' is 'AbbottX' followed by NULs
+//   - '=' compares over the shorter operand, so NAME = 'AB' is a prefix test;
+//     '<' and '>' break ties on length
+//   - string '-' moves the left operand's trailing blanks to the end
+//   - numeric division by zero yields 0
+//   - date arithmetic on a blank date yields a blank date
+//   - .AND. binds tighter than .OR.; .NOT. binds looser than comparisons
+//
+// Compiled trees keep scratch buffers and are not safe for concurrent use.
+
+// exprType is the result type of a compiled (sub-)expression.
+type exprType int
+
+const (
+	exprCharacter exprType = iota
+	exprNumeric
+	exprDate
+	exprLogical
+)
+
+// exprNode is a compiled sub-expression. Exactly one evaluator matching typ is
+// set. Character results are length bytes long; the returned slice may alias
+// the record or a scratch buffer and is only valid until the next evaluation.
+type exprNode struct {
+	typ     exprType
+	length  int
+	str     func(rec Record) []byte
+	num     func(rec Record) float64
+	date    func(rec Record) float64 // Julian day number, 0 for blank
+	dtos    func(rec Record) []byte  // YYYYMMDD bytes, when cheaper than formatting date
+	logical func(rec Record) bool
+
+	constant bool    // numeric literal
+	value    float64 // literal value when constant
+}
+
+// compiledExpr is a logical expression compiled to Go.
+type compiledExpr struct {
+	eval      func(rec Record) bool
+	usesRecNo bool
+}
+
+// compileExpr compiles a logical dBASE expression against the field layout.
+// It returns an error if the expression uses anything the compiler does not
+// support; the caller then falls back to CodeBase.
+func compileExpr(defs *FieldDefs, expression string) (*compiledExpr, error) {
+	tokens, err := tokenizeExpr(expression)
+	if err != nil {
+		return nil, err
+	}
+
+	c := &exprCompiler{defs: defs, tokens: tokens}
+	node, err := c.parseOr()
+	if err != nil {
+		return nil, err
+	}
+	if c.pos != len(c.tokens) {
+		return nil, NewErrorf("unexpected '%s' in expression", c.tokens[c.pos].text)
+	}
+	if node.typ != exprLogical {
+		return nil, NewError("expression is not logical")
+	}
+
+	return &compiledExpr{eval: node.logical, usesRecNo: c.usesRecNo}, nil
+}
+
+// compileCharExpr compiles a character dBASE expression against the field
+// layout and returns its evaluator and fixed result length. It returns an
+// error if the expression is not of character type or uses anything the
+// compiler does not support.
+func compileCharExpr(defs *FieldDefs, expression string) (func(rec Record) []byte, int, error) {
+	tokens, err := tokenizeExpr(expression)
+	if err != nil {
+		return nil, 0, err
+	}
+
+	c := &exprCompiler{defs: defs, tokens: tokens}
+	node, err := c.parseOr()
+	if err != nil {
+		return nil, 0, err
+	}
+	if c.pos != len(c.tokens) {
+		return nil, 0, NewErrorf("unexpected '%s' in expression", c.tokens[c.pos].text)
+	}
+	if node.typ != exprCharacter {
+		return nil, 0, NewError("expression is not of character type")
+	}
+
+	return node.str, node.length, nil
+}
+
+// Tokenizer
+
+type exprTokenKind int
+
+const (
+	tokNumber exprTokenKind = iota
+	tokString
+	tokIdent
+	tokOperator // = <> # < > <= >= $ + - * / ( ) ,
+	tokDot      // .AND. .OR. .NOT. .T. .F. .TRUE. .FALSE. (text upper-cased)
+)
+
+type exprToken struct {
+	kind exprTokenKind
+	text string
+}
+
+// tokenizeExpr splits an expression into tokens.
+func tokenizeExpr(expression string) ([]exprToken, error) {
+	var tokens []exprToken
+	s := expression
+
+	for i := 0; i < len(s); {
+		ch := s[i]
+		switch {
+		case ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n':
+			i++
+
+		case ch == '\'' || ch == '"' || ch == '[':
+			closing := ch
+			if ch == '[' {
+				closing = ']'
+			}
+			end := strings.IndexByte(s[i+1:], closing)
+			if end < 0 {
+				return nil, NewError("unterminated string literal")
+			}
+			tokens = append(tokens, exprToken{tokString, s[i+1 : i+1+end]})
+			i += end + 2
+
+		case isDigit(ch) || ch == '.' && i+1 < len(s) && isDigit(s[i+1]):
+			start := i
+			for i < len(s) && isDigit(s[i]) {
+				i++
+			}
+			// A '.' belongs to the number unless it starts an operator like .AND.
+			if i < len(s) && s[i] == '.' && (i+1 >= len(s) || !isLetter(s[i+1])) {
+				i++
+				for i < len(s) && isDigit(s[i]) {
+					i++
+				}
+			}
+			if i < len(s) && (isLetter(s[i]) || s[i] == '_') {
+				return nil, NewErrorf("invalid number near '%s'", s[start:])
+			}
+			tokens = append(tokens, exprToken{tokNumber, s[start:i]})
+
+		case ch == '.':
+			end := strings.IndexByte(s[i+1:], '.')
+			if end < 0 {
+				return nil, NewError("unterminated operator")
+			}
+			word := strings.ToUpper(s[i : i+end+2])
+			switch word {
+			case ".AND.", ".OR.", ".NOT.", ".T.", ".F.", ".TRUE.", ".FALSE.":
+			default:
+				return nil, NewErrorf("unsupported operator '%s'", word)
+			}
+			tokens = append(tokens, exprToken{tokDot, word})
+			i += end + 2
+
+		case isLetter(ch) || ch == '_':
+			start := i
+			for i < len(s) && (isLetter(s[i]) || isDigit(s[i]) || s[i] == '_') {
+				i++
+			}
+			tokens = append(tokens, exprToken{tokIdent, s[start:i]})
+
+		case ch == '<' || ch == '>':
+			if i+1 < len(s) && (s[i+1] == '=' || ch == '<' && s[i+1] == '>') {
+				tokens = append(tokens, exprToken{tokOperator, s[i : i+2]})
+				i += 2
+			} else {
+				tokens = append(tokens, exprToken{tokOperator, s[i : i+1]})
+				i++
+			}
+
+		case strings.IndexByte("=#$+-*/(),", ch) >= 0:
+			// '==', '**' and '->' are not part of the compiled subset
+			if i+1 < len(s) && (ch == '=' && s[i+1] == '=' || ch == '*' && s[i+1] == '*' || ch == '-' && s[i+1] == '>') {
+				return nil, NewErrorf("unsupported operator '%s'", s[i:i+2])
+			}
+			tokens = append(tokens, exprToken{tokOperator, s[i : i+1]})
+			i++
+
+		default:
+			return nil, NewErrorf("unsupported character '%c'", ch)
+		}
+	}
+
+	return tokens, nil
+}
+
+func isDigit(ch byte) bool {
+	return ch >= '0' && ch <= '9'
+}
+
+func isLetter(ch byte) bool {
+	return ch >= 'a' && ch <= 'z' || ch >= 'A' && ch <= 'Z'
+}
+
+// Parser
+
+type exprCompiler struct {
+	defs      *FieldDefs
+	tokens    []exprToken
+	pos       int
+	usesRecNo bool
+}
+
+func (c *exprCompiler) peek() *exprToken {
+	if c.pos >= len(c.tokens) {
+		return nil
+	}
+	return &c.tokens[c.pos]
+}
+
+// accept consumes the next token if it has the given kind and text.
+func (c *exprCompiler) accept(kind exprTokenKind, text string) bool {
+	if tok := c.peek(); tok != nil && tok.kind == kind && tok.text == text {
+		c.pos++
+		return true
+	}
+	return false
+}
+
+func (c *exprCompiler) expect(text string) error {
+	if !c.accept(tokOperator, text) {
+		return NewErrorf("expected '%s'", text)
+	}
+	return nil
+}
+
+// parseOr parses: and { .OR. and }
+func (c *exprCompiler) parseOr() (*exprNode, error) {
+	left, err := c.parseAnd()
+	if err != nil {
+		return nil, err
+	}
+	for c.accept(tokDot, ".OR.") {
+		right, err := c.parseAnd()
+		if err != nil {
+			return nil, err
+		}
+		if left.typ != exprLogical || right.typ != exprLogical {
+			return nil, NewError(".OR. requires logical operands")
+		}
+		l, r := left.logical, right.logical
+		left = &exprNode{typ: exprLogical, logical: func(rec Record) bool { return l(rec) || r(rec) }}
+	}
+	return left, nil
+}
+
+// parseAnd parses: not { .AND. not }
+func (c *exprCompiler) parseAnd() (*exprNode, error) {
+	left, err := c.parseNot()
+	if err != nil {
+		return nil, err
+	}
+	for c.accept(tokDot, ".AND.") {
+		right, err := c.parseNot()
+		if err != nil {
+			return nil, err
+		}
+		if left.typ != exprLogical || right.typ != exprLogical {
+			return nil, NewError(".AND. requires logical operands")
+		}
+		l, r := left.logical, right.logical
+		left = &exprNode{typ: exprLogical, logical: func(rec Record) bool { return l(rec) && r(rec) }}
+	}
+	return left, nil
+}
+
+// parseNot parses: .NOT. not | comparison
+func (c *exprCompiler) parseNot() (*exprNode, error) {
+	if !c.accept(tokDot, ".NOT.") {
+		return c.parseComparison()
+	}
+	operand, err := c.parseNot()
+	if err != nil {
+		return nil, err
+	}
+	if operand.typ != exprLogical {
+		return nil, NewError(".NOT. requires a logical operand")
+	}
+	l := operand.logical
+	return &exprNode{typ: exprLogical, logical: func(rec Record) bool { return !l(rec) }}, nil
+}
+
+// parseComparison parses: additive { op additive }
+func (c *exprCompiler) parseComparison() (*exprNode, error) {
+	left, err := c.parseAdditive()
+	if err != nil {
+		return nil, err
+	}
+	for {
+		tok := c.peek()
+		if tok == nil || tok.kind != tokOperator {
+			return left, nil
+		}
+		op := tok.text
+		switch op {
+		case "=", "<>", "#", "<", ">", "<=", ">=", "$":
+		default:
+			return left, nil
+		}
+		c.pos++
+
+		right, err := c.parseAdditive()
+		if err != nil {
+			return nil, err
+		}
+		if left, err = compareNodes(op, left, right); err != nil {
+			return nil, err
+		}
+	}
+}
+
+// parseAdditive parses: multiplicative { (+|-) multiplicative }
+func (c *exprCompiler) parseAdditive() (*exprNode, error) {
+	left, err := c.parseMultiplicative()
+	if err != nil {
+		return nil, err
+	}
+	for {
+		var op string
+		switch {
+		case c.accept(tokOperator, "+"):
+			op = "+"
+		case c.accept(tokOperator, "-"):
+			op = "-"
+		default:
+			return left, nil
+		}
+
+		right, err := c.parseMultiplicative()
+		if err != nil {
+			return nil, err
+		}
+		if left, err = addNodes(op, left, right); err != nil {
+			return nil, err
+		}
+	}
+}
+
+// parseMultiplicative parses: unary { (*|/) unary }
+func (c *exprCompiler) parseMultiplicative() (*exprNode, error) {
+	left, err := c.parseUnary()
+	if err != nil {
+		return nil, err
+	}
+	for {
+		var op string
+		switch {
+		case c.accept(tokOperator, "*"):
+			op = "*"
+		case c.accept(tokOperator, "/"):
+			op = "/"
+		default:
+			return left, nil
+		}
+
+		right, err := c.parseUnary()
+		if err != nil {
+			return nil, err
+		}
+		if left.typ != exprNumeric || right.typ != exprNumeric {
+			return nil, NewErrorf("'%s' requires numeric operands", op)
+		}
+		l, r := left.num, right.num
+		if op == "*" {
+			left = &exprNode{typ: exprNumeric, num: func(rec Record) float64 { return l(rec) * r(rec) }}
+		} else {
+			left = &exprNode{typ: exprNumeric, num: func(rec Record) float64 {
+				d := r(rec)
+				if d == 0 {
+					return 0
+				}
+				return l(rec) / d
+			}}
+		}
+	}
+}
+
+// parseUnary parses a primary, allowing a minus sign only on numeric literals
+// as CodeBase does.
+func (c *exprCompiler) parseUnary() (*exprNode, error) {
+	if c.accept(tokOperator, "-") {
+		tok := c.peek()
+		if tok == nil || tok.kind != tokNumber {
+			return nil, NewError("unary minus is only supported on numeric literals")
+		}
+		c.pos++
+		return numericLiteral("-" + tok.text)
+	}
+	return c.parsePrimary()
+}
+
+// parsePrimary parses literals, parenthesized expressions, fields and functions.
+func (c *exprCompiler) parsePrimary() (*exprNode, error) {
+	tok := c.peek()
+	if tok == nil {
+		return nil, NewError("unexpected end of expression")
+	}
+	c.pos++
+
+	switch tok.kind {
+	case tokNumber:
+		return numericLiteral(tok.text)
+
+	case tokString:
+		val := []byte(tok.text)
+		return &exprNode{typ: exprCharacter, length: len(val), str: func(Record) []byte { return val }}, nil
+
+	case tokDot:
+		var val bool
+		switch tok.text {
+		case ".T.", ".TRUE.":
+			val = true
+		case ".F.", ".FALSE.":
+			val = false
+		default:
+			return nil, NewErrorf("unexpected '%s'", tok.text)
+		}
+		return &exprNode{typ: exprLogical, logical: func(Record) bool { return val }}, nil
+
+	case tokOperator:
+		if tok.text != "(" {
+			return nil, NewErrorf("unexpected '%s'", tok.text)
+		}
+		node, err := c.parseOr()
+		if err != nil {
+			return nil, err
+		}
+		return node, c.expect(")")
+
+	case tokIdent:
+		if c.accept(tokOperator, "(") {
+			return c.parseFunction(strings.ToUpper(tok.text))
+		}
+		return c.fieldNode(tok.text)
+	}
+
+	return nil, NewErrorf("unexpected '%s'", tok.text)
+}
+
+// parseFunction parses the arguments of a function call and compiles it.
+func (c *exprCompiler) parseFunction(name string) (*exprNode, error) {
+	var args []*exprNode
+	if !c.accept(tokOperator, ")") {
+		for {
+			arg, err := c.parseOr()
+			if err != nil {
+				return nil, err
+			}
+			args = append(args, arg)
+			if c.accept(tokOperator, ")") {
+				break
+			}
+			if err := c.expect(","); err != nil {
+				return nil, err
+			}
+		}
+	}
+
+	switch name {
+	case "DELETED":
+		if len(args) != 0 {
+			return nil, NewError("DELETED() takes no arguments")
+		}
+		return &exprNode{typ: exprLogical, logical: func(rec Record) bool { return rec.Deleted() }}, nil
+
+	case "RECNO":
+		if len(args) != 0 {
+			return nil, NewError("RECNO() takes no arguments")
+		}
+		c.usesRecNo = true
+		return &exprNode{typ: exprNumeric, num: func(rec Record) float64 { return float64(rec.recNo) }}, nil
+
+	case "UPPER":
+		if len(args) != 1 || args[0].typ != exprCharacter {
+			return nil, NewError("UPPER() requires one character argument")
+		}
+		return upperNode(args[0]), nil
+
+	case "TRIM":
+		if len(args) != 1 || args[0].typ != exprCharacter {
+			return nil, NewError("TRIM() requires one character argument")
+		}
+		return trimNode(args[0]), nil
+
+	case "ALLTRIM":
+		if len(args) != 1 || args[0].typ != exprCharacter {
+			return nil, NewError("ALLTRIM() requires one character argument")
+		}
+		return allTrimNode(args[0]), nil
+
+	case "SUBSTR":
+		if len(args) < 2 || len(args) > 3 || args[0].typ != exprCharacter {
+			return nil, NewError("SUBSTR() requires a character argument and constant positions")
+		}
+		for _, arg := range args[1:] {
+			if !arg.constant {
+				return nil, NewError("SUBSTR() requires constant positions")
+			}
+		}
+		count := -1
+		if len(args) == 3 {
+			count = int(args[2].value)
+		}
+		return substrNode(args[0], int(args[1].value), count), nil
+
+	case "DTOS":
+		if len(args) != 1 || args[0].typ != exprDate {
+			return nil, NewError("DTOS() requires one date argument")
+		}
+		return dtosNode(args[0]), nil
+
+	case "VAL":
+		if len(args) != 1 || args[0].typ != exprCharacter {
+			return nil, NewError("VAL() requires one character argument")
+		}
+		str := args[0].str
+		return &exprNode{typ: exprNumeric, num: func(rec Record) float64 { return parseValPrefix(str(rec)) }}, nil
+	}
+
+	return nil, NewErrorf("function %s() is not supported by the compiler", name)
+}
+
+// fieldNode compiles a field reference.
+func (c *exprCompiler) fieldNode(name string) (*exprNode, error) {
+	def := c.defs.ByName(name)
+	if def == nil {
+		return nil, NewErrorf("field '%s' not found", name)
+	}
+	if def.nullable {
+		return nil, NewErrorf("field '%s' is nullable", name)
+	}
+
+	start, end := def.offset, def.offset+def.length
+	raw := func(rec Record) []byte { return rec.data[start:end] }
+
+	switch def.Type() {
+	case FTCharacter:
+		return &exprNode{typ: exprCharacter, length: def.length, str: raw}, nil
+	case FTNumeric, FTFloat:
+		return &exprNode{typ: exprNumeric, num: func(rec Record) float64 { return decodeNumeric(raw(rec)) }}, nil
+	case FTInteger:
+		return &exprNode{typ: exprNumeric, num: func(rec Record) float64 { return float64(decodeInteger(raw(rec))) }}, nil
+	case FTDate:
+		return &exprNode{
+			typ:  exprDate,
+			date: func(rec Record) float64 { return float64(decodeDateJulian(raw(rec))) },
+			dtos: raw,
+		}, nil
+	case FTLogical:
+		return &exprNode{typ: exprLogical, logical: func(rec Record) bool { return decodeLogical(raw(rec)) }}, nil
+	}
+
+	return nil, NewErrorf("field '%s' of type %s is not supported by the compiler", name, def.Type().Name())
+}
+
+// numericLiteral compiles a numeric constant.
+func numericLiteral(text string) (*exprNode, error) {
+	val, err := strconv.ParseFloat(text, 64)
+	if err != nil {
+		return nil, NewErrorf("invalid number '%s'", text)
+	}
+	return &exprNode{typ: exprNumeric, num: func(Record) float64 { return val }, constant: true, value: val}, nil
+}
+
+// compareNodes compiles a comparison or the '$' operator.
+func compareNodes(op string, left, right *exprNode) (*exprNode, error) {
+	if left.typ != right.typ {
+		return nil, NewErrorf("'%s' requires operands of the same type", op)
+	}
+
+	logical := func(fn func(rec Record) bool) *exprNode {
+		return &exprNode{typ: exprLogical, logical: fn}
+	}
+
+	switch left.typ {
+	case exprCharacter:
+		l, r := left.str, right.str
+		if op == "$" {
+			// CodeBase's result for an empty left operand is unreliable
+			if left.length == 0 {
+				return nil, NewError("'$' with an empty operand is not supported by the compiler")
+			}
+			return logical(func(rec Record) bool { return bytes.Contains(r(rec), l(rec)) }), nil
+		}
+		cmp := func(rec Record) int {
+			a, b := l(rec), r(rec)
+			n := min(len(a), len(b))
+			return bytes.Compare(a[:n], b[:n])
+		}
+		switch op {
+		case "=":
+			return logical(func(rec Record) bool { return cmp(rec) == 0 }), nil
+		case "<>", "#":
+			return logical(func(rec Record) bool { return cmp(rec) != 0 }), nil
+		case "<=":
+			return logical(func(rec Record) bool { return cmp(rec) <= 0 }), nil
+		case ">=":
+			return logical(func(rec Record) bool { return cmp(rec) >= 0 }), nil
+		case "<":
+			return logical(func(rec Record) bool {
+				a, b := l(rec), r(rec)
+				n := min(len(a), len(b))
+				res := bytes.Compare(a[:n], b[:n])
+				return res < 0 || res == 0 && len(a) < len(b)
+			}), nil
+		case ">":
+			return logical(func(rec Record) bool {
+				a, b := l(rec), r(rec)
+				n := min(len(a), len(b))
+				res := bytes.Compare(a[:n], b[:n])
+				return res > 0 || res == 0 && len(a) > len(b)
+			}), nil
+		}
+
+	case exprNumeric, exprDate:
+		l, r := left.num, right.num
+		if left.typ == exprDate {
+			l, r = left.date, right.date
+		}
+		switch op {
+		case "=":
+			return logical(func(rec Record) bool { return l(rec) == r(rec) }), nil
+		case "<>", "#":
+			return logical(func(rec Record) bool { return l(rec) != r(rec) }), nil
+		case "<":
+			return logical(func(rec Record) bool { return l(rec) < r(rec) }), nil
+		case ">":
+			return logical(func(rec Record) bool { return l(rec) > r(rec) }), nil
+		case "<=":
+			return logical(func(rec Record) bool { return l(rec) <= r(rec) }), nil
+		case ">=":
+			return logical(func(rec Record) bool { return l(rec) >= r(rec) }), nil
+		}
+
+	case exprLogical:
+		l, r := left.logical, right.logical
+		switch op {
+		case "=":
+			return logical(func(rec Record) bool { return l(rec) == r(rec) }), nil
+		case "<>", "#":
+			return logical(func(rec Record) bool { return l(rec) != r(rec) }), nil
+		}
+	}
+
+	return nil, NewErrorf("'%s' is not supported for these operands", op)
+}
+
+// addNodes compiles '+' and '-' for numbers, dates and strings.
+func addNodes(op string, left, right *exprNode) (*exprNode, error) {
+	switch {
+	case left.typ == exprNumeric && right.typ == exprNumeric:
+		l, r := left.num, right.num
+		if op == "+" {
+			return &exprNode{typ: exprNumeric, num: func(rec Record) float64 { return l(rec) + r(rec) }}, nil
+		}
+		return &exprNode{typ: exprNumeric, num: func(rec Record) float64 { return l(rec) - r(rec) }}, nil
+
+	// Date arithmetic on a blank date yields a blank date (or 0 for a difference)
+	case left.typ == exprDate && right.typ == exprNumeric:
+		l, r := left.date, right.num
+		sign := 1.0
+		if op == "-" {
+			sign = -1
+		}
+		return &exprNode{typ: exprDate, date: func(rec Record) float64 {
+			if d := l(rec); d != 0 {
+				return d + sign*r(rec)
+			}
+			return 0
+		}}, nil
+
+	case left.typ == exprNumeric && right.typ == exprDate && op == "+":
+		l, r := left.num, right.date
+		return &exprNode{typ: exprDate, date: func(rec Record) float64 {
+			if d := r(rec); d != 0 {
+				return l(rec) + d
+			}
+			return 0
+		}}, nil
+
+	case left.typ == exprDate && right.typ == exprDate && op == "-":
+		l, r := left.date, right.date
+		return &exprNode{typ: exprNumeric, num: func(rec Record) float64 {
+			if d := l(rec); d != 0 {
+				return d - r(rec)
+			}
+			return 0
+		}}, nil
+
+	case left.typ == exprCharacter && right.typ == exprCharacter:
+		l, r := left.str, right.str
+		length := left.length + right.length
+		buf := make([]byte, length)
+		if op == "+" {
+			return &exprNode{typ: exprCharacter, length: length, str: func(rec Record) []byte {
+				a := l(rec)
+				content := len(a)
+				for content > 0 && a[content-1] == 0 {
+					content--
+				}
+				n := copy(buf, a[:content])
+				n += copy(buf[n:], r(rec))
+				clear(buf[n:])
+				return buf
+			}}, nil
+		}
+		return &exprNode{typ: exprCharacter, length: length, str: func(rec Record) []byte {
+			a := l(rec)
+			trimmed := len(bytes.TrimRight(a, " "))
+			n := copy(buf, a[:trimmed])
+			n += copy(buf[n:], r(rec))
+			for i := n; i < len(buf); i++ {
+				buf[i] = ' '
+			}
+			return buf
+		}}, nil
+	}
+
+	return nil, NewErrorf("'%s' is not supported for these operands", op)
+}
+
+// upperNode compiles UPPER(): ASCII letters are upper-cased in place.
+func upperNode(arg *exprNode) *exprNode {
+	str := arg.str
+	buf := make([]byte, arg.length)
+	return &exprNode{typ: exprCharacter, length: arg.length, str: func(rec Record) []byte {
+		for i, ch := range str(rec) {
+			if ch >= 'a' && ch <= 'z' {
+				ch -= 'a' - 'A'
+			}
+			buf[i] = ch
+		}
+		return buf
+	}}
+}
+
+// trimNode compiles TRIM(): trailing blanks are replaced by NUL bytes, keeping
+// the result length fixed.
+func trimNode(arg *exprNode) *exprNode {
+	str := arg.str
+	buf := make([]byte, arg.length)
+	return &exprNode{typ: exprCharacter, length: arg.length, str: func(rec Record) []byte {
+		src := str(rec)
+		n := len(src)
+		for n > 0 && (src[n-1] == ' ' || src[n-1] == 0) {
+			n--
+		}
+		copy(buf, src[:n])
+		clear(buf[n:])
+		return buf
+	}}
+}
+
+// allTrimNode compiles ALLTRIM(): leading blanks are dropped and the rest is
+// trimmed as by TRIM(), keeping the result length fixed.
+func allTrimNode(arg *exprNode) *exprNode {
+	str := arg.str
+	buf := make([]byte, arg.length)
+	return &exprNode{typ: exprCharacter, length: arg.length, str: func(rec Record) []byte {
+		src := str(rec)
+		start, end := 0, len(src)
+		for end > 0 && (src[end-1] == ' ' || src[end-1] == 0) {
+			end--
+		}
+		for start < end && src[start] == ' ' {
+			start++
+		}
+		n := copy(buf, src[start:end])
+		clear(buf[n:])
+		return buf
+	}}
+}
+
+// substrNode compiles SUBSTR() with constant positions. Like CodeBase, a start
+// before 1 is treated as 1 and the length is clamped to the argument.
+func substrNode(arg *exprNode, start, count int) *exprNode {
+	offset := min(max(start, 1)-1, arg.length)
+	if count < 0 || count > arg.length-offset {
+		count = arg.length - offset
+	}
+	end := offset + count
+	str := arg.str
+	return &exprNode{typ: exprCharacter, length: count, str: func(rec Record) []byte {
+		return str(rec)[offset:end]
+	}}
+}
+
+// dtosNode compiles DTOS(). Date fields are already stored as YYYYMMDD.
+func dtosNode(arg *exprNode) *exprNode {
+	if arg.dtos != nil {
+		return &exprNode{typ: exprCharacter, length: 8, str: arg.dtos}
+	}
+
+	date := arg.date
+	buf := make([]byte, 8)
+	return &exprNode{typ: exprCharacter, length: 8, str: func(rec Record) []byte {
+		jd := int(date(rec))
+		if jd <= 0 {
+			copy(buf, "        ")
+			return buf
+		}
+		y, m, d := JulianToYMD(jd)
+		val := y*10000 + m*100 + d
+		for i := 7; i >= 0; i-- {
+			buf[i] = byte('0' + val%10)
+			val /= 10
+		}
+		return buf
+	}}
+}
+
+// parseValPrefix converts the leading numeric part of s like C's strtod,
+// which CodeBase's VAL() uses: leading white space is skipped and hexadecimal,
+// infinity and NaN forms are accepted. Unparseable input yields 0.
+func parseValPrefix(s []byte) float64 {
+	i := 0
+	for i < len(s) && (s[i] == ' ' || s[i] >= '\t' && s[i] <= '\r') {
+		i++
+	}
+	s = s[i:]
+
+	sign := 1.0
+	body := s
+	if len(body) > 0 && (body[0] == '+' || body[0] == '-') {
+		if body[0] == '-' {
+			sign = -1
+		}
+		body = body[1:]
+	}
+
+	switch {
+	case hasPrefixFold(body, "infinity"), hasPrefixFold(body, "inf"):
+		return sign * math.Inf(1)
+	case hasPrefixFold(body, "nan"):
+		return math.NaN()
+	case len(body) > 2 && body[0] == '0' && (body[1] == 'x' || body[1] == 'X'):
+		if val, ok := parseHexPrefix(body[2:]); ok {
+			return sign * val
+		}
+		return 0 // "0x" alone parses as 0
+	}
+
+	end := numericPrefixLen(s)
+	if end == 0 {
+		return 0
+	}
+	val, err := strconv.ParseFloat(string(s[:end]), 64)
+	if err != nil && !math.IsInf(val, 0) {
+		return 0
+	}
+	return val
+}
+
+// parseHexPrefix parses hex digits with an optional fraction and binary
+// exponent, as strtod does after a "0x" prefix.
+func parseHexPrefix(s []byte) (float64, bool) {
+	isHex := func(ch byte) bool {
+		return isDigit(ch) || ch >= 'a' && ch <= 'f' || ch >= 'A' && ch <= 'F'
+	}
+
+	i, digits := 0, 0
+	for i < len(s) && isHex(s[i]) {
+		i++
+		digits++
+	}
+	if i < len(s) && s[i] == '.' {
+		i++
+		for i < len(s) && isHex(s[i]) {
+			i++
+			digits++
+		}
+	}
+	if digits == 0 {
+		return 0, false
+	}
+	mantissa := string(s[:i])
+
+	exponent := "p0"
+	if i < len(s) && (s[i] == 'p' || s[i] == 'P') {
+		j := i + 1
+		if j < len(s) && (s[j] == '+' || s[j] == '-') {
+			j++
+		}
+		expStart := j
+		for j < len(s) && isDigit(s[j]) {
+			j++
+		}
+		if j > expStart {
+			exponent = "p" + string(s[i+1:j])
+		}
+	}
+
+	val, err := strconv.ParseFloat("0x"+mantissa+exponent, 64)
+	if err != nil && !math.IsInf(val, 0) {
+		return 0, false
+	}
+	return val, true
+}
+
+// hasPrefixFold reports whether s begins with prefix, ignoring ASCII case.
+func hasPrefixFold(s []byte, prefix string) bool {
+	return len(s) >= len(prefix) && strings.EqualFold(string(s[:len(prefix)]), prefix)
+}
@@ -0,0 +1,273 @@
+package vulpo
+
+import (
+	"math"
+	"path/filepath"
+	"strings"
+	"testing"
+)
+
+// exprParityCases returns expressions exercising every compiled operator and
+// function against the fields of v.
+func exprParityCases(v *Vulpo) []string {
+	cases := []string{
+		"DELETED()",
+		".NOT. DELETED() .AND. RECNO() > 2",
+		"RECNO() = 1 .OR. RECNO() = 3 .AND. .F.",
+		".T. .AND. .NOT. .F.",
+	}
+
+	for i := 0; i < v.FieldCount(); i++ {
+		def := v.FieldDefs().ByIndex(i)
+		if def.IsNullable() {
+			continue
+		}
+		f := def.Name()
+		switch def.Type() {
+		case FTCharacter:
+			cases = append(cases,
+				f+" = 'A'", f+" = ''", f+" <> 'M'", f+" # 'M'", f+" > 'M'", f+" < 'M'",
+				f+" >= 'B'", f+" <= 'B'", f+" > ''", "'a' $ "+f, f+" $ 'abcdefghij'",
+				"UPPER("+f+") = 'A'", "UPPER("+f+") > 'M'", "TRIM("+f+") = ''",
+				"TRIM("+f+") < "+f, "TRIM("+f+") + 'X' $ "+f+" + 'X'", f+" - 'x' > "+f+" + 'x'",
+				"SUBSTR("+f+", 2, 3) > 'b'", "SUBSTR("+f+", 0, 2) = SUBSTR("+f+", 1)",
+				"SUBSTR("+f+", 300, 2) = ''", "VAL("+f+") > 0", "VAL(SUBSTR("+f+", 2)) = 0",
+				"UPPER(TRIM("+f+")) = TRIM(UPPER("+f+"))", f+" = "+f,
+				"TRIM("+f+") + 'X' = "+f+" + 'X'", "TRIM("+f+") + 'X' < "+f, "'X' + TRIM("+f+") + 'X' > 'X' + "+f,
+				"TRIM("+f+") + ' ' + 'Y' < "+f+" + 'Y'", "ALLTRIM("+f+") = TRIM("+f+")", "ALLTRIM("+f+") + 'X' < "+f,
+				"ALLTRIM("+f+") + TRIM("+f+") = TRIM("+f+") + ALLTRIM("+f+")",
+			)
+		case FTNumeric, FTFloat, FTInteger:
+			cases = append(cases,
+				f+" > 0", f+" = 0", f+" <> 21", f+" * 2 - 1 >= "+f+" / 3", f+" / 0 = 0",
+				f+" - 10 * 2 = 1", f+" + -1.5 < .5", f+" >= 20 .AND. "+f+" <= 40", f+">1.AND."+f+"<50",
+			)
+		case FTDate:
+			cases = append(cases,
+				"DTOS("+f+") > '2000'", "DTOS("+f+") = ''", f+" > "+f+" - 30", f+" - "+f+" = 0",
+				"DTOS("+f+" + 1) > DTOS("+f+")", "1 + "+f+" >= "+f, "VAL(SUBSTR(DTOS("+f+"), 1, 4)) > 1990",
+				"DTOS("+f+" - 30) < DTOS("+f+")", f+" - "+f+" + 1 = 1",
+			)
+		case FTLogical:
+			cases = append(cases, f, ".NOT. "+f, f+" = .T.", f+" <> .F. .OR. DELETED()")
+		}
+	}
+	return cases
+}
+
+func TestExprFilter_CompiledMatchesCodeBase(t *testing.T) {
+	// CodeBase only resolves upper-case field names, so use the sample tables
+	files, _ := filepath.Glob("mkfdbflib/data/*.dbf")
+
+	for _, file := range files {
+		t.Run(file, func(t *testing.T) {
+			v := &Vulpo{}
+			if err := v.Open(file); err != nil {
+				t.Skipf("Cannot open %s: %v", file, err)
+			}
+			defer v.Close()
+
+			header := v.Header()
+			for _, expression := range exprParityCases(v) {
+				filter, err := v.NewExprFilter(expression)
+				if err != nil {
+					t.Errorf("Failed to parse %q: %v", expression, err)
+					continue
+				}
+				if !filter.Compiled() {
+					t.Errorf("Expected %q to compile", expression)
+					filter.Free()
+					continue
+				}
+
+				for recNo := 1; recNo <= int(header.RecordCount()); recNo++ {
+					if err := v.Goto(recNo); err != nil {
+						t.Fatalf("Goto(%d) failed: %v", recNo, err)
+					}
+					got, _ := filter.Evaluate()
+					if want := filter.evaluateC(); got != want {
+						t.Errorf("%q on record %d: compiled %v, CodeBase %v", expression, recNo, got, want)
+					}
+				}
+				filter.Free()
+			}
+		})
+	}
+}
+
+func TestExprFilter_TrimConcatenationKeys(t *testing.T) {
+	// CodeBase moves the NUL bytes TRIM leaves behind the concatenated text,
+	// so TRIM(NAME) + 'X' = 'AbbottX' finds the record named Abbott
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	name, err := v.NewExprFilter("NAME")
+	if err != nil {
+		t.Fatalf("Failed to parse NAME: %v", err)
+	}
+	defer name.Free()
+
+	header := v.Header()
+	for recNo := 1; recNo <= 3; recNo++ {
+		if err := v.Goto(recNo); err != nil {
+			t.Fatalf("Goto(%d) failed: %v", recNo, err)
+		}
+		value, err := name.EvaluateAsString()
+		if err != nil {
+			t.Fatalf("EvaluateAsString failed: %v", err)
+		}
+		key := strings.TrimRight(value, " ")
+
+		for _, expression := range []string{
+			"TRIM(NAME) + 'X' = '" + key + "X'",
+			"TRIM(NAME) + ' ' + 'Y' = '" + key + " Y'",
+			"'" + key + "X' = TRIM(NAME) + 'X'",
+			"ALLTRIM(NAME) + 'X' = '" + key + "X'",
+			"TRIM(NAME) + 'X' < '" + key + "Y'",
+		} {
+			filter, err := v.NewExprFilter(expression)
+			if err != nil {
+				t.Fatalf("Failed to parse %q: %v", expression, err)
+			}
+			if !filter.Compiled() {
+				t.Errorf("Expected %q to compile", expression)
+			}
+
+			want := 0
+			for n := 1; n <= int(header.RecordCount()); n++ {
+				if err := v.Goto(n); err != nil {
+					t.Fatalf("Goto(%d) failed: %v", n, err)
+				}
+				if filter.evaluateC() {
+					want++
+				}
+			}
+			filter.Free()
+
+			got, err := v.CountByExpression(expression)
+			if err != nil || got != want || want == 0 {
+				t.Errorf("CountByExpression(%q) = %d, %v; CodeBase counts %d", expression, got, err, want)
+			}
+		}
+	}
+}
+
+func TestExprFilter_CompilerFallback(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	// Valid for CodeBase but outside the compiled subset
+	for _, expression := range []string{"YEAR(BIRTH_DATE) = 1969", "LEFT(NAME, 3) = 'Abb'", "LTRIM(NAME) = 'Abbott'"} {
+		filter, err := v.NewExprFilter(expression)
+		if err != nil {
+			t.Fatalf("Failed to parse %q: %v", expression, err)
+		}
+		if filter.Compiled() {
+			t.Errorf("Expected %q to fall back to CodeBase", expression)
+		}
+
+		want, err := v.CountByExpression(expression)
+		if err != nil {
+			t.Fatalf("CountByExpression(%q) failed: %v", expression, err)
+		}
+		if want == 0 {
+			t.Errorf("Expected matches for %q", expression)
+		}
+		filter.Free()
+	}
+
+	// Non-logical expressions are not compiled
+	filter, err := v.NewExprFilter("UPPER(NAME)")
+	if err != nil {
+		t.Fatalf("Failed to parse: %v", err)
+	}
+	if filter.Compiled() {
+		t.Error("Expected character expression not to be compiled")
+	}
+	filter.Free()
+}
+
+func TestVulpo_SearchByExpression_Compiled(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	expression := "AGE > 40 .AND. 'e' $ NAME"
+	count, err := v.CountByExpression(expression)
+	if err != nil {
+		t.Fatalf("CountByExpression failed: %v", err)
+	}
+
+	result, err := v.SearchByExpression(expression, nil)
+	if err != nil {
+		t.Fatalf("SearchByExpression failed: %v", err)
+	}
+	header := v.Header()
+	if result.TotalMatched != count || len(result.Matches) != count {
+		t.Errorf("Expected %d matches, got %d", count, result.TotalMatched)
+	}
+	if result.TotalScanned != int(header.RecordCount()) {
+		t.Errorf("Expected %d records scanned, got %d", header.RecordCount(), result.TotalScanned)
+	}
+
+	filter, _ := v.NewExprFilter(expression)
+	defer filter.Free()
+	for _, match := range result.Matches {
+		_ = v.Goto(match.RecordNumber)
+		if !filter.evaluateC() {
+			t.Errorf("Record %d returned but does not match", match.RecordNumber)
+		}
+	}
+
+	if count > 1 {
+		limited, err := v.SearchByExpression(expression, &ExprSearchOptions{MaxResults: 1})
+		if err != nil {
+			t.Fatalf("SearchByExpression with limit failed: %v", err)
+		}
+		if limited.TotalMatched != 1 || limited.Matches[0].RecordNumber != result.Matches[0].RecordNumber {
+			t.Errorf("Expected the first match only, got %d matches", limited.TotalMatched)
+		}
+	}
+}
+
+func TestParseValPrefix(t *testing.T) {
+	tests := []struct {
+		input string
+		want  float64
+	}{
+		{"12abc", 12},
+		{" 1.5e2", 150},
+		{"1e", 1},
+		{".5", 0.5},
+		{"+5", 5},
+		{"- 5", 0},
+		{"1,5", 1},
+		{"0x10", 16},
+		{"0x1.8p1", 3},
+		{"-0x", 0},
+		{"", 0},
+		{"abc", 0},
+		{"12\x0034", 12},
+	}
+
+	for _, tt := range tests {
+		if got := parseValPrefix([]byte(tt.input)); got != tt.want {
+			t.Errorf("parseValPrefix(%q) = %v, want %v", tt.input, got, tt.want)
+		}
+	}
+
+	if got := parseValPrefix([]byte("-inf")); !math.IsInf(got, -1) {
+		t.Errorf("parseValPrefix(\"-inf\") = %v, want -Inf", got)
+	}
+	if got := parseValPrefix([]byte("nan")); !math.IsNaN(got) {
+		t.Errorf("parseValPrefix(\"nan\") = %v, want NaN", got)
+	}
+}
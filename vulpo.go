@@ -51,6 +51,21 @@ package vulpo
 #cgo LDFLAGS: -L./mkfdbflib -lmkfdbf
 #include "d4all.h"
 #include <stdlib.h>
+
+// vulpo4nullFlags returns the offset in the record of the hidden _NullFlags
+// field, which CodeBase keeps behind the visible fields and f4null reads, or
+// -1 for a table without nullable fields.
+static long vulpo4nullFlags(DATA4 *data)
+{
+   int i, n = d4numFields( data ) ;
+
+   for ( i = 0 ; i < n ; i++ )
+      if ( data->fields[i].null )
+         break ;
+   if ( i == n || data->fields[n].type != '0' )
+      return -1 ;
+   return (long)data->fields[n].offset ;
+}
 */
 import "C"
 import (
@@ -95,6 +110,12 @@ type Vulpo struct {
 	header    *Header
 	fieldDefs *FieldDefs // kept for internal use during creation
 	fields    *Fields    // public field collection with readers
+	cache     CacheConfig
+	deleted   *deletedSet         // deleted records, once counted
+	packing   *packLog            // records changed during an online pack (see NewPacker)
+	cursors   map[*Vulpo]struct{} // open cursors sharing codeBase (see NewCursor)
+	cursor    bool                // codeBase belongs to the table the cursor is over
+	appending bool                // a record is being filled in (see Append)
 }
 
 // Open establishes a connection to the specified DBF file.
@@ -102,6 +123,8 @@ type Vulpo struct {
 //
 // Parameters:
 //   - filename: Path to the DBF file to open
+//   - config: Optional; starts the buffer cache with this size, policy and
+//     file modes, as StartCache does
 //
 // Returns:
 //   - error: nil on success, error describing the failure otherwise
@@ -118,13 +141,24 @@ type Vulpo struct {
 //		log.Fatalf("Failed to open database: %v", err)
 //	}
 //	defer v.Close()
-func (v *Vulpo) Open(filename string) error {
+//
+//	// With a 4 MB cache that keeps index blocks through table scans
+//	err = v.Open("/path/to/data.dbf", &vulpo.CacheConfig{
+//		Blocks: 4096,
+//		Policy: vulpo.CacheScanResistant,
+//	})
+func (v *Vulpo) Open(filename string, config ...*CacheConfig) error {
 	if v.Active() {
 		return NewError("database already open")
 	}
+	if len(config) > 0 && config[0] != nil {
+		if err := config[0].validate(); err != nil {
+			return err
+		}
+	}
 
 	// Initialize CODE4 structure
-	v.codeBase = (*C.CODE4)(C.malloc(C.sizeof_CODE4))
+	v.codeBase = newCodeBase()
 	if v.codeBase == nil {
 		return NewError("failed to allocate CODE4 structure")
 	}
@@ -132,7 +166,7 @@ func (v *Vulpo) Open(filename string) error {
 	// Initialize the codebase using code4initLow (code4init macro expansion)
 	result := C.code4initLow(v.codeBase, nil, 6401, C.long(C.sizeof_CODE4))
 	if result != 0 {
-		C.free(unsafe.Pointer(v.codeBase))
+		freeCodeBase(v.codeBase)
 		v.codeBase = nil
 		return NewErrorf("failed to initialize codebase: %d", int(result))
 	}
@@ -141,22 +175,36 @@ func (v *Vulpo) Open(filename string) error {
 	cFilename := C.CString(filename)
 	defer C.free(unsafe.Pointer(cFilename))
 
-	// Open the data file
+	// Open the data file; its production index, if any, parses the tag
+	// expressions
+	exprMutex.Lock()
 	v.data = C.d4open(v.codeBase, cFilename)
+	exprMutex.Unlock()
 	if v.data == nil {
 		// Clean up on failure
 		C.code4initUndo(v.codeBase)
-		C.free(unsafe.Pointer(v.codeBase))
+		freeCodeBase(v.codeBase)
 		v.codeBase = nil
 		return NewErrorf("failed to open database file: %s", filename)
 	}
 
 	v.filename = filename
+	v.deleted = &deletedSet{}
+	v.packing = &packLog{}
 
 	// Set finalizer to ensure cleanup
 	runtime.SetFinalizer(v, (*Vulpo).finalize)
 
-	return v.readHeader()
+	if err := v.readHeader(); err != nil {
+		return err
+	}
+	if len(config) > 0 && config[0] != nil {
+		if err := v.startCache(*config[0]); err != nil {
+			_ = v.Close()
+			return err
+		}
+	}
+	return nil
 }
 
 // Close closes the database connection and releases all associated resources.
@@ -214,9 +262,21 @@ func (v *Vulpo) finalize() {
 }
 
 func (v *Vulpo) reset() error {
+	// Cursors go first: code4initUndo releases the CODE4 they share
+	if v.cursor {
+		delete(v.cursors, v)
+	} else {
+		for c := range v.cursors {
+			_ = c.reset() // Ignore error, the table is closing
+		}
+		if v.packing != nil && v.packing.packer != nil {
+			_ = v.packing.packer.Abort()
+		}
+	}
+
 	// Close the data file
 	if v.data != nil {
-		result := C.d4close(v.data)
+		result := v.keyed(func() C.int { return C.d4close(v.data) })
 		v.data = nil
 		if result != 0 {
 			return NewErrorf("failed to close database: %d", int(result))
@@ -224,14 +284,19 @@ func (v *Vulpo) reset() error {
 	}
 
 	// Cleanup the codebase
-	if v.codeBase != nil {
+	if v.codeBase != nil && !v.cursor {
 		C.code4initUndo(v.codeBase)
-		C.free(unsafe.Pointer(v.codeBase))
-		v.codeBase = nil
+		freeCodeBase(v.codeBase)
 	}
+	v.codeBase = nil
+	v.cursors = nil
+	v.cursor = false
 
 	// Clear all state
 	v.filename = ""
+	v.cache = CacheConfig{}
+	v.deleted = nil
+	v.packing = nil
 	v.header = nil
 	v.fieldDefs = nil
 
@@ -441,6 +506,10 @@ func (v *Vulpo) readHeader() error {
 	// FoxPro memo files use FPT extension, detected via table flags bit 1
 	header.hasFpt = (headerRead.TableFlags & 0x02) != 0
 
+	// Record layout, used to address records directly in the file
+	header.headerLen = int(headerRead.RecordOffset)
+	header.recordLen = int(headerRead.RecordSize)
+
 	// Validate against codebase values for consistency
 	if uint32(C.d4recCountDo(v.data)) != headerRead.Recordcount {
 		return NewError("header record count mismatch with codebase")
@@ -497,6 +566,11 @@ func (v *Vulpo) readFieldDefs() error {
 			nullable:  cField.null != 0,
 			binary:    cField.binary != 0,
 			system:    false, // Basic implementation - can be enhanced
+
+			offset:     int(cField.offset),
+			length:     int(cField.len),
+			nullOffset: -1,
+			nullBit:    int(cField.nullBit),
 		}
 
 		// Add to FieldDefs (internal)
@@ -509,7 +583,16 @@ func (v *Vulpo) readFieldDefs() error {
 		fields.indices[strings.ToLower(fieldDef.fieldname)] = i
 	}
 
+	fieldDefs.setNullFlagsOffset(int(C.vulpo4nullFlags(v.data)))
+
 	v.fieldDefs = fieldDefs
 	v.fields = fields
 	return nil
 }
+
+// currentRecord returns the live CodeBase record buffer for the current record.
+// The slice aliases C memory: it is only valid while the database is open and
+// its contents change whenever the cursor moves.
+func (v *Vulpo) currentRecord() []byte {
+	return unsafe.Slice((*byte)(unsafe.Pointer(v.data.record)), int(v.data.dataFile.recWidth))
+}
@@ -3,10 +3,46 @@ package vulpo
 /*
 #include "d4all.h"
 #include <stdlib.h>
+
+// VULPO4SEEK_MISMATCH is returned by vulpo4seekTyped when the tag's key type
+// does not accept the value.
+#define VULPO4SEEK_MISMATCH (-2)
+
+// vulpo4seekTyped seeks the selected tag, as d4seek does, with a value that
+// needs no parsing: value for numeric tags (kind 'N') and, as a Julian day,
+// for date tags (kind 'D'), or the len bytes at key for character tags (kind
+// 'C').
+static int vulpo4seekTyped(DATA4 *data, int kind, double value, const char *key, int len)
+{
+   TAG4 *tag = d4tagDefault( data ) ;
+   int type ;
+
+   if ( tag == 0 )
+      return r4noTag ;
+
+   type = tfile4type( tag->tagFile ) ;
+   switch ( kind )
+   {
+      case 'N':
+         if ( type != 'N' && type != 'F' && type != 'I' && type != 'Y' && type != 'B' )
+            return VULPO4SEEK_MISMATCH ;
+         return d4seekDouble( data, value ) ;
+      case 'D':
+         if ( type != 'D' )
+            return VULPO4SEEK_MISMATCH ;
+         return d4seekDouble( data, value ) ;
+      default:
+         if ( type != 'C' && type != 'W' )
+            return VULPO4SEEK_MISMATCH ;
+         return d4seekN( data, key == 0 ? "" : key, (short)len ) ;
+   }
+}
 */
 import "C"
 import (
 	"fmt"
+	"math"
+	"time"
 	"unsafe"
 )
 
@@ -151,19 +187,19 @@ func (sr SeekResult) String() string {
 // convertSeekResult converts CodeBase seek result to SeekResult
 func convertSeekResult(result C.int) SeekResult {
 	switch result {
-	case 0: // r4success
+	case C.r4success:
 		return SeekSuccess
-	case 1: // r4after
+	case C.r4after:
 		return SeekAfter
-	case 2: // r4eof
+	case C.r4eof:
 		return SeekEOF
-	case 3: // r4entry
+	case C.r4entry:
 		return SeekEntry
-	case 4: // r4locked
+	case C.r4locked:
 		return SeekLocked
-	case 5: // r4unique
+	case C.r4unique:
 		return SeekUnique
-	case -1: // r4noTag (typically)
+	case C.r4noTag, -1:
 		return SeekNoTag
 	default:
 		if result < 0 {
@@ -188,7 +224,7 @@ func (v *Vulpo) Seek(searchValue string) (SeekResult, error) {
 	cSearchValue := C.CString(searchValue)
 	defer C.free(unsafe.Pointer(cSearchValue))
 
-	result := C.d4seek(v.data, cSearchValue)
+	result := v.keyed(func() C.int { return C.d4seek(v.data, cSearchValue) })
 	return convertSeekResult(result), nil
 }
 
@@ -199,7 +235,92 @@ func (v *Vulpo) SeekDouble(searchValue float64) (SeekResult, error) {
 		return SeekError, NewError("database not open")
 	}
 
-	result := C.d4seekDouble(v.data, C.double(searchValue))
+	result := v.keyed(func() C.int { return C.d4seekDouble(v.data, C.double(searchValue)) })
+	return convertSeekResult(result), nil
+}
+
+// maxExactInt is the largest integer magnitude a float64 holds exactly.
+const maxExactInt = 1 << 53
+
+// SeekInt64 searches the selected numeric tag for an integer value.
+//
+// Like SeekDouble, the value is handed to CodeBase in binary and converted
+// straight to the tag's key, so no string is formatted or parsed. FoxPro
+// numeric keys are doubles, so the value must be within ±2^53 to be exact.
+// Returns an error if the database is not open, the value is out of range or
+// the selected tag is not numeric.
+func (v *Vulpo) SeekInt64(searchValue int64) (SeekResult, error) {
+	if searchValue > maxExactInt || searchValue < -maxExactInt {
+		return SeekError, NewErrorf("seek value %d is not exactly representable in a numeric key", searchValue)
+	}
+	return v.seekTyped('N', float64(searchValue), nil)
+}
+
+// SeekDecimal searches the selected numeric tag for the decimal value
+// unscaled × 10^-scale, e.g. SeekDecimal(12345, 2) for 123.45.
+//
+// The key is the same double CodeBase would parse from the decimal string:
+// both operands of the division are exact, so the quotient is correctly
+// rounded. Returns an error if the database is not open, unscaled exceeds
+// ±2^53, scale is outside 0-22, or the selected tag is not numeric.
+func (v *Vulpo) SeekDecimal(unscaled int64, scale int) (SeekResult, error) {
+	if unscaled > maxExactInt || unscaled < -maxExactInt {
+		return SeekError, NewErrorf("seek value %d is not exactly representable in a numeric key", unscaled)
+	}
+	if scale < 0 || scale >= len(exactPow10) {
+		return SeekError, NewErrorf("invalid decimal scale: %d", scale)
+	}
+	return v.seekTyped('N', float64(unscaled)/exactPow10[scale], nil)
+}
+
+// SeekTime searches the selected date tag for the calendar date of t, in
+// t's location; the time of day is ignored.
+//
+// The date is passed as its Julian day number, the form date keys are built
+// from, instead of being formatted as CCYYMMDD and parsed back. Returns an
+// error if the database is not open or the selected tag is not a date tag.
+func (v *Vulpo) SeekTime(searchValue time.Time) (SeekResult, error) {
+	year, month, day := searchValue.Date()
+	return v.seekTyped('D', float64(YMDToJulian(year, int(month), day)), nil)
+}
+
+// SeekBytes searches the selected character tag for key, which may be a
+// prefix of the full key as for Seek.
+//
+// The bytes are passed to CodeBase in place, without the C string copy Seek
+// makes. Returns an error if the database is not open, key is longer than
+// a seek key can be, or the selected tag is not a character tag.
+func (v *Vulpo) SeekBytes(key []byte) (SeekResult, error) {
+	if len(key) > math.MaxInt16 {
+		return SeekError, NewErrorf("seek key of %d bytes is too long", len(key))
+	}
+	return v.seekTyped('C', 0, key)
+}
+
+// seekTyped runs vulpo4seekTyped and checks the tag type.
+func (v *Vulpo) seekTyped(kind byte, value float64, key []byte) (SeekResult, error) {
+	if !v.Active() {
+		return SeekError, NewError("database not open")
+	}
+
+	var keyPtr *C.char
+	if len(key) > 0 {
+		keyPtr = (*C.char)(unsafe.Pointer(&key[0]))
+	}
+
+	result := v.keyed(func() C.int {
+		return C.vulpo4seekTyped(v.data, C.int(kind), C.double(value), keyPtr, C.int(len(key)))
+	})
+	if result == C.VULPO4SEEK_MISMATCH {
+		kindName := "character"
+		switch kind {
+		case 'N':
+			kindName = "numeric"
+		case 'D':
+			kindName = "date"
+		}
+		return SeekError, NewErrorf("selected tag does not accept a %s seek value", kindName)
+	}
 	return convertSeekResult(result), nil
 }
 
@@ -213,7 +334,7 @@ func (v *Vulpo) SeekNext(searchValue string) (SeekResult, error) {
 	cSearchValue := C.CString(searchValue)
 	defer C.free(unsafe.Pointer(cSearchValue))
 
-	result := C.d4seekNext(v.data, cSearchValue)
+	result := v.keyed(func() C.int { return C.d4seekNext(v.data, cSearchValue) })
 	return convertSeekResult(result), nil
 }
 
@@ -224,7 +345,7 @@ func (v *Vulpo) SeekNextDouble(searchValue float64) (SeekResult, error) {
 		return SeekError, NewError("database not open")
 	}
 
-	result := C.d4seekNextDouble(v.data, C.double(searchValue))
+	result := v.keyed(func() C.int { return C.d4seekNextDouble(v.data, C.double(searchValue)) })
 	return convertSeekResult(result), nil
 }
 
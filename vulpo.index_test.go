@@ -1,7 +1,9 @@
 package vulpo
 
 import (
+	"fmt"
 	"testing"
+	"time"
 )
 
 const testDBFWithIndexPath = "mkfdbflib/data/info.dbf"
@@ -420,3 +422,66 @@ func TestVulpo_SeekWithTagRestoresOriginalSelection(t *testing.T) {
 			originalTag.Name(), restoredTag.Name())
 	}
 }
+
+func TestVulpo_TypedSeeks(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	// seekBoth runs a string seek and a typed seek and checks they agree
+	seekBoth := func(text string, typed func() (SeekResult, error)) SeekResult {
+		t.Helper()
+		want, _ := v.Seek(text)
+		wantPos := v.Position()
+		got, err := typed()
+		if err != nil {
+			t.Fatalf("Typed seek for %q failed: %v", text, err)
+		}
+		if got != want || v.Position() != wantPos {
+			t.Errorf("Typed seek for %q: %v at %d, Seek gave %v at %d", text, got, v.Position(), want, wantPos)
+		}
+		return got
+	}
+
+	_ = v.SelectTag(v.TagByName("INF_AGE"))
+	for age := int64(18); age <= 66; age++ {
+		seekBoth(fmt.Sprint(age), func() (SeekResult, error) { return v.SeekInt64(age) })
+	}
+	if r := seekBoth("21.5", func() (SeekResult, error) { return v.SeekDecimal(215, 1) }); r != SeekAfter {
+		t.Errorf("Expected SeekAfter for 21.5, got %v", r)
+	}
+	if r := seekBoth("64.00", func() (SeekResult, error) { return v.SeekDecimal(6400, 2) }); r != SeekSuccess {
+		t.Errorf("Expected SeekSuccess for 64.00, got %v", r)
+	}
+	if r := seekBoth("99", func() (SeekResult, error) { return v.SeekInt64(99) }); r != SeekEOF {
+		t.Errorf("Expected SeekEOF for 99, got %v", r)
+	}
+	if _, err := v.SeekTime(time.Now()); err == nil {
+		t.Error("Expected error for a date seek on a numeric tag")
+	}
+	if _, err := v.SeekInt64(1 << 60); err == nil {
+		t.Error("Expected error for an inexact integer")
+	}
+	if _, err := v.SeekDecimal(1, 23); err == nil {
+		t.Error("Expected error for an invalid scale")
+	}
+
+	_ = v.SelectTag(v.TagByName("INF_BRTH"))
+	for _, date := range []time.Time{
+		time.Date(1969, 2, 25, 13, 30, 0, 0, time.UTC),
+		time.Date(1969, 2, 24, 0, 0, 0, 0, time.UTC),
+		time.Date(1969, 2, 26, 0, 0, 0, 0, time.UTC),
+	} {
+		seekBoth(date.Format("20060102"), func() (SeekResult, error) { return v.SeekTime(date) })
+	}
+
+	_ = v.SelectTag(v.TagByName("INF_NAME"))
+	for _, name := range []string{"Fred", "Fre", "Abbott", "B", "Zed", ""} {
+		seekBoth(name, func() (SeekResult, error) { return v.SeekBytes([]byte(name)) })
+	}
+	if _, err := v.SeekInt64(1); err == nil {
+		t.Error("Expected error for a numeric seek on a character tag")
+	}
+}
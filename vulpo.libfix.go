@@ -0,0 +1,69 @@
+package vulpo
+
+/*
+#cgo LDFLAGS: -Wl,--wrap=file4tempLow
+#include "d4all.h"
+#include <string.h>
+
+// x4putInfo replaces the library's own version, which was written for a
+// 32-bit long: it builds a leaf entry's packed record number, duplicate count
+// and trailing count through an unsigned long pointer, so on LP64 it stores
+// 8 bytes (10 for long record numbers) into the 6-byte info buffer of its
+// callers. r4reindexAdd keeps that buffer on the stack, which made every
+// compound index rebuild (d4reindex, i4reindex, d4pack) abort with a
+// smashed stack. This version stores exactly the 6 bytes. The library's
+// definition is weak (libmkfdbf.a's b4block.o went through objcopy
+// --weaken-symbol=x4putInfo), so this one serves all of its callers,
+// including b4insertLeaf, b4removeLeaf and b4reindex, which call it from
+// within b4block.o where --wrap does not reach.
+int x4putInfo( const B4NODE_HEADER *header, void *buffer, const S4LONG rec, const int trail, const int dupCnt )
+{
+   unsigned char *buf = (unsigned char *)buffer ;
+   unsigned long long info ;
+   unsigned int mask ;
+   int i ;
+
+   if ( header == 0 || buffer == 0 || rec < 0 || trail < 0 || dupCnt < 0 )
+      return error4( 0, e4parm, E90439 ) ;
+   if ( header->infoLen > 4 && header->recNumLen <= 16 )
+      return error4( 0, e4info, E80401 ) ;
+
+   memcpy( &mask, header->recNumMask, sizeof( mask ) ) ;
+   info = (unsigned long long)( (unsigned int)rec & mask ) ;
+   info |= (unsigned long long)(unsigned int)dupCnt << header->recNumLen ;
+   info |= (unsigned long long)(unsigned int)trail << ( header->recNumLen + header->dupCntLen ) ;
+
+   for ( i = 0 ; i < 6 ; i++ )
+      buf[i] = (unsigned char)( info >> ( 8 * i ) ) ;
+   return 0 ;
+}
+
+int __real_file4tempLow( FILE4 *, CODE4 *, const int, int, const char * ) ;
+
+// __wrap_file4tempLow stands in for file4tempLow wherever the library calls
+// it. Temporary files are named TEMPnnnn.TMP after the current time in
+// seconds, and a name already taken costs a half second sleep before the next
+// try, so sorts that spill within the same second (one per tag during
+// Reindex) queued up behind each other for seconds. Temporary files created
+// without an extension get one of their own instead, T00 to TZZ in turn, which
+// keeps the names of up to 1296 files per second apart.
+int __wrap_file4tempLow( FILE4 *file, CODE4 *codeBase, const int autoRemove, int createTemp, const char *ext )
+{
+   static const char digits[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ" ;
+   static unsigned int next ;
+   char unique[4] ;
+   unsigned int n ;
+
+   if ( ext == 0 )
+   {
+      n = __atomic_fetch_add( &next, 1, __ATOMIC_RELAXED ) % ( 36 * 36 ) ;
+      unique[0] = 'T' ;
+      unique[1] = digits[n / 36] ;
+      unique[2] = digits[n % 36] ;
+      unique[3] = 0 ;
+      ext = unique ;
+   }
+   return __real_file4tempLow( file, codeBase, autoRemove, createTemp, ext ) ;
+}
+*/
+import "C"
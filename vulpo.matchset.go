@@ -0,0 +1,154 @@
+package vulpo
+
+// MatchSet holds the record numbers matching an expression as a bitmap with
+// one bit per record, rather than a map of field readers per match. Field
+// values are read on demand with ForEach, which visits the matches in
+// ascending record-number order so the data file is read front to back.
+//
+// A MatchSet remembers the Vulpo it was built from and is only valid while
+// that table stays open. It reflects the table at the time of the search.
+type MatchSet struct {
+	Expression string // The expression used
+
+	bits    Bitmap
+	count   int
+	scanned int
+	vulpo   *Vulpo
+}
+
+// MatchExpression finds the records matching a dBASE expression and returns
+// their record numbers as a MatchSet.
+//
+// Parameters:
+//   - expression: dBASE logical expression
+//   - options: Search options (nil for defaults); MaxResults keeps the first
+//     matches in navigation order, UseIndex lets tag-covered conditions be
+//     answered from the index
+//
+// Returns:
+//   - *MatchSet: The matching record numbers
+//   - error: Error if the database is not open, the expression is invalid or
+//     the scan fails
+//
+// Example:
+//
+//	matches, err := v.MatchExpression("AGE > 40", nil)
+//	if err != nil {
+//		return err
+//	}
+//	name := v.FieldDefs().Index("NAME")
+//	err = matches.ForEach(func(rec Record) error {
+//		value, err := rec.String(name)
+//		fmt.Println(rec.RecordNumber(), value)
+//		return err
+//	})
+func (v *Vulpo) MatchExpression(expression string, options *ExprSearchOptions) (*MatchSet, error) {
+	if !v.Active() {
+		return nil, NewError("database not open")
+	}
+
+	if options == nil {
+		options = &ExprSearchOptions{}
+	}
+
+	filter, err := v.NewExprFilter(expression)
+	if err != nil {
+		return nil, NewErrorf("failed to create expression filter: %v", err)
+	}
+	defer filter.Free()
+
+	header := v.Header()
+	set := &MatchSet{
+		Expression: expression,
+		bits:       make(Bitmap, 0, (int(header.RecordCount())+64)>>6),
+		vulpo:      v,
+	}
+
+	set.scanned, err = v.eachMatch(filter, options.UseIndex, false, func(rec Record) error {
+		recNo := rec.RecordNumber()
+		set.bits = set.bits.grow(recNo + 1)
+		set.bits.set(recNo)
+		set.count++
+
+		if options.MaxResults > 0 && set.count >= options.MaxResults {
+			return errStopScan
+		}
+		return nil
+	})
+	if err != nil && err != errStopScan {
+		return nil, err
+	}
+
+	return set, nil
+}
+
+// Len returns the number of matching records.
+func (m *MatchSet) Len() int {
+	return m.count
+}
+
+// Scanned returns the number of records examined to build the set.
+func (m *MatchSet) Scanned() int {
+	return m.scanned
+}
+
+// Contains reports whether the record with the given 1-indexed record number
+// matched.
+func (m *MatchSet) Contains(recNo int) bool {
+	return m.bits.Get(recNo)
+}
+
+// RecordNumbers returns the matching record numbers in ascending order.
+func (m *MatchSet) RecordNumbers() []int {
+	recNos := make([]int, 0, m.count)
+	for recNo := m.bits.Next(1); recNo >= 0; recNo = m.bits.Next(recNo + 1) {
+		recNos = append(recNos, recNo)
+	}
+	return recNos
+}
+
+// ForEach calls fn with a Record view of every matching record in ascending
+// record-number order, until fn returns an error.
+//
+// Records are read from a memory-mapped Scanner when possible, so no CodeBase
+// call is made per record; otherwise each record is loaded with Goto and the
+// current position is restored afterwards. The view is only valid during the
+// call. Records appended after the set was built are never visited.
+func (m *MatchSet) ForEach(fn func(rec Record) error) error {
+	v := m.vulpo
+	if v == nil || !v.Active() {
+		return NewError("database not open")
+	}
+
+	if m.count == 0 {
+		return nil
+	}
+
+	if scanner, err := v.NewScanner(); err == nil {
+		defer scanner.Close()
+		for recNo := m.bits.Next(1); recNo >= 0 && recNo <= scanner.Count(); recNo = m.bits.Next(recNo + 1) {
+			if err := fn(scanner.Record(recNo)); err != nil {
+				return err
+			}
+		}
+		return nil
+	}
+
+	// Mapping unavailable: position CodeBase on each match
+	originalPosition := v.Position()
+	defer func() {
+		if originalPosition > 0 {
+			_ = v.Goto(originalPosition) // Ignore error in defer
+		}
+	}()
+
+	for recNo := m.bits.Next(1); recNo >= 0; recNo = m.bits.Next(recNo + 1) {
+		if err := v.Goto(recNo); err != nil {
+			return err
+		}
+		if err := fn(Record{data: v.currentRecord(), recNo: recNo, defs: v.fieldDefs}); err != nil {
+			return err
+		}
+	}
+	return nil
+}
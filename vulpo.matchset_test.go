@@ -0,0 +1,136 @@
+package vulpo
+
+import (
+	"errors"
+	"testing"
+)
+
+func TestVulpo_MatchExpression_NoDatabase(t *testing.T) {
+	v := &Vulpo{}
+
+	if _, err := v.MatchExpression("AGE > 40", nil); err == nil {
+		t.Error("Expected error for MatchExpression with inactive database")
+	}
+	if err := v.ForEachExpressionRecord("AGE > 40", func(Record) error { return nil }); err == nil {
+		t.Error("Expected error for ForEachExpressionRecord with inactive database")
+	}
+}
+
+func TestVulpo_MatchExpression(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	name := v.FieldDefs().Index("NAME")
+	for _, expression := range []string{"AGE > 40 .AND. 'e' $ NAME", "YEAR(BIRTH_DATE) < 1950 .AND. AGE < 25", "AGE > 99"} {
+		for _, options := range []*ExprSearchOptions{nil, {UseIndex: true}} {
+			want, err := v.SearchByExpression(expression, options)
+			if err != nil {
+				t.Fatalf("SearchByExpression(%q) failed: %v", expression, err)
+			}
+
+			set, err := v.MatchExpression(expression, options)
+			if err != nil {
+				t.Fatalf("MatchExpression(%q) failed: %v", expression, err)
+			}
+			if set.Len() != want.TotalMatched || set.Scanned() != want.TotalScanned {
+				t.Errorf("%q: expected %d matches of %d scanned, got %d of %d",
+					expression, want.TotalMatched, want.TotalScanned, set.Len(), set.Scanned())
+				continue
+			}
+
+			recNos := set.RecordNumbers()
+			for i, match := range want.Matches {
+				if recNos[i] != match.RecordNumber || !set.Contains(match.RecordNumber) {
+					t.Errorf("%q: match %d is record %d, want %d", expression, i, recNos[i], match.RecordNumber)
+					break
+				}
+			}
+
+			// Values read through the set agree with the cursor
+			visited := 0
+			err = set.ForEach(func(rec Record) error {
+				if rec.RecordNumber() != recNos[visited] {
+					t.Errorf("%q: ForEach visited record %d, want %d", expression, rec.RecordNumber(), recNos[visited])
+				}
+				visited++
+
+				got, err := rec.String(name)
+				if err != nil {
+					return err
+				}
+				if err := v.Goto(rec.RecordNumber()); err != nil {
+					return err
+				}
+				if wantName, _ := v.FieldReader("NAME").AsString(); got != wantName {
+					t.Errorf("Record %d: NAME %q, want %q", rec.RecordNumber(), got, wantName)
+				}
+				return nil
+			})
+			if err != nil || visited != set.Len() {
+				t.Errorf("%q: ForEach visited %d records, %v; want %d", expression, visited, err, set.Len())
+			}
+		}
+	}
+
+	limited, err := v.MatchExpression("AGE > 40", &ExprSearchOptions{MaxResults: 3})
+	if err != nil {
+		t.Fatalf("MatchExpression with limit failed: %v", err)
+	}
+	if limited.Len() != 3 || len(limited.RecordNumbers()) != 3 {
+		t.Errorf("Expected 3 matches, got %d", limited.Len())
+	}
+}
+
+func TestVulpo_ForEachExpressionRecord(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	// Select a tag so the compiled path scans through CodeBase navigation
+	if tags := v.ListTags(); len(tags) > 0 {
+		_ = v.SelectTag(tags[0])
+	}
+
+	age := v.FieldDefs().Index("AGE")
+	for _, expression := range []string{"AGE > 40", "YEAR(BIRTH_DATE) < 1950 .AND. AGE > 40"} {
+		count, err := v.CountByExpression(expression)
+		if err != nil {
+			t.Fatalf("CountByExpression(%q) failed: %v", expression, err)
+		}
+
+		visited := 0
+		err = v.ForEachExpressionRecord(expression, func(rec Record) error {
+			visited++
+			value, err := rec.Int(age)
+			if value <= 40 {
+				t.Errorf("%q: record %d has AGE %d", expression, rec.RecordNumber(), value)
+			}
+			return err
+		})
+		if err != nil || visited != count {
+			t.Errorf("%q: visited %d records, %v; want %d", expression, visited, err, count)
+		}
+
+		// The field reader map is positioned on each match
+		err = v.ForEachExpressionMatch(expression, func(fields map[string]FieldReader) error {
+			value, err := fields["AGE"].AsInt()
+			if value <= 40 {
+				t.Errorf("%q: field reader on record %d has AGE %d", expression, v.Position(), value)
+			}
+			return err
+		})
+		if err != nil {
+			t.Errorf("ForEachExpressionMatch(%q) failed: %v", expression, err)
+		}
+	}
+
+	stop := errors.New("stop")
+	if err := v.ForEachExpressionRecord("AGE > 40", func(Record) error { return stop }); !errors.Is(err, stop) {
+		t.Errorf("Expected callback error, got %v", err)
+	}
+}
@@ -0,0 +1,705 @@
+package vulpo
+
+/*
+#include "d4all.h"
+#include <string.h>
+
+// vulpo4memoFile returns the table's memo file, or NULL without one.
+static FILE4 *vulpo4memoFile(DATA4 *data)
+{
+   if ( data->dataFile->memoFile.file.hand == INVALID4HANDLE )
+      return 0 ;
+   return &data->dataFile->memoFile.file ;
+}
+
+static int vulpo4memoBlockSize(DATA4 *data)
+{
+   return data->dataFile->memoFile.blockSize ;
+}
+
+static int vulpo4memoTruncate(FILE4 *file, long len)
+{
+   return file4lenSet( file, len ) ;
+}
+
+// vulpo4memoCheck goes to record recNo and tells whether the len bytes at
+// offset of the record are those at pointer: 0 if they are, 1 if not, or a
+// negative error code.
+static int vulpo4memoCheck(DATA4 *data, long recNo, int offset, const void *pointer, int len)
+{
+   int rc = d4go( data, recNo ) ;
+   if ( rc != 0 )
+      return rc < 0 ? rc : -1 ;
+   return memcmp( d4record( data ) + offset, pointer, len ) == 0 ? 0 : 1 ;
+}
+
+// vulpo4memoSet writes pointer over the len bytes at offset of the current
+// record and writes the record.
+static int vulpo4memoSet(DATA4 *data, int offset, const void *pointer, int len)
+{
+   memcpy( d4record( data ) + offset, pointer, len ) ;
+   d4changed( data, 1 ) ;
+   return d4updateRecord( data, 0 ) ;
+}
+*/
+import "C"
+import (
+	"encoding/binary"
+	"fmt"
+	"io"
+	"os"
+	"sort"
+	"strconv"
+	"strings"
+	"time"
+	"unsafe"
+)
+
+// memoHeaderLen is the size of the memo file header, which the first memo
+// blocks follow.
+const memoHeaderLen = 512
+
+// MemoStats describes how the blocks of a table's memo file are used.
+//
+// When a memo grows past the blocks it has, CodeBase writes it anew at the
+// end of the file and its old blocks stay unused: tables whose memos are
+// rewritten keep growing, with live memos scattered among dead blocks.
+type MemoStats struct {
+	BlockSize  int // bytes per block
+	Blocks     int // blocks after the header, live or dead
+	LiveBlocks int // blocks holding the memos records point to
+	Memos      int // memos records point to, deleted records included
+}
+
+// DeadBlocks returns the number of blocks no record points to.
+func (s MemoStats) DeadBlocks() int {
+	return s.Blocks - s.LiveBlocks
+}
+
+// Fragmentation returns the share of the memo file's blocks that no record
+// points to, from 0 for a compact file to nearly 1: the space CompactMemos
+// would reclaim.
+func (s MemoStats) Fragmentation() float64 {
+	if s.Blocks <= 0 {
+		return 0
+	}
+	return float64(s.DeadBlocks()) / float64(s.Blocks)
+}
+
+// memoRef is a memo a record points to.
+type memoRef struct {
+	block  int // first block
+	blocks int // blocks it spans
+	recNo  int
+	field  int // index into memoFields
+}
+
+// memoField locates a memo pointer in the record.
+type memoField struct {
+	offset int
+	length int // 4 for a binary block number, 10 for a decimal one
+}
+
+// memoFields returns the fields of the table that point into the memo file.
+func (v *Vulpo) memoFields() []memoField {
+	var fields []memoField
+	for _, fd := range v.fieldDefs.fields {
+		switch fd.Type() {
+		case FTMemo, FTGeneral, FTPicture, FTBlob:
+			if fd.length == 4 || fd.length == 10 {
+				fields = append(fields, memoField{offset: fd.offset, length: fd.length})
+			}
+		}
+	}
+	return fields
+}
+
+// decode returns the block number the field holds in record, 0 for none.
+func (f memoField) decode(record []byte) int {
+	data := record[f.offset : f.offset+f.length]
+	if f.length == 4 {
+		return int(binary.LittleEndian.Uint32(data))
+	}
+	block, err := strconv.Atoi(strings.TrimSpace(string(data)))
+	if err != nil || block < 0 {
+		return 0
+	}
+	return block
+}
+
+// encode returns the field bytes that point to block.
+func (f memoField) encode(block int) []byte {
+	if f.length == 4 {
+		return binary.LittleEndian.AppendUint32(nil, uint32(block))
+	}
+	return []byte(fmt.Sprintf("%10d", block))
+}
+
+// memoFile is the open memo file of a table, read and written through
+// CodeBase so that its buffer cache stays coherent.
+type memoFile struct {
+	file      *C.FILE4
+	blockSize int
+	first     int // first block after the header
+}
+
+// openMemo returns the memo file of the table.
+func (v *Vulpo) openMemo() (*memoFile, error) {
+	file := C.vulpo4memoFile(v.data)
+	if file == nil {
+		return nil, NewError("table has no memo file")
+	}
+	blockSize := int(C.vulpo4memoBlockSize(v.data))
+	if blockSize <= 0 {
+		return nil, NewErrorf("invalid memo block size: %d", blockSize)
+	}
+	return &memoFile{file: file, blockSize: blockSize, first: (memoHeaderLen + blockSize - 1) / blockSize}, nil
+}
+
+// read reads len(buf) bytes at block.
+func (m *memoFile) read(block int, buf []byte) error {
+	if got := m.readUpTo(block, buf); got != len(buf) {
+		return NewErrorf("failed to read memo block %d", block)
+	}
+	return nil
+}
+
+// readUpTo reads up to len(buf) bytes at block, fewer at the end of the
+// file, and returns how many it read.
+func (m *memoFile) readUpTo(block int, buf []byte) int {
+	return int(C.file4read(m.file, C.long(block*m.blockSize), unsafe.Pointer(&buf[0]), C.uint(len(buf))))
+}
+
+// write writes buf at block.
+func (m *memoFile) write(block int, buf []byte) error {
+	if result := C.file4write(m.file, C.long(block*m.blockSize), unsafe.Pointer(&buf[0]), C.uint(len(buf))); result < 0 {
+		return NewErrorf("failed to write memo block %d: error code %d", block, int(result))
+	}
+	return nil
+}
+
+// next returns the next free block, where CodeBase writes new memos.
+func (m *memoFile) next() (int, error) {
+	var header [4]byte
+	if err := m.read(0, header[:]); err != nil {
+		return 0, err
+	}
+	return int(binary.BigEndian.Uint32(header[:])), nil
+}
+
+// blocks returns the number of blocks the memo at block spans, from the
+// length in its header, or 0 if that runs past end.
+func (m *memoFile) blocks(block, end int) (int, error) {
+	var header [8]byte
+	if block < m.first || block >= end {
+		return 0, nil
+	}
+	if err := m.read(block, header[:]); err != nil {
+		return 0, err
+	}
+	blocks := (len(header) + int(binary.BigEndian.Uint32(header[4:])) + m.blockSize - 1) / m.blockSize
+	if blocks > end-block {
+		return 0, nil
+	}
+	return blocks, nil
+}
+
+// scanMemos returns the memos the records of the table point to, at or after
+// block from, sorted by block, with the next free block of the memo file.
+// Memos that run past the end of the file are returned with no blocks.
+func (v *Vulpo) scanMemos(memo *memoFile, from int) ([]memoRef, int, error) {
+	// Changes pending in the record buffers of cursors count too
+	if result := v.keyed(func() C.int { return C.code4flush(v.codeBase) }); result < 0 {
+		return nil, 0, NewErrorf("failed to flush database before scan: error code %d", int(result))
+	}
+	end, err := memo.next()
+	if err != nil {
+		return nil, 0, err
+	}
+
+	fields := v.memoFields()
+	count := int(C.d4recCountDo(v.data))
+	if len(fields) == 0 || count == 0 {
+		return nil, end, nil
+	}
+
+	file, err := os.Open(v.filename)
+	if err != nil {
+		return nil, 0, NewErrorf("failed to open data file for scanning: %s", v.filename).SetWrapped(err)
+	}
+	defer file.Close()
+
+	refs, err := v.readMemoRefs(file, fields, from, 1, count, nil)
+	if err != nil {
+		return nil, 0, err
+	}
+	if err := memo.measure(refs, end); err != nil {
+		return nil, 0, err
+	}
+	return refs, end, nil
+}
+
+// readMemoRefs appends to refs the memos at or after block from that the n
+// records from first point to, read from file.
+func (v *Vulpo) readMemoRefs(file *os.File, fields []memoField, from, first, n int, refs []memoRef) ([]memoRef, error) {
+	headerLen, recordLen := v.header.headerLen, v.header.recordLen
+	buf := make([]byte, max(1, min(n, deletedScanChunk/recordLen))*recordLen)
+	for read := 0; read < n; {
+		chunk := min(len(buf)/recordLen, n-read)
+		got, err := file.ReadAt(buf[:chunk*recordLen], int64(headerLen+(first-1+read)*recordLen))
+		if err != nil && err != io.EOF {
+			return nil, NewErrorf("failed to read data file: %s", v.filename).SetWrapped(err)
+		}
+		if chunk = got / recordLen; chunk == 0 {
+			break
+		}
+		for i := 0; i < chunk; i++ {
+			record := buf[i*recordLen : (i+1)*recordLen]
+			for f, field := range fields {
+				if block := field.decode(record); block != 0 && block >= from {
+					refs = append(refs, memoRef{block: block, recNo: first + read + i, field: f})
+				}
+			}
+		}
+		read += chunk
+	}
+	return refs, nil
+}
+
+// measure sorts refs by block and sets the blocks each spans, 0 for those
+// that run past end.
+func (m *memoFile) measure(refs []memoRef, end int) error {
+	sort.Slice(refs, func(i, j int) bool { return refs[i].block < refs[j].block })
+	for i := range refs {
+		var err error
+		if refs[i].blocks, err = m.blocks(refs[i].block, end); err != nil {
+			return err
+		}
+	}
+	return nil
+}
+
+// MemoStats reports how much of the table's memo file is taken by memos
+// records point to, and how much is dead space, so that compaction can be
+// scheduled when Fragmentation passes a threshold.
+//
+// Returns:
+//   - MemoStats: Block counts of the memo file
+//   - error: Error if the database is not open, has no memo file or a file
+//     cannot be read
+//
+// The memo pointers are read straight from the data file, then the length
+// of each memo from its first block.
+//
+// Example:
+//
+//	stats, err := v.MemoStats()
+//	if err != nil {
+//		return err
+//	}
+//	if stats.Fragmentation() > 0.5 {
+//		err = v.CompactMemos()
+//	}
+func (v *Vulpo) MemoStats() (MemoStats, error) {
+	if !v.Active() {
+		return MemoStats{}, NewError("database not open")
+	}
+	memo, err := v.openMemo()
+	if err != nil {
+		return MemoStats{}, err
+	}
+
+	refs, end, err := v.scanMemos(memo, 0)
+	if err != nil {
+		return MemoStats{}, err
+	}
+	stats := MemoStats{BlockSize: memo.blockSize, Blocks: max(0, end-memo.first), Memos: len(refs)}
+	for _, ref := range refs {
+		stats.LiveBlocks += ref.blocks
+	}
+	return stats, nil
+}
+
+// MemoCompactProgress reports how far a memo compaction has got.
+type MemoCompactProgress struct {
+	Memos      int           // memos to place
+	Placed     int           // memos placed, moved or left where they were
+	Moved      int           // memos moved
+	BytesMoved int64         // bytes of the memos moved
+	Elapsed    time.Duration // time spent in Step so far
+}
+
+// MemoCompactor compacts a table's memo file in steps (see
+// NewMemoCompactor).
+type MemoCompactor struct {
+	v        *Vulpo
+	cursor   *Cursor // writes the new memo pointers
+	memo     *memoFile
+	fields   []memoField
+	refs     []memoRef // memos left to place, by block
+	dest     int       // block the next memo goes to
+	end      int       // next free block when refs was read
+	count    int       // records when refs was read
+	buf      []byte
+	progress MemoCompactProgress
+	done     bool
+}
+
+// NewMemoCompactor starts compacting the table's memo file: each memo is
+// moved down to the end of the one before it, in file order, and the record
+// pointing to it updated, until the dead blocks are all at the end of the
+// file, which is then cut off. Unlike a rewrite of the whole file, the work
+// is done in steps of bounded duration, between which the table is in use as
+// usual.
+//
+// Returns:
+//   - *MemoCompactor: The compaction, to drive with Step
+//   - error: Error if the database is not open, has no memo file, a pack is
+//     running, or the memo file is damaged
+//
+// Each step locks the table. Memos written between steps through the table
+// or its cursors are taken into account, from the records changed or
+// appended since the last step rather than a scan of the whole table: a memo
+// rewritten elsewhere is not moved, and memos added at the end of the file
+// are moved in turn. Each step places at least one memo more than were
+// written since the one before, so the compaction ends however busy the
+// table is. Memos written by other programs between steps are not seen, and
+// would be cut off with the dead blocks. The table and its cursors are moved
+// back onto their current records after each step, so they read the memos
+// at their new place. A crash in the middle of a step can leave a memo
+// damaged; back up the memo file first.
+//
+// Example:
+//
+//	c, err := v.NewMemoCompactor()
+//	if err != nil {
+//		return err
+//	}
+//	defer c.Close()
+//	for {
+//		done, err := c.Step(10 * time.Millisecond)
+//		if err != nil || done {
+//			return err
+//		}
+//		// serve requests on v
+//	}
+func (v *Vulpo) NewMemoCompactor() (*MemoCompactor, error) {
+	if !v.Active() {
+		return nil, NewError("database not open")
+	}
+	if v.packing.compactor != nil {
+		return nil, NewError("memo compaction already in progress")
+	}
+	if v.packing.packer != nil {
+		return nil, NewError("cannot compact memos while a pack is in progress")
+	}
+	memo, err := v.openMemo()
+	if err != nil {
+		return nil, err
+	}
+
+	cursor, err := v.NewCursor()
+	if err != nil {
+		return nil, err
+	}
+	c := &MemoCompactor{v: v, cursor: cursor, memo: memo, fields: v.memoFields(), dest: memo.first}
+	if err := c.plan(); err != nil {
+		_ = cursor.Close()
+		return nil, err
+	}
+	v.packing.compactor = c
+	v.packing.memos = nil
+	return c, nil
+}
+
+// plan reads the memos to place, from all the records.
+func (c *MemoCompactor) plan() error {
+	count := int(C.d4recCountDo(c.v.data))
+	refs, end, err := c.v.scanMemos(c.memo, c.dest)
+	if err != nil {
+		return err
+	}
+	if err := c.check(refs, c.dest); err != nil {
+		return err
+	}
+	c.refs, c.end, c.count = refs, end, count
+	c.progress.Memos = len(refs)
+	return nil
+}
+
+// pickUp adds to the memos to place those written since refs was read, at or
+// after the next free block of then: the memos of the records changed since,
+// as noted by the table's packLog, and of the records appended since. It
+// returns how many it added.
+func (c *MemoCompactor) pickUp(end int) (int, error) {
+	v := c.v
+	count := int(C.d4recCountDo(v.data))
+	changed := v.packing.memos
+	v.packing.memos = nil
+
+	file, err := os.Open(v.filename)
+	if err != nil {
+		return 0, NewErrorf("failed to open data file for scanning: %s", v.filename).SetWrapped(err)
+	}
+	defer file.Close()
+
+	var refs []memoRef
+	for recNo := changed.Next(1); recNo >= 0 && recNo <= c.count; recNo = changed.Next(recNo + 1) {
+		if refs, err = v.readMemoRefs(file, c.fields, c.end, recNo, 1, refs); err != nil {
+			return 0, err
+		}
+	}
+	if count > c.count {
+		if refs, err = v.readMemoRefs(file, c.fields, c.end, c.count+1, count-c.count, refs); err != nil {
+			return 0, err
+		}
+	}
+	if err := c.memo.measure(refs, end); err != nil {
+		return 0, err
+	}
+	if err := c.check(refs, c.end); err != nil {
+		return 0, err
+	}
+
+	c.refs = append(c.refs, refs...)
+	c.end, c.count = end, count
+	c.progress.Memos += len(refs)
+	return len(refs), nil
+}
+
+// check verifies that refs, sorted by block, lie one after the other from
+// block from to the end of the memo file.
+func (c *MemoCompactor) check(refs []memoRef, from int) error {
+	last := from
+	for _, ref := range refs {
+		if ref.blocks == 0 || ref.block < last {
+			return NewErrorf("memo file damaged at block %d: memos overlap or run past its end", ref.block)
+		}
+		last = ref.block + ref.blocks
+	}
+	return nil
+}
+
+// Step moves memos for about slice, and once all are in place cuts the dead
+// blocks off the end of the memo file. It places at least one memo more than
+// were written since the last step, however long that takes.
+//
+// Parameters:
+//   - slice: Time the step may take; it ends after the memo that passes it,
+//     once it has placed its minimum
+//
+// Returns:
+//   - bool: true once the memo file is compact
+//   - error: Error if the compaction was closed, the table cannot be locked
+//     or a file cannot be read or written
+func (c *MemoCompactor) Step(slice time.Duration) (bool, error) {
+	if c.done {
+		return true, nil
+	}
+	if !c.cursor.Active() {
+		return false, NewError("memo compaction not in progress")
+	}
+
+	start := time.Now()
+	err := c.step(start, slice)
+	c.progress.Elapsed += time.Since(start)
+	if err != nil {
+		return false, err
+	}
+	if c.done {
+		return true, c.Close()
+	}
+	return false, nil
+}
+
+// step does the work of Step with the table locked.
+func (c *MemoCompactor) step(start time.Time, slice time.Duration) error {
+	v, data := c.v, c.cursor.data
+	if result := v.keyed(func() C.int { return C.code4flush(v.codeBase) }); result < 0 {
+		return NewErrorf("failed to flush database before compaction: error code %d", int(result))
+	}
+	if result := C.d4lockAll(data); result != 0 {
+		return NewErrorf("failed to lock table for compaction: error code %d", int(result))
+	}
+	defer C.d4unlock(data)
+
+	// The table and its cursors read their records again where moved
+	var moved Bitmap
+	defer func() { c.reload(moved) }()
+
+	// Memos written since the last step at the end of the file must be
+	// placed too, and more memos placed than were written for the
+	// compaction to end
+	end, err := c.memo.next()
+	if err != nil {
+		return err
+	}
+	picked := 0
+	if end != c.end {
+		if picked, err = c.pickUp(end); err != nil {
+			return err
+		}
+	}
+
+	for placed := 0; len(c.refs) > 0; placed++ {
+		if placed > picked && time.Since(start) >= slice {
+			break
+		}
+		if err := c.place(c.refs[0], &moved); err != nil {
+			return err
+		}
+		c.refs = c.refs[1:]
+		c.progress.Placed++
+	}
+	if len(c.refs) == 0 {
+		if err := c.truncate(); err != nil {
+			return err
+		}
+		c.done = true
+	}
+	return nil
+}
+
+// place moves the memo ref down to dest, unless its record no longer points
+// to it, and advances dest past it.
+func (c *MemoCompactor) place(ref memoRef, moved *Bitmap) error {
+	field := c.fields[ref.field]
+	data := c.cursor.data
+	pointer := field.encode(ref.block)
+	result := c.cursor.keyed(func() C.int {
+		return C.vulpo4memoCheck(data, C.long(ref.recNo), C.int(field.offset), unsafe.Pointer(&pointer[0]), C.int(field.length))
+	})
+	if result < 0 {
+		return NewErrorf("failed to read record %d: error code %d", ref.recNo, int(result))
+	}
+	if result == 1 {
+		// Rewritten elsewhere since the scan: its blocks are dead
+		return nil
+	}
+
+	// A memo rewritten in place since the scan may have shrunk
+	blocks, err := c.memo.blocks(ref.block, ref.block+ref.blocks)
+	if err != nil {
+		return err
+	}
+	if blocks == 0 {
+		return NewErrorf("memo file damaged at block %d", ref.block)
+	}
+	if ref.block == c.dest {
+		c.dest += blocks
+		return nil
+	}
+
+	// The rest of its last block is copied too, unless the file ends first
+	size := blocks * c.memo.blockSize
+	if len(c.buf) < size {
+		c.buf = make([]byte, size)
+	}
+	if size = c.memo.readUpTo(ref.block, c.buf[:size]); size <= 0 {
+		return NewErrorf("failed to read memo block %d", ref.block)
+	}
+	if err := c.memo.write(c.dest, c.buf[:size]); err != nil {
+		return err
+	}
+	pointer = field.encode(c.dest)
+	result = c.cursor.keyed(func() C.int {
+		return C.vulpo4memoSet(data, C.int(field.offset), unsafe.Pointer(&pointer[0]), C.int(field.length))
+	})
+	if result != 0 {
+		return NewErrorf("failed to update memo pointer of record %d: error code %d", ref.recNo, int(result))
+	}
+
+	*moved = moved.grow(ref.recNo + 1)
+	moved.set(ref.recNo)
+	c.dest += blocks
+	c.progress.Moved++
+	c.progress.BytesMoved += int64(size)
+	return nil
+}
+
+// truncate cuts the memo file off after the last memo.
+func (c *MemoCompactor) truncate() error {
+	var header [4]byte
+	binary.BigEndian.PutUint32(header[:], uint32(c.dest))
+	if err := c.memo.write(0, header[:]); err != nil {
+		return err
+	}
+	if result := C.vulpo4memoTruncate(c.memo.file, C.long(c.dest*c.memo.blockSize)); result < 0 {
+		return NewErrorf("failed to truncate memo file: error code %d", int(result))
+	}
+	return nil
+}
+
+// reload reads again the current record of the table and of its cursors
+// where it is one of moved, so that they see, and write back, the new memo
+// pointer.
+func (c *MemoCompactor) reload(moved Bitmap) {
+	if moved.Count() == 0 {
+		return
+	}
+	for _, t := range c.tables() {
+		if recNo := int(C.d4recNo(t.data)); recNo > 0 && moved.Get(recNo) {
+			t.keyed(func() C.int { return C.d4go(t.data, C.long(recNo)) })
+		}
+	}
+}
+
+// tables returns the table and its cursors but the compactor's own.
+func (c *MemoCompactor) tables() []*Vulpo {
+	tables := []*Vulpo{c.v}
+	for cursor := range c.v.cursors {
+		if cursor != &c.cursor.Vulpo {
+			tables = append(tables, cursor)
+		}
+	}
+	return tables
+}
+
+// Progress reports how far the compaction has got.
+func (c *MemoCompactor) Progress() MemoCompactProgress {
+	return c.progress
+}
+
+// Close ends the compaction. Memos already moved stay where they are; the
+// memo file is consistent between steps, just not yet compact.
+//
+// Returns:
+//   - error: Error if closing the compactor's cursor fails
+func (c *MemoCompactor) Close() error {
+	if !c.cursor.Active() {
+		return nil
+	}
+	if c.v.packing != nil && c.v.packing.compactor == c {
+		c.v.packing.compactor = nil
+		c.v.packing.memos = nil
+	}
+	return c.cursor.Close()
+}
+
+// CompactMemos compacts the table's memo file with a MemoCompactor, run to
+// the end: the dead blocks left by rewritten memos are reclaimed and the
+// file shrinks to the memos records point to.
+//
+// Returns:
+//   - error: Error if the database is not open, has no memo file or the
+//     compaction fails
+//
+// Example:
+//
+//	if err := v.CompactMemos(); err != nil {
+//		log.Fatal(err)
+//	}
+func (v *Vulpo) CompactMemos() error {
+	c, err := v.NewMemoCompactor()
+	if err != nil {
+		return err
+	}
+	defer c.Close()
+
+	for {
+		done, err := c.Step(time.Second)
+		if err != nil || done {
+			return err
+		}
+	}
+}
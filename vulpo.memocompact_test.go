@@ -0,0 +1,320 @@
+package vulpo
+
+import (
+	"encoding/binary"
+	"fmt"
+	"os"
+	"path/filepath"
+	"strings"
+	"testing"
+	"time"
+)
+
+// fragmentedMemoTable writes a copy of testdata/basicmemo into a temporary
+// directory with its records repeated copies times, each memo in its own
+// blocks followed by a dead copy of it, and returns the path of the copy with
+// the memo of each record.
+func fragmentedMemoTable(t testing.TB, copies int) (string, []string) {
+	t.Helper()
+
+	rt := readRawTable(t, copyTable(t, "testdata/basicmemo.dbf", t.TempDir(), ".dbf"))
+	memo, err := os.ReadFile("testdata/basicmemo.fpt")
+	if err != nil {
+		t.Fatalf("Failed to read basicmemo.fpt: %v", err)
+	}
+	blockSize := int(binary.BigEndian.Uint16(memo[6:8]))
+	const offset = 5 // of the comments field
+
+	// The memo of each record of the original, with its length header
+	memos := make([][]byte, rt.count)
+	for i := range memos {
+		if block := int(binary.LittleEndian.Uint32(rt.record(i + 1)[offset:])); block != 0 {
+			n := 8 + int(binary.BigEndian.Uint32(memo[block*blockSize+4:]))
+			memos[i] = memo[block*blockSize : block*blockSize+n]
+		}
+	}
+
+	var records []byte
+	fpt := append([]byte(nil), memo[:memoHeaderLen]...)
+	var want []string
+	for c := 0; c < copies; c++ {
+		for i := range memos {
+			record := append([]byte(nil), rt.record(i+1)...)
+			if memos[i] == nil {
+				want = append(want, "")
+			} else {
+				binary.LittleEndian.PutUint32(record[offset:], uint32(len(fpt)/blockSize))
+				want = append(want, string(memos[i][8:]))
+				for dead := 0; dead < 2; dead++ {
+					fpt = append(fpt, memos[i]...)
+					fpt = append(fpt, make([]byte, (blockSize-len(fpt)%blockSize)%blockSize)...)
+				}
+			}
+			records = append(records, record...)
+		}
+	}
+	rt.setRecords(records)
+	rt.write(t)
+	binary.BigEndian.PutUint32(fpt[0:4], uint32(len(fpt)/blockSize))
+
+	path := rt.path
+	if err := os.WriteFile(filepath.Join(filepath.Dir(path), "basicmemo.fpt"), fpt, 0o644); err != nil {
+		t.Fatalf("Failed to write memo file: %v", err)
+	}
+	return path, want
+}
+
+// checkMemos reads the comments of every record and compares them with want.
+func checkMemos(t *testing.T, v *Vulpo, want []string) {
+	t.Helper()
+
+	field := v.FieldByName("comments")
+	for recNo := 1; recNo <= len(want); recNo++ {
+		if err := v.Goto(recNo); err != nil {
+			t.Fatalf("Goto(%d) failed: %v", recNo, err)
+		}
+		if got, err := field.AsString(); err != nil || got != want[recNo-1] {
+			t.Fatalf("Record %d memo = %d bytes, %v, want %d bytes", recNo, len(got), err, len(want[recNo-1]))
+		}
+	}
+}
+
+func TestVulpo_MemoStats(t *testing.T) {
+	v := &Vulpo{}
+	if _, err := v.MemoStats(); err == nil {
+		t.Error("Expected error for MemoStats with inactive database")
+	}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	if _, err := v.MemoStats(); err == nil {
+		t.Error("Expected error for MemoStats without a memo file")
+	}
+	if _, err := v.NewMemoCompactor(); err == nil {
+		t.Error("Expected error for NewMemoCompactor without a memo file")
+	}
+	_ = v.Close()
+
+	// basicmemo is compact: its two memos take all 50 blocks after the header
+	if err := v.Open("testdata/basicmemo.dbf"); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+	stats, err := v.MemoStats()
+	if err != nil {
+		t.Fatalf("MemoStats failed: %v", err)
+	}
+	if stats != (MemoStats{BlockSize: 64, Blocks: 50, LiveBlocks: 50, Memos: 2}) || stats.Fragmentation() != 0 {
+		t.Errorf("MemoStats = %+v, fragmentation %v", stats, stats.Fragmentation())
+	}
+}
+
+func TestVulpo_CompactMemos(t *testing.T) {
+	path, want := fragmentedMemoTable(t, 10)
+	v := &Vulpo{}
+	if err := v.Open(path); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	before, err := v.MemoStats()
+	if err != nil {
+		t.Fatalf("MemoStats failed: %v", err)
+	}
+	if before.Memos != 20 || before.Blocks != 2*before.LiveBlocks || before.Fragmentation() != 0.5 {
+		t.Fatalf("MemoStats = %+v, want 20 memos and half the blocks dead", before)
+	}
+
+	if err := v.CompactMemos(); err != nil {
+		t.Fatalf("CompactMemos failed: %v", err)
+	}
+	after, err := v.MemoStats()
+	if err != nil {
+		t.Fatalf("MemoStats failed: %v", err)
+	}
+	if after.Memos != 20 || after.Blocks != before.LiveBlocks || after.DeadBlocks() != 0 {
+		t.Errorf("MemoStats after compaction = %+v, want %d blocks all live", after, before.LiveBlocks)
+	}
+	info, err := os.Stat(filepath.Join(filepath.Dir(path), "basicmemo.fpt"))
+	if err != nil {
+		t.Fatalf("Stat failed: %v", err)
+	}
+	if size := int(info.Size()); size != memoHeaderLen+after.Blocks*after.BlockSize {
+		t.Errorf("Memo file is %d bytes, want %d", size, memoHeaderLen+after.Blocks*after.BlockSize)
+	}
+	checkMemos(t, v, want)
+
+	// The moved pointers are on disk
+	if err := v.Close(); err != nil {
+		t.Fatalf("Close failed: %v", err)
+	}
+	if err := v.Open(path); err != nil {
+		t.Fatalf("Failed to reopen test file: %v", err)
+	}
+	checkMemos(t, v, want)
+}
+
+func TestVulpo_NewMemoCompactor_Steps(t *testing.T) {
+	path, want := fragmentedMemoTable(t, 10)
+	v := &Vulpo{}
+	if err := v.Open(path); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+	c2, err := v.NewCursor()
+	if err != nil {
+		t.Fatalf("NewCursor failed: %v", err)
+	}
+	defer c2.Close()
+
+	compactor, err := v.NewMemoCompactor()
+	if err != nil {
+		t.Fatalf("NewMemoCompactor failed: %v", err)
+	}
+	defer compactor.Close()
+
+	// The table sits on the last record, whose memo moves in the last step;
+	// a cursor reads memos between steps
+	if err := v.Goto(len(want)); err != nil {
+		t.Fatalf("Goto failed: %v", err)
+	}
+	field := v.FieldByName("comments")
+	if got, _ := field.AsString(); got != want[len(want)-1] {
+		t.Fatalf("Last memo = %d bytes, want %d", len(got), len(want[len(want)-1]))
+	}
+
+	steps := 0
+	for {
+		done, err := compactor.Step(time.Nanosecond)
+		if err != nil {
+			t.Fatalf("Step failed: %v", err)
+		}
+		steps++
+		if done {
+			break
+		}
+		checkMemos(t, &c2.Vulpo, want)
+	}
+
+	progress := compactor.Progress()
+	if steps != 20 || progress.Placed != 20 || progress.Moved != 19 || progress.BytesMoved == 0 {
+		t.Errorf("Compaction took %d steps, progress %+v; want one step per memo, all but the first moved", steps, progress)
+	}
+	if got, _ := field.AsString(); got != want[len(want)-1] {
+		t.Errorf("Last memo after compaction = %d bytes, want %d", len(got), len(want[len(want)-1]))
+	}
+	if stats, err := v.MemoStats(); err != nil || stats.Fragmentation() != 0 {
+		t.Errorf("MemoStats after compaction = %+v, %v", stats, err)
+	}
+	if done, err := compactor.Step(time.Second); err != nil || !done {
+		t.Errorf("Step after completion = %v, %v, want done", done, err)
+	}
+	checkMemos(t, v, want)
+}
+
+func TestVulpo_NewMemoCompactor_BusyTable(t *testing.T) {
+	path, want := fragmentedMemoTable(t, 10)
+	v := &Vulpo{}
+	if err := v.Open(path); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	compactor, err := v.NewMemoCompactor()
+	if err != nil {
+		t.Fatalf("NewMemoCompactor failed: %v", err)
+	}
+	defer compactor.Close()
+	if _, err := v.NewMemoCompactor(); err == nil {
+		t.Error("Second NewMemoCompactor succeeded, want error")
+	}
+	memos := compactor.Progress().Memos
+
+	// Between steps a memo grows, which moves it to the end of the file, and
+	// a record is appended with a memo: two new memos for each one a step of
+	// a nanosecond would place on its own
+	field := v.FieldByName("comments")
+	steps := 0
+	for done := false; !done; steps++ {
+		if steps > memos {
+			t.Fatalf("Compaction not done after %d steps, progress %+v", steps, compactor.Progress())
+		}
+		recNo := steps%len(want) + 1
+		if err := v.Goto(recNo); err != nil {
+			t.Fatalf("Goto failed: %v", err)
+		}
+		want[recNo-1] += strings.Repeat("grown ", 20)
+		if err := field.SetString(want[recNo-1]); err != nil {
+			t.Fatalf("SetString failed: %v", err)
+		}
+		appended := fmt.Sprintf("appended before step %d", steps)
+		if err := v.Append(func() error { return field.SetString(appended) }); err != nil {
+			t.Fatalf("Append failed: %v", err)
+		}
+		want = append(want, appended)
+
+		if done, err = compactor.Step(time.Nanosecond); err != nil {
+			t.Fatalf("Step failed: %v", err)
+		}
+	}
+
+	if progress := compactor.Progress(); progress.Memos != memos+2*steps || progress.Placed != progress.Memos {
+		t.Errorf("Progress after %d steps = %+v, want %d memos, all placed", steps, progress, memos+2*steps)
+	}
+	checkMemos(t, v, want)
+	if err := v.Close(); err != nil {
+		t.Fatalf("Close failed: %v", err)
+	}
+	if err := v.Open(path); err != nil {
+		t.Fatalf("Failed to reopen test file: %v", err)
+	}
+	checkMemos(t, v, want)
+}
+
+func TestVulpo_NewMemoCompactor_Pack(t *testing.T) {
+	path, want := fragmentedMemoTable(t, 10)
+	v := &Vulpo{}
+	if err := v.Open(path); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+	if err := v.Goto(1); err != nil {
+		t.Fatalf("Goto failed: %v", err)
+	}
+	if err := v.Delete(); err != nil {
+		t.Fatalf("Delete failed: %v", err)
+	}
+
+	// A pack renumbers the records the compaction knows its memos by
+	compactor, err := v.NewMemoCompactor()
+	if err != nil {
+		t.Fatalf("NewMemoCompactor failed: %v", err)
+	}
+	if done, err := compactor.Step(time.Nanosecond); err != nil || done {
+		t.Fatalf("Step = %v, %v, want the compaction unfinished", done, err)
+	}
+	if err := v.Pack(); err == nil {
+		t.Error("Pack during a memo compaction succeeded, want error")
+	}
+	if p, err := v.NewPacker(nil); err == nil {
+		_ = p.Abort()
+		t.Error("NewPacker during a memo compaction succeeded, want error")
+	}
+	checkMemos(t, v, want)
+
+	if err := compactor.Close(); err != nil {
+		t.Fatalf("Close failed: %v", err)
+	}
+	p, err := v.NewPacker(nil)
+	if err != nil {
+		t.Fatalf("NewPacker failed: %v", err)
+	}
+	if c, err := v.NewMemoCompactor(); err == nil {
+		_ = c.Close()
+		t.Error("NewMemoCompactor during a pack succeeded, want error")
+	}
+	if err := p.Finish(); err != nil {
+		t.Fatalf("Finish failed: %v", err)
+	}
+	checkMemos(t, v, want[1:])
+}
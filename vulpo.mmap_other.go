@@ -0,0 +1,17 @@
+//go:build !unix
+
+package vulpo
+
+import (
+	"os"
+)
+
+// mapFile is not supported on this platform; scans fall back to ReadBatch.
+func mapFile(_ *os.File, _ int) ([]byte, error) {
+	return nil, NewError("memory-mapped scans are not supported on this platform")
+}
+
+// unmapFile is a no-op on platforms without mapFile support.
+func unmapFile(_ []byte) error {
+	return nil
+}
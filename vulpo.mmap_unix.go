@@ -0,0 +1,18 @@
+//go:build unix
+
+package vulpo
+
+import (
+	"os"
+	"syscall"
+)
+
+// mapFile maps the first length bytes of f read-only into memory.
+func mapFile(f *os.File, length int) ([]byte, error) {
+	return syscall.Mmap(int(f.Fd()), 0, length, syscall.PROT_READ, syscall.MAP_SHARED)
+}
+
+// unmapFile releases a mapping created by mapFile.
+func unmapFile(data []byte) error {
+	return syscall.Munmap(data)
+}
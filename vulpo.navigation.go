@@ -32,7 +32,7 @@ func (v *Vulpo) Goto(recordidx int) error {
 		return NewErrorf("invalid record index: %d (must be > 0)", recordidx)
 	}
 
-	result := C.d4go(v.data, C.long(recordidx))
+	result := v.keyed(func() C.int { return C.d4go(v.data, C.long(recordidx)) })
 	if result != 0 {
 		return NewErrorf("failed to go to record %d: error code %d", recordidx, int(result))
 	}
@@ -60,7 +60,7 @@ func (v *Vulpo) Next() error {
 		return NewError("database not open")
 	}
 
-	result := C.d4skip(v.data, 1)
+	result := v.keyed(func() C.int { return C.d4skip(v.data, 1) })
 	if result != 0 {
 		return NewErrorf("failed to move to next record: error code %d", int(result))
 	}
@@ -88,7 +88,7 @@ func (v *Vulpo) Previous() error {
 		return NewError("database not open")
 	}
 
-	result := C.d4skip(v.data, -1)
+	result := v.keyed(func() C.int { return C.d4skip(v.data, -1) })
 	if result != 0 {
 		return NewErrorf("failed to move to previous record: error code %d", int(result))
 	}
@@ -117,7 +117,7 @@ func (v *Vulpo) Skip(num int) error {
 		return NewError("database not open")
 	}
 
-	result := C.d4skip(v.data, C.long(num))
+	result := v.keyed(func() C.int { return C.d4skip(v.data, C.long(num)) })
 	if result != 0 {
 		return NewErrorf("failed to skip %d records: error code %d", num, int(result))
 	}
@@ -132,7 +132,7 @@ func (v *Vulpo) First() error {
 		return NewError("database not open")
 	}
 
-	result := C.d4top(v.data)
+	result := v.keyed(func() C.int { return C.d4top(v.data) })
 	if result != 0 {
 		return NewErrorf("failed to go to first record: error code %d", int(result))
 	}
@@ -147,7 +147,7 @@ func (v *Vulpo) Last() error {
 		return NewError("database not open")
 	}
 
-	result := C.d4bottom(v.data)
+	result := v.keyed(func() C.int { return C.d4bottom(v.data) })
 	if result != 0 {
 		return NewErrorf("failed to go to last record: error code %d", int(result))
 	}
@@ -155,6 +155,100 @@ func (v *Vulpo) Last() error {
 	return nil
 }
 
+// FirstActive moves the cursor to the first record in the current navigation
+// order that is not marked for deletion.
+//
+// Returns:
+//   - error: nil on success, also when no record is active, with EOF()
+//     reporting true; error if navigation fails
+//
+// Without a selected tag, the deleted records are skipped using the set
+// CountDeleted keeps (built on first use), without being read. With a tag,
+// records are read in tag order until one is not deleted.
+//
+// Example:
+//
+//	for err := v.FirstActive(); err == nil && !v.EOF(); err = v.NextActive() {
+//		// process record
+//	}
+func (v *Vulpo) FirstActive() error {
+	if !v.Active() {
+		return NewError("database not open")
+	}
+
+	var err error
+	if C.d4tagSelected(v.data) == nil {
+		err = v.skipToActive(1)
+	} else if err = v.First(); err == nil && !v.atEOF() {
+		err = v.stepToActive()
+	}
+	// Running off the end of an empty or all deleted table finds no active
+	// record, which is not a failure
+	if err != nil && v.atEOF() {
+		return nil
+	}
+	return err
+}
+
+// NextActive moves the cursor to the next record in the current navigation
+// order that is not marked for deletion, as FirstActive does from the top.
+//
+// Returns:
+//   - error: nil on success, error if navigation fails, as Next does past
+//     the last record
+func (v *Vulpo) NextActive() error {
+	if !v.Active() {
+		return NewError("database not open")
+	}
+
+	if C.d4tagSelected(v.data) == nil && !v.atEOF() {
+		return v.skipToActive(max(v.Position(), 0) + 1)
+	}
+	if err := v.Next(); err != nil || v.atEOF() {
+		return err
+	}
+	return v.stepToActive()
+}
+
+// skipToActive goes to the first record at or after physical record from
+// that the deleted set does not hold, or past the last record.
+func (v *Vulpo) skipToActive(from int) error {
+	set, err := v.deletedRecords(false)
+	if err != nil {
+		return err
+	}
+
+	// Records added since the set was built count as not deleted until read
+	recNo := set.bits.nextClear(from)
+	if recNo > set.count && recNo > int(C.d4recCountDo(v.data)) {
+		v.keyed(func() C.int { return C.d4goEof(v.data) })
+		return NewErrorf("failed to move to next record: error code %d", int(C.r4eof))
+	}
+
+	if err := v.Goto(recNo); err != nil {
+		return err
+	}
+	if C.d4deleted(v.data) != 0 {
+		if recNo <= set.count {
+			// Deleted by another process since the set was built
+			set.invalidate()
+		}
+		return v.stepToActive()
+	}
+	return nil
+}
+
+// stepToActive moves on in the current order while the current record is
+// deleted.
+func (v *Vulpo) stepToActive() error {
+	for C.d4deleted(v.data) != 0 {
+		if err := v.Next(); err != nil || v.atEOF() {
+			return err
+		}
+	}
+	return nil
+}
+
 // Position returns the current record number (1-indexed).
 // Returns -1 if the database is not active or if at EOF/BOF.
 func (v *Vulpo) Position() int {
@@ -202,3 +296,14 @@ func (v *Vulpo) EOF() bool {
 func (v *Vulpo) IsEOF() bool {
 	return v.EOF()
 }
+
+// atBOF and atEOF read the cursor flags straight from the DATA4 structure.
+// They are used on hot field-reading paths where the d4bof/d4eof cgo calls
+// would otherwise dominate; callers must have checked Active().
+func (v *Vulpo) atBOF() bool {
+	return v.data.bofFlag != 0
+}
+
+func (v *Vulpo) atEOF() bool {
+	return v.data.eofFlag != 0
+}
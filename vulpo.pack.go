@@ -0,0 +1,828 @@
+package vulpo
+
+/*
+#include "d4all.h"
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+// vulpo4packIndexName returns the name of the i-th index file open on the
+// table, or NULL past the last one.
+static const char *vulpo4packIndexName(DATA4 *data, int i)
+{
+   INDEX4FILE *indexFile ;
+
+   for ( indexFile = (INDEX4FILE *)l4first( &data->dataFile->indexes ) ; indexFile != 0 ; indexFile = (INDEX4FILE *)l4next( &data->dataFile->indexes, indexFile ) )
+      if ( i-- == 0 )
+         return indexFile->file.name ;
+   return 0 ;
+}
+
+// vulpo4packTag returns the i-th tag of the table's production index, or
+// NULL past the last one.
+static TAG4FILE *vulpo4packTag(DATA4 *data, int i)
+{
+   INDEX4FILE *indexFile = (INDEX4FILE *)l4first( &data->dataFile->indexes ) ;
+   TAG4FILE *tagFile = 0 ;
+
+   if ( indexFile == 0 )
+      return 0 ;
+   while ( ( tagFile = (TAG4FILE *)l4next( &indexFile->tags, tagFile ) ) != 0 && i-- > 0 )
+      ;
+   return tagFile ;
+}
+
+// vulpo4packMemoName returns the name of the table's memo file, or NULL.
+static const char *vulpo4packMemoName(DATA4 *data)
+{
+   if ( data->dataFile->memoFile.file.hand == INVALID4HANDLE )
+      return 0 ;
+   return data->dataFile->memoFile.file.name ;
+}
+
+// vulpo4packPut writes record, a whole record, over record recNo of data, or
+// appends it when recNo is 0, updating the tags as a change through the
+// fields would. Memo fields keep the block numbers in record.
+static int vulpo4packPut(DATA4 *data, long recNo, const void *record)
+{
+   int rc ;
+
+   if ( recNo == 0 )
+   {
+      rc = d4appendStart( data, 0 ) ;
+      if ( rc != 0 )
+         return rc < 0 ? rc : -1 ;
+      memcpy( data->record, record, data->dataFile->recWidth ) ;
+      return d4append( data ) ;
+   }
+
+   rc = d4go( data, recNo ) ;
+   if ( rc != 0 )
+      return rc < 0 ? rc : -1 ;
+   memcpy( data->record, record, data->dataFile->recWidth ) ;
+   d4changed( data, 1 ) ;
+   return d4updateRecord( data, 0 ) ;
+}
+
+// vulpo4packReopen points file at the file now found under its name, which
+// has replaced the one it had open, keeping the handle number so that every
+// structure holding it stays valid.
+static int vulpo4packReopen(FILE4 *file)
+{
+   int flags, fd, rc ;
+
+   flags = fcntl( file->hand, F_GETFL ) ;
+   if ( flags < 0 )
+      return -1 ;
+   fd = open( file->name, flags & ( O_ACCMODE | O_APPEND ) ) ;
+   if ( fd < 0 )
+      return -1 ;
+   rc = dup2( fd, file->hand ) ;
+   close( fd ) ;
+   return rc < 0 ? -1 : 0 ;
+}
+
+// vulpo4packSwap moves the table's data and index files over to the packed
+// files renamed into their place, then drops the blocks CodeBase holds from
+// the old ones (d4refresh). New index blocks go at the end of the new file,
+// as after opening it. The tags reload their headers on next use as the
+// index version changed.
+static int vulpo4packSwap(DATA4 *data)
+{
+   DATA4FILE *dataFile = data->dataFile ;
+   INDEX4FILE *indexFile ;
+
+   if ( vulpo4packReopen( &dataFile->file ) < 0 )
+      return -1 ;
+   for ( indexFile = (INDEX4FILE *)l4first( &dataFile->indexes ) ; indexFile != 0 ; indexFile = (INDEX4FILE *)l4next( &dataFile->indexes, indexFile ) )
+   {
+      if ( vulpo4packReopen( &indexFile->file ) < 0 )
+         return -1 ;
+      indexFile->eof = (long)file4len( &indexFile->file ) ;
+   }
+   return d4refresh( data ) ;
+}
+*/
+import "C"
+import (
+	"bufio"
+	"encoding/binary"
+	"io"
+	"os"
+	"path/filepath"
+	"time"
+	"unsafe"
+)
+
+// packRename renames the files of a pack swap; tests make it fail.
+var packRename = os.Rename
+
+// PackPhase is the stage an online pack has reached.
+type PackPhase int
+
+const (
+	// PackCopy copies the records not marked for deletion to the packed file
+	PackCopy PackPhase = iota
+	// PackIndex rebuilds the index of the packed file
+	PackIndex
+	// PackReady waits for Finish to swap the packed file in
+	PackReady
+	// PackDone is reached once the packed file has replaced the table
+	PackDone
+)
+
+// String returns the name of the phase.
+func (p PackPhase) String() string {
+	switch p {
+	case PackCopy:
+		return "copy"
+	case PackIndex:
+		return "index"
+	case PackReady:
+		return "ready"
+	case PackDone:
+		return "done"
+	default:
+		return "unknown"
+	}
+}
+
+// PackProgress reports how far an online pack has got.
+type PackProgress struct {
+	Phase          PackPhase
+	Done           int           // Records copied, or tags rebuilt
+	Total          int           // Records to copy, or tags to rebuild
+	Tag            string        // Tag just rebuilt, in the PackIndex phase
+	Kept           int           // Records written to the packed file
+	Elapsed        time.Duration // Time spent in Step and Finish so far
+	BytesPerSecond float64       // Data file read rate of the copy
+}
+
+// packChunk is the amount of the data file a Packer reads at once.
+const packChunk = 1 << 20
+
+// packStepRecords is the number of records PackOnline copies per step.
+const packStepRecords = 1 << 16
+
+// packLog notes the records changed through the table or its cursors while a
+// Packer runs, so that Finish can carry the changes over to the packed file,
+// and while a MemoCompactor runs, so that its next step finds the memos
+// written since the last one. It is shared by the table and its cursors.
+// The two do not run together: a pack renumbers the records the compactor
+// knows its memos by.
+type packLog struct {
+	packer    *Packer
+	changed   Bitmap
+	compactor *MemoCompactor
+	memos     Bitmap // changed since the compactor's last step
+}
+
+// note records a change to record recNo.
+func (l *packLog) note(recNo int) {
+	if recNo < 1 {
+		return
+	}
+	if l.packer != nil {
+		l.changed = l.changed.grow(recNo + 1)
+		l.changed.set(recNo)
+	}
+	if l.compactor != nil {
+		l.memos = l.memos.grow(recNo + 1)
+		l.memos.set(recNo)
+	}
+}
+
+// Packer packs a table in steps while it stays in use (see NewPacker).
+type Packer struct {
+	v        *Vulpo
+	progress func(PackProgress)
+	phase    PackPhase
+
+	dir       string   // directory holding the packed files until the swap
+	dataPath  string   // packed data file
+	indexPath string   // packed production index, "" without one
+	index     string   // the table's production index
+	src       *os.File // the table's data file, read by the copy
+	dst       *os.File // packed data file, written by the copy
+	out       *bufio.Writer
+	shadow    *Vulpo // packed table, open from the index phase on
+	buf       []byte
+	originals [][2]string         // the table's files linked aside by replace, and their paths
+	headers   map[string]C.S4LONG // offset of each tag's header in the packed index, by tag name
+	swapped   bool                // Finish got to the swap, so only Abort is left
+	damaged   bool                // a failed swap could not be undone
+
+	headerLen int
+	recordLen int
+	count     int    // records when the pack started
+	copied    int    // records read by the copy
+	kept      Bitmap // records written to the packed file
+	written   int
+	tag       string // tag last rebuilt
+	tags      [2]int // tags rebuilt, tags to rebuild
+	elapsed   time.Duration
+	copying   time.Duration
+}
+
+// NewPacker starts an online pack of the table: the records not marked for
+// deletion are copied to a new data file in steps, the index is rebuilt on
+// the copy, and Finish then swaps the new files in for the table's own.
+// Between steps the table, its cursors and other programs reading it carry
+// on as usual; only Finish holds the table locked, for as long as it takes
+// to carry over the changes made since the copy started.
+//
+// Parameters:
+//   - progress: Called after each step and as each tag is rebuilt, or nil
+//
+// Returns:
+//   - *Packer: The pack, to drive with Step and complete with Finish
+//   - error: Error if the database is not open, is a cursor, a pack or a
+//     memo compaction is already running or the packed files cannot be
+//     created
+//
+// The packed files are written to a hidden directory beside the table. The
+// memo file is not rewritten: the copied records keep their memo blocks, as
+// they do with Pack. Changes made through this table and its cursors while
+// the pack runs are carried over by Finish. Records deleted meanwhile stay in
+// the packed file, marked deleted, and records recalled after the copy
+// passed them are added at its end. Other programs must not write to the
+// table until Finish returns; programs that keep it open across Finish go on
+// seeing the unpacked file.
+//
+// Example:
+//
+//	p, err := v.NewPacker(nil)
+//	if err != nil {
+//		return err
+//	}
+//	for {
+//		done, err := p.Step(100000)
+//		if err != nil {
+//			p.Abort()
+//			return err
+//		}
+//		if done {
+//			break
+//		}
+//		// serve requests on v
+//	}
+//	return p.Finish()
+func (v *Vulpo) NewPacker(progress func(PackProgress)) (*Packer, error) {
+	if !v.Active() {
+		return nil, NewError("database not open")
+	}
+	if v.cursor {
+		return nil, NewError("cannot pack through a cursor")
+	}
+	if v.packing.packer != nil {
+		return nil, NewError("pack already in progress")
+	}
+	if v.packing.compactor != nil {
+		return nil, NewError("cannot pack while a memo compaction is in progress")
+	}
+
+	// The copy reads the file, so pending changes must be in it
+	if result := v.keyed(func() C.int { return C.code4flush(v.codeBase) }); result < 0 {
+		return nil, NewErrorf("failed to flush database before pack: error code %d", int(result))
+	}
+
+	p := &Packer{
+		v:         v,
+		progress:  progress,
+		headerLen: v.header.headerLen,
+		recordLen: v.header.recordLen,
+		count:     int(C.d4recCountDo(v.data)),
+	}
+	if err := p.create(); err != nil {
+		p.cleanup()
+		return nil, err
+	}
+
+	v.packing.packer = p
+	v.packing.changed = nil
+	return p, nil
+}
+
+// create makes the directory of the packed files, starts the packed data
+// file with the table's header and puts the production index and memo file
+// beside it, so that the packed table opens like the table.
+func (p *Packer) create() error {
+	v := p.v
+	if C.vulpo4packIndexName(v.data, 1) != nil {
+		return NewError("online pack supports the production index only")
+	}
+
+	dir, err := os.MkdirTemp(filepath.Dir(v.filename), "."+filepath.Base(v.filename)+".pack")
+	if err != nil {
+		return NewError("failed to create pack directory").SetWrapped(err)
+	}
+	p.dir = dir
+	p.dataPath = filepath.Join(dir, filepath.Base(v.filename))
+
+	if p.src, err = os.Open(v.filename); err != nil {
+		return NewErrorf("failed to open data file for packing: %s", v.filename).SetWrapped(err)
+	}
+	if p.dst, err = os.Create(p.dataPath); err != nil {
+		return NewError("failed to create packed data file").SetWrapped(err)
+	}
+	header := make([]byte, p.headerLen)
+	if _, err := p.src.ReadAt(header, 0); err != nil {
+		return NewErrorf("failed to read header of %s", v.filename).SetWrapped(err)
+	}
+	p.out = bufio.NewWriterSize(p.dst, packChunk)
+	if _, err := p.out.Write(header); err != nil {
+		return NewError("failed to write packed data file").SetWrapped(err)
+	}
+
+	if name := C.vulpo4packIndexName(v.data, 0); name != nil {
+		p.index = C.GoString(name)
+		p.indexPath = filepath.Join(dir, filepath.Base(p.index))
+		if err := copyFile(p.index, p.indexPath); err != nil {
+			return NewErrorf("failed to copy index file %s", p.index).SetWrapped(err)
+		}
+	}
+	if name := C.vulpo4packMemoName(v.data); name != nil {
+		// Only opened, never written: the packed records use its blocks
+		memo := C.GoString(name)
+		if err := os.Link(memo, filepath.Join(dir, filepath.Base(memo))); err != nil {
+			return NewErrorf("failed to link memo file %s", memo).SetWrapped(err)
+		}
+	}
+
+	p.kept = Bitmap(nil).grow(p.count + 1)
+	p.buf = make([]byte, max(1, packChunk/p.recordLen)*p.recordLen)
+	return nil
+}
+
+// copyFile copies the file at from to a new file at to.
+func copyFile(from, to string) error {
+	in, err := os.Open(from)
+	if err != nil {
+		return err
+	}
+	defer in.Close()
+
+	out, err := os.Create(to)
+	if err != nil {
+		return err
+	}
+	if _, err := io.Copy(out, in); err != nil {
+		_ = out.Close()
+		return err
+	}
+	return out.Close()
+}
+
+// Step does the next part of the pack: it copies up to records records, or,
+// once all are copied, rebuilds the index of the packed file in one go.
+//
+// Parameters:
+//   - records: Most records to copy in this step; bounds its duration
+//
+// Returns:
+//   - bool: true once the pack is ready for Finish
+//   - error: Error if the table was closed or a file cannot be read or written
+func (p *Packer) Step(records int) (bool, error) {
+	if !p.v.Active() || p.v.packing.packer != p {
+		return false, NewError("pack not in progress")
+	}
+	if records <= 0 {
+		return false, NewErrorf("invalid number of records to copy: %d", records)
+	}
+
+	start := time.Now()
+	var err error
+	switch p.phase {
+	case PackCopy:
+		// Changes pending in record buffers go to the file before the copy
+		// reads it, so the records ahead of the copy are taken as they are
+		if result := p.v.keyed(func() C.int { return C.code4flush(p.v.codeBase) }); result < 0 {
+			return false, NewErrorf("failed to flush database before copy: error code %d", int(result))
+		}
+		err = p.copyRecords(records)
+		p.copying += time.Since(start)
+	case PackIndex:
+		err = p.rebuildIndex()
+	}
+	p.elapsed += time.Since(start)
+	if err != nil {
+		return false, err
+	}
+
+	p.report()
+	if p.phase == PackCopy && p.dst == nil {
+		p.phase = PackIndex
+	}
+	return p.phase == PackReady, nil
+}
+
+// copyRecords copies the next records records that are not marked for
+// deletion to the packed data file, and completes the file after the last.
+func (p *Packer) copyRecords(records int) error {
+	end := min(p.copied+records, p.count)
+	for p.copied < end {
+		n := min(len(p.buf)/p.recordLen, end-p.copied)
+		chunk := p.buf[:n*p.recordLen]
+		if _, err := p.src.ReadAt(chunk, int64(p.headerLen+p.copied*p.recordLen)); err != nil {
+			return NewErrorf("failed to read data file: %s", p.v.filename).SetWrapped(err)
+		}
+		for i := 0; i < n; i++ {
+			record := chunk[i*p.recordLen : (i+1)*p.recordLen]
+			if record[0] == '*' {
+				continue
+			}
+			if _, err := p.out.Write(record); err != nil {
+				return NewError("failed to write packed data file").SetWrapped(err)
+			}
+			p.kept.set(p.copied + i + 1)
+			p.written++
+		}
+		p.copied += n
+	}
+	if p.copied < p.count {
+		return nil
+	}
+
+	// End of file mark and the record count in the header
+	if err := p.out.WriteByte(0x1A); err != nil {
+		return NewError("failed to write packed data file").SetWrapped(err)
+	}
+	if err := p.out.Flush(); err != nil {
+		return NewError("failed to write packed data file").SetWrapped(err)
+	}
+	var count [4]byte
+	binary.LittleEndian.PutUint32(count[:], uint32(p.written))
+	if _, err := p.dst.WriteAt(count[:], 4); err != nil {
+		return NewError("failed to write packed data file").SetWrapped(err)
+	}
+	if err := p.dst.Close(); err != nil {
+		return NewError("failed to write packed data file").SetWrapped(err)
+	}
+	p.dst = nil
+	return nil
+}
+
+// rebuildIndex opens the packed table and rebuilds its index with Reindex.
+func (p *Packer) rebuildIndex() error {
+	p.shadow = &Vulpo{}
+	if err := p.shadow.Open(p.dataPath); err != nil {
+		p.shadow = nil
+		return NewErrorf("failed to open packed data file: %v", err)
+	}
+	if p.indexPath != "" {
+		err := p.shadow.Reindex(func(tag string, done, total int) {
+			p.tag, p.tags = tag, [2]int{done, total}
+			p.report()
+		})
+		if err != nil {
+			return NewErrorf("failed to rebuild packed index: %v", err)
+		}
+	}
+	p.phase = PackReady
+	return nil
+}
+
+// Progress reports how far the pack has got.
+func (p *Packer) Progress() PackProgress {
+	progress := PackProgress{
+		Phase:   p.phase,
+		Done:    p.copied,
+		Total:   p.count,
+		Kept:    p.written,
+		Elapsed: p.elapsed,
+	}
+	if p.copying > 0 {
+		progress.BytesPerSecond = float64(p.copied*p.recordLen) / p.copying.Seconds()
+	}
+	if p.phase == PackIndex || (p.phase >= PackReady && p.tags[1] > 0) {
+		progress.Done, progress.Total, progress.Tag = p.tags[0], p.tags[1], p.tag
+	}
+	return progress
+}
+
+// report passes the progress to the callback given to NewPacker.
+func (p *Packer) report() {
+	if p.progress != nil {
+		p.progress(p.Progress())
+	}
+}
+
+// Finish completes the pack: any steps left are run, then, with the table
+// locked, the changes made through the table and its cursors since the pack
+// started are carried over to the packed files, which replace the table's
+// own. The table and its cursors stay open, on the first record.
+//
+// Returns:
+//   - error: Error if the pack is not in progress, a memo compaction is
+//     running, the table cannot be locked or the files cannot be swapped.
+//     Once a running compaction is closed, Finish can be called again.
+//     Otherwise the table is left on its own files and the pack is to be
+//     aborted, unless the error says the table is damaged: a swap that
+//     failed half way could not be undone, and the table's original files
+//     are kept in the pack directory it names
+//
+// The table's files are linked into the pack directory before the packed
+// files are renamed over them, so that a swap failing part way through is
+// undone by renaming them back.
+//
+// Once the steps are done, the time Finish holds the lock grows with the
+// number of records changed during the pack, not with the size of the
+// table. As after Pack, record numbers change and MatchSets and deleted
+// record lists taken before are no longer valid.
+func (p *Packer) Finish() error {
+	for p.phase < PackReady {
+		if _, err := p.Step(packStepRecords); err != nil {
+			return err
+		}
+	}
+	if !p.v.Active() || p.v.packing.packer != p {
+		return NewError("pack not in progress")
+	}
+	if p.swapped {
+		return NewError("pack failed in Finish; abort it")
+	}
+	// The compaction knows the memos by record number
+	if p.v.packing.compactor != nil {
+		return NewError("cannot finish pack while a memo compaction is in progress")
+	}
+
+	start := time.Now()
+	v := p.v
+	if result := v.keyed(func() C.int { return C.code4flush(v.codeBase) }); result < 0 {
+		return NewErrorf("failed to flush database before swap: error code %d", int(result))
+	}
+	p.swapped = true
+	if err := p.replace(); err != nil {
+		return err
+	}
+	if result := C.vulpo4packSwap(v.data); result != 0 {
+		// Back onto the table's own files, under their names again
+		err := p.restore(NewErrorf("failed to reopen packed table: error code %d", int(result)))
+		if !p.damaged && C.vulpo4packSwap(v.data) != 0 {
+			p.damaged = true
+			return NewErrorf("table is damaged: failed to reopen packed table and then the table's own files; close and reopen it")
+		}
+		return err
+	}
+
+	// Reindex lays the tag headers out afresh, wherever the table's index
+	// had them
+	for i := 0; ; i++ {
+		tagFile := C.vulpo4packTag(v.data, C.int(i))
+		if tagFile == nil {
+			break
+		}
+		if offset, ok := p.headers[C.GoString(&tagFile.alias[0])]; ok {
+			tagFile.headerOffset = offset
+		}
+	}
+
+	v.deleted.invalidate()
+	v.packing.packer = nil
+	v.packing.changed = nil
+	v.keyed(func() C.int { return C.d4top(v.data) })
+	for c := range v.cursors {
+		c.keyed(func() C.int { return C.d4top(c.data) })
+	}
+
+	p.phase = PackDone
+	p.elapsed += time.Since(start)
+	p.report()
+	p.cleanup()
+	return nil
+}
+
+// carryOver writes to the packed table the records changed since the pack
+// started and those added to the table: a copied record is written over its
+// copy, another is appended unless it is marked for deletion.
+func (p *Packer) carryOver() error {
+	v := p.v
+	count := int(C.d4recCountDo(v.data))
+
+	// Packed record numbers of the copied records, by counting the kept
+	// records up to them
+	var rank []int
+	newNo := func(recNo int) int {
+		if rank == nil {
+			rank = make([]int, len(p.kept)+1)
+			for i, word := range p.kept {
+				rank[i+1] = rank[i] + Bitmap{word}.Count()
+			}
+		}
+		word := recNo >> 6
+		return rank[word] + Bitmap{p.kept[word] & (1<<(uint(recNo)&63+1) - 1)}.Count()
+	}
+
+	record := make([]byte, p.recordLen)
+	put := func(recNo int) error {
+		if _, err := p.src.ReadAt(record, int64(p.headerLen+(recNo-1)*p.recordLen)); err != nil {
+			return NewErrorf("failed to read record %d: %s", recNo, v.filename).SetWrapped(err)
+		}
+		target := 0
+		if recNo <= p.count && p.kept.Get(recNo) {
+			target = newNo(recNo)
+		} else if record[0] == '*' {
+			return nil
+		}
+		result := p.shadow.keyed(func() C.int {
+			return C.vulpo4packPut(p.shadow.data, C.long(target), unsafe.Pointer(&record[0]))
+		})
+		if result != 0 {
+			return NewErrorf("failed to carry record %d over to packed table: error code %d", recNo, int(result))
+		}
+		return nil
+	}
+
+	changed := v.packing.changed
+	for recNo := changed.Next(1); recNo >= 0 && recNo <= p.count; recNo = changed.Next(recNo + 1) {
+		if err := put(recNo); err != nil {
+			return err
+		}
+	}
+	for recNo := p.count + 1; recNo <= count; recNo++ {
+		if err := put(recNo); err != nil {
+			return err
+		}
+	}
+	return nil
+}
+
+// replace locks the table, carries the changes over to the packed files and
+// renames them over the table's, after linking the table's files into the
+// pack directory for restore. The packed index gets a version number
+// different from the table's index, so that CodeBase reloads every tag once
+// the table moves onto the new files, and the offsets of its tag headers are
+// kept for Finish to point the table's tags at.
+func (p *Packer) replace() error {
+	v := p.v
+	if result := C.d4lockAll(v.data); result != 0 {
+		return NewErrorf("failed to lock table for swap: error code %d", int(result))
+	}
+	defer C.d4unlock(v.data)
+
+	if err := p.carryOver(); err != nil {
+		return err
+	}
+	p.headers = make(map[string]C.S4LONG)
+	for i := 0; ; i++ {
+		tagFile := C.vulpo4packTag(p.shadow.data, C.int(i))
+		if tagFile == nil {
+			break
+		}
+		p.headers[C.GoString(&tagFile.alias[0])] = tagFile.headerOffset
+	}
+	if err := p.shadow.Close(); err != nil {
+		return NewErrorf("failed to close packed table: %v", err)
+	}
+	p.shadow = nil
+
+	if p.indexPath != "" {
+		var version [4]byte
+		if err := readAt(p.index, version[:], 8); err != nil {
+			return NewErrorf("failed to read index version: %s", p.index).SetWrapped(err)
+		}
+		binary.BigEndian.PutUint32(version[:], binary.BigEndian.Uint32(version[:])+1)
+		if err := writeAt(p.indexPath, version[:], 8); err != nil {
+			return NewError("failed to write packed index version").SetWrapped(err)
+		}
+	}
+
+	renames := [][2]string{{p.dataPath, v.filename}}
+	if p.indexPath != "" {
+		renames = append(renames, [2]string{p.indexPath, p.index})
+	}
+	p.originals = nil
+	for _, rename := range renames {
+		original := filepath.Join(p.dir, "unpacked-"+filepath.Base(rename[1]))
+		if err := os.Link(rename[1], original); err != nil {
+			return NewErrorf("failed to link %s aside", rename[1]).SetWrapped(err)
+		}
+		p.originals = append(p.originals, [2]string{original, rename[1]})
+	}
+
+	for _, rename := range renames {
+		if err := packRename(rename[0], rename[1]); err != nil {
+			return p.restore(NewErrorf("failed to replace %s", rename[1]).SetWrapped(err))
+		}
+	}
+	return nil
+}
+
+// restore renames the table's files, linked aside by replace, back into
+// place after a failed swap. It returns cause once the table's files are
+// back, or an error saying the table is damaged, and where its files are
+// kept, if they cannot all be put back.
+func (p *Packer) restore(cause Error) error {
+	for _, original := range p.originals {
+		if err := packRename(original[0], original[1]); err != nil {
+			p.damaged = true
+			return NewErrorf("table is damaged: %s, and %s could not be put back; the table's original files are in %s",
+				cause.Error(), original[1], p.dir).SetWrapped(err)
+		}
+	}
+	return cause
+}
+
+// readAt reads len(buf) bytes at off of the file at path.
+func readAt(path string, buf []byte, off int64) error {
+	f, err := os.Open(path)
+	if err != nil {
+		return err
+	}
+	defer f.Close()
+	_, err = f.ReadAt(buf, off)
+	return err
+}
+
+// writeAt writes buf at off of the file at path.
+func writeAt(path string, buf []byte, off int64) error {
+	f, err := os.OpenFile(path, os.O_WRONLY, 0)
+	if err != nil {
+		return err
+	}
+	if _, err := f.WriteAt(buf, off); err != nil {
+		_ = f.Close()
+		return err
+	}
+	return f.Close()
+}
+
+// Abort stops the pack and removes the packed files. The table is left as
+// it is.
+//
+// Returns:
+//   - error: Error if the pack already finished
+func (p *Packer) Abort() error {
+	if p.phase == PackDone {
+		return NewError("pack already finished")
+	}
+	if p.v.packing != nil && p.v.packing.packer == p {
+		p.v.packing.packer = nil
+		p.v.packing.changed = nil
+	}
+	p.cleanup()
+	return nil
+}
+
+// cleanup closes the files of the pack and removes its directory.
+func (p *Packer) cleanup() {
+	if p.shadow != nil {
+		_ = p.shadow.Close()
+		p.shadow = nil
+	}
+	if p.dst != nil {
+		_ = p.dst.Close()
+		p.dst = nil
+	}
+	if p.src != nil {
+		_ = p.src.Close()
+		p.src = nil
+	}
+	// The directory of a damaged table holds its original files
+	if p.dir != "" && !p.damaged {
+		_ = os.RemoveAll(p.dir)
+		p.dir = ""
+	}
+}
+
+// PackOnline packs the table as Pack does, but through a Packer: the records
+// are copied to a new file and its index is rebuilt while other programs go
+// on reading the table, and the table is locked only while the new files are
+// swapped in.
+//
+// Parameters:
+//   - progress: Called as the pack goes on, or nil
+//
+// Returns:
+//   - error: Error if the database is not open or the pack fails; the table
+//     is then left as it was, unless the error says it is damaged (see
+//     Packer.Finish)
+//
+// Example:
+//
+//	err := v.PackOnline(func(p vulpo.PackProgress) {
+//		fmt.Printf("%s %d/%d, %.0f MB/s\n", p.Phase, p.Done, p.Total, p.BytesPerSecond/1e6)
+//	})
+func (v *Vulpo) PackOnline(progress func(PackProgress)) error {
+	p, err := v.NewPacker(progress)
+	if err != nil {
+		return err
+	}
+	for {
+		done, err := p.Step(packStepRecords)
+		if err != nil {
+			_ = p.Abort()
+			return err
+		}
+		if done {
+			break
+		}
+	}
+	if err := p.Finish(); err != nil {
+		if p.phase != PackDone {
+			_ = p.Abort()
+		}
+		return err
+	}
+	return nil
+}
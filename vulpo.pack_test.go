@@ -0,0 +1,387 @@
+package vulpo
+
+import (
+	"bytes"
+	"errors"
+	"fmt"
+	"os"
+	"path/filepath"
+	"strings"
+	"testing"
+)
+
+// deleteEvery opens the table at path and deletes every every-th record,
+// starting with the first. It returns the open table.
+func deleteEvery(t *testing.T, path string, every int) *Vulpo {
+	t.Helper()
+
+	v := &Vulpo{}
+	if err := v.Open(path); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	header := v.Header()
+	for recNo := 1; recNo <= int(header.RecordCount()); recNo += every {
+		if err := v.Goto(recNo); err != nil {
+			t.Fatalf("Goto(%d) failed: %v", recNo, err)
+		}
+		if err := v.Delete(); err != nil {
+			t.Fatalf("Delete failed: %v", err)
+		}
+	}
+	return v
+}
+
+// recordNames returns the NAME of every record of the table in record order.
+func recordNames(t *testing.T, v *Vulpo) []string {
+	t.Helper()
+
+	if err := v.SelectTag(nil); err != nil {
+		t.Fatalf("SelectTag failed: %v", err)
+	}
+	var names []string
+	for err := v.First(); err == nil && !v.EOF(); err = v.Next() {
+		name, _ := v.FieldByName("NAME").AsString()
+		names = append(names, name)
+	}
+	return names
+}
+
+// checkSeeks seeks every name through the INF_NAME tag and checks that it
+// lands on the record holding it.
+func checkSeeks(t *testing.T, v *Vulpo, names []string) {
+	t.Helper()
+
+	if err := v.SelectTag(v.TagByName("INF_NAME")); err != nil {
+		t.Fatalf("SelectTag failed: %v", err)
+	}
+	for i, name := range names {
+		result, err := v.Seek(name)
+		if err != nil || !result.IsFound() {
+			t.Fatalf("Seek(%s) = %v, %v", name, result, err)
+		}
+		if v.Position() != i+1 {
+			t.Fatalf("Seek(%s) landed on record %d, want %d", name, v.Position(), i+1)
+		}
+	}
+}
+
+// packDirs returns the pack directories left beside the table at path.
+func packDirs(t *testing.T, path string) []string {
+	t.Helper()
+
+	entries, err := os.ReadDir(filepath.Dir(path))
+	if err != nil {
+		t.Fatalf("Failed to list %s: %v", filepath.Dir(path), err)
+	}
+	var dirs []string
+	for _, entry := range entries {
+		if strings.Contains(entry.Name(), ".pack") {
+			dirs = append(dirs, entry.Name())
+		}
+	}
+	return dirs
+}
+
+func TestVulpo_NewPacker_NoDatabase(t *testing.T) {
+	v := &Vulpo{}
+
+	if _, err := v.NewPacker(nil); err == nil {
+		t.Error("Expected error for NewPacker with inactive database")
+	}
+	if err := v.PackOnline(nil); err == nil {
+		t.Error("Expected error for PackOnline with inactive database")
+	}
+}
+
+func TestVulpo_PackOnline(t *testing.T) {
+	path, _ := distinctNamesTable(t, 2)
+	v := deleteEvery(t, path, 3)
+	defer v.Close()
+	refPath, _ := distinctNamesTable(t, 2)
+	ref := deleteEvery(t, refPath, 3)
+	defer ref.Close()
+
+	phases := make(map[PackPhase]int)
+	var last PackProgress
+	err := v.PackOnline(func(p PackProgress) {
+		phases[p.Phase]++
+		last = p
+	})
+	if err != nil {
+		t.Fatalf("PackOnline failed: %v", err)
+	}
+	if err := ref.Pack(); err != nil {
+		t.Fatalf("Pack failed: %v", err)
+	}
+
+	if phases[PackCopy] == 0 || phases[PackIndex] == 0 || phases[PackDone] != 1 {
+		t.Errorf("Progress reported phases %v, want copy, index and done", phases)
+	}
+	want := recordNames(t, ref)
+	if last.Kept != len(want) {
+		t.Errorf("Progress reported %d records kept, want %d", last.Kept, len(want))
+	}
+
+	got := recordNames(t, v)
+	if len(got) != len(want) {
+		t.Fatalf("Packed table has %d records, want %d", len(got), len(want))
+	}
+	for i := range want {
+		if got[i] != want[i] {
+			t.Fatalf("Record %d NAME = %q, want %q", i+1, got[i], want[i])
+		}
+	}
+	if active, err := v.CountActive(); err != nil || active != len(want) {
+		t.Errorf("CountActive = %d, %v, want %d", active, err, len(want))
+	}
+	if deleted, err := v.CountDeleted(); err != nil || deleted != 0 {
+		t.Errorf("CountDeleted = %d, %v, want 0", deleted, err)
+	}
+	checkSeeks(t, v, want)
+	if dirs := packDirs(t, path); len(dirs) != 0 {
+		t.Errorf("Pack directories left behind: %v", dirs)
+	}
+
+	// The packed files are what a fresh open finds
+	if err := v.Close(); err != nil {
+		t.Fatalf("Close failed: %v", err)
+	}
+	if err := v.Open(path); err != nil {
+		t.Fatalf("Failed to reopen packed table: %v", err)
+	}
+	checkSeeks(t, v, want)
+}
+
+func TestVulpo_PackOnline_TrimmedKeys(t *testing.T) {
+	// The packed table is large enough for the rebuild to build keys
+	// natively, which it must not do for the TRIMX tag. Record 2, the only
+	// short name, becomes record 1.
+	path := shortNameTable(t, 60)
+	v := deleteEvery(t, path, 5)
+	defer v.Close()
+	refPath := shortNameTable(t, 60)
+	ref := deleteEvery(t, refPath, 5)
+
+	if err := v.PackOnline(nil); err != nil {
+		t.Fatalf("PackOnline failed: %v", err)
+	}
+	if err := ref.Pack(); err != nil {
+		t.Fatalf("Pack failed: %v", err)
+	}
+	ref.Close()
+
+	want, _ := os.ReadFile(strings.TrimSuffix(refPath, ".dbf") + ".cdx")
+	got, _ := os.ReadFile(strings.TrimSuffix(path, ".dbf") + ".cdx")
+	if len(want) == 0 || !bytes.Equal(got, want) {
+		t.Errorf("Index after PackOnline (%d bytes) differs from the one Pack builds (%d bytes)", len(got), len(want))
+	}
+
+	count, err := v.CountActive()
+	if err != nil || count < reindexNativeMin {
+		t.Fatalf("Packed table has %d records (%v), fewer than are built natively", count, err)
+	}
+	tag := v.TagByName("TRIMX")
+	if result, err := v.SeekWithTag(tag, "SHORTX"); err != nil || result != SeekSuccess || v.Position() != 1 {
+		t.Errorf("Seek SHORTX after PackOnline = %v, %v at record %d; want Success at record 1", result, err, v.Position())
+	}
+	if n, err := v.CountTagRange(tag, "SHORTX", "SHORTX"); err != nil || n != 1 {
+		t.Errorf("CountTagRange SHORTX after PackOnline = %d, %v; want 1", n, err)
+	}
+
+	// Keys added afterwards take new blocks from the end of the packed index
+	name := v.FieldByName("NAME")
+	if _, err := v.AppendBatch(1000, func(i int) error { return name.SetString(fmt.Sprintf("ADD%04d", i)) }); err != nil {
+		t.Fatalf("AppendBatch after PackOnline failed: %v", err)
+	}
+	count += 1000
+	if n, err := v.CountTagRange(tag, "", ""); err != nil || n != count {
+		t.Errorf("CountTagRange after AppendBatch = %d, %v; want %d", n, err, count)
+	}
+	if result, err := v.SeekWithTag(tag, "ADD0999X"); err != nil || result != SeekSuccess || v.Position() != count {
+		t.Errorf("Seek ADD0999X = %v, %v at record %d; want Success at record %d", result, err, v.Position(), count)
+	}
+}
+
+func TestVulpo_NewPacker_Changes(t *testing.T) {
+	path, _ := distinctNamesTable(t, 2)
+	v := deleteEvery(t, path, 3)
+	defer v.Close()
+	header := v.Header()
+	count := int(header.RecordCount())
+
+	c, err := v.NewCursor()
+	if err != nil {
+		t.Fatalf("NewCursor failed: %v", err)
+	}
+	defer c.Close()
+	before := recordNames(t, v)
+
+	p, err := v.NewPacker(nil)
+	if err != nil {
+		t.Fatalf("NewPacker failed: %v", err)
+	}
+	if _, err := v.NewPacker(nil); err == nil {
+		t.Error("Expected error for a second NewPacker")
+	}
+	if _, err := c.NewPacker(nil); err == nil {
+		t.Error("Expected error for NewPacker on a cursor")
+	}
+	if err := v.Pack(); err == nil {
+		t.Error("Expected error for Pack during an online pack")
+	}
+
+	if done, err := p.Step(count / 2); err != nil || done {
+		t.Fatalf("Step = %v, %v, want more to do", done, err)
+	}
+	if progress := p.Progress(); progress.Phase != PackCopy || progress.Done != count/2 || progress.Total != count {
+		t.Errorf("Progress = %+v, want copy of %d of %d", progress, count/2, count)
+	}
+
+	// Record 1 was skipped by the copy and is recalled, record 2 was copied
+	// and is deleted, the last deleted record is recalled before the copy
+	// gets there, all through the table and its cursor
+	lastDeleted := (count-1)/3*3 + 1
+	for _, change := range []struct {
+		on      *Vulpo
+		recNo   int
+		deleted bool
+	}{{v, 1, false}, {&c.Vulpo, 2, true}, {v, lastDeleted, false}} {
+		if err := change.on.Goto(change.recNo); err != nil {
+			t.Fatalf("Goto(%d) failed: %v", change.recNo, err)
+		}
+		if change.deleted {
+			err = change.on.Delete()
+		} else {
+			err = change.on.Recall()
+		}
+		if err != nil {
+			t.Fatalf("Changing record %d failed: %v", change.recNo, err)
+		}
+	}
+
+	if err := p.Finish(); err != nil {
+		t.Fatalf("Finish failed: %v", err)
+	}
+	if err := p.Abort(); err == nil {
+		t.Error("Expected error for Abort after Finish")
+	}
+
+	// Kept: the live records in order, then record 1 at the end
+	var want []string
+	for i, name := range before {
+		recNo := i + 1
+		if recNo == 1 || ((recNo-1)%3 == 0 && recNo != lastDeleted) {
+			continue
+		}
+		want = append(want, name)
+	}
+	want = append(want, before[0])
+
+	got := recordNames(t, v)
+	if len(got) != len(want) {
+		t.Fatalf("Packed table has %d records, want %d", len(got), len(want))
+	}
+	for i := range want {
+		if got[i] != want[i] {
+			t.Fatalf("Record %d NAME = %q, want %q", i+1, got[i], want[i])
+		}
+	}
+	if list, err := v.ListDeletedRecords(); err != nil || len(list) != 1 || list[0].RecordNumber != 1 {
+		t.Errorf("ListDeletedRecords = %+v, %v, want record 1 only", list, err)
+	}
+
+	// The cursor reads the packed table too
+	checkSeeks(t, &c.Vulpo, want)
+}
+
+func TestVulpo_NewPacker_Abort(t *testing.T) {
+	path, _ := distinctNamesTable(t, 1)
+	v := deleteEvery(t, path, 2)
+	defer v.Close()
+	before := recordNames(t, v)
+
+	p, err := v.NewPacker(nil)
+	if err != nil {
+		t.Fatalf("NewPacker failed: %v", err)
+	}
+	if _, err := p.Step(10); err != nil {
+		t.Fatalf("Step failed: %v", err)
+	}
+	if err := p.Abort(); err != nil {
+		t.Fatalf("Abort failed: %v", err)
+	}
+	if _, err := p.Step(10); err == nil {
+		t.Error("Expected error for Step after Abort")
+	}
+	if dirs := packDirs(t, path); len(dirs) != 0 {
+		t.Errorf("Pack directories left behind: %v", dirs)
+	}
+	if got := recordNames(t, v); len(got) != len(before) {
+		t.Errorf("Aborted pack changed the table to %d records, want %d", len(got), len(before))
+	}
+
+	// Closing the table aborts a pack left running
+	if _, err := v.NewPacker(nil); err != nil {
+		t.Fatalf("NewPacker after Abort failed: %v", err)
+	}
+	if err := v.Close(); err != nil {
+		t.Fatalf("Close failed: %v", err)
+	}
+	if dirs := packDirs(t, path); len(dirs) != 0 {
+		t.Errorf("Pack directories left behind: %v", dirs)
+	}
+}
+
+func TestVulpo_NewPacker_FailedSwap(t *testing.T) {
+	// The index cannot be renamed into place after the data file was, so
+	// Finish must put the table's own data file back
+	path, _ := distinctNamesTable(t, 1)
+	v := deleteEvery(t, path, 2)
+	defer v.Close()
+	before := recordNames(t, v)
+
+	failed := errors.New("rename failed")
+	packRename = func(from, to string) error {
+		if strings.HasSuffix(to, ".cdx") && !strings.Contains(filepath.Base(from), "unpacked-") {
+			return failed
+		}
+		return os.Rename(from, to)
+	}
+	defer func() {
+		packRename = os.Rename
+	}()
+
+	p, err := v.NewPacker(nil)
+	if err != nil {
+		t.Fatalf("NewPacker failed: %v", err)
+	}
+	err = p.Finish()
+	if !errors.Is(err, failed) || strings.Contains(err.Error(), "damaged") {
+		t.Fatalf("Finish = %v, want the rename error without damage", err)
+	}
+	if err := p.Finish(); err == nil {
+		t.Error("Expected error for Finish after a failed swap")
+	}
+	if err := p.Abort(); err != nil {
+		t.Fatalf("Abort failed: %v", err)
+	}
+	if dirs := packDirs(t, path); len(dirs) != 0 {
+		t.Errorf("Pack directories left behind: %v", dirs)
+	}
+
+	// The table is still on its own files, on disk too
+	if got := recordNames(t, v); strings.Join(got, ",") != strings.Join(before, ",") {
+		t.Errorf("Failed swap changed the table to %d records, want %d", len(got), len(before))
+	}
+	checkSeeks(t, v, before)
+	if err := v.Close(); err != nil {
+		t.Fatalf("Close failed: %v", err)
+	}
+	if err := v.Open(path); err != nil {
+		t.Fatalf("Failed to reopen test file: %v", err)
+	}
+	if got := recordNames(t, v); len(got) != len(before) {
+		t.Errorf("Reopened table has %d records, want %d", len(got), len(before))
+	}
+	checkSeeks(t, v, before)
+}
@@ -0,0 +1,124 @@
+package vulpo
+
+import (
+	"runtime"
+	"sync"
+	"sync/atomic"
+)
+
+// parallelChunkSize is the largest run of records a ParallelScan worker
+// claims at once. Smaller tables are split further so every worker gets work.
+const parallelChunkSize = 1024
+
+// ParallelScan calls fn for every record, deleted ones included, spreading the
+// physical record range 1..RecordCount over several goroutines.
+//
+// Parameters:
+//   - workers: Number of goroutines to use; 0 or less uses GOMAXPROCS
+//   - fn: Callback receiving the worker index (0..workers-1) and a Record view
+//
+// Returns:
+//   - error: nil on success, the first callback error, or an error if the scan fails
+//
+// Workers read from one shared read-only mapping of the data file (see
+// Scanner), so no CodeBase calls are made while the scan runs: the library's
+// memory pools and expression state are process-global and not safe to use
+// from several goroutines, even through separate CODE4 handles. The record
+// range is cut into chunks that idle workers claim from a shared counter, so a
+// worker held up by slow callbacks does not leave the others waiting.
+//
+// fn is called concurrently and must not call methods on v or retain the
+// Record. Records are visited in physical order within a chunk but chunks
+// complete in no particular order; use Record.RecordNumber to merge results
+// in order, and the worker index to keep per-worker accumulators without
+// locking. The selected tag is ignored. After the first error, workers stop
+// claiming new chunks.
+//
+// If the file cannot be mapped, the scan runs sequentially on worker 0.
+//
+// Example:
+//
+//	amount := v.FieldDefs().Index("AMOUNT")
+//	totals := make([]float64, runtime.GOMAXPROCS(0))
+//	err := v.ParallelScan(len(totals), func(worker int, rec Record) error {
+//		val, err := rec.Float(amount)
+//		totals[worker] += val
+//		return err
+//	})
+func (v *Vulpo) ParallelScan(workers int, fn func(worker int, rec Record) error) error {
+	if !v.Active() {
+		return NewError("database not open")
+	}
+
+	if workers <= 0 {
+		workers = runtime.GOMAXPROCS(0)
+	}
+
+	scanner, err := v.NewScanner()
+	if err != nil {
+		return v.scanPhysical(func(rec Record) error {
+			return fn(0, rec)
+		})
+	}
+	defer scanner.Close()
+
+	return scanner.parallelScan(workers, fn)
+}
+
+// parallelScan runs the workers of ParallelScan over the scanner's records.
+func (s *Scanner) parallelScan(workers int, fn func(worker int, rec Record) error) error {
+	count := s.Count()
+	if count == 0 {
+		return nil
+	}
+
+	chunk := min(parallelChunkSize, max(1, count/(workers*4)))
+	workers = min(workers, (count+chunk-1)/chunk)
+
+	var (
+		next     atomic.Int64
+		stopped  atomic.Bool
+		firstErr error
+		errOnce  sync.Once
+		wg       sync.WaitGroup
+	)
+
+	for worker := 0; worker < workers; worker++ {
+		wg.Add(1)
+		go func(worker int) {
+			defer wg.Done()
+			for !stopped.Load() {
+				start := int(next.Add(int64(chunk))) - chunk + 1
+				if start > count {
+					return
+				}
+				end := min(start+chunk-1, count)
+				for recNo := start; recNo <= end; recNo++ {
+					if err := fn(worker, s.Record(recNo)); err != nil {
+						errOnce.Do(func() { firstErr = err })
+						stopped.Store(true)
+						return
+					}
+				}
+			}
+		}(worker)
+	}
+
+	wg.Wait()
+	return firstErr
+}
+
+// scanPhysical runs fn over every record in physical order through CodeBase
+// navigation, temporarily deselecting any tag.
+func (v *Vulpo) scanPhysical(fn func(rec Record) error) error {
+	if tag := v.SelectedTag(); tag != nil {
+		if err := v.SelectTag(nil); err != nil {
+			return err
+		}
+		defer func() {
+			_ = v.SelectTag(tag) // Ignore error in defer
+		}()
+	}
+
+	return v.scanBatches(fn)
+}
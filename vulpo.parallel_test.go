@@ -0,0 +1,88 @@
+package vulpo
+
+import (
+	"errors"
+	"runtime"
+	"sync/atomic"
+	"testing"
+)
+
+func TestVulpo_ParallelScan_NoDatabase(t *testing.T) {
+	v := &Vulpo{}
+
+	if err := v.ParallelScan(2, func(int, Record) error { return nil }); err == nil {
+		t.Error("Expected error for ParallelScan with inactive database")
+	}
+}
+
+func TestVulpo_ParallelScan_VisitsEveryRecordOnce(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	var wantDeleted []bool
+	err := v.Scan(func(rec Record) error {
+		wantDeleted = append(wantDeleted, rec.Deleted())
+		return nil
+	})
+	if err != nil {
+		t.Fatalf("Scan failed: %v", err)
+	}
+
+	if tags := v.ListTags(); len(tags) > 0 {
+		_ = v.SelectTag(tags[0])
+	}
+
+	for _, workers := range []int{0, 1, 3, 64} {
+		visits := make([]atomic.Int32, len(wantDeleted)+1)
+		deleted := make([]atomic.Bool, len(wantDeleted)+1)
+		maxWorker := workers
+		if maxWorker <= 0 {
+			maxWorker = runtime.GOMAXPROCS(0)
+		}
+
+		err := v.ParallelScan(workers, func(worker int, rec Record) error {
+			if worker < 0 || worker >= maxWorker {
+				t.Errorf("Worker index %d out of range", worker)
+			}
+			visits[rec.RecordNumber()].Add(1)
+			deleted[rec.RecordNumber()].Store(rec.Deleted())
+			return nil
+		})
+		if err != nil {
+			t.Fatalf("ParallelScan(%d) failed: %v", workers, err)
+		}
+
+		for recNo := 1; recNo <= len(wantDeleted); recNo++ {
+			if n := visits[recNo].Load(); n != 1 {
+				t.Errorf("ParallelScan(%d): record %d visited %d times", workers, recNo, n)
+			}
+			if deleted[recNo].Load() != wantDeleted[recNo-1] {
+				t.Errorf("ParallelScan(%d): record %d deleted flag mismatch", workers, recNo)
+			}
+		}
+	}
+}
+
+func TestVulpo_ParallelScan_CallbackError(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	stop := errors.New("stop")
+	var calls atomic.Int32
+	err := v.ParallelScan(4, func(int, Record) error {
+		calls.Add(1)
+		return stop
+	})
+	if !errors.Is(err, stop) {
+		t.Errorf("Expected callback error, got %v", err)
+	}
+	if n := calls.Load(); n > 4 {
+		t.Errorf("Expected workers to stop after the first error, got %d calls", n)
+	}
+}
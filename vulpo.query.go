@@ -0,0 +1,100 @@
+package vulpo
+
+/*
+#include "d4all.h"
+#include <stdlib.h>
+*/
+import "C"
+import "unsafe"
+
+// queryIndexed walks the records matching expression through the CodeBase
+// relation query optimizer. relate4querySet splits the expression into
+// sub-expressions, and those covered by a tag of the table are resolved to a
+// record bitmap from the index before any record is read; only candidate
+// records are then loaded and checked against the remainder of the
+// expression.
+//
+// fn is called with the table positioned on each matching record, in
+// record-number order. The current position is restored afterwards.
+//
+// Returns handled=false, without calling fn, for expressions rejected by
+// queryPushdownSafe, when no part of the expression can be answered from an
+// index, or when the query cannot be set up; the caller should then fall back
+// to a full scan. Once fn has been called, handled is true and any failure is
+// returned as an error.
+func (v *Vulpo) queryIndexed(expression string, fn func() error) (handled bool, err error) {
+	if !queryPushdownSafe(expression) {
+		return false, nil
+	}
+
+	relate := C.relate4init(v.data)
+	if relate == nil {
+		C.error4set(v.codeBase, 0)
+		return false, nil
+	}
+	defer C.relate4free(relate, 0)
+
+	originalPosition := v.Position()
+	defer func() {
+		if originalPosition > 0 {
+			_ = v.Goto(originalPosition) // Ignore error in defer
+		}
+	}()
+
+	cExpr := C.CString(expression)
+	defer C.free(unsafe.Pointer(cExpr))
+
+	// The query is evaluated with the shared expression engine
+	exprMutex.Lock()
+	result := C.relate4querySet(relate, cExpr)
+	if result == 0 {
+		// relate4optimizeable builds a trial bitmap and resets the relation,
+		// so it must run before relate4top
+		if C.relate4optimizeable(relate) == 1 {
+			result = C.relate4top(relate)
+		} else {
+			result = -1
+		}
+	}
+	exprMutex.Unlock()
+
+	if result < 0 {
+		C.error4set(v.codeBase, 0)
+		return false, nil
+	}
+
+	for result == 0 {
+		if err := fn(); err != nil {
+			return true, err
+		}
+
+		exprMutex.Lock()
+		result = C.relate4skip(relate, 1)
+		exprMutex.Unlock()
+	}
+
+	if result < 0 {
+		C.error4set(v.codeBase, 0)
+		return true, NewErrorf("indexed query failed: error code %d", int(result))
+	}
+	return true, nil
+}
+
+// queryPushdownSafe reports whether expression may be handed to the relation
+// query optimizer. The bundled CodeBase build loses every match of a top-level
+// .OR. when one operand is a tag range below the smallest key (AGE < 20 .OR.
+// AGE > 60 returns nothing if no age is under 20), so expressions containing
+// .OR. are always scanned. Expressions the tokenizer does not understand are
+// scanned as well.
+func queryPushdownSafe(expression string) bool {
+	tokens, err := tokenizeExpr(expression)
+	if err != nil {
+		return false
+	}
+	for _, tok := range tokens {
+		if tok.kind == tokDot && tok.text == ".OR." {
+			return false
+		}
+	}
+	return true
+}
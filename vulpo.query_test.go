@@ -0,0 +1,142 @@
+package vulpo
+
+import (
+	"errors"
+	"testing"
+)
+
+func TestVulpo_ExpressionSearch_UseIndexMatchesScan(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	indexed := &ExprSearchOptions{UseIndex: true}
+	expressions := []string{
+		"AGE > 40",
+		"AGE = 30",
+		"AGE > 40 .AND. 'e' $ NAME",
+		"AGE > 60 .AND. .NOT. AGE = 62",
+		"AGE > 30 .AND. AGE < 20",
+		"BIRTH_DATE < CTOD('01/01/50') .AND. AGE >= 60",
+		"AGE < 20 .OR. AGE > 60", // CodeBase's optimizer drops these matches
+		"'e' $ NAME",
+		"YEAR(BIRTH_DATE) > 1940 .AND. AGE < 25",
+	}
+
+	for _, expression := range expressions {
+		want, err := v.SearchByExpression(expression, nil)
+		if err != nil {
+			t.Fatalf("SearchByExpression(%q) failed: %v", expression, err)
+		}
+
+		got, err := v.SearchByExpression(expression, indexed)
+		if err != nil {
+			t.Fatalf("SearchByExpression(%q) with index failed: %v", expression, err)
+		}
+		if got.TotalMatched != want.TotalMatched || len(got.Matches) != len(want.Matches) {
+			t.Errorf("%q: expected %d matches, got %d", expression, want.TotalMatched, got.TotalMatched)
+			continue
+		}
+		for i := range want.Matches {
+			if got.Matches[i].RecordNumber != want.Matches[i].RecordNumber {
+				t.Errorf("%q: match %d is record %d, want %d", expression, i, got.Matches[i].RecordNumber, want.Matches[i].RecordNumber)
+				break
+			}
+		}
+
+		count, err := v.CountByExpression(expression, indexed)
+		if err != nil || count != want.TotalMatched {
+			t.Errorf("%q: CountByExpression with index = %d, %v; want %d", expression, count, err, want.TotalMatched)
+		}
+
+		visited := 0
+		err = v.ForEachExpressionMatch(expression, func(map[string]FieldReader) error {
+			visited++
+			return nil
+		}, indexed)
+		if err != nil || visited != want.TotalMatched {
+			t.Errorf("%q: ForEachExpressionMatch with index visited %d, %v; want %d", expression, visited, err, want.TotalMatched)
+		}
+	}
+}
+
+func TestVulpo_ExpressionSearch_UseIndexPushdown(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	if err := v.Goto(5); err != nil {
+		t.Fatalf("Goto failed: %v", err)
+	}
+
+	header := v.Header()
+	result, err := v.SearchByExpression("AGE >= 60", &ExprSearchOptions{UseIndex: true})
+	if err != nil {
+		t.Fatalf("SearchByExpression failed: %v", err)
+	}
+	if result.TotalMatched == 0 {
+		t.Fatal("Expected matches for AGE >= 60")
+	}
+	if result.TotalScanned != result.TotalMatched || result.TotalScanned >= int(header.RecordCount()) {
+		t.Errorf("Expected only matching records to be visited, scanned %d of %d for %d matches",
+			result.TotalScanned, header.RecordCount(), result.TotalMatched)
+	}
+	if pos := v.Position(); pos != 5 {
+		t.Errorf("Expected position 5 to be restored, got %d", pos)
+	}
+
+	// Field readers read the current record, so check them inside the callback
+	err = v.ForEachExpressionMatch("AGE >= 60", func(fields map[string]FieldReader) error {
+		age, err := fields["AGE"].AsInt()
+		if err != nil {
+			return err
+		}
+		if age < 60 {
+			t.Errorf("Record %d has AGE %d", v.Position(), age)
+		}
+		return nil
+	}, &ExprSearchOptions{UseIndex: true})
+	if err != nil {
+		t.Fatalf("ForEachExpressionMatch failed: %v", err)
+	}
+
+	limited, err := v.SearchByExpression("AGE >= 60", &ExprSearchOptions{UseIndex: true, MaxResults: 2})
+	if err != nil {
+		t.Fatalf("SearchByExpression with limit failed: %v", err)
+	}
+	if limited.TotalMatched != 2 || limited.Matches[1].RecordNumber != result.Matches[1].RecordNumber {
+		t.Errorf("Expected the first 2 matches, got %d", limited.TotalMatched)
+	}
+
+	stop := errors.New("stop")
+	err = v.ForEachExpressionMatch("AGE >= 60", func(map[string]FieldReader) error {
+		return stop
+	}, &ExprSearchOptions{UseIndex: true})
+	if !errors.Is(err, stop) {
+		t.Errorf("Expected callback error, got %v", err)
+	}
+}
+
+func TestQueryPushdownSafe(t *testing.T) {
+	tests := []struct {
+		expression string
+		want       bool
+	}{
+		{"AGE > 40", true},
+		{"AGE > 40 .AND. .NOT. DELETED()", true},
+		{"NAME = '.OR.'", true},
+		{"AGE < 20 .OR. AGE > 60", false},
+		{"AGE > 1 .AND. (AGE = 2 .or. AGE = 3)", false},
+		{"NAME = 'unterminated", false},
+	}
+
+	for _, tt := range tests {
+		if got := queryPushdownSafe(tt.expression); got != tt.want {
+			t.Errorf("queryPushdownSafe(%q) = %v, want %v", tt.expression, got, tt.want)
+		}
+	}
+}
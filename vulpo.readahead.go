@@ -0,0 +1,211 @@
+package vulpo
+
+/*
+#define _GNU_SOURCE
+#include "d4all.h"
+#include <fcntl.h>
+#include <stddef.h>
+#include <string.h>
+#include <unistd.h>
+
+// The read-ahead state of a file lives in the FILE4's advance-read fields
+// (space30 to space34), which only Win32 builds with S4READ_ADVANCE use.
+// owner is set to the file itself once SetReadAhead has given it a window;
+// any other value means read-ahead is off for the file.
+typedef struct
+{
+   const FILE4 *owner ;
+   unsigned long start ;      // where the last read started
+   unsigned long next ;       // where the last read ended
+   unsigned long advised ;    // end of the range asked ahead for
+   unsigned window ;          // bytes to read ahead of a scan
+   unsigned short run ;       // reads in order so far
+   unsigned char sequential ; // POSIX_FADV_SEQUENTIAL given
+} VULPO4AHEAD ;
+
+typedef char vulpo4aheadFits[ sizeof( VULPO4AHEAD ) <= offsetof( FILE4, space34 ) + sizeof( unsigned ) - offsetof( FILE4, space30 ) ? 1 : -1 ] ;
+
+// Reads in order before a file counts as scanned.
+#define VULPO4AHEAD_RUN 4
+
+static VULPO4AHEAD *vulpo4ahead(FILE4 *file)
+{
+   return (VULPO4AHEAD *)&file->space30 ;
+}
+
+// vulpo4aheadRead notes a read of len bytes at pos. Once reads follow each
+// other through the file, it tells the kernel the file is read sequentially
+// (which widens its own read-ahead and drops pages behind) and asks it to
+// start reading the next window in the background, a half window before the
+// reads get there, so they find the data in the page cache. A read elsewhere
+// ends the scan.
+static void vulpo4aheadRead(FILE4 *file, unsigned long pos, unsigned len)
+{
+   VULPO4AHEAD *ahead = vulpo4ahead( file ) ;
+   unsigned long end = pos + len, from ;
+
+   if ( ahead->owner != file || ahead->window == 0 )
+      return ;
+
+   if ( pos >= ahead->start && pos < ahead->next && end <= ahead->next )
+   {
+      // Reading the last range again, as d4go does for the current
+      // record, neither continues nor ends a scan
+      return ;
+   }
+   if ( pos >= ahead->next && pos - ahead->next <= ahead->window )
+   {
+      if ( ahead->run < VULPO4AHEAD_RUN )
+         ahead->run++ ;
+   }
+   else
+   {
+      ahead->run = 0 ;
+      ahead->advised = 0 ;
+      if ( ahead->sequential )
+      {
+         posix_fadvise( file->hand, 0, 0, POSIX_FADV_NORMAL ) ;
+         ahead->sequential = 0 ;
+      }
+   }
+   ahead->start = pos ;
+   ahead->next = end ;
+
+   if ( ahead->run < VULPO4AHEAD_RUN )
+      return ;
+   if ( !ahead->sequential )
+   {
+      posix_fadvise( file->hand, 0, 0, POSIX_FADV_SEQUENTIAL ) ;
+      ahead->sequential = 1 ;
+   }
+   if ( ahead->advised < end + ahead->window / 2 )
+   {
+      from = ahead->advised > end ? ahead->advised : end ;
+      posix_fadvise( file->hand, (off_t)from, (off_t)( end + ahead->window - from ), POSIX_FADV_WILLNEED ) ;
+      ahead->advised = end + ahead->window ;
+   }
+}
+
+// file4readLow replaces the library's own version, which positions the file
+// with lseek before every read: a single pread does both, halving the
+// system calls of unbuffered record reads, and the read feeds the read-ahead
+// of the file. The library's definition is weak (libmkfdbf.a's f4file.o went
+// through objcopy --weaken-symbol=file4readLow), so this one serves all of
+// its reads, including those of file4read and file4readAll, which call it
+// from within f4file.o where --wrap does not reach. A short read is returned
+// as such, for the callers to handle as the library's version does.
+unsigned file4readLow( FILE4 *file, FILE4LONG pos, void *ptr, unsigned len )
+{
+   ssize_t rc ;
+
+   if ( pos < 0 )
+   {
+      file4readError( file, pos, len, "file4readLow" ) ;
+      return 0 ;
+   }
+
+   vulpo4aheadRead( file, (unsigned long)pos, len ) ;
+   rc = pread( file->hand, ptr, len, (off_t)pos ) ;
+   if ( rc < 0 )
+   {
+      file4readError( file, pos, len, "file4readLow" ) ;
+      return 0 ;
+   }
+   return (unsigned)rc ;
+}
+
+static void vulpo4aheadSet(FILE4 *file, unsigned window)
+{
+   VULPO4AHEAD *ahead = vulpo4ahead( file ) ;
+
+   if ( ahead->owner == file && ahead->sequential )
+      posix_fadvise( file->hand, 0, 0, POSIX_FADV_NORMAL ) ;
+   memset( ahead, 0, sizeof( *ahead ) ) ;
+   if ( window == 0 )
+      return ;
+   ahead->owner = file ;
+   ahead->window = window ;
+}
+
+// vulpo4aheadData returns the read-ahead state of the table's data file.
+static VULPO4AHEAD vulpo4aheadData(DATA4 *data)
+{
+   return *vulpo4ahead( &data->dataFile->file ) ;
+}
+
+// vulpo4aheadStart gives the table's data, index and memo files a read-ahead
+// window, or turns read-ahead off with a window of 0.
+static void vulpo4aheadStart(DATA4 *data, unsigned window)
+{
+   DATA4FILE *dataFile = data->dataFile ;
+   INDEX4FILE *indexFile ;
+
+   vulpo4aheadSet( &dataFile->file, window ) ;
+   for ( indexFile = (INDEX4FILE *)l4first( &dataFile->indexes ) ; indexFile != 0 ; indexFile = (INDEX4FILE *)l4next( &dataFile->indexes, indexFile ) )
+      vulpo4aheadSet( &indexFile->file, window ) ;
+   if ( dataFile->memoFile.file.hand != INVALID4HANDLE )
+      vulpo4aheadSet( &dataFile->memoFile.file, window ) ;
+}
+*/
+import "C"
+
+// maxReadAhead bounds the read-ahead window: the kernel reads ahead no more
+// than the device allows anyway, and a window stays within 32 bits.
+const maxReadAhead = 1 << 30
+
+// SetReadAhead sets how far ahead of a scan in physical order the table's
+// data, index and memo files are read. Once CodeBase reads a file in order,
+// as Next does without a selected tag, the kernel is told the file is read
+// sequentially and is asked to read the next window in the background
+// (posix_fadvise), so the scan finds its blocks in the page cache instead of
+// waiting for the disk on each one. Reads elsewhere in the file end the scan.
+//
+// Parameters:
+//   - window: Bytes to read ahead, 0 to turn read-ahead off (the default)
+//
+// Returns:
+//   - error: Error if the database is not open or the window is out of range
+//
+// Read-ahead pays off on tables larger than the page cache holds, or read
+// for the first time; the window is best a few times the read-ahead of the
+// device, such as 1 MB.
+//
+// Example:
+//
+//	if err := v.SetReadAhead(1 << 20); err != nil {
+//		log.Fatal(err)
+//	}
+//	for err := v.First(); err == nil && !v.EOF(); err = v.Next() {
+//		// process record
+//	}
+func (v *Vulpo) SetReadAhead(window int) error {
+	if !v.Active() {
+		return NewError("database not open")
+	}
+	if window < 0 || window > maxReadAhead {
+		return NewErrorf("invalid read-ahead window %d: must be from 0 to %d", window, maxReadAhead)
+	}
+
+	C.vulpo4aheadStart(v.data, C.uint(window))
+	return nil
+}
+
+// readAheadState is the read-ahead state of a file, as kept by the read
+// hook.
+type readAheadState struct {
+	on         bool   // the file has a read-ahead window
+	sequential bool   // the kernel was told the file is read in order
+	next       uint64 // where the last read ended
+	advised    uint64 // end of the range asked ahead for
+}
+
+// dataReadAhead returns the read-ahead state of the table's data file.
+func (v *Vulpo) dataReadAhead() readAheadState {
+	ahead := C.vulpo4aheadData(v.data)
+	return readAheadState{
+		on:         ahead.owner == &v.data.dataFile.file,
+		sequential: ahead.sequential != 0,
+		next:       uint64(ahead.next),
+		advised:    uint64(ahead.advised),
+	}
+}
@@ -0,0 +1,149 @@
+package vulpo
+
+import (
+	"testing"
+)
+
+func TestVulpo_SetReadAhead_NoDatabase(t *testing.T) {
+	v := &Vulpo{}
+
+	if err := v.SetReadAhead(1 << 20); err == nil {
+		t.Error("Expected error for SetReadAhead with inactive database")
+	}
+}
+
+func TestVulpo_SetReadAhead_InvalidWindow(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	for _, window := range []int{-1, maxReadAhead + 1} {
+		if err := v.SetReadAhead(window); err == nil {
+			t.Errorf("Expected error for read-ahead window %d", window)
+		}
+	}
+}
+
+// scanNames reads NAME of every record in physical order, then seeks a few
+// names through INF_NAME, and returns what it read.
+func scanNames(t *testing.T, v *Vulpo) ([]string, []int) {
+	t.Helper()
+
+	var names []string
+	name := v.FieldByName("NAME")
+	for err := v.First(); err == nil && !v.EOF(); err = v.Next() {
+		value, err := name.AsString()
+		if err != nil {
+			t.Fatalf("AsString failed: %v", err)
+		}
+		names = append(names, value)
+	}
+
+	var found []int
+	if err := v.SelectTag(v.TagByName("INF_NAME")); err != nil {
+		t.Fatalf("SelectTag failed: %v", err)
+	}
+	for i := 0; i < len(names); i += len(names) / 7 {
+		if _, err := v.Seek(names[i]); err != nil {
+			t.Fatalf("Seek(%s) failed: %v", names[i], err)
+		}
+		found = append(found, v.Position())
+	}
+	return names, found
+}
+
+func TestVulpo_SetReadAhead(t *testing.T) {
+	path, count := distinctNamesTable(t, 20)
+
+	read := func(window int, cache bool) ([]string, []int) {
+		v := &Vulpo{}
+		if err := v.Open(path); err != nil {
+			t.Fatalf("Failed to open test file: %v", err)
+		}
+		defer v.Close()
+		if cache {
+			if err := v.StartCache(CacheLRU); err != nil {
+				t.Fatalf("StartCache failed: %v", err)
+			}
+		}
+		if err := v.SetReadAhead(window); err != nil {
+			t.Fatalf("SetReadAhead failed: %v", err)
+		}
+		return scanNames(t, v)
+	}
+
+	names, found := read(0, false)
+	if len(names) != count {
+		t.Fatalf("Scan read %d records, want %d", len(names), count)
+	}
+	for _, window := range []int{4096, 1 << 20} {
+		for _, cache := range []bool{false, true} {
+			gotNames, gotFound := read(window, cache)
+			if len(gotNames) != len(names) {
+				t.Errorf("window %d, cache %v: scan read %d records, want %d", window, cache, len(gotNames), len(names))
+				continue
+			}
+			for i := range names {
+				if gotNames[i] != names[i] {
+					t.Errorf("window %d, cache %v: record %d NAME = %q, want %q", window, cache, i+1, gotNames[i], names[i])
+					break
+				}
+			}
+			for i := range found {
+				if gotFound[i] != found[i] {
+					t.Errorf("window %d, cache %v: seek %d found record %d, want %d", window, cache, i, gotFound[i], found[i])
+				}
+			}
+		}
+	}
+}
+
+func TestVulpo_SetReadAhead_Engages(t *testing.T) {
+	path, _ := distinctNamesTable(t, 20)
+	v := &Vulpo{}
+	if err := v.Open(path); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	if state := v.dataReadAhead(); state.on {
+		t.Error("Read-ahead is on before SetReadAhead")
+	}
+	if err := v.SetReadAhead(1 << 20); err != nil {
+		t.Fatalf("SetReadAhead failed: %v", err)
+	}
+
+	// A scan in physical order reads the data file in order
+	if err := v.First(); err != nil {
+		t.Fatalf("First failed: %v", err)
+	}
+	for i := 0; i < 100; i++ {
+		if err := v.Next(); err != nil {
+			t.Fatalf("Next failed: %v", err)
+		}
+	}
+	state := v.dataReadAhead()
+	if !state.on || !state.sequential {
+		t.Fatalf("After a scan, read-ahead state = %+v, want on and sequential", state)
+	}
+	if state.advised <= state.next {
+		t.Errorf("After a scan, read-ahead advised up to %d, not past the read position %d", state.advised, state.next)
+	}
+
+	// A read elsewhere ends the scan
+	if err := v.Goto(2); err != nil {
+		t.Fatalf("Goto failed: %v", err)
+	}
+	if state := v.dataReadAhead(); state.sequential || state.advised != 0 {
+		t.Errorf("After a jump back, read-ahead state = %+v, want the scan ended", state)
+	}
+
+	if err := v.SetReadAhead(0); err != nil {
+		t.Fatalf("SetReadAhead failed: %v", err)
+	}
+	if state := v.dataReadAhead(); state.on {
+		t.Error("Read-ahead is still on after SetReadAhead(0)")
+	}
+}
@@ -0,0 +1,215 @@
+package vulpo
+
+import (
+	"time"
+)
+
+// Record is a read-only view of one raw record image, such as an entry of a
+// RecordBatch. Field values are decoded in Go straight from the record bytes
+// using the byte ranges computed at Open() time; no cgo call is made.
+//
+// Fields are addressed by zero-based index; use FieldDefs().Index(name) to
+// resolve a name once outside the scan loop. Memo fields only hold a block
+// reference in the record and cannot be decoded from it.
+type Record struct {
+	data  []byte
+	recNo int
+	defs  *FieldDefs
+}
+
+// At returns a Record view of the batch entry at index i (0 to Len()-1).
+// The view aliases the batch buffer.
+func (b *RecordBatch) At(i int) Record {
+	return Record{
+		data:  b.Record(i),
+		recNo: b.RecordNumber(i),
+		defs:  b.defs,
+	}
+}
+
+// RecordNumber returns the 1-indexed physical record number.
+func (r Record) RecordNumber() int {
+	return r.recNo
+}
+
+// Deleted reports whether the record is marked for deletion.
+func (r Record) Deleted() bool {
+	return len(r.data) > 0 && r.data[0] == '*'
+}
+
+// Bytes returns the raw bytes of the field at index field, or nil if the index
+// is out of range. The slice aliases the record image.
+func (r Record) Bytes(field int) []byte {
+	def := r.def(field)
+	if def == nil {
+		return nil
+	}
+	return def.bytes(r.data)
+}
+
+// IsNull reports whether the field at index field is null.
+func (r Record) IsNull(field int) bool {
+	def := r.def(field)
+	if def == nil {
+		return false
+	}
+	return def.isNullIn(r.data)
+}
+
+// String returns the value of a character field with surrounding blanks
+// trimmed, or the CCYYMMDD text of a date field ("" when blank).
+func (r Record) String(field int) (string, error) {
+	def, raw, err := r.field(field)
+	if err != nil {
+		return "", err
+	}
+
+	switch def.Type() {
+	case FTCharacter:
+		return decodeCharacter(raw), nil
+	case FTDate:
+		if isBlankDate(raw) {
+			return "", nil
+		}
+		return string(raw), nil
+	default:
+		return "", NewConversionError(def.Type().Name(), "string")
+	}
+}
+
+// Float returns the value of a numeric, float, integer, currency or double field.
+func (r Record) Float(field int) (float64, error) {
+	def, raw, err := r.field(field)
+	if err != nil {
+		return 0, err
+	}
+
+	switch def.Type() {
+	case FTNumeric, FTFloat:
+		return decodeNumeric(raw), nil
+	case FTInteger:
+		return float64(decodeInteger(raw)), nil
+	case FTCurrency:
+		return decodeCurrency(raw), nil
+	case FTBlob, FTDouble:
+		if len(raw) == 8 {
+			return decodeDouble(raw), nil
+		}
+	}
+
+	return 0, NewConversionError(def.Type().Name(), "float")
+}
+
+// Int returns the value of an integer field, or the truncated value of any
+// other field Float accepts.
+func (r Record) Int(field int) (int64, error) {
+	def, raw, err := r.field(field)
+	if err != nil {
+		return 0, err
+	}
+
+	if def.Type() == FTInteger {
+		return int64(decodeInteger(raw)), nil
+	}
+
+	val, err := r.Float(field)
+	if err != nil {
+		return 0, NewConversionError(def.Type().Name(), "integer")
+	}
+	return int64(val), nil
+}
+
+// Bool returns the value of a logical field.
+func (r Record) Bool(field int) (bool, error) {
+	def, raw, err := r.field(field)
+	if err != nil {
+		return false, err
+	}
+
+	if def.Type() != FTLogical {
+		return false, NewConversionError(def.Type().Name(), "boolean")
+	}
+	return decodeLogical(raw), nil
+}
+
+// Time returns the value of a date or datetime field. Blank values are
+// returned as the zero time.
+func (r Record) Time(field int) (time.Time, error) {
+	def, raw, err := r.field(field)
+	if err != nil {
+		return time.Time{}, err
+	}
+
+	switch def.Type() {
+	case FTDate:
+		if isBlankDate(raw) {
+			return time.Time{}, nil
+		}
+		jd := decodeDateJulian(raw)
+		if jd < 0 {
+			return time.Time{}, NewErrorf("invalid date format: %s", string(raw))
+		}
+		y, m, d := JulianToYMD(jd)
+		return time.Date(y, time.Month(m), d, 0, 0, 0, 0, time.UTC), nil
+	case FTDateTime:
+		if len(raw) == 8 {
+			return decodeDateTime(raw), nil
+		}
+	}
+
+	return time.Time{}, NewConversionError(def.Type().Name(), "time")
+}
+
+// Value returns the field's native value: string for character fields,
+// float64 for numeric/float/currency/double, int for integer, bool for
+// logical and time.Time for date/datetime fields. Null fields return nil.
+func (r Record) Value(field int) (interface{}, error) {
+	def, _, err := r.field(field)
+	if err != nil {
+		return nil, err
+	}
+
+	if def.isNullIn(r.data) {
+		return nil, nil
+	}
+
+	switch def.Type() {
+	case FTCharacter:
+		return r.String(field)
+	case FTInteger:
+		val, err := r.Int(field)
+		return int(val), err
+	case FTLogical:
+		return r.Bool(field)
+	case FTDate, FTDateTime:
+		return r.Time(field)
+	default:
+		return r.Float(field)
+	}
+}
+
+// def returns the definition of the field at index field, or nil.
+func (r Record) def(field int) *FieldDef {
+	if r.defs == nil {
+		return nil
+	}
+	return r.defs.ByIndex(field)
+}
+
+// field resolves the definition and raw bytes of the field at index field.
+func (r Record) field(field int) (*FieldDef, []byte, error) {
+	def := r.def(field)
+	if def == nil {
+		return nil, nil, NewErrorf("invalid field index: %d", field)
+	}
+
+	if def.Type() == FTMemo {
+		return nil, nil, NewErrorf("memo field '%s' cannot be decoded from the record buffer", def.Name())
+	}
+
+	raw := def.bytes(r.data)
+	if raw == nil {
+		return nil, nil, NewErrorf("field '%s' lies outside the record buffer", def.Name())
+	}
+	return def, raw, nil
+}
@@ -0,0 +1,889 @@
+package vulpo
+
+/*
+#cgo LDFLAGS: -Wl,--wrap=sort4getInit -Wl,--wrap=sort4get
+#include "d4all.h"
+#include "r4reinde.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// VULPO4REINDEX_HEADER_STEP is the distance between the tag headers of a
+// compound index, which the tag of tags records in place of record numbers.
+#define VULPO4REINDEX_HEADER_STEP 1024
+
+// VULPO4REINDEX is the state of a reindex of one index file. The shared
+// R4REINDEX writes the tags into the index file one after the other, exactly
+// as i4reindex does. Each tag has an R4REINDEX of its own for its sort, which
+// r4reindexSupplyKeys fills from a pass over the data file just before the
+// tag is written, as in i4reindex, so that one sort is alive at a time; the
+// shared writer state is copied into the tag's R4REINDEX around the pass and
+// r4reindexWriteKeys. Tags marked native have their keys built and sorted
+// outside CodeBase and skip the pass.
+typedef struct
+{
+   INDEX4 *index ;
+   R4REINDEX reindex ;
+   int nTags ;
+   TAG4 **tags ;
+   R4REINDEX *tagReindex ;
+   char *native ;
+   int nWritten ;    // tags written
+} VULPO4REINDEX ;
+
+// VULPO4RUNS is a set of sorted runs of fixed-width entries, each a key
+// followed by its record number in big-endian order, so that memcmp over
+// whole entries orders them as CodeBase's sort does: by key, then record
+// number. Installed in place of a tag's SORT4, it is merged by the wrapped
+// sort4get below as r4reindexWriteKeys reads the keys.
+typedef struct
+{
+   const unsigned char *entries ;
+   unsigned int entryLen ;
+   long *next ;      // next entry of each run
+   const long *end ;
+   int *heap ;       // runs with entries left, smallest next entry first
+   int heapN ;
+} VULPO4RUNS ;
+
+// vulpo4runsCmp marks a SORT4 whose pointers field holds a VULPO4RUNS.
+static int S4CALL vulpo4runsCmp(const void *a, const void *b, size_t len)
+{
+   return memcmp( a, b, len ) ;
+}
+
+static int vulpo4runsLess(const VULPO4RUNS *runs, int a, int b)
+{
+   return memcmp( runs->entries + runs->next[a] * runs->entryLen, runs->entries + runs->next[b] * runs->entryLen, runs->entryLen ) < 0 ;
+}
+
+static void vulpo4runsSiftDown(VULPO4RUNS *runs, int i)
+{
+   int child, run ;
+
+   for ( ;; i = child )
+   {
+      child = 2 * i + 1 ;
+      if ( child >= runs->heapN )
+         return ;
+      if ( child + 1 < runs->heapN && vulpo4runsLess( runs, runs->heap[child + 1], runs->heap[child] ) )
+         child++ ;
+      if ( !vulpo4runsLess( runs, runs->heap[child], runs->heap[i] ) )
+         return ;
+      run = runs->heap[i] ;
+      runs->heap[i] = runs->heap[child] ;
+      runs->heap[child] = run ;
+   }
+}
+
+int __real_sort4getInit( SORT4 * ) ;
+int __real_sort4get( SORT4 *, S4LONG *, void **, void ** ) ;
+
+// __wrap_sort4getInit and __wrap_sort4get stand in for the library's
+// functions, serving sorts marked by vulpo4runsCmp from their runs and
+// passing every other sort through.
+int __wrap_sort4getInit( SORT4 *sort )
+{
+   VULPO4RUNS *runs ;
+   int i ;
+
+   if ( sort == 0 || sort->cmp != vulpo4runsCmp )
+      return __real_sort4getInit( sort ) ;
+
+   runs = (VULPO4RUNS *)sort->pointers ;
+   for ( i = runs->heapN / 2 - 1 ; i >= 0 ; i-- )
+      vulpo4runsSiftDown( runs, i ) ;
+   return 0 ;
+}
+
+int __wrap_sort4get( SORT4 *sort, S4LONG *recNo, void **key, void **other )
+{
+   VULPO4RUNS *runs ;
+   const unsigned char *entry ;
+   int run ;
+
+   if ( sort == 0 || sort->cmp != vulpo4runsCmp )
+      return __real_sort4get( sort, recNo, key, other ) ;
+
+   runs = (VULPO4RUNS *)sort->pointers ;
+   if ( runs->heapN == 0 )
+      return r4done ;
+
+   run = runs->heap[0] ;
+   entry = runs->entries + runs->next[run] * runs->entryLen ;
+   *key = (void *)entry ;
+   *recNo = (S4LONG)( (unsigned S4LONG)entry[sort->sortLen] << 24 | (unsigned S4LONG)entry[sort->sortLen + 1] << 16 |
+                      (unsigned S4LONG)entry[sort->sortLen + 2] << 8 | (unsigned S4LONG)entry[sort->sortLen + 3] ) ;
+   if ( other != 0 )
+      *other = (void *)( entry + runs->entryLen ) ;
+
+   if ( ++runs->next[run] == runs->end[run] )
+      runs->heap[0] = runs->heap[--runs->heapN] ;
+   vulpo4runsSiftDown( runs, 0 ) ;
+   return 0 ;
+}
+
+// vulpo4reindexCopyState copies everything but the sort from one R4REINDEX
+// to another.
+static void vulpo4reindexCopyState(R4REINDEX *to, const R4REINDEX *from)
+{
+   size_t sortEnd = offsetof( R4REINDEX, sort ) + sizeof( SORT4 ) ;
+
+   memcpy( to, from, offsetof( R4REINDEX, sort ) ) ;
+   memcpy( (char *)to + sortEnd, (const char *)from + sortEnd, sizeof( R4REINDEX ) - sortEnd ) ;
+}
+
+// vulpo4reindexFree releases a reindex state, whether or not it completed.
+static void vulpo4reindexFree(VULPO4REINDEX *r)
+{
+   r4reindexFree( &r->reindex ) ;
+   free( r->tags ) ;
+   free( r->tagReindex ) ;
+   free( r->native ) ;
+   free( r ) ;
+}
+
+// vulpo4reindexBegin locks the table and prepares the index file for a
+// rebuild as i4reindex does: the tag headers are laid out, the block buffers
+// allocated and, for a compound index, the tag of tags is written. Returns
+// NULL on failure with the CodeBase result in *status.
+static VULPO4REINDEX *vulpo4reindexBegin(INDEX4 *index, int *status)
+{
+   CODE4 *codeBase = index->codeBase ;
+   INDEX4FILE *indexFile = index->indexFile ;
+   TAG4FILE *tagIndex = indexFile->tagIndex ;
+   VULPO4REINDEX *r ;
+   TAG4 *tag ;
+   char name[LEN4TAG_ALIAS + 1] ;
+   S4LONG recNo ;
+   int i, rc ;
+
+   if ( error4code( codeBase ) < 0 )
+   {
+      *status = e4codeBase ;
+      return 0 ;
+   }
+   if ( index->tags.nLink != indexFile->tags.nLink )
+   {
+      *status = e4struct ;
+      return 0 ;
+   }
+
+   rc = d4lockAll( index->data ) ;
+   if ( rc != 0 )
+   {
+      *status = rc ;
+      return 0 ;
+   }
+   i4deleteRemoveKeys( index ) ;
+
+   r = (VULPO4REINDEX *)calloc( 1, sizeof( VULPO4REINDEX ) ) ;
+   if ( r == 0 )
+   {
+      *status = e4memory ;
+      return 0 ;
+   }
+   r->index = index ;
+
+   rc = r4reindexInit( &r->reindex, index, indexFile ) ;
+   if ( rc < 0 )
+   {
+      free( r ) ;
+      *status = rc ;
+      return 0 ;
+   }
+
+   r->nTags = (int)index->tags.nLink ;
+   r->tags = (TAG4 **)calloc( r->nTags + 1, sizeof( TAG4 * ) ) ;
+   r->tagReindex = (R4REINDEX *)calloc( r->nTags + 1, sizeof( R4REINDEX ) ) ;
+   r->native = (char *)calloc( r->nTags + 1, 1 ) ;
+   if ( r->tags == 0 || r->tagReindex == 0 || r->native == 0 )
+   {
+      vulpo4reindexFree( r ) ;
+      *status = e4memory ;
+      return 0 ;
+   }
+   for ( i = 0, tag = 0 ; i < r->nTags && ( tag = (TAG4 *)l4next( &index->tags, tag ) ) != 0 ; i++ )
+      r->tags[i] = tag ;
+
+   rc = r4reindexTagHeadersCalc( &r->reindex ) ;
+   if ( rc >= 0 )
+      rc = r4reindexBlocksAlloc( &r->reindex ) ;
+
+   if ( rc >= 0 )
+   {
+      if ( indexFile->file.lowAccessMode != OPEN4DENY_RW )
+         tagIndex->header.version = indexFile->versionOld + 1 ;
+
+      r->reindex.nBlocksUsed = 0 ;
+      if ( (unsigned char)tagIndex->header.typeCode >= 0x40 )
+      {
+         // Compound index: the tag of tags maps each tag name to its header
+         r->reindex.tag = tagIndex ;
+         rc = sort4init( &r->reindex.sort, codeBase, tagIndex->header.keyLen, 0 ) ;
+         r->reindex.sort.cmp = (S4CMP_FUNCTION *)memcmp ;
+         for ( i = 0, recNo = VULPO4REINDEX_HEADER_STEP ; rc >= 0 && i < r->nTags ; i++, recNo += VULPO4REINDEX_HEADER_STEP )
+         {
+            memset( name, ' ', LEN4TAG_ALIAS ) ;
+            name[LEN4TAG_ALIAS] = 0 ;
+            memcpy( name, r->tags[i]->tagFile->alias, strlen( r->tags[i]->tagFile->alias ) ) ;
+            rc = sort4put( &r->reindex.sort, recNo, name, "" ) ;
+            r->reindex.keyCount++ ;
+         }
+         if ( rc >= 0 )
+            rc = r4reindexWriteKeys( &r->reindex, e4unique ) ;
+      }
+      else if ( r->reindex.nTags > 1 )
+         rc = e4index ;
+   }
+
+   if ( rc != 0 )
+   {
+      vulpo4reindexFree( r ) ;
+      *status = rc ;
+      return 0 ;
+   }
+
+   *status = 0 ;
+   return r ;
+}
+
+// vulpo4reindexWrite sorts the keys of the next tag with r4reindexSupplyKeys
+// and writes them into the index file, freeing the sort. For a native tag,
+// the keys are read from nRuns sorted runs of entries (see VULPO4RUNS), run k
+// ending before entry ends[k], instead. Returns 0, a positive result that
+// ends the reindex (as from i4reindex), or a negative CodeBase error.
+static int vulpo4reindexWrite(VULPO4REINDEX *r, const unsigned char *entries, const long *ends, int nRuns)
+{
+   R4REINDEX *tagReindex = &r->tagReindex[r->nWritten] ;
+   TAG4 *tag = r->tags[r->nWritten] ;
+   S4LONG keyCount = 0 ;
+   VULPO4RUNS runs ;
+   int i, rc ;
+
+   if ( entries != 0 )
+   {
+      memset( &runs, 0, sizeof( runs ) ) ;
+      runs.entries = entries ;
+      runs.entryLen = tag->tagFile->header.keyLen + 4 ;
+      runs.end = ends ;
+      runs.next = (long *)calloc( nRuns + 1, sizeof( long ) ) ;
+      runs.heap = (int *)calloc( nRuns + 1, sizeof( int ) ) ;
+      if ( runs.next == 0 || runs.heap == 0 )
+      {
+         free( runs.next ) ;
+         free( runs.heap ) ;
+         return e4memory ;
+      }
+      for ( i = 0 ; i < nRuns ; i++ )
+      {
+         runs.next[i] = i == 0 ? 0 : ends[i - 1] ;
+         if ( runs.next[i] < ends[i] )
+            runs.heap[runs.heapN++] = i ;
+      }
+      keyCount = nRuns == 0 ? 0 : ends[nRuns - 1] ;
+
+      // The runs stand in for the tag's sort
+      memset( &tagReindex->sort, 0, sizeof( SORT4 ) ) ;
+      tagReindex->sort.codeBase = r->reindex.codeBase ;
+      tagReindex->sort.cmp = vulpo4runsCmp ;
+      tagReindex->sort.pointers = (char **)&runs ;
+      tagReindex->sort.sortLen = tag->tagFile->header.keyLen ;
+   }
+
+   vulpo4reindexCopyState( tagReindex, &r->reindex ) ;
+   tagReindex->tag = tag->tagFile ;
+   tagReindex->nBlocksUsed = 0 ;
+   tagReindex->keyCount = keyCount ;
+
+   rc = entries != 0 ? 0 : r4reindexSupplyKeys( tagReindex ) ;
+   if ( rc == 0 )
+      rc = r4reindexWriteKeys( tagReindex, t4unique( tag ) ) ;
+
+   vulpo4reindexCopyState( &r->reindex, tagReindex ) ;
+   if ( entries != 0 )
+   {
+      memset( &tagReindex->sort, 0, sizeof( SORT4 ) ) ;
+      free( runs.next ) ;
+      free( runs.heap ) ;
+   }
+   else
+      sort4free( &tagReindex->sort ) ;
+   r->nWritten++ ;
+   return rc ;
+}
+
+// vulpo4reindexRelink walks each level of every tag from its last block to
+// its first, restoring the right sibling links the writer leaves unset, and
+// reloads the tag's block buffers, as i4reindex does after writing.
+static int vulpo4reindexRelink(VULPO4REINDEX *r)
+{
+   INDEX4FILE *indexFile = r->reindex.indexFile ;
+   TAG4FILE *tagFile ;
+   B4BLOCK *block ;
+   S4LONG node, right ;
+   int i, rc ;
+
+   for ( i = 0 ; i < r->nTags ; i++ )
+   {
+      tagFile = r->tags[i]->tagFile ;
+      tfile4rlBottom( tagFile ) ;
+
+      while ( tagFile->blocks.lastNode != 0 )
+      {
+         block = tfile4block( tagFile ) ;
+         right = block->fileBlock ;
+
+         for ( node = block->header.leftNode ; node != -1 ; node = block->header.leftNode )
+         {
+            if ( node <= 0 )
+               return e4struct ;
+            if ( block->changed )
+            {
+               rc = b4flush( block ) ;
+               if ( rc < 0 )
+                  return rc ;
+            }
+            rc = file4readAllInternal( &indexFile->file, node, &block->header, B4BLOCK_SIZE ) ;
+            if ( rc < 0 )
+               return rc ;
+
+            block->fileBlock = node ;
+            if ( block->header.rightNode != right )
+            {
+               block->header.rightNode = right ;
+               block->changed = 1 ;
+            }
+            right = node ;
+         }
+
+         block->builtOn = -1 ;
+         rc = b4top( block ) ;
+         if ( rc < 0 )
+            return rc ;
+         tfile4up( tagFile ) ;
+      }
+   }
+
+   return 0 ;
+}
+
+// vulpo4reindexEnd completes the reindex when rc is 0, writing the tag
+// headers, and releases the state. As after i4reindex, the record buffer is
+// left blank with no current record unless an error occurred. Returns rc or
+// the first error completing the index.
+static int vulpo4reindexEnd(VULPO4REINDEX *r, int rc)
+{
+   DATA4 *data = r->reindex.data ;
+
+   if ( rc == 0 )
+      rc = r4reindexTagHeadersWrite( &r->reindex ) ;
+   if ( rc == 0 )
+      rc = vulpo4reindexRelink( r ) ;
+
+   vulpo4reindexFree( r ) ;
+
+   if ( rc >= 0 )
+   {
+      data->recNum = -1 ;
+      data->recNumOld = -1 ;
+      d4blankLow( data, data->record ) ;
+   }
+   return rc ;
+}
+
+// vulpo4reindexNextIndex returns the index file after index in the table's
+// list of open index files, or the first one when index is NULL.
+static INDEX4 *vulpo4reindexNextIndex(DATA4 *data, INDEX4 *index)
+{
+   return (INDEX4 *)l4next( &data->indexes, index ) ;
+}
+
+// vulpo4reindexTag returns the i-th tag of a reindex, in write order.
+static TAG4 *vulpo4reindexTag(VULPO4REINDEX *r, int i)
+{
+   return r->tags[i] ;
+}
+
+// vulpo4reindexRecCount returns the number of records the reindex covers.
+static S4LONG vulpo4reindexRecCount(VULPO4REINDEX *r)
+{
+   return dfile4recCount( r->reindex.dataFile, -2L ) ;
+}
+
+// vulpo4reindexNumKey builds the key of a numeric field value as the
+// expression engine does for a FoxPro tag.
+static void vulpo4reindexNumKey(char *key, const char *field, int len)
+{
+   t4dblToFox( key, c4atod( field, len ) ) ;
+}
+*/
+import "C"
+import (
+	"bytes"
+	"encoding/binary"
+	"math"
+	"runtime"
+	"slices"
+	"strconv"
+	"strings"
+	"sync"
+	"unsafe"
+)
+
+// reindexNativeMin is the number of records from which tags are built
+// natively; smaller tables are sorted by CodeBase in memory faster than the
+// table can be mapped.
+const reindexNativeMin = 8192
+
+// Reindex rebuilds every tag of the table's open index files from the data
+// file.
+//
+// Parameters:
+//   - progress: Optional callback invoked after each tag has been written, with
+//     the tag name, the number of tags rebuilt so far and the total number of
+//     tags; nil for no reporting
+//
+// Returns:
+//   - error: Error if the database is not open, the table cannot be locked, or
+//     evaluating a key or writing an index file fails
+//
+// Tags are rebuilt one after the other as CodeBase's i4reindex does, each
+// from its own pass over the data file and its own sort, so only one sort
+// pool (CODE4.memSizeSortPool) is in use at a time before the sort spills to
+// temporary files.
+//
+// On tables of 8192 records or more, tags whose keys are copied straight from
+// the record skip CodeBase's pass: plain character, numeric and date fields,
+// and UPPER(), LEFT() and SUBSTR() of a character field, on unfiltered,
+// ascending tags with machine collation. Their keys are built by GOMAXPROCS
+// workers over a memory mapping of the data file, each worker sorts its own
+// share in memory, and the sorted runs are merged as the tag is written.
+// Numeric and date keys follow CodeBase's conversions, handing the values the
+// Go decoders reject to c4atod and date4long. Every other expression, TRIM()
+// and concatenations included, is evaluated by CodeBase.
+//
+// The table is locked and pending changes to the current record are written
+// first. Like Pack, Reindex leaves the table without a current record; call
+// a positioning function such as First or Goto afterwards.
+//
+// WARNING: The index files are rewritten in place. Take appropriate backups
+// first.
+//
+// Example:
+//
+//	err := v.Reindex(func(tag string, done, total int) {
+//		fmt.Printf("rebuilt %s (%d/%d)\n", tag, done, total)
+//	})
+//	if err != nil {
+//		log.Fatal(err)
+//	}
+func (v *Vulpo) Reindex(progress func(tag string, done, total int)) error {
+	if !v.Active() {
+		return NewError("database not open")
+	}
+
+	// Pending changes to the current record must reach the file first
+	if result := v.keyed(func() C.int { return C.d4updateRecord(v.data, 0) }); result < 0 {
+		C.error4set(v.codeBase, 0)
+		return NewErrorf("failed to update record before reindexing: error code %d", int(result))
+	}
+
+	// The mapping is made before any index file is taken apart, as creating
+	// it flushes the table; without it every tag goes through CodeBase
+	var scanner *Scanner
+	if C.d4recCountDo(v.data) >= reindexNativeMin {
+		if mapped, err := v.NewScanner(); err == nil {
+			scanner = mapped
+			defer scanner.Close()
+		}
+	}
+
+	total := 0
+	for index := C.vulpo4reindexNextIndex(v.data, nil); index != nil; index = C.vulpo4reindexNextIndex(v.data, index) {
+		total += int(index.tags.nLink)
+	}
+
+	done := 0
+	for index := C.vulpo4reindexNextIndex(v.data, nil); index != nil; index = C.vulpo4reindexNextIndex(v.data, index) {
+		// Key evaluation uses the expression engine's globals; building native
+		// keys and writing their runs do not, so those run unlocked
+		var status C.int
+		var native []*reindexSource
+		exprMutex.Lock()
+		r := C.vulpo4reindexBegin(index, &status)
+		exprMutex.Unlock()
+		rc := C.int(0)
+		if r != nil && scanner != nil && scanner.Count() == int(C.vulpo4reindexRecCount(r)) {
+			native = v.reindexNative(r)
+		}
+
+		if r == nil {
+			C.error4set(v.codeBase, 0)
+			if status == C.r4locked {
+				return NewError("failed to reindex: table is locked by another user")
+			}
+			return NewErrorf("failed to prepare reindex: error code %d", int(status))
+		}
+
+		var runs []*reindexRuns
+		if rc == 0 && native != nil {
+			var err error
+			if runs, err = scanner.reindexRuns(native, runtime.GOMAXPROCS(0)); err != nil {
+				rc = C.e4memory
+			}
+		}
+
+		for i := 0; rc == 0 && i < int(r.nTags); i++ {
+			name := C.GoString(C.t4alias(C.vulpo4reindexTag(r, C.int(i))))
+			if runs != nil && runs[i] != nil {
+				rc = C.vulpo4reindexWrite(r, runs[i].entries, runs[i].ends, C.int(runs[i].n))
+			} else {
+				exprMutex.Lock()
+				rc = C.vulpo4reindexWrite(r, nil, nil, 0)
+				exprMutex.Unlock()
+			}
+			if rc == 0 {
+				done++
+				if progress != nil {
+					progress(name, done, total)
+				}
+			}
+		}
+		for _, run := range runs {
+			run.free()
+		}
+
+		if rc = C.vulpo4reindexEnd(r, rc); rc != 0 {
+			C.error4set(v.codeBase, 0)
+			return NewErrorf("failed to reindex: error code %d", int(rc))
+		}
+	}
+
+	return nil
+}
+
+// reindexSource is the key expression of a tag built natively.
+type reindexSource struct {
+	expression string
+	keyLen     int
+}
+
+// reindexKey builds the keys of a tag from record images. Every worker
+// compiles its own.
+type reindexKey struct {
+	entry []byte // zeroed key and record number, appended per key
+	key   func(rec Record, dst []byte)
+}
+
+// compileReindexKey compiles the key expression of a tag. It fails for
+// anything but plain numeric and date fields, whose keys are converted as the
+// expression engine does, and the character keys parseKeyWindow accepts.
+func compileReindexKey(defs *FieldDefs, src *reindexSource) (*reindexKey, error) {
+	k := &reindexKey{entry: make([]byte, src.keyLen+4)}
+
+	if def := defs.ByName(strings.TrimSpace(src.expression)); def != nil && !def.nullable && src.keyLen == 8 {
+		start, length := def.offset, C.int(def.length)
+		switch def.Type() {
+		case FTNumeric, FTFloat:
+			// Plain decimals convert exactly in Go; c4atod takes the rest
+			k.key = func(rec Record, dst []byte) {
+				raw := bytes.TrimLeft(rec.data[start:start+int(length)], " \x00")
+				if len(raw) == 0 {
+					putFoxDouble(dst, 0)
+				} else if val, ok := parseDecimal(raw); ok {
+					putFoxDouble(dst, val)
+				} else {
+					C.vulpo4reindexNumKey((*C.char)(unsafe.Pointer(&dst[0])), (*C.char)(unsafe.Pointer(&rec.data[start])), length)
+				}
+			}
+			return k, nil
+		case FTDate:
+			// Dates the Go decoder rejects are left to date4long
+			k.key = func(rec Record, dst []byte) {
+				raw := rec.data[start : start+8]
+				jd := decodeDateJulian(raw)
+				if jd < 0 {
+					jd = date4long(raw)
+				}
+				putFoxDouble(dst, float64(jd))
+			}
+			return k, nil
+		}
+	}
+
+	tokens, err := tokenizeExpr(src.expression)
+	if err != nil {
+		return nil, err
+	}
+	c := &exprCompiler{defs: defs, tokens: tokens}
+	start, length, upper, err := c.parseKeyWindow()
+	if err != nil {
+		return nil, err
+	}
+	if c.pos != len(c.tokens) {
+		return nil, NewErrorf("unexpected '%s' in key expression", c.tokens[c.pos].text)
+	}
+	if length != src.keyLen {
+		return nil, NewErrorf("expression length %d differs from key length %d", length, src.keyLen)
+	}
+	k.key = func(rec Record, dst []byte) {
+		copy(dst, rec.data[start:start+length])
+		if upper {
+			for i, ch := range dst[:length] {
+				if ch >= 'a' && ch <= 'z' {
+					dst[i] = ch - ('a' - 'A')
+				}
+			}
+		}
+	}
+	return k, nil
+}
+
+// parseKeyWindow parses a key expression whose key is a run of the bytes of
+// one character field: the field itself, or UPPER(), LEFT() or SUBSTR() with
+// constant positions inside the field, applied to such an expression. It
+// returns the offset and length of the run in the record and whether the key
+// is upper-cased.
+func (c *exprCompiler) parseKeyWindow() (start, length int, upper bool, err error) {
+	tok := c.peek()
+	if tok == nil || tok.kind != tokIdent {
+		return 0, 0, false, NewError("expected a field or function in key expression")
+	}
+	c.pos++
+
+	if !c.accept(tokOperator, "(") {
+		def := c.defs.ByName(tok.text)
+		if def == nil || def.nullable || def.Type() != FTCharacter {
+			return 0, 0, false, NewErrorf("'%s' is not a character field", tok.text)
+		}
+		return def.offset, def.length, false, nil
+	}
+
+	name := strings.ToUpper(tok.text)
+	if start, length, upper, err = c.parseKeyWindow(); err != nil {
+		return 0, 0, false, err
+	}
+	var pos []int
+	for c.accept(tokOperator, ",") {
+		arg := c.peek()
+		if arg == nil || arg.kind != tokNumber {
+			return 0, 0, false, NewErrorf("%s() requires constant positions", name)
+		}
+		c.pos++
+		n, convErr := strconv.Atoi(arg.text)
+		if convErr != nil {
+			return 0, 0, false, NewErrorf("invalid position '%s'", arg.text)
+		}
+		pos = append(pos, n)
+	}
+	if err := c.expect(")"); err != nil {
+		return 0, 0, false, err
+	}
+
+	switch {
+	case name == "UPPER" && len(pos) == 0:
+		return start, length, true, nil
+	case name == "LEFT" && len(pos) == 1 && pos[0] >= 1 && pos[0] <= length:
+		return start, pos[0], upper, nil
+	case name == "SUBSTR" && len(pos) == 1 && pos[0] >= 1 && pos[0] <= length:
+		return start + pos[0] - 1, length - pos[0] + 1, upper, nil
+	case name == "SUBSTR" && len(pos) == 2 && pos[0] >= 1 && pos[1] >= 1 && pos[0]+pos[1]-1 <= length:
+		return start + pos[0] - 1, pos[1], upper, nil
+	}
+	return 0, 0, false, NewErrorf("%s() is not built natively", name)
+}
+
+// putFoxDouble stores the FoxPro key of a double in dst, byte for byte as
+// t4dblToFox builds it: big-endian, with the sign bit set for positive values
+// and every bit inverted for negative ones, so the keys sort like the values.
+// Negative zero gets the all-zero key t4dblToFox gives it.
+func putFoxDouble(dst []byte, val float64) {
+	bits := math.Float64bits(val)
+	switch {
+	case bits == 1<<63:
+		bits = 0
+	case bits&(1<<63) != 0:
+		bits = ^bits
+	default:
+		bits |= 1 << 63
+	}
+	binary.BigEndian.PutUint64(dst, bits)
+}
+
+// reindexNative picks the tags of a reindex whose keys can be built natively
+// and marks them. It returns the sources of the native tags by position, or
+// nil if there are none.
+func (v *Vulpo) reindexNative(r *C.VULPO4REINDEX) []*reindexSource {
+	nTags := int(r.nTags)
+	marks := unsafe.Slice(r.native, nTags)
+	sources := make([]*reindexSource, nTags)
+	found := false
+
+	for i := range sources {
+		tagFile := C.vulpo4reindexTag(r, C.int(i)).tagFile
+		if tagFile.filter != nil || tagFile.header.descending != 0 || tagFile.vfpInfo.sortType != C.sort4machine {
+			continue
+		}
+
+		src := &reindexSource{
+			expression: C.GoString(C.expr4source(tagFile.expr)),
+			keyLen:     int(tagFile.header.keyLen),
+		}
+		if _, err := compileReindexKey(v.fieldDefs, src); err != nil {
+			continue
+		}
+		sources[i] = src
+		marks[i] = 1
+		found = true
+	}
+
+	if !found {
+		return nil
+	}
+	return sources
+}
+
+// reindexRuns holds the keys of a native tag in C memory as the sorted runs
+// vulpo4reindexWrite merges: one run per worker, each entry a key followed by
+// its record number in big-endian order.
+type reindexRuns struct {
+	entries *C.uchar
+	ends    *C.long
+	n       int
+}
+
+// free releases the C memory of the runs; it does nothing on nil.
+func (rr *reindexRuns) free() {
+	if rr == nil {
+		return
+	}
+	C.free(unsafe.Pointer(rr.entries))
+	C.free(unsafe.Pointer(rr.ends))
+}
+
+// reindexRuns builds the keys of the native tags with parallel workers over
+// the scanner and sorts every worker's share of each tag into a run. The
+// result has an entry per tag, nil for the tags left to CodeBase.
+func (s *Scanner) reindexRuns(sources []*reindexSource, workers int) ([]*reindexRuns, error) {
+	keys := make([][]*reindexKey, workers)
+	entries := make([][][]byte, workers)
+	for worker := range keys {
+		keys[worker] = make([]*reindexKey, len(sources))
+		entries[worker] = make([][]byte, len(sources))
+		for i, src := range sources {
+			if src == nil {
+				continue
+			}
+			key, err := compileReindexKey(s.defs, src)
+			if err != nil {
+				return nil, err
+			}
+			keys[worker][i] = key
+			entries[worker][i] = make([]byte, 0, (s.Count()/workers+1)*len(key.entry))
+		}
+	}
+
+	err := s.parallelScan(workers, func(worker int, rec Record) error {
+		for i, key := range keys[worker] {
+			if key == nil {
+				continue
+			}
+			buf := append(entries[worker][i], key.entry...)
+			entry := buf[len(buf)-len(key.entry):]
+			key.key(rec, entry)
+			binary.BigEndian.PutUint32(entry[len(entry)-4:], uint32(rec.RecordNumber()))
+			entries[worker][i] = buf
+		}
+		return nil
+	})
+	if err != nil {
+		return nil, err
+	}
+
+	runs := make([]*reindexRuns, len(sources))
+	var wg sync.WaitGroup
+	for i, src := range sources {
+		if src == nil {
+			continue
+		}
+
+		entryLen := src.keyLen + 4
+		size := 0
+		for worker := range entries {
+			size += len(entries[worker][i])
+		}
+
+		run := &reindexRuns{
+			entries: (*C.uchar)(C.malloc(C.size_t(max(size, 1)))),
+			ends:    (*C.long)(C.malloc(C.size_t(workers) * C.size_t(unsafe.Sizeof(C.long(0))))),
+			n:       workers,
+		}
+		if run.entries == nil || run.ends == nil {
+			run.free()
+			for _, built := range runs {
+				built.free()
+			}
+			wg.Wait()
+			return nil, NewError("failed to allocate index keys")
+		}
+		runs[i] = run
+
+		dst := unsafe.Slice((*byte)(run.entries), max(size, 1))
+		ends := unsafe.Slice(run.ends, workers)
+		offset := 0
+		for worker := range entries {
+			src := entries[worker][i]
+			ends[worker] = C.long((offset + len(src)) / entryLen)
+
+			wg.Add(1)
+			go func(src, dst []byte) {
+				defer wg.Done()
+				sortReindexEntries(src, dst, entryLen)
+			}(src, dst[offset:offset+len(src)])
+			offset += len(src)
+		}
+	}
+	wg.Wait()
+
+	return runs, nil
+}
+
+// sortReindexEntries writes the fixed-width entries of src, a key followed by
+// a record number, to dst in ascending byte order. Entries are ordered by the
+// first 8 bytes of their key as a number, which settles numeric and date keys
+// outright, then by the rest of the key, then by their position in src, which
+// workers fill in record number order.
+func sortReindexEntries(src, dst []byte, entryLen int) {
+	type prefixed struct {
+		prefix uint64
+		index  int32
+	}
+
+	keyLen := entryLen - 4
+	order := make([]prefixed, len(src)/entryLen)
+	var head [8]byte
+	for i := range order {
+		copy(head[:], src[i*entryLen:i*entryLen+min(keyLen, 8)])
+		order[i] = prefixed{binary.BigEndian.Uint64(head[:]), int32(i)}
+	}
+
+	slices.SortFunc(order, func(a, b prefixed) int {
+		if a.prefix != b.prefix {
+			if a.prefix < b.prefix {
+				return -1
+			}
+			return 1
+		}
+		if keyLen > 8 {
+			ra, rb := int(a.index)*entryLen, int(b.index)*entryLen
+			if c := bytes.Compare(src[ra+8:ra+keyLen], src[rb+8:rb+keyLen]); c != 0 {
+				return c
+			}
+		}
+		return int(a.index - b.index)
+	})
+	for i, e := range order {
+		copy(dst[i*entryLen:], src[int(e.index)*entryLen:int(e.index+1)*entryLen])
+	}
+}
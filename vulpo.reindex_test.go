@@ -0,0 +1,341 @@
+package vulpo
+
+import (
+	"bytes"
+	"encoding/binary"
+	"fmt"
+	"math"
+	"os"
+	"path/filepath"
+	"strings"
+	"testing"
+)
+
+// testDBFTrimTagsPath is a copy of the info table whose production index has
+// tags on TRIM(NAME)+'X' (TRIMX), UPPER(NAME) (UNAME) and LEFT(NAME,6) (LNAME).
+const testDBFTrimTagsPath = "testdata/trimtags.dbf"
+
+// copyTable copies the files of a table with the extensions exts, such as
+// ".dbf" and ".cdx", into dir and returns the path of the copied table. Files
+// other than the table that do not exist are skipped.
+func copyTable(t testing.TB, table, dir string, exts ...string) string {
+	t.Helper()
+
+	base := strings.TrimSuffix(table, filepath.Ext(table))
+	for _, ext := range exts {
+		data, err := os.ReadFile(base + ext)
+		if os.IsNotExist(err) && ext != filepath.Ext(table) {
+			continue
+		}
+		if err != nil {
+			t.Fatalf("Failed to read %s: %v", base+ext, err)
+		}
+		if err := os.WriteFile(filepath.Join(dir, filepath.Base(base)+ext), data, 0o644); err != nil {
+			t.Fatalf("Failed to copy %s: %v", base+ext, err)
+		}
+	}
+	return filepath.Join(dir, filepath.Base(table))
+}
+
+// rawTable is a table file read into memory, for fixtures that lay out or
+// patch records byte by byte.
+type rawTable struct {
+	path      string
+	data      []byte
+	count     int
+	headerLen int
+	recordLen int
+}
+
+// readRawTable reads a table file and the record layout from its header.
+func readRawTable(t testing.TB, path string) *rawTable {
+	t.Helper()
+
+	data, err := os.ReadFile(path)
+	if err != nil {
+		t.Fatalf("Failed to read %s: %v", path, err)
+	}
+	return &rawTable{
+		path:      path,
+		data:      data,
+		count:     int(binary.LittleEndian.Uint32(data[4:8])),
+		headerLen: int(binary.LittleEndian.Uint16(data[8:10])),
+		recordLen: int(binary.LittleEndian.Uint16(data[10:12])),
+	}
+}
+
+// record returns the bytes of record recNo, deletion flag first.
+func (rt *rawTable) record(recNo int) []byte {
+	start := rt.headerLen + (recNo-1)*rt.recordLen
+	return rt.data[start : start+rt.recordLen]
+}
+
+// records returns the bytes of all records, laid end to end.
+func (rt *rawTable) records() []byte {
+	return rt.data[rt.headerLen : rt.headerLen+rt.count*rt.recordLen]
+}
+
+// setRecords replaces the records of the table with records, laid end to
+// end, and sets the record count to match.
+func (rt *rawTable) setRecords(records []byte) {
+	rt.count = len(records) / rt.recordLen
+	data := append(rt.data[:rt.headerLen:rt.headerLen], records...)
+	binary.LittleEndian.PutUint32(data[4:8], uint32(rt.count))
+	rt.data = append(data, 0x1A)
+}
+
+// field returns the stored bytes of a field of record recNo.
+func (rt *rawTable) field(t testing.TB, recNo int, name string) []byte {
+	t.Helper()
+
+	offset := 1
+	for desc := 32; rt.data[desc] != 0x0D; desc += 32 {
+		length := int(rt.data[desc+16])
+		if strings.TrimRight(string(rt.data[desc:desc+11]), "\x00") == name {
+			return rt.record(recNo)[offset : offset+length]
+		}
+		offset += length
+	}
+	t.Fatalf("No field %s in %s", name, rt.path)
+	return nil
+}
+
+// write writes the table back to its file.
+func (rt *rawTable) write(t testing.TB) {
+	t.Helper()
+
+	if err := os.WriteFile(rt.path, rt.data, 0o644); err != nil {
+		t.Fatalf("Failed to write %s: %v", rt.path, err)
+	}
+}
+
+// replicateTable writes a copy of a table into dir with every record
+// repeated copies times, together with its production index, and returns the
+// path of the copy. The index still describes the original records until it
+// is rebuilt.
+func replicateTable(t testing.TB, table, dir string, copies int) string {
+	t.Helper()
+
+	rt := readRawTable(t, copyTable(t, table, dir, ".dbf", ".cdx"))
+	rt.setRecords(bytes.Repeat(rt.records(), copies))
+	rt.write(t)
+	return rt.path
+}
+
+// shortNameTable writes a copy of the trimtags table with every record
+// repeated copies times, as replicateTable does, and returns its path. Every
+// NAME fills its field but the one of record 2, "SHORT", so the keys of TRIMX
+// only differ from NAME+'X' on a record a sample of the table would miss.
+func shortNameTable(t testing.TB, copies int) string {
+	t.Helper()
+
+	rt := readRawTable(t, replicateTable(t, testDBFTrimTagsPath, t.TempDir(), copies))
+	for recNo := 1; recNo <= rt.count; recNo++ {
+		name := rt.field(t, recNo, "NAME")
+		copy(name, fmt.Sprintf("%0*d", len(name), recNo*7919%rt.count))
+	}
+	copy(rt.field(t, 2, "NAME"), fmt.Sprintf("%-20s", "SHORT"))
+	rt.write(t)
+	return rt.path
+}
+
+// setRawField overwrites the stored bytes of a field of record recNo in a
+// table file.
+func setRawField(t testing.TB, path string, recNo int, field, value string) {
+	t.Helper()
+
+	rt := readRawTable(t, path)
+	copy(rt.field(t, recNo, field), value)
+	rt.write(t)
+}
+
+func TestVulpo_Reindex_NoDatabase(t *testing.T) {
+	v := &Vulpo{}
+
+	if err := v.Reindex(nil); err == nil {
+		t.Error("Expected error for Reindex with inactive database")
+	}
+}
+
+func TestVulpo_Reindex_MatchesPack(t *testing.T) {
+	// With no deleted records, Pack rebuilds the index with CodeBase's own
+	// i4reindex, which Reindex must reproduce byte for byte. The larger
+	// table does not fit the sort memory, so Pack spills every tag to disk,
+	// while Reindex builds and merges the keys natively. Record 2 is not
+	// among the records the native keys are checked on, and gets dates the
+	// Go decoder used to reject.
+	for _, copies := range []int{1, 40} {
+		t.Run(fmt.Sprintf("Copies=%d", copies), func(t *testing.T) {
+			reindexed := replicateTable(t, testDBFWithIndexPath, t.TempDir(), copies)
+			packed := replicateTable(t, testDBFWithIndexPath, t.TempDir(), copies)
+			for _, path := range []string{reindexed, packed} {
+				setRawField(t, path, 2, "BIRTH_DATE", "2023013 ")
+				setRawField(t, path, 3, "BIRTH_DATE", "201 0101")
+			}
+
+			v := &Vulpo{}
+			if err := v.Open(packed); err != nil {
+				t.Fatalf("Failed to open test file: %v", err)
+			}
+			if n, _ := v.CountDeleted(); n != 0 {
+				t.Fatalf("Expected no deleted records, got %d", n)
+			}
+			if err := v.Pack(); err != nil {
+				t.Fatalf("Pack failed: %v", err)
+			}
+			v.Close()
+
+			if err := v.Open(reindexed); err != nil {
+				t.Fatalf("Failed to open test file: %v", err)
+			}
+			var names []string
+			var done []int
+			err := v.Reindex(func(tag string, n, total int) {
+				names = append(names, tag)
+				done = append(done, n)
+				if total != 3 {
+					t.Errorf("Expected 3 tags in total, got %d", total)
+				}
+			})
+			if err != nil {
+				t.Fatalf("Reindex failed: %v", err)
+			}
+
+			if got := strings.Join(names, ","); got != strings.Join(v.TagNames(), ",") {
+				t.Errorf("Progress reported tags %s, want %s", got, strings.Join(v.TagNames(), ","))
+			}
+			for i, n := range done {
+				if n != i+1 {
+					t.Errorf("Progress call %d reported %d tags done", i, n)
+				}
+			}
+
+			// The rebuilt tags are usable straight away
+			tag := v.TagByName("INF_AGE")
+			count, err := v.CountTagRange(tag, "", "")
+			header := v.Header()
+			if err != nil || count != int(header.RecordCount()) {
+				t.Errorf("CountTagRange after Reindex = %d, %v; want %d", count, err, header.RecordCount())
+			}
+			v.Close()
+
+			want, _ := os.ReadFile(strings.TrimSuffix(packed, ".dbf") + ".cdx")
+			got, _ := os.ReadFile(strings.TrimSuffix(reindexed, ".dbf") + ".cdx")
+			if len(want) == 0 || !bytes.Equal(got, want) {
+				t.Errorf("Reindexed index (%d bytes) differs from the one rebuilt by Pack (%d bytes)", len(got), len(want))
+			}
+		})
+	}
+}
+
+func TestVulpo_Reindex_TrimmedKeys(t *testing.T) {
+	// The UPPER and LEFT tags are built natively; TRIMX must be left to
+	// CodeBase
+	reindexed := shortNameTable(t, 40)
+	packed := shortNameTable(t, 40)
+
+	v := &Vulpo{}
+	if err := v.Open(packed); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	if err := v.Pack(); err != nil {
+		t.Fatalf("Pack failed: %v", err)
+	}
+	v.Close()
+
+	if err := v.Open(reindexed); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	if err := v.Reindex(nil); err != nil {
+		t.Fatalf("Reindex failed: %v", err)
+	}
+
+	tag := v.TagByName("TRIMX")
+	if result, err := v.SeekWithTag(tag, "SHORTX"); err != nil || result != SeekSuccess || v.Position() != 2 {
+		t.Errorf("Seek SHORTX after Reindex = %v, %v at record %d; want Success at record 2", result, err, v.Position())
+	}
+	if count, err := v.CountTagRange(tag, "SHORTX", "SHORTX"); err != nil || count != 1 {
+		t.Errorf("CountTagRange SHORTX after Reindex = %d, %v; want 1", count, err)
+	}
+	v.Close()
+
+	want, _ := os.ReadFile(strings.TrimSuffix(packed, ".dbf") + ".cdx")
+	got, _ := os.ReadFile(strings.TrimSuffix(reindexed, ".dbf") + ".cdx")
+	if len(want) == 0 || !bytes.Equal(got, want) {
+		t.Errorf("Reindexed index (%d bytes) differs from the one rebuilt by Pack (%d bytes)", len(got), len(want))
+	}
+}
+
+func TestVulpo_Reindex_RestoresTag(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(copyTable(t, testDBFWithIndexPath, t.TempDir(), ".dbf", ".cdx")); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	before, err := v.SeekMany(v.TagByName("INF_AGE"), []string{"20", "33", "64", "99"})
+	if err != nil {
+		t.Fatalf("SeekMany failed: %v", err)
+	}
+
+	if err := v.Reindex(nil); err != nil {
+		t.Fatalf("Reindex failed: %v", err)
+	}
+
+	after, err := v.SeekMany(v.TagByName("INF_AGE"), []string{"20", "33", "64", "99"})
+	if err != nil {
+		t.Fatalf("SeekMany after Reindex failed: %v", err)
+	}
+	for i := range before {
+		if before[i] != after[i] {
+			t.Errorf("Key %d: record %d before Reindex, %d after", i, before[i], after[i])
+		}
+	}
+}
+
+func TestPutFoxDouble(t *testing.T) {
+	// Keys as t4dblToFox builds them
+	tests := []struct {
+		val  float64
+		want uint64
+	}{
+		{0, 0x8000000000000000},
+		{math.Copysign(0, -1), 0},
+		{1, 0xbff0000000000000},
+		{-1, 0x400fffffffffffff},
+		{123.456, 0xc05edd2f1a9fbe77},
+		{-0.001, 0x40af9db22d0e5603},
+	}
+
+	for _, tt := range tests {
+		key := make([]byte, 8)
+		putFoxDouble(key, tt.val)
+		if got := binary.BigEndian.Uint64(key); got != tt.want {
+			t.Errorf("putFoxDouble(%v) = %016x, want %016x", tt.val, got, tt.want)
+		}
+	}
+}
+
+func TestSortReindexEntries(t *testing.T) {
+	// Keys longer than the 8-byte prefix, with duplicates that must keep
+	// their record order
+	keys := []string{"SMITH     B", "JONES     A", "SMITH     A", "JONES     A", "ADAMS     Z", "SMITH     B"}
+	entryLen := len(keys[0]) + 4
+
+	var src []byte
+	for i, key := range keys {
+		src = append(src, key...)
+		src = binary.BigEndian.AppendUint32(src, uint32(i+1))
+	}
+	dst := make([]byte, len(src))
+	sortReindexEntries(src, dst, entryLen)
+
+	var want []byte
+	for _, i := range []int{4, 1, 3, 2, 0, 5} {
+		want = append(want, keys[i]...)
+		want = binary.BigEndian.AppendUint32(want, uint32(i+1))
+	}
+	if !bytes.Equal(dst, want) {
+		t.Errorf("sortReindexEntries = %q, want %q", dst, want)
+	}
+}
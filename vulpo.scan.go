@@ -0,0 +1,223 @@
+package vulpo
+
+/*
+#include "d4all.h"
+*/
+import "C"
+import (
+	"errors"
+	"os"
+)
+
+// Scanner is a read-only, memory-mapped view of the records of an open DBF
+// file. Record i is addressed directly at headerLen + (i-1)*recordLen, so
+// scanning bypasses d4skip and CodeBase's buffering entirely: field decoding
+// and the deleted check read the mapped bytes without copying.
+//
+// A Scanner sees the records present when it was created. Records appended
+// afterwards are not visible; create a new Scanner to pick them up. Close the
+// Scanner when done to release the mapping.
+type Scanner struct {
+	file      *os.File
+	data      []byte
+	headerLen int
+	recordLen int
+	count     int
+	defs      *FieldDefs
+}
+
+// NewScanner maps the data file read-only and returns a Scanner over its
+// records in physical order. Pending changes in the CodeBase record buffer are
+// flushed first so the mapping reflects them.
+//
+// Returns an error if the database is not open or the file cannot be mapped.
+func (v *Vulpo) NewScanner() (*Scanner, error) {
+	if !v.Active() {
+		return nil, NewError("database not open")
+	}
+
+	if result := v.keyed(func() C.int { return C.d4flush(v.data) }); result < 0 {
+		return nil, NewErrorf("failed to flush database before scan: error code %d", int(result))
+	}
+
+	scanner := &Scanner{
+		headerLen: v.header.headerLen,
+		recordLen: v.header.recordLen,
+		count:     int(C.d4recCountDo(v.data)),
+		defs:      v.fieldDefs,
+	}
+
+	if scanner.recordLen <= 0 {
+		return nil, NewErrorf("invalid record length: %d", scanner.recordLen)
+	}
+
+	file, err := os.Open(v.filename)
+	if err != nil {
+		return nil, NewErrorf("failed to open data file for scanning: %s", v.filename).SetWrapped(err)
+	}
+
+	info, err := file.Stat()
+	if err != nil {
+		_ = file.Close()
+		return nil, NewErrorf("failed to stat data file: %s", v.filename).SetWrapped(err)
+	}
+
+	// Never address past the end of the file, even if the header count is ahead
+	if available := (int(info.Size()) - scanner.headerLen) / scanner.recordLen; available < scanner.count {
+		scanner.count = max(available, 0)
+	}
+
+	if scanner.count == 0 {
+		_ = file.Close()
+		return scanner, nil
+	}
+
+	data, err := mapFile(file, scanner.headerLen+scanner.count*scanner.recordLen)
+	if err != nil {
+		_ = file.Close()
+		return nil, NewErrorf("failed to map data file: %s", v.filename).SetWrapped(err)
+	}
+
+	scanner.file = file
+	scanner.data = data
+	return scanner, nil
+}
+
+// Count returns the number of records visible to the scanner.
+func (s *Scanner) Count() int {
+	return s.count
+}
+
+// Record returns a zero-copy view of the record with the given 1-indexed
+// physical record number. The returned Record has no data (and decoding fails)
+// if recNo is out of range or the scanner is closed.
+func (s *Scanner) Record(recNo int) Record {
+	if recNo < 1 || recNo > s.count || s.data == nil {
+		return Record{recNo: recNo, defs: s.defs}
+	}
+
+	start := s.headerLen + (recNo-1)*s.recordLen
+	return Record{
+		data:  s.data[start : start+s.recordLen : start+s.recordLen],
+		recNo: recNo,
+		defs:  s.defs,
+	}
+}
+
+// Deleted reports whether the record with the given 1-indexed record number is
+// marked for deletion, reading only its flag byte.
+func (s *Scanner) Deleted(recNo int) bool {
+	if recNo < 1 || recNo > s.count || s.data == nil {
+		return false
+	}
+	return s.data[s.headerLen+(recNo-1)*s.recordLen] == '*'
+}
+
+// Close releases the mapping. Records obtained from the scanner must not be
+// used afterwards.
+func (s *Scanner) Close() error {
+	if s.data == nil {
+		return nil
+	}
+
+	err := unmapFile(s.data)
+	s.data = nil
+	s.count = 0
+
+	if closeErr := s.file.Close(); err == nil {
+		err = closeErr
+	}
+	s.file = nil
+
+	if err != nil {
+		return NewError("failed to release scanner").SetWrapped(err)
+	}
+	return nil
+}
+
+// Scan calls fn for every record, deleted ones included, until fn returns an
+// error or the table is exhausted.
+//
+// Parameters:
+//   - fn: Callback receiving a Record view; it must not retain the view
+//
+// Returns:
+//   - error: nil on success, the callback's error, or an error if the scan fails
+//
+// Without a selected tag, records are read in physical order from a
+// memory-mapped Scanner. With a selected tag, Scan falls back to CodeBase
+// navigation through ReadBatch so records arrive in tag order. The current
+// position is preserved.
+//
+// Example:
+//
+//	amount := v.FieldDefs().Index("AMOUNT")
+//	total := 0.0
+//	err := v.Scan(func(rec Record) error {
+//		if !rec.Deleted() {
+//			val, _ := rec.Float(amount)
+//			total += val
+//		}
+//		return nil
+//	})
+func (v *Vulpo) Scan(fn func(rec Record) error) error {
+	if !v.Active() {
+		return NewError("database not open")
+	}
+
+	if v.SelectedTag() == nil {
+		scanner, err := v.NewScanner()
+		if err == nil {
+			defer scanner.Close()
+			for recNo := 1; recNo <= scanner.Count(); recNo++ {
+				if err := fn(scanner.Record(recNo)); err != nil {
+					return err
+				}
+			}
+			return nil
+		}
+		// Mapping unavailable: fall through to CodeBase navigation
+	}
+
+	return v.scanBatches(fn)
+}
+
+// scanBatches runs fn over every record in the current navigation order using
+// ReadBatch, preserving the current position.
+func (v *Vulpo) scanBatches(fn func(rec Record) error) error {
+	originalPosition := v.Position()
+	defer func() {
+		if originalPosition > 0 {
+			_ = v.Goto(originalPosition) // Ignore error in defer
+		}
+	}()
+
+	batch, err := v.NewRecordBatch(scanBatchSize)
+	if err != nil {
+		return err
+	}
+
+	if err := v.First(); err != nil {
+		return NewErrorf("failed to go to first record: %v", err)
+	}
+
+	for {
+		if err := v.ReadBatchInto(batch); err != nil {
+			return err
+		}
+		if batch.Len() == 0 {
+			return nil
+		}
+		for i := 0; i < batch.Len(); i++ {
+			if err := fn(batch.At(i)); err != nil {
+				return err
+			}
+		}
+	}
+}
+
+// scanBatchSize is the number of records copied per cgo call by batch scans.
+const scanBatchSize = 512
+
+// errStopScan is returned by internal scan callbacks to end a scan early.
+var errStopScan = errors.New("scan stopped")
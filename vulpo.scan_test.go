@@ -0,0 +1,152 @@
+package vulpo
+
+import (
+	"bytes"
+	"errors"
+	"testing"
+)
+
+func TestVulpo_Scan_NoDatabase(t *testing.T) {
+	v := &Vulpo{}
+
+	if _, err := v.NewScanner(); err == nil {
+		t.Error("Expected error for NewScanner with inactive database")
+	}
+
+	if err := v.Scan(func(Record) error { return nil }); err == nil {
+		t.Error("Expected error for Scan with inactive database")
+	}
+}
+
+func TestScanner_MatchesReadBatch(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	scanner, err := v.NewScanner()
+	if err != nil {
+		t.Fatalf("NewScanner failed: %v", err)
+	}
+	defer scanner.Close()
+
+	header := v.Header()
+	if scanner.Count() != int(header.RecordCount()) {
+		t.Errorf("Expected %d records, got %d", header.RecordCount(), scanner.Count())
+	}
+
+	_ = v.SelectTag(nil)
+	_ = v.First()
+	batch, err := v.ReadBatch(scanner.Count() + 1)
+	if err != nil {
+		t.Fatalf("ReadBatch failed: %v", err)
+	}
+	if batch.Len() != scanner.Count() {
+		t.Fatalf("Expected %d batch records, got %d", scanner.Count(), batch.Len())
+	}
+
+	for i := 0; i < batch.Len(); i++ {
+		recNo := batch.RecordNumber(i)
+		rec := scanner.Record(recNo)
+		if rec.RecordNumber() != recNo {
+			t.Errorf("Expected record number %d, got %d", recNo, rec.RecordNumber())
+		}
+		if !bytes.Equal(rec.data, batch.Record(i)) {
+			t.Errorf("Record %d: mapped image differs from CodeBase record buffer", recNo)
+		}
+		if scanner.Deleted(recNo) != batch.Deleted(i) {
+			t.Errorf("Record %d: expected deleted=%v", recNo, batch.Deleted(i))
+		}
+	}
+
+	if _, err := scanner.Record(0).Float(0); err == nil {
+		t.Error("Expected error decoding an out-of-range record")
+	}
+}
+
+func TestVulpo_Scan_OrderAndPosition(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	// Physical order through the mapped scanner
+	var physical []int
+	err := v.Scan(func(rec Record) error {
+		physical = append(physical, rec.RecordNumber())
+		return nil
+	})
+	if err != nil {
+		t.Fatalf("Scan failed: %v", err)
+	}
+	for i, recNo := range physical {
+		if recNo != i+1 {
+			t.Fatalf("Expected physical record %d at position %d, got %d", i+1, i, recNo)
+		}
+	}
+
+	// Tag order through CodeBase navigation
+	tags := v.ListTags()
+	if len(tags) == 0 {
+		t.Skip("Test file has no tags")
+	}
+	_ = v.SelectTag(tags[0])
+	wantRecs, _ := collectCursorOrder(t, v)
+
+	_ = v.Goto(2)
+	var ordered []int
+	err = v.Scan(func(rec Record) error {
+		ordered = append(ordered, rec.RecordNumber())
+		return nil
+	})
+	if err != nil {
+		t.Fatalf("Scan with tag failed: %v", err)
+	}
+	compareOrders(t, wantRecs, ordered, make([]bool, len(wantRecs)), make([]bool, len(ordered)))
+
+	if v.Position() != 2 {
+		t.Errorf("Expected position 2 to be restored, got %d", v.Position())
+	}
+}
+
+func TestVulpo_Scan_CallbackError(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	stop := errors.New("stop")
+	calls := 0
+	err := v.Scan(func(Record) error {
+		calls++
+		return stop
+	})
+	if !errors.Is(err, stop) {
+		t.Errorf("Expected callback error, got %v", err)
+	}
+	if calls != 1 {
+		t.Errorf("Expected scan to stop after 1 call, got %d", calls)
+	}
+}
+
+func TestScanner_EmptyFile(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open("testdata/empty.dbf"); err != nil {
+		t.Skipf("Cannot open empty test file: %v", err)
+	}
+	defer v.Close()
+
+	scanner, err := v.NewScanner()
+	if err != nil {
+		t.Fatalf("NewScanner failed: %v", err)
+	}
+	if scanner.Count() != 0 {
+		t.Errorf("Expected 0 records, got %d", scanner.Count())
+	}
+	if err := scanner.Close(); err != nil {
+		t.Errorf("Close failed: %v", err)
+	}
+}
@@ -0,0 +1,205 @@
+package vulpo
+
+/*
+#include "d4all.h"
+#include <stdlib.h>
+#include <string.h>
+
+int vulpo4tagKey(TAG4 *tag, const char *str, int len, char *key) ;
+
+// VULPO4SEEK_SKIP is the number of entries vulpo4seekMany steps through with
+// tfile4skip before descending from the root with tfile4seek instead.
+#define VULPO4SEEK_SKIP 16
+
+typedef struct
+{
+   const char *key ;
+   int keyLen ;
+   int sigLen ;
+   int index ;
+} VULPO4SEEKKEY ;
+
+// vulpo4seekKeyCmp orders keys bytewise, then by input position.
+static int vulpo4seekKeyCmp(const void *a, const void *b)
+{
+   const VULPO4SEEKKEY *ka = (const VULPO4SEEKKEY *)a ;
+   const VULPO4SEEKKEY *kb = (const VULPO4SEEKKEY *)b ;
+   int rc = memcmp( ka->key, kb->key, ka->keyLen ) ;
+
+   if ( rc != 0 )
+      return rc ;
+   return ka->index - kb->index ;
+}
+
+// vulpo4seekMany resolves n seek values, stored back to back in values with
+// their lengths in lens, to the record number of the first tag entry
+// matching each one (0 when there is none), written to recNos in input
+// order. The values are converted with the tag's seek converter and sorted,
+// then resolved in one ascending pass: the tag moves forward with tfile4skip
+// while the next key is at most VULPO4SEEK_SKIP entries ahead, and with
+// tfile4seek otherwise. Returns 0 or a negative CodeBase error.
+static int vulpo4seekMany(TAG4 *tag, const char *values, const int *lens, int n, long *recNos)
+{
+   TAG4FILE *tagFile = tag->tagFile ;
+   int keyLen = tagFile->header.keyLen ;
+   int descending = tfile4isDescending( tagFile ) ;
+   VULPO4SEEKKEY *order ;
+   char *keys, *current ;
+   int i, skipped, rc = 0, positioned = 0 ;
+
+   if ( n <= 0 )
+      return 0 ;
+
+   keys = (char *)malloc( (size_t)n * keyLen ) ;
+   order = (VULPO4SEEKKEY *)malloc( (size_t)n * sizeof( VULPO4SEEKKEY ) ) ;
+   if ( keys == 0 || order == 0 )
+   {
+      free( keys ) ;
+      free( order ) ;
+      return e4memory ;
+   }
+
+   for ( i = 0 ; i < n ; i++ )
+   {
+      order[i].key = keys + (size_t)i * keyLen ;
+      order[i].keyLen = keyLen ;
+      order[i].sigLen = vulpo4tagKey( tag, values, lens[i], keys + (size_t)i * keyLen ) ;
+      order[i].index = i ;
+      values += lens[i] ;
+      if ( order[i].sigLen < 0 )
+      {
+         rc = -1 ;
+         break ;
+      }
+   }
+
+   if ( rc == 0 )
+      rc = t4versionCheck( tag, 0, 0 ) ;
+
+   if ( rc == 0 )
+   {
+      // A descending tag is walked backwards, so its keys are seeked one by one
+      if ( !descending )
+         qsort( order, (size_t)n, sizeof( VULPO4SEEKKEY ), vulpo4seekKeyCmp ) ;
+
+      for ( i = 0 ; i < n ; i++ )
+      {
+         const VULPO4SEEKKEY *k = &order[i] ;
+
+         // Entries before the current one are below the previous key, and so
+         // below this one: step forward while the current key is smaller
+         if ( positioned && !descending )
+         {
+            for ( skipped = 0 ; skipped < VULPO4SEEK_SKIP && !tfile4eof( tagFile ) ; skipped++ )
+            {
+               if ( memcmp( tfile4key( tagFile ), k->key, k->sigLen ) >= 0 )
+                  break ;
+               if ( tfile4skip( tagFile, 1L ) != 1L )
+                  tfile4goEof( tagFile ) ;
+            }
+            if ( skipped == VULPO4SEEK_SKIP )
+               positioned = 0 ;
+         }
+
+         if ( !positioned || descending )
+         {
+            rc = tfile4seek( tagFile, k->key, k->sigLen ) ;
+            if ( rc < 0 )
+               break ;
+            rc = 0 ;
+            positioned = 1 ;
+         }
+
+         current = tfile4eof( tagFile ) ? 0 : tfile4key( tagFile ) ;
+         if ( current != 0 && memcmp( current, k->key, k->sigLen ) == 0 )
+            recNos[k->index] = tfile4recNo( tagFile ) ;
+         else
+            recNos[k->index] = 0 ;
+      }
+   }
+
+   free( keys ) ;
+   free( order ) ;
+   return rc ;
+}
+*/
+import "C"
+import "unsafe"
+
+// seekManyBatchSize is the number of keys resolved per cgo call by SeekMany.
+const seekManyBatchSize = 1 << 16
+
+// SeekMany looks up many keys in a tag at once and returns, for each key, the
+// record number of its first entry in tag order.
+//
+// Parameters:
+//   - tag: Tag to search; it does not need to be selected
+//   - keys: Seek values, formatted as for Seek
+//
+// Returns:
+//   - []int: Record numbers in the order of keys, 0 where a key is not found
+//   - error: Error if the database is not open, the tag is invalid or cannot
+//     be searched, or reading the index fails
+//
+// A key is found when an entry starts with it, as for Seek, so keys on
+// character tags may be partial. Each batch of keys is converted, sorted and
+// resolved in a single cgo call that walks the tag once in key order: keys
+// close to the previous one are reached by stepping through the leaf
+// entries, and only gaps descend the tree from the root. Neither the table
+// position nor the selected tag is changed.
+//
+// Example:
+//
+//	recNos, err := v.SeekMany(v.TagByName("INVOICE"), invoiceNumbers)
+//	for i, recNo := range recNos {
+//		if recNo == 0 {
+//			fmt.Printf("invoice %s not found\n", invoiceNumbers[i])
+//		}
+//	}
+func (v *Vulpo) SeekMany(tag *Tag, keys []string) ([]int, error) {
+	if !v.Active() {
+		return nil, NewError("database not open")
+	}
+	if tag == nil || !tag.IsValid() {
+		return nil, NewError("invalid tag")
+	}
+
+	// Pending changes to the current record must reach the index first
+	if result := v.keyed(func() C.int { return C.d4updateRecord(v.data, 0) }); result < 0 {
+		C.error4set(v.codeBase, 0)
+		return nil, NewErrorf("failed to update record before seeking: error code %d", int(result))
+	}
+
+	result := make([]int, 0, len(keys))
+	var values []byte
+	var lens []C.int
+	recNos := make([]C.long, min(len(keys), seekManyBatchSize))
+
+	for start := 0; start < len(keys); start += seekManyBatchSize {
+		batch := keys[start:min(start+seekManyBatchSize, len(keys))]
+
+		values, lens = values[:0], lens[:0]
+		for _, key := range batch {
+			values = append(values, key...)
+			lens = append(lens, C.int(len(key)))
+		}
+		var valuesPtr *C.char
+		if len(values) > 0 {
+			valuesPtr = (*C.char)(unsafe.Pointer(&values[0]))
+		}
+
+		rc := C.vulpo4seekMany(tag.tagPtr, valuesPtr, &lens[0], C.int(len(batch)), &recNos[0])
+		if rc == -1 {
+			return nil, NewErrorf("tag '%s' does not support seeking", tag.Name())
+		}
+		if rc < 0 {
+			C.error4set(v.codeBase, 0)
+			return nil, NewErrorf("failed to seek in tag '%s': error code %d", tag.Name(), int(rc))
+		}
+
+		for _, recNo := range recNos[:len(batch)] {
+			result = append(result, int(recNo))
+		}
+	}
+	return result, nil
+}
@@ -0,0 +1,85 @@
+package vulpo
+
+import (
+	"fmt"
+	"testing"
+)
+
+func TestVulpo_SeekMany_NoDatabase(t *testing.T) {
+	v := &Vulpo{}
+
+	if _, err := v.SeekMany(&Tag{}, []string{"1"}); err == nil {
+		t.Error("Expected error for SeekMany with inactive database")
+	}
+}
+
+func TestVulpo_SeekMany_MatchesSeek(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	var ages []string
+	for age := 70; age >= 0; age -= 3 {
+		ages = append(ages, fmt.Sprint(age), fmt.Sprint(age/2))
+	}
+
+	tests := []struct {
+		tag  string
+		keys []string
+	}{
+		{"INF_AGE", ages},
+		{"INF_AGE", []string{"21", "21", "64", "22", "20", "65", "21.0"}},
+		{"INF_NAME", []string{"Fred", "Abbott", "Zed", "B", "Gin", "Borgerson", "Abbotts", "Abbott", ""}},
+		{"INF_BRTH", []string{"19690225", "19690224", "19690226", "19690225"}},
+		{"INF_AGE", nil},
+	}
+
+	for _, tt := range tests {
+		tag := v.TagByName(tt.tag)
+		got, err := v.SeekMany(tag, tt.keys)
+		if err != nil {
+			t.Fatalf("SeekMany(%s) failed: %v", tt.tag, err)
+		}
+		if len(got) != len(tt.keys) {
+			t.Fatalf("SeekMany(%s) returned %d results for %d keys", tt.tag, len(got), len(tt.keys))
+		}
+
+		found := 0
+		for i, key := range tt.keys {
+			want := 0
+			if result, _ := v.SeekWithTag(tag, key); result == SeekSuccess {
+				want = v.Position()
+			}
+			if got[i] != want {
+				t.Errorf("SeekMany(%s) key %q: got record %d, want %d", tt.tag, key, got[i], want)
+			}
+			if want != 0 {
+				found++
+			}
+		}
+		if len(tt.keys) > 0 && (found == 0 || found == len(tt.keys)) {
+			t.Errorf("SeekMany(%s): expected a mix of hits and misses, got %d of %d", tt.tag, found, len(tt.keys))
+		}
+	}
+}
+
+func TestVulpo_SeekMany_PreservesPosition(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	_ = v.Goto(7)
+	if _, err := v.SeekMany(v.TagByName("INF_AGE"), []string{"64", "30"}); err != nil {
+		t.Fatalf("SeekMany failed: %v", err)
+	}
+	if v.Position() != 7 {
+		t.Errorf("Expected position 7, got %d", v.Position())
+	}
+	if v.SelectedTag() != nil {
+		t.Error("Expected no tag to be selected")
+	}
+}
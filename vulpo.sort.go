@@ -0,0 +1,494 @@
+package vulpo
+
+/*
+#include "d4all.h"
+#include <stdlib.h>
+
+// VULPO4SORT is a SORT4 together with the memory pool size it was created
+// with. The sorter reads CODE4.memSizeSortPool again while spooling, merging
+// and freeing, so a non-default pool size must be in effect around every call.
+typedef struct
+{
+   SORT4 sort ;
+   unsigned poolSize ;
+} VULPO4SORT ;
+
+// vulpo4sortEnter installs the sort's pool size and returns the previous one.
+static unsigned vulpo4sortEnter(VULPO4SORT *s)
+{
+   unsigned oldPoolSize = s->sort.codeBase->memSizeSortPool ;
+
+   if ( s->poolSize > 0 )
+      s->sort.codeBase->memSizeSortPool = s->poolSize ;
+   return oldPoolSize ;
+}
+
+// vulpo4sortInit allocates and initializes a sort for entries of sortLen
+// bytes. A non-zero poolSize overrides CODE4.memSizeSortPool for this sort,
+// and a non-zero maxEntries caps the number of entries held in memory before
+// a run is written to the spool file; it cannot exceed poolSize / 8, the
+// size of the entry pointer array. Returns NULL on failure with the
+// CodeBase result in *status.
+static VULPO4SORT *vulpo4sortInit(CODE4 *codeBase, int sortLen, unsigned poolSize, unsigned maxEntries, int *status)
+{
+   VULPO4SORT *s ;
+   unsigned oldPoolSize = codeBase->memSizeSortPool ;
+
+   s = (VULPO4SORT *)malloc( sizeof( VULPO4SORT ) ) ;
+   if ( s == 0 )
+   {
+      *status = e4memory ;
+      return 0 ;
+   }
+   s->poolSize = poolSize ;
+
+   if ( poolSize > 0 )
+      codeBase->memSizeSortPool = poolSize ;
+   *status = sort4init( &s->sort, codeBase, sortLen, 0 ) ;
+   codeBase->memSizeSortPool = oldPoolSize ;
+
+   if ( *status < 0 )
+   {
+      free( s ) ;
+      return 0 ;
+   }
+
+   if ( maxEntries > 0 && maxEntries < s->sort.pointersMax )
+      s->sort.pointersMax = maxEntries < s->sort.pointersInit ? s->sort.pointersInit : maxEntries ;
+
+   return s ;
+}
+
+// vulpo4sortPut adds n entries of sortLen bytes stored back to back in keys.
+// Returns 0 or the first negative sort4put result.
+static int vulpo4sortPut(VULPO4SORT *s, const char *keys, const long *recNos, int n)
+{
+   unsigned oldPoolSize = vulpo4sortEnter( s ) ;
+   int i, rc = 0 ;
+
+   for ( i = 0 ; i < n ; i++ )
+   {
+      rc = sort4put( &s->sort, (S4LONG)recNos[i], keys + (size_t)i * s->sort.sortLen, 0 ) ;
+      if ( rc < 0 )
+         break ;
+   }
+
+   s->sort.codeBase->memSizeSortPool = oldPoolSize ;
+   return rc < 0 ? rc : 0 ;
+}
+
+// vulpo4sortGetInit merges the spooled runs, if any, ready for reading.
+static int vulpo4sortGetInit(VULPO4SORT *s)
+{
+   unsigned oldPoolSize = vulpo4sortEnter( s ) ;
+   int rc = sort4getInit( &s->sort ) ;
+
+   s->sort.codeBase->memSizeSortPool = oldPoolSize ;
+   return rc ;
+}
+
+// vulpo4sortGet copies up to n record numbers, in sorted order, into recNos.
+// Returns the number copied; *status receives the last sort4get result (0
+// while entries remain, positive when the sort is exhausted, negative on
+// error).
+static int vulpo4sortGet(VULPO4SORT *s, long *recNos, int n, int *status)
+{
+   unsigned oldPoolSize = vulpo4sortEnter( s ) ;
+   S4LONG recNo ;
+   void *sortData, *info ;
+   int count = 0 ;
+   int rc = 0 ;
+
+   while ( count < n )
+   {
+      rc = sort4get( &s->sort, &recNo, &sortData, &info ) ;
+      if ( rc != 0 )
+         break ;
+      recNos[count++] = (long)recNo ;
+   }
+
+   s->sort.codeBase->memSizeSortPool = oldPoolSize ;
+   *status = rc ;
+   return count ;
+}
+
+// vulpo4sortFree releases the sort, its memory pools and its spool file.
+static void vulpo4sortFree(VULPO4SORT *s)
+{
+   CODE4 *codeBase = s->sort.codeBase ;
+   unsigned oldPoolSize = vulpo4sortEnter( s ) ;
+
+   sort4free( &s->sort ) ;
+   codeBase->memSizeSortPool = oldPoolSize ;
+   free( s ) ;
+}
+*/
+import "C"
+import (
+	"bytes"
+	"encoding/binary"
+	"math"
+	"sort"
+	"unsafe"
+)
+
+// SortKey names one field of a Sort ordering
+type SortKey struct {
+	Field      string // Field to sort on (case-insensitive)
+	Descending bool   // Sort from highest to lowest
+}
+
+// SortOptions configures Sort
+type SortOptions struct {
+	MemoryBudget int  // Bytes of sort entries held in memory before spilling to disk (0 for the CodeBase default)
+	SkipDeleted  bool // Leave out records marked for deletion
+}
+
+// sortHeapLimit is the largest limit served by the in-memory top-K heap;
+// larger limits, and unlimited sorts, go through the CodeBase sorter.
+const sortHeapLimit = 1 << 16
+
+// sortBatchSize is the number of entries passed to or from the CodeBase
+// sorter per cgo call.
+const sortBatchSize = 1024
+
+// Sort orders the records by the given keys without needing a tag, and
+// returns their record numbers in that order.
+//
+// Parameters:
+//   - keys: Fields to order by, most significant first
+//   - limit: Number of leading records to return (0 for all)
+//   - options: Optional memory budget and deleted-record handling
+//
+// Returns:
+//   - []int: Record numbers in sorted order
+//   - error: Error if the database is not open, a key field is unknown or
+//     cannot be sorted on, or the sort fails
+//
+// Each record's key fields are encoded into one fixed-width byte string that
+// compares like the values (numbers and dates by value, character fields by
+// their stored bytes, logical .F. before .T., nulls first), followed by the
+// record number so equal keys keep their physical order. A small limit is
+// served by a bounded heap in Go memory, so only the limit's worth of keys is
+// ever held. Otherwise the keys go to the CodeBase sorter (SORT4), which
+// sorts runs in memory pools and merges them through a temporary spool file
+// once options.MemoryBudget bytes of entries are held. CodeBase merges the
+// runs in one pass, so the budget is raised to at least √records entries.
+//
+// Example:
+//
+//	// The ten largest orders
+//	recNos, err := v.Sort([]SortKey{{Field: "AMOUNT", Descending: true}}, 10)
+//	for _, recNo := range recNos {
+//		_ = v.Goto(recNo)
+//		// ...
+//	}
+func (v *Vulpo) Sort(keys []SortKey, limit int, options ...*SortOptions) ([]int, error) {
+	if !v.Active() {
+		return nil, NewError("database not open")
+	}
+
+	opts := &SortOptions{}
+	if len(options) > 0 && options[0] != nil {
+		opts = options[0]
+	}
+
+	encoder, err := v.newSortEncoder(keys)
+	if err != nil {
+		return nil, err
+	}
+
+	if limit < 0 {
+		limit = 0
+	}
+	if limit > 0 && limit <= sortHeapLimit {
+		return v.sortTopK(encoder, limit, opts)
+	}
+	return v.sortExternal(encoder, limit, opts)
+}
+
+// sortEncoder turns the key fields of a record into an order-preserving
+// byte string followed by the big-endian record number.
+type sortEncoder struct {
+	defs  []*FieldDef
+	desc  []bool
+	width int // total entry width, record number included
+}
+
+// newSortEncoder resolves the key fields.
+func (v *Vulpo) newSortEncoder(keys []SortKey) (*sortEncoder, error) {
+	if len(keys) == 0 {
+		return nil, NewError("no sort keys")
+	}
+
+	encoder := &sortEncoder{}
+	for _, key := range keys {
+		idx := v.fieldDefs.Index(key.Field)
+		if idx < 0 {
+			return nil, NewErrorf("field '%s' not found", key.Field)
+		}
+		def := v.fieldDefs.ByIndex(idx)
+		size := sortKeySize(def)
+		if size == 0 {
+			return nil, NewErrorf("field '%s' of type %s cannot be sorted on", def.Name(), def.Type().Name())
+		}
+
+		encoder.defs = append(encoder.defs, def)
+		encoder.desc = append(encoder.desc, key.Descending)
+		encoder.width += size
+	}
+	encoder.width += 4
+	return encoder, nil
+}
+
+// sortKeySize returns the encoded size of a key field, or 0 if the field
+// cannot be sorted on. Nullable fields carry a leading null marker byte.
+func sortKeySize(def *FieldDef) int {
+	size := 0
+	switch def.Type() {
+	case FTCharacter:
+		size = def.length
+	case FTLogical:
+		size = 1
+	case FTNumeric, FTFloat, FTInteger, FTDate:
+		size = 8
+	case FTCurrency, FTBlob, FTDouble, FTDateTime:
+		if def.length == 8 {
+			size = 8
+		}
+	}
+	if size > 0 && def.nullable {
+		size++
+	}
+	return size
+}
+
+// encode appends the entry for rec to dst.
+func (e *sortEncoder) encode(dst []byte, rec Record) []byte {
+	for i, def := range e.defs {
+		start := len(dst)
+		raw := def.bytes(rec.data)
+		null := def.isNullIn(rec.data)
+		if def.nullable {
+			if null {
+				dst = append(dst, 0)
+			} else {
+				dst = append(dst, 1)
+			}
+		}
+
+		switch def.Type() {
+		case FTCharacter:
+			if null || len(raw) != def.length {
+				dst = appendZeros(dst, def.length)
+			} else {
+				dst = append(dst, raw...)
+			}
+		case FTLogical:
+			if !null && decodeLogical(raw) {
+				dst = append(dst, 1)
+			} else {
+				dst = append(dst, 0)
+			}
+		default:
+			dst = binary.BigEndian.AppendUint64(dst, sortKeyBits(def, raw, null))
+		}
+
+		if e.desc[i] {
+			for j := start; j < len(dst); j++ {
+				dst[j] = ^dst[j]
+			}
+		}
+	}
+	return binary.BigEndian.AppendUint32(dst, uint32(rec.RecordNumber()))
+}
+
+// sortKeyBits maps a numeric, date or datetime value to a uint64 that orders
+// like the value.
+func sortKeyBits(def *FieldDef, raw []byte, null bool) uint64 {
+	if null {
+		return 0
+	}
+
+	var n int64
+	switch def.Type() {
+	case FTNumeric, FTFloat, FTBlob, FTDouble:
+		var f float64
+		if def.Type() == FTNumeric || def.Type() == FTFloat {
+			f = decodeNumeric(raw)
+		} else {
+			f = decodeDouble(raw)
+		}
+		bits := math.Float64bits(f)
+		if bits&(1<<63) != 0 {
+			return ^bits
+		}
+		return bits | 1<<63
+	case FTInteger:
+		n = int64(decodeInteger(raw))
+	case FTCurrency:
+		n = decodeCurrencyUnits(raw)
+	case FTDate:
+		n = int64(decodeDateJulian(raw))
+	case FTDateTime:
+		if len(raw) == 8 {
+			n = int64(binary.LittleEndian.Uint32(raw[:4]))<<32 | int64(binary.LittleEndian.Uint32(raw[4:8]))
+		}
+	}
+	return uint64(n) ^ 1<<63
+}
+
+// entryRecNo extracts the record number from the end of an encoded entry.
+func entryRecNo(entry []byte) int {
+	return int(binary.BigEndian.Uint32(entry[len(entry)-4:]))
+}
+
+// sortTopK keeps the limit smallest entries in a max-heap.
+func (v *Vulpo) sortTopK(e *sortEncoder, limit int, opts *SortOptions) ([]int, error) {
+	w := e.width
+	arena := make([]byte, 0, limit*w)
+	heap := make([]int, 0, limit) // entry offsets into arena, largest at the root
+	scratch := make([]byte, 0, w)
+
+	entry := func(i int) []byte {
+		return arena[heap[i] : heap[i]+w]
+	}
+	siftDown := func(i int) {
+		for {
+			largest := i
+			for _, child := range [2]int{2*i + 1, 2*i + 2} {
+				if child < len(heap) && bytes.Compare(entry(child), entry(largest)) > 0 {
+					largest = child
+				}
+			}
+			if largest == i {
+				return
+			}
+			heap[i], heap[largest] = heap[largest], heap[i]
+			i = largest
+		}
+	}
+
+	err := v.Scan(func(rec Record) error {
+		if opts.SkipDeleted && rec.Deleted() {
+			return nil
+		}
+
+		if len(heap) < limit {
+			arena = e.encode(arena, rec)
+			heap = append(heap, len(arena)-w)
+			for i := len(heap) - 1; i > 0; {
+				parent := (i - 1) / 2
+				if bytes.Compare(entry(i), entry(parent)) <= 0 {
+					break
+				}
+				heap[i], heap[parent] = heap[parent], heap[i]
+				i = parent
+			}
+			return nil
+		}
+
+		scratch = e.encode(scratch[:0], rec)
+		if bytes.Compare(scratch, entry(0)) < 0 {
+			copy(entry(0), scratch)
+			siftDown(0)
+		}
+		return nil
+	})
+	if err != nil {
+		return nil, err
+	}
+
+	sort.Slice(heap, func(i, j int) bool {
+		return bytes.Compare(entry(i), entry(j)) < 0
+	})
+
+	recNos := make([]int, len(heap))
+	for i := range heap {
+		recNos[i] = entryRecNo(entry(i))
+	}
+	return recNos, nil
+}
+
+// sortExternal runs the entries through the CodeBase sorter.
+func (v *Vulpo) sortExternal(e *sortEncoder, limit int, opts *SortOptions) ([]int, error) {
+	var poolSize, maxEntries C.uint
+	if opts.MemoryBudget > 0 {
+		// The runs are merged in a single pass that holds one entry of every
+		// run, so at least √records entries must fit in memory
+		header := v.Header()
+		minEntries := int(math.Sqrt(float64(header.RecordCount()))) + 1
+		maxEntries = C.uint(max(minEntries, opts.MemoryBudget/e.width))
+		// The pool size also sizes the entry pointer array (8 bytes per
+		// entry), and each pool holds a 16-byte header and at least one entry
+		poolSize = C.uint(max(min(opts.MemoryBudget, int(v.codeBase.memSizeSortPool)), 8*int(maxEntries), 16+e.width+4))
+	}
+
+	var status C.int
+	sorter := C.vulpo4sortInit(v.codeBase, C.int(e.width), poolSize, maxEntries, &status)
+	if sorter == nil {
+		C.error4set(v.codeBase, 0)
+		return nil, NewErrorf("failed to initialize sort: error code %d", int(status))
+	}
+	defer C.vulpo4sortFree(sorter)
+
+	keys := make([]byte, 0, sortBatchSize*e.width)
+	recNos := make([]C.long, 0, sortBatchSize)
+	flush := func() error {
+		if len(recNos) == 0 {
+			return nil
+		}
+		rc := C.vulpo4sortPut(sorter, (*C.char)(unsafe.Pointer(&keys[0])), &recNos[0], C.int(len(recNos)))
+		keys, recNos = keys[:0], recNos[:0]
+		if rc < 0 {
+			C.error4set(v.codeBase, 0)
+			return NewErrorf("failed to add sort entries: error code %d", int(rc))
+		}
+		return nil
+	}
+
+	count := 0
+	err := v.Scan(func(rec Record) error {
+		if opts.SkipDeleted && rec.Deleted() {
+			return nil
+		}
+		keys = e.encode(keys, rec)
+		recNos = append(recNos, C.long(rec.RecordNumber()))
+		count++
+		if len(recNos) == sortBatchSize {
+			return flush()
+		}
+		return nil
+	})
+	if err == nil {
+		err = flush()
+	}
+	if err != nil {
+		return nil, err
+	}
+
+	if rc := C.vulpo4sortGetInit(sorter); rc < 0 {
+		C.error4set(v.codeBase, 0)
+		return nil, NewErrorf("failed to merge sort runs: error code %d", int(rc))
+	}
+
+	if limit == 0 || limit > count {
+		limit = count
+	}
+	result := make([]int, 0, limit)
+	batch := make([]C.long, sortBatchSize)
+	for len(result) < limit {
+		n := C.vulpo4sortGet(sorter, &batch[0], C.int(min(sortBatchSize, limit-len(result))), &status)
+		for _, recNo := range batch[:n] {
+			result = append(result, int(recNo))
+		}
+		if status < 0 {
+			C.error4set(v.codeBase, 0)
+			return nil, NewErrorf("failed to read sorted entries: error code %d", int(status))
+		}
+		if status != 0 {
+			break
+		}
+	}
+	return result, nil
+}
@@ -0,0 +1,191 @@
+package vulpo
+
+import (
+	"path/filepath"
+	"sort"
+	"testing"
+	"time"
+)
+
+func TestVulpo_Sort_NoDatabase(t *testing.T) {
+	v := &Vulpo{}
+
+	if _, err := v.Sort([]SortKey{{Field: "AGE"}}, 0); err == nil {
+		t.Error("Expected error for Sort with inactive database")
+	}
+}
+
+func TestVulpo_Sort_InvalidKeys(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	if _, err := v.Sort(nil, 0); err == nil {
+		t.Error("Expected error without sort keys")
+	}
+	if _, err := v.Sort([]SortKey{{Field: "NOPE"}}, 0); err == nil {
+		t.Error("Expected error for an unknown field")
+	}
+}
+
+// sortReference orders the records with sort.SliceStable on decoded values.
+func sortReference(t *testing.T, v *Vulpo, keys []SortKey, skipDeleted bool) []int {
+	t.Helper()
+
+	type row struct {
+		recNo  int
+		values []interface{}
+	}
+	var rows []row
+	err := v.Scan(func(rec Record) error {
+		if skipDeleted && rec.Deleted() {
+			return nil
+		}
+		r := row{recNo: rec.RecordNumber()}
+		for _, key := range keys {
+			field := v.FieldDefs().Index(key.Field)
+			var value interface{}
+			switch def := v.FieldDefs().ByIndex(field); def.Type() {
+			case FTCharacter:
+				value = string(rec.Bytes(field))
+			case FTDate:
+				value = float64(decodeDateJulian(rec.Bytes(field)))
+			case FTLogical:
+				value, _ = rec.Bool(field)
+			case FTDateTime:
+				tm, _ := rec.Time(field)
+				value = tm
+			default:
+				value, _ = rec.Float(field)
+			}
+			r.values = append(r.values, value)
+		}
+		rows = append(rows, r)
+		return nil
+	})
+	if err != nil {
+		t.Fatalf("Reference scan failed: %v", err)
+	}
+
+	sort.SliceStable(rows, func(i, j int) bool {
+		for k, key := range keys {
+			cmp := 0
+			switch a := rows[i].values[k].(type) {
+			case string:
+				b := rows[j].values[k].(string)
+				cmp = map[bool]int{true: -1, false: 0}[a < b] + map[bool]int{true: 1, false: 0}[a > b]
+			case float64:
+				b := rows[j].values[k].(float64)
+				cmp = map[bool]int{true: -1, false: 0}[a < b] + map[bool]int{true: 1, false: 0}[a > b]
+			case bool:
+				b := rows[j].values[k].(bool)
+				cmp = map[bool]int{true: -1, false: 0}[!a && b] + map[bool]int{true: 1, false: 0}[a && !b]
+			case time.Time:
+				cmp = a.Compare(rows[j].values[k].(time.Time))
+			}
+			if key.Descending {
+				cmp = -cmp
+			}
+			if cmp != 0 {
+				return cmp < 0
+			}
+		}
+		return false
+	})
+
+	recNos := make([]int, len(rows))
+	for i, r := range rows {
+		recNos[i] = r.recNo
+	}
+	return recNos
+}
+
+func TestVulpo_Sort_MatchesReference(t *testing.T) {
+	files, _ := filepath.Glob("mkfdbflib/data/*.dbf")
+
+	for _, file := range files {
+		t.Run(file, func(t *testing.T) {
+			v := &Vulpo{}
+			if err := v.Open(file); err != nil {
+				t.Skipf("Cannot open %s: %v", file, err)
+			}
+			defer v.Close()
+
+			// Every sortable field descending, then the first one ascending
+			var keys []SortKey
+			for i := 0; i < v.FieldCount(); i++ {
+				def := v.FieldDefs().ByIndex(i)
+				if !def.IsNullable() && sortKeySize(def) > 0 {
+					keys = append(keys, SortKey{Field: def.Name(), Descending: true})
+				}
+			}
+			if len(keys) == 0 {
+				t.Skip("No sortable fields")
+			}
+			keys = append([]SortKey{{Field: keys[0].Field}}, keys...)
+
+			for k := 1; k <= len(keys); k++ {
+				want := sortReference(t, v, keys[:k], false)
+
+				for _, tt := range []struct {
+					name    string
+					limit   int
+					options *SortOptions
+				}{
+					{"heap", 5, nil},
+					{"external", 0, nil},
+					{"spilled", 0, &SortOptions{MemoryBudget: 256}},
+					{"spilled limit", sortHeapLimit + 1, &SortOptions{MemoryBudget: 64}},
+				} {
+					got, err := v.Sort(keys[:k], tt.limit, tt.options)
+					if err != nil {
+						t.Fatalf("%s sort on %v failed: %v", tt.name, keys[:k], err)
+					}
+					expected := want
+					if tt.limit > 0 && tt.limit < len(want) {
+						expected = want[:tt.limit]
+					}
+					if len(got) != len(expected) {
+						t.Fatalf("%s sort on %v returned %d records, want %d", tt.name, keys[:k], len(got), len(expected))
+					}
+					for i := range expected {
+						if got[i] != expected[i] {
+							t.Errorf("%s sort on %v: position %d is record %d, want %d", tt.name, keys[:k], i, got[i], expected[i])
+							break
+						}
+					}
+				}
+			}
+		})
+	}
+}
+
+func TestVulpo_Sort_SkipDeleted(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	keys := []SortKey{{Field: "AGE", Descending: true}, {Field: "NAME"}}
+	want := sortReference(t, v, keys, true)
+	for _, limit := range []int{0, 3} {
+		got, err := v.Sort(keys, limit, &SortOptions{SkipDeleted: true})
+		if err != nil {
+			t.Fatalf("Sort failed: %v", err)
+		}
+		if limit > 0 {
+			want = want[:limit]
+		}
+		if len(got) != len(want) {
+			t.Fatalf("Expected %d records, got %d", len(want), len(got))
+		}
+		for i := range want {
+			if got[i] != want[i] {
+				t.Errorf("Position %d is record %d, want %d", i, got[i], want[i])
+			}
+		}
+	}
+}
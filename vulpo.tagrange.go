@@ -0,0 +1,351 @@
+package vulpo
+
+/*
+#include "d4all.h"
+#include <string.h>
+
+// vulpo4tagKey converts str to the binary key format of the tag with the
+// tag's own seek converter, as d4seek does. Character keys may be partial:
+// only the first len bytes take part in comparisons. Returns the number of
+// significant key bytes, or -1 if the tag has no seek conversion. Also used
+// by SeekMany.
+int vulpo4tagKey(TAG4 *tag, const char *str, int len, char *key)
+{
+   TAG4FILE *tagFile = tag->tagFile ;
+   int keyLen = tagFile->header.keyLen ;
+   int type ;
+
+   if ( tagFile->stok == 0 )
+      return -1 ;
+
+   memset( key, 0, keyLen ) ;
+   type = tfile4type( tagFile ) ;
+   if ( type == 'C' || type == 'W' )
+   {
+      if ( len > keyLen )
+         len = keyLen ;
+      tagFile->stok( key, str, len ) ;
+      return len ;
+   }
+
+   tagFile->stok( key, str, len ) ;
+   return keyLen ;
+}
+
+// vulpo4tagPosition positions the tag on the first entry of a range walk:
+// just after the entry (from, fromRecNo) when fromRecNo > 0, on the first key
+// not below from when fromLen > 0, and on the first key otherwise. Returns 0
+// when positioned on an entry, r4eof when no entry remains, or a negative
+// CodeBase error.
+static int vulpo4tagPosition(TAG4 *tag, const char *from, int fromLen, long fromRecNo)
+{
+   TAG4FILE *tagFile = tag->tagFile ;
+   int rc ;
+
+   rc = t4versionCheck( tag, 0, 0 ) ;
+   if ( rc < 0 )
+      return rc ;
+
+   if ( fromRecNo > 0 )
+   {
+      rc = tfile4go( tagFile, (const unsigned char *)from, fromRecNo, 0 ) ;
+      if ( rc == r4success && tfile4skip( tagFile, 1L ) != 1L )
+         return r4eof ;
+   }
+   else if ( fromLen > 0 )
+      rc = tfile4seek( tagFile, from, fromLen ) ;
+   else
+      rc = tfile4top( tagFile ) ;
+
+   if ( rc < 0 )
+      return rc ;
+   return tfile4eof( tagFile ) ? r4eof : 0 ;
+}
+
+// vulpo4tagRead copies up to n entries with keys up to hi (compared on the
+// first hiLen bytes; no bound when hiLen is 0) into keys and recNos, starting
+// as described for vulpo4tagPosition. When keys is NULL the entries are only
+// counted. FoxPro keys, collated character keys included, are stored so that
+// they order bytewise, so the bound is checked with memcmp. Returns the
+// number of entries read; *status receives 0 while the
+// range may continue, r4eof once it is exhausted, or a negative error.
+static int vulpo4tagRead(TAG4 *tag, const char *from, int fromLen, long fromRecNo, const char *hi, int hiLen, char *keys, long *recNos, int n, int *status)
+{
+   TAG4FILE *tagFile = tag->tagFile ;
+   int keyLen = tagFile->header.keyLen ;
+   int count = 0 ;
+   char *key ;
+
+   *status = vulpo4tagPosition( tag, from, fromLen, fromRecNo ) ;
+
+   while ( *status == 0 && count < n )
+   {
+      key = tfile4key( tagFile ) ;
+      if ( hiLen > 0 && memcmp( key, hi, (size_t)hiLen ) > 0 )
+      {
+         *status = r4eof ;
+         break ;
+      }
+
+      if ( keys != 0 )
+      {
+         memcpy( keys + (size_t)count * keyLen, key, keyLen ) ;
+         recNos[count] = tfile4recNo( tagFile ) ;
+      }
+      count++ ;
+
+      if ( tfile4skip( tagFile, 1L ) != 1L )
+         *status = r4eof ;
+   }
+
+   return count ;
+}
+*/
+import "C"
+import (
+	"math"
+	"unsafe"
+)
+
+// tagRangeBatchSize is the number of entries copied from the tag per cgo call.
+const tagRangeBatchSize = 256
+
+// TagRange is a cursor over the entries of a tag whose keys fall within a
+// range. Entries are read straight from the index blocks in key order, as
+// (key, record number) pairs, without reading any data record; call Goto
+// to load the record of the current entry when non-key fields are needed.
+//
+// Keys are in the tag's binary format: character keys hold the padded
+// expression text, while numeric and date keys use the index's sortable
+// encoding. The cursor reads ahead in batches, so entries added to the tag
+// after a batch was read may not be seen.
+type TagRange struct {
+	vulpo  *Vulpo
+	tag    *Tag
+	keyLen int
+	lo     []byte // nil for no lower bound
+	hi     []byte // nil for no upper bound
+
+	batch   int // entries copied per cgo call
+	keys    []byte
+	recNos  []C.long
+	n, i    int
+	started bool
+	done    bool
+	err     error
+}
+
+// TagRange returns a cursor over the entries of tag with keys between lo and
+// hi inclusive.
+//
+// Parameters:
+//   - tag: Tag to read; it does not need to be selected
+//   - lo: Smallest key, formatted as for Seek (empty for the first key)
+//   - hi: Largest key, formatted as for Seek (empty for the last key)
+//
+// Returns:
+//   - *TagRange: Cursor positioned before the first entry
+//   - error: Error if the database is not open, the tag is invalid or
+//     descending, or a bound cannot be converted to a key
+//
+// Bounds on character tags may be partial: hi "M" includes every key that
+// starts with "M". Neither the table position nor the selected tag is
+// changed, unless Goto is called.
+//
+// Example:
+//
+//	r, err := v.TagRange(v.TagByName("INF_AGE"), "30", "39")
+//	for r.Next() {
+//		fmt.Println(r.RecordNumber())
+//	}
+//	if err := r.Err(); err != nil {
+//		log.Fatal(err)
+//	}
+func (v *Vulpo) TagRange(tag *Tag, lo, hi string) (*TagRange, error) {
+	if !v.Active() {
+		return nil, NewError("database not open")
+	}
+	if tag == nil || !tag.IsValid() {
+		return nil, NewError("invalid tag")
+	}
+	if C.tfile4isDescending(tag.tagPtr.tagFile) != 0 {
+		return nil, NewErrorf("tag '%s' is descending; ranges need an ascending tag", tag.Name())
+	}
+
+	// Pending changes to the current record must reach the index first
+	if result := v.keyed(func() C.int { return C.d4updateRecord(v.data, 0) }); result < 0 {
+		C.error4set(v.codeBase, 0)
+		return nil, NewErrorf("failed to update record before reading tag: error code %d", int(result))
+	}
+
+	r := &TagRange{
+		vulpo:  v,
+		tag:    tag,
+		keyLen: int(tag.tagPtr.tagFile.header.keyLen),
+		batch:  tagRangeBatchSize,
+	}
+
+	var err error
+	if r.lo, err = r.convertKey(lo); err != nil {
+		return nil, err
+	}
+	if r.hi, err = r.convertKey(hi); err != nil {
+		return nil, err
+	}
+	return r, nil
+}
+
+// convertKey converts a bound to its significant key bytes.
+func (r *TagRange) convertKey(value string) ([]byte, error) {
+	if value == "" {
+		return nil, nil
+	}
+
+	key := make([]byte, r.keyLen)
+	cValue := C.CString(value)
+	defer C.free(unsafe.Pointer(cValue))
+
+	n := C.vulpo4tagKey(r.tag.tagPtr, cValue, C.int(len(value)), (*C.char)(unsafe.Pointer(&key[0])))
+	if n < 0 {
+		return nil, NewErrorf("tag '%s' does not support seeking", r.tag.Name())
+	}
+	return key[:n], nil
+}
+
+// Next advances to the next entry of the range, reporting whether there is
+// one. It returns false at the end of the range or on error; check Err.
+func (r *TagRange) Next() bool {
+	if r.i+1 < r.n {
+		r.i++
+		return true
+	}
+	if r.done || r.err != nil {
+		r.i = r.n
+		return false
+	}
+
+	if r.keys == nil {
+		r.keys = make([]byte, r.batch*r.keyLen)
+		r.recNos = make([]C.long, r.batch)
+	}
+
+	// The first batch seeks the lower bound; later ones resume after the last
+	// entry returned, so other tag navigation in between does no harm
+	from, fromRecNo := r.resumePoint()
+	r.started = true
+
+	n, err := r.read(from, fromRecNo, (*C.char)(unsafe.Pointer(&r.keys[0])), &r.recNos[0], r.batch)
+	r.n, r.i = n, 0
+	if err != nil {
+		r.err = err
+	}
+	return n > 0
+}
+
+// resumePoint returns where the next read starts: the lower bound before the
+// first read, and just after the last entry read afterwards.
+func (r *TagRange) resumePoint() ([]byte, C.long) {
+	if !r.started || r.n == 0 {
+		return r.lo, 0
+	}
+	return r.keys[(r.n-1)*r.keyLen : r.n*r.keyLen], r.recNos[r.n-1]
+}
+
+// read runs one vulpo4tagRead call and records the end of the range.
+func (r *TagRange) read(from []byte, fromRecNo C.long, keys *C.char, recNos *C.long, n int) (int, error) {
+	var fromPtr, hiPtr *C.char
+	if len(from) > 0 {
+		fromPtr = (*C.char)(unsafe.Pointer(&from[0]))
+	}
+	if len(r.hi) > 0 {
+		hiPtr = (*C.char)(unsafe.Pointer(&r.hi[0]))
+	}
+
+	var status C.int
+	count := C.vulpo4tagRead(r.tag.tagPtr, fromPtr, C.int(len(from)), fromRecNo, hiPtr, C.int(len(r.hi)), keys, recNos, C.int(n), &status)
+	if status < 0 {
+		C.error4set(r.vulpo.codeBase, 0)
+		r.done = true
+		return 0, NewErrorf("failed to read tag '%s': error code %d", r.tag.Name(), int(status))
+	}
+	if status != 0 {
+		r.done = true
+	}
+	return int(count), nil
+}
+
+// Key returns the key of the current entry. The slice is only valid until the
+// next call to Next.
+func (r *TagRange) Key() []byte {
+	if r.i >= r.n {
+		return nil
+	}
+	return r.keys[r.i*r.keyLen : (r.i+1)*r.keyLen]
+}
+
+// RecordNumber returns the record number of the current entry, or 0 if there
+// is none.
+func (r *TagRange) RecordNumber() int {
+	if r.i >= r.n {
+		return 0
+	}
+	return int(r.recNos[r.i])
+}
+
+// Goto positions the table on the record of the current entry, reading it
+// from the data file.
+func (r *TagRange) Goto() error {
+	recNo := r.RecordNumber()
+	if recNo == 0 {
+		return NewError("no current tag entry")
+	}
+	return r.vulpo.Goto(recNo)
+}
+
+// Err returns the error that ended the iteration, if any.
+func (r *TagRange) Err() error {
+	return r.err
+}
+
+// Count returns the number of entries left in the range, the current entry
+// excluded, and ends the iteration. The entries are counted in one pass over
+// the index blocks without copying them.
+func (r *TagRange) Count() (int, error) {
+	total := max(r.n-r.i-1, 0)
+
+	if !r.done && r.err == nil {
+		from, fromRecNo := r.resumePoint()
+		r.started = true
+
+		n, err := r.read(from, fromRecNo, nil, nil, math.MaxInt32)
+		total += n
+		if err != nil {
+			r.err = err
+		}
+	}
+
+	r.i, r.n, r.done = 0, 0, true
+	return total, r.err
+}
+
+// CountTagRange returns the number of entries of tag with keys between lo
+// and hi inclusive, reading only the index. See TagRange for the bounds.
+func (v *Vulpo) CountTagRange(tag *Tag, lo, hi string) (int, error) {
+	r, err := v.TagRange(tag, lo, hi)
+	if err != nil {
+		return 0, err
+	}
+	return r.Count()
+}
+
+// TagRangeExists reports whether tag has any key between lo and hi
+// inclusive, reading only the index. See TagRange for the bounds.
+func (v *Vulpo) TagRangeExists(tag *Tag, lo, hi string) (bool, error) {
+	r, err := v.TagRange(tag, lo, hi)
+	if err != nil {
+		return false, err
+	}
+
+	n, err := r.read(r.lo, 0, nil, nil, 1)
+	return n > 0, err
+}
@@ -0,0 +1,200 @@
+package vulpo
+
+import (
+	"fmt"
+	"sort"
+	"strings"
+	"testing"
+)
+
+func TestVulpo_TagRange_NoDatabase(t *testing.T) {
+	v := &Vulpo{}
+
+	if _, err := v.TagRange(&Tag{}, "", ""); err == nil {
+		t.Error("Expected error for TagRange with inactive database")
+	}
+	if _, err := v.CountTagRange(&Tag{}, "", ""); err == nil {
+		t.Error("Expected error for CountTagRange with inactive database")
+	}
+}
+
+// tagRangeReference returns the record numbers whose value of field, as
+// mapped by key, lies within [lo, hi], in tag order (key, then record number).
+// A unique tag only holds the first record of each key.
+func tagRangeReference(t *testing.T, v *Vulpo, field string, key func(rec Record, field int) string, lo, hi string, unique bool) []int {
+	t.Helper()
+
+	idx := v.FieldDefs().Index(field)
+	type entry struct {
+		key   string
+		recNo int
+	}
+	var entries []entry
+	err := v.Scan(func(rec Record) error {
+		k := key(rec, idx)
+		if (lo == "" || k >= lo) && (hi == "" || k <= hi || strings.HasPrefix(k, hi)) {
+			entries = append(entries, entry{k, rec.RecordNumber()})
+		}
+		return nil
+	})
+	if err != nil {
+		t.Fatalf("Reference scan failed: %v", err)
+	}
+
+	sort.SliceStable(entries, func(i, j int) bool { return entries[i].key < entries[j].key })
+	var recNos []int
+	for i, e := range entries {
+		if unique && i > 0 && e.key == entries[i-1].key {
+			continue
+		}
+		recNos = append(recNos, e.recNo)
+	}
+	return recNos
+}
+
+func TestVulpo_TagRange_MatchesScan(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	age := func(rec Record, field int) string {
+		value, _ := rec.Float(field)
+		return fmt.Sprintf("%03.0f", value)
+	}
+	name := func(rec Record, field int) string { return string(rec.Bytes(field)) }
+	birth := func(rec Record, field int) string { return string(rec.Bytes(field)) }
+
+	tests := []struct {
+		tag, field     string
+		lo, hi         string
+		refLo, refHi   string
+		key            func(rec Record, field int) string
+		unique         bool
+		expectNonEmpty bool
+	}{
+		{"INF_AGE", "AGE", "30", "39", "030", "039", age, false, true},
+		{"INF_AGE", "AGE", "", "25", "", "025", age, false, true},
+		{"INF_AGE", "AGE", "60", "", "060", "", age, false, true},
+		{"INF_AGE", "AGE", "", "", "", "", age, false, true},
+		{"INF_AGE", "AGE", "90", "99", "090", "099", age, false, false},
+		{"INF_NAME", "NAME", "B", "C", "B", "C", name, true, true},
+		{"INF_NAME", "NAME", "Mc", "Mc", "Mc", "Mc", name, true, false},
+		{"INF_NAME", "NAME", "Fred", "Ginger", "Fred", "Ginger", name, true, true},
+		{"INF_BRTH", "BIRTH_DATE", "19690101", "19691231", "19690101", "19691231", birth, false, true},
+		{"INF_BRTH", "BIRTH_DATE", "19500101", "19591231", "19500101", "19591231", birth, false, false},
+	}
+
+	for _, tt := range tests {
+		want := tagRangeReference(t, v, tt.field, tt.key, tt.refLo, tt.refHi, tt.unique)
+		if tt.expectNonEmpty && len(want) == 0 {
+			t.Fatalf("%s [%q, %q]: reference is empty", tt.tag, tt.lo, tt.hi)
+		}
+		tag := v.TagByName(tt.tag)
+
+		// A small batch exercises resuming between batches
+		for _, batch := range []int{tagRangeBatchSize, 7} {
+			r, err := v.TagRange(tag, tt.lo, tt.hi)
+			if err != nil {
+				t.Fatalf("TagRange failed: %v", err)
+			}
+			r.batch = batch
+
+			var got []int
+			for r.Next() {
+				if len(r.Key()) != r.keyLen {
+					t.Fatalf("Expected %d key bytes, got %d", r.keyLen, len(r.Key()))
+				}
+				got = append(got, r.RecordNumber())
+			}
+			if err := r.Err(); err != nil {
+				t.Fatalf("Iteration failed: %v", err)
+			}
+
+			if len(got) != len(want) {
+				t.Fatalf("%s [%q, %q] batch %d: got %d entries, want %d", tt.tag, tt.lo, tt.hi, batch, len(got), len(want))
+			}
+			for i := range want {
+				if got[i] != want[i] {
+					t.Errorf("%s [%q, %q] batch %d: entry %d is record %d, want %d", tt.tag, tt.lo, tt.hi, batch, i, got[i], want[i])
+					break
+				}
+			}
+		}
+
+		count, err := v.CountTagRange(tag, tt.lo, tt.hi)
+		if err != nil || count != len(want) {
+			t.Errorf("CountTagRange(%s, %q, %q) = %d, %v; want %d", tt.tag, tt.lo, tt.hi, count, err, len(want))
+		}
+		exists, err := v.TagRangeExists(tag, tt.lo, tt.hi)
+		if err != nil || exists != (len(want) > 0) {
+			t.Errorf("TagRangeExists(%s, %q, %q) = %v, %v", tt.tag, tt.lo, tt.hi, exists, err)
+		}
+	}
+}
+
+func TestVulpo_TagRange_CountAfterNext(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	tag := v.TagByName("INF_AGE")
+	total, err := v.CountTagRange(tag, "", "")
+	if err != nil {
+		t.Fatalf("CountTagRange failed: %v", err)
+	}
+	header := v.Header()
+	if total != int(header.RecordCount()) {
+		t.Errorf("Expected %d entries, got %d", header.RecordCount(), total)
+	}
+
+	r, _ := v.TagRange(tag, "", "")
+	r.batch = 10
+	for i := 0; i < 15; i++ {
+		if !r.Next() {
+			t.Fatal("Expected more entries")
+		}
+	}
+	rest, err := r.Count()
+	if err != nil || rest != total-15 {
+		t.Errorf("Count after 15 entries = %d, %v; want %d", rest, err, total-15)
+	}
+	if r.Next() {
+		t.Error("Expected the range to be exhausted after Count")
+	}
+}
+
+func TestVulpo_TagRange_PreservesPosition(t *testing.T) {
+	v := &Vulpo{}
+	if err := v.Open(testDBFWithIndexPath); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	_ = v.Goto(42)
+	r, err := v.TagRange(v.TagByName("INF_NAME"), "A", "B")
+	if err != nil {
+		t.Fatalf("TagRange failed: %v", err)
+	}
+	if !r.Next() {
+		t.Fatal("Expected an entry")
+	}
+	first := r.RecordNumber()
+	for r.Next() {
+	}
+	if v.Position() != 42 {
+		t.Errorf("Expected position 42, got %d", v.Position())
+	}
+	if v.SelectedTag() != nil {
+		t.Error("Expected no tag to be selected")
+	}
+
+	r, _ = v.TagRange(v.TagByName("INF_NAME"), "A", "B")
+	r.Next()
+	if err := r.Goto(); err != nil || v.Position() != first {
+		t.Errorf("Goto moved to %d (%v), want %d", v.Position(), err, first)
+	}
+}
@@ -1,7 +1,12 @@
 package vulpo
 
 import (
+	"fmt"
+	"os"
+	"strconv"
+	"syscall"
 	"testing"
+	"time"
 )
 
 const benchDBFPath = "mkfdbflib/data/info.dbf"
@@ -23,6 +28,29 @@ func BenchmarkVulpo_OpenClose(b *testing.B) {
 	}
 }
 
+// BenchmarkVulpo_NewCursor measures opening and closing a cursor over an open
+// table, against a full Open and Close in BenchmarkVulpo_OpenClose
+func BenchmarkVulpo_NewCursor(b *testing.B) {
+	v := &Vulpo{}
+	if err := v.Open(benchDBFPath); err != nil {
+		b.Fatalf("Failed to open file: %v", err)
+	}
+	defer func() {
+		_ = v.Close()
+	}()
+
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		c, err := v.NewCursor()
+		if err != nil {
+			b.Fatalf("NewCursor failed: %v", err)
+		}
+		if err := c.Close(); err != nil {
+			b.Fatalf("Failed to close cursor: %v", err)
+		}
+	}
+}
+
 // BenchmarkVulpo_HeaderAccess measures the performance of accessing header information
 func BenchmarkVulpo_HeaderAccess(b *testing.B) {
 	v := &Vulpo{}
@@ -68,6 +96,647 @@ func BenchmarkVulpo_Active(b *testing.B) {
 	}
 }
 
+// BenchmarkVulpo_ScanNext measures a full-table scan using one d4skip call per record
+func BenchmarkVulpo_ScanNext(b *testing.B) {
+	v := &Vulpo{}
+
+	err := v.Open(benchDBFPath)
+	if err != nil {
+		b.Fatalf("Failed to open file: %v", err)
+	}
+	defer func() {
+		_ = v.Close()
+	}()
+
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		_ = v.First()
+		for !v.EOF() {
+			_ = v.Deleted()
+			if v.Next() != nil {
+				break
+			}
+		}
+	}
+}
+
+// BenchmarkVulpo_ScanReadBatch measures a full-table scan copying records in batches
+func BenchmarkVulpo_ScanReadBatch(b *testing.B) {
+	v := &Vulpo{}
+
+	err := v.Open(benchDBFPath)
+	if err != nil {
+		b.Fatalf("Failed to open file: %v", err)
+	}
+	defer func() {
+		_ = v.Close()
+	}()
+
+	batch, err := v.NewRecordBatch(256)
+	if err != nil {
+		b.Fatalf("Failed to allocate batch: %v", err)
+	}
+
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		_ = v.First()
+		for {
+			if err := v.ReadBatchInto(batch); err != nil || batch.Len() == 0 {
+				break
+			}
+			for j := 0; j < batch.Len(); j++ {
+				_ = batch.Deleted(j)
+			}
+		}
+	}
+}
+
+// BenchmarkVulpo_ScanAllFields measures reading every field through the field readers
+func BenchmarkVulpo_ScanAllFields(b *testing.B) {
+	v := &Vulpo{}
+
+	err := v.Open(benchDBFPath)
+	if err != nil {
+		b.Fatalf("Failed to open file: %v", err)
+	}
+	defer func() {
+		_ = v.Close()
+	}()
+
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		_ = v.First()
+		for !v.EOF() {
+			for j := 0; j < v.FieldCount(); j++ {
+				_, _ = v.Field(j).Value()
+			}
+			if v.Next() != nil {
+				break
+			}
+		}
+	}
+}
+
+// BenchmarkVulpo_ScanAllFieldsBatch measures decoding every field from batched record images
+func BenchmarkVulpo_ScanAllFieldsBatch(b *testing.B) {
+	v := &Vulpo{}
+
+	err := v.Open(benchDBFPath)
+	if err != nil {
+		b.Fatalf("Failed to open file: %v", err)
+	}
+	defer func() {
+		_ = v.Close()
+	}()
+
+	batch, err := v.NewRecordBatch(256)
+	if err != nil {
+		b.Fatalf("Failed to allocate batch: %v", err)
+	}
+
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		_ = v.First()
+		for {
+			if err := v.ReadBatchInto(batch); err != nil || batch.Len() == 0 {
+				break
+			}
+			for j := 0; j < batch.Len(); j++ {
+				rec := batch.At(j)
+				for k := 0; k < v.FieldCount(); k++ {
+					_, _ = rec.Value(k)
+				}
+			}
+		}
+	}
+}
+
+// BenchmarkVulpo_ScanAllFieldsMapped measures decoding every field through the memory-mapped scanner
+func BenchmarkVulpo_ScanAllFieldsMapped(b *testing.B) {
+	v := &Vulpo{}
+
+	err := v.Open(benchDBFPath)
+	if err != nil {
+		b.Fatalf("Failed to open file: %v", err)
+	}
+	defer func() {
+		_ = v.Close()
+	}()
+
+	scanner, err := v.NewScanner()
+	if err != nil {
+		b.Fatalf("Failed to create scanner: %v", err)
+	}
+	defer scanner.Close()
+
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		for recNo := 1; recNo <= scanner.Count(); recNo++ {
+			rec := scanner.Record(recNo)
+			for k := 0; k < v.FieldCount(); k++ {
+				_, _ = rec.Value(k)
+			}
+		}
+	}
+}
+
+// BenchmarkVulpo_ScanColumns measures projecting every field into typed column vectors
+func BenchmarkVulpo_ScanColumns(b *testing.B) {
+	v := &Vulpo{}
+
+	err := v.Open(benchDBFPath)
+	if err != nil {
+		b.Fatalf("Failed to open file: %v", err)
+	}
+	defer func() {
+		_ = v.Close()
+	}()
+
+	var names []string
+	for i := 0; i < v.FieldCount(); i++ {
+		if _, ok := columnTypeFor(v.FieldDefs().ByIndex(i)); ok {
+			names = append(names, v.FieldDefs().ByIndex(i).Name())
+		}
+	}
+
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		_ = v.ScanColumnBatches(names, nil, func(*ColumnSet) error { return nil })
+	}
+}
+
+// BenchmarkVulpo_ParallelScanAllFields measures decoding every field with ParallelScan
+func BenchmarkVulpo_ParallelScanAllFields(b *testing.B) {
+	v := &Vulpo{}
+
+	err := v.Open(benchDBFPath)
+	if err != nil {
+		b.Fatalf("Failed to open file: %v", err)
+	}
+	defer func() {
+		_ = v.Close()
+	}()
+
+	fieldCount := v.FieldCount()
+
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		_ = v.ParallelScan(0, func(_ int, rec Record) error {
+			for k := 0; k < fieldCount; k++ {
+				_, _ = rec.Value(k)
+			}
+			return nil
+		})
+	}
+}
+
+// BenchmarkVulpo_CountByExpression measures counting matches with the compiled evaluator
+func BenchmarkVulpo_CountByExpression(b *testing.B) {
+	v := &Vulpo{}
+
+	err := v.Open(benchDBFPath)
+	if err != nil {
+		b.Fatalf("Failed to open file: %v", err)
+	}
+	defer func() {
+		_ = v.Close()
+	}()
+
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		_, _ = v.CountByExpression("AGE > 40 .AND. 'e' $ UPPER(NAME)")
+	}
+}
+
+// BenchmarkVulpo_CountByExpressionIndexed measures a selective count resolved from a tag
+func BenchmarkVulpo_CountByExpressionIndexed(b *testing.B) {
+	v := &Vulpo{}
+
+	err := v.Open(benchDBFPath)
+	if err != nil {
+		b.Fatalf("Failed to open file: %v", err)
+	}
+	defer func() {
+		_ = v.Close()
+	}()
+
+	options := &ExprSearchOptions{UseIndex: true}
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		_, _ = v.CountByExpression("AGE >= 60", options)
+	}
+}
+
+// BenchmarkVulpo_CountByExpressionCodeBase measures the same count through expr4true
+func BenchmarkVulpo_CountByExpressionCodeBase(b *testing.B) {
+	v := &Vulpo{}
+
+	err := v.Open(benchDBFPath)
+	if err != nil {
+		b.Fatalf("Failed to open file: %v", err)
+	}
+	defer func() {
+		_ = v.Close()
+	}()
+
+	filter, err := v.NewExprFilter("AGE > 40 .AND. 'e' $ UPPER(NAME)")
+	if err != nil {
+		b.Fatalf("Failed to parse expression: %v", err)
+	}
+	defer filter.Free()
+
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		_ = v.First()
+		for !v.EOF() {
+			_ = filter.evaluateC()
+			if v.Next() != nil {
+				break
+			}
+		}
+	}
+}
+
+// BenchmarkVulpo_SearchByExpression measures a search building a field reader map per match
+func BenchmarkVulpo_SearchByExpression(b *testing.B) {
+	v := &Vulpo{}
+
+	err := v.Open(benchDBFPath)
+	if err != nil {
+		b.Fatalf("Failed to open file: %v", err)
+	}
+	defer func() {
+		_ = v.Close()
+	}()
+
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		_, _ = v.SearchByExpression("AGE < 40", nil)
+	}
+}
+
+// BenchmarkVulpo_MatchExpression measures the same search into a MatchSet, reading one field per match
+func BenchmarkVulpo_MatchExpression(b *testing.B) {
+	v := &Vulpo{}
+
+	err := v.Open(benchDBFPath)
+	if err != nil {
+		b.Fatalf("Failed to open file: %v", err)
+	}
+	defer func() {
+		_ = v.Close()
+	}()
+
+	name := v.FieldDefs().Index("NAME")
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		matches, _ := v.MatchExpression("AGE < 40", nil)
+		_ = matches.ForEach(func(rec Record) error {
+			_ = rec.Bytes(name)
+			return nil
+		})
+	}
+}
+
+// BenchmarkVulpo_Aggregate measures a grouped count, sum and average over every record
+func BenchmarkVulpo_Aggregate(b *testing.B) {
+	v := &Vulpo{}
+
+	err := v.Open(benchDBFPath)
+	if err != nil {
+		b.Fatalf("Failed to open file: %v", err)
+	}
+	defer func() {
+		_ = v.Close()
+	}()
+
+	aggs := []AggSpec{{Func: AggCount}, {Func: AggSum, Field: "AGE"}, {Func: AggAvg, Field: "AGE"}}
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		_, _ = v.Aggregate([]string{"BIRTH_DATE"}, aggs, "")
+	}
+}
+
+// BenchmarkVulpo_Sort measures a top-10 heap sort and a full SORT4 sort without a tag
+func BenchmarkVulpo_Sort(b *testing.B) {
+	v := &Vulpo{}
+
+	err := v.Open(benchDBFPath)
+	if err != nil {
+		b.Fatalf("Failed to open file: %v", err)
+	}
+	defer func() {
+		_ = v.Close()
+	}()
+
+	keys := []SortKey{{Field: "AGE", Descending: true}, {Field: "NAME"}}
+
+	b.Run("TopK", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			_, _ = v.Sort(keys, 10)
+		}
+	})
+	b.Run("Full", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			_, _ = v.Sort(keys, 0)
+		}
+	})
+}
+
+// BenchmarkVulpo_TagRangeCount compares counting a key range from the index
+// with seeking and stepping through the data records
+func BenchmarkVulpo_TagRangeCount(b *testing.B) {
+	v := &Vulpo{}
+
+	err := v.Open(benchDBFPath)
+	if err != nil {
+		b.Fatalf("Failed to open file: %v", err)
+	}
+	defer func() {
+		_ = v.Close()
+	}()
+
+	tag := v.TagByName("INF_AGE")
+	age := v.FieldByName("AGE")
+
+	b.Run("CountTagRange", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			_, _ = v.CountTagRange(tag, "21", "40")
+		}
+	})
+	b.Run("SeekNext", func(b *testing.B) {
+		_ = v.SelectTag(tag)
+		defer func() { _ = v.SelectTag(nil) }()
+		for i := 0; i < b.N; i++ {
+			count := 0
+			_, _ = v.Seek("21")
+			for !v.EOF() {
+				if value, _ := age.AsFloat(); value > 40 {
+					break
+				}
+				count++
+				if v.Next() != nil {
+					break
+				}
+			}
+		}
+	})
+}
+
+// BenchmarkVulpo_SeekMany compares resolving 1000 keys in one call with
+// seeking them one at a time
+func BenchmarkVulpo_SeekMany(b *testing.B) {
+	v := &Vulpo{}
+
+	err := v.Open(benchDBFPath)
+	if err != nil {
+		b.Fatalf("Failed to open file: %v", err)
+	}
+	defer func() {
+		_ = v.Close()
+	}()
+
+	tag := v.TagByName("INF_AGE")
+	keys := make([]string, 1000)
+	for i := range keys {
+		keys[i] = strconv.Itoa(20 + i*7%50)
+	}
+
+	b.Run("SeekMany", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			_, _ = v.SeekMany(tag, keys)
+		}
+	})
+	b.Run("Seek", func(b *testing.B) {
+		_ = v.SelectTag(tag)
+		defer func() { _ = v.SelectTag(nil) }()
+		for i := 0; i < b.N; i++ {
+			for _, key := range keys {
+				_, _ = v.Seek(key)
+			}
+		}
+	})
+}
+
+// BenchmarkVulpo_SeekTyped compares a formatted string seek with typed seeks
+func BenchmarkVulpo_SeekTyped(b *testing.B) {
+	v := &Vulpo{}
+
+	err := v.Open(benchDBFPath)
+	if err != nil {
+		b.Fatalf("Failed to open file: %v", err)
+	}
+	defer func() {
+		_ = v.Close()
+	}()
+
+	_ = v.SelectTag(v.TagByName("INF_AGE"))
+
+	b.Run("Seek", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			_, _ = v.Seek(strconv.Itoa(20 + i%45))
+		}
+	})
+	b.Run("SeekInt64", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			_, _ = v.SeekInt64(int64(20 + i%45))
+		}
+	})
+
+	_ = v.SelectTag(v.TagByName("INF_BRTH"))
+	date := time.Date(1969, 2, 25, 0, 0, 0, 0, time.UTC)
+
+	b.Run("SeekDate", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			_, _ = v.Seek(date.Format("20060102"))
+		}
+	})
+	b.Run("SeekTime", func(b *testing.B) {
+		for i := 0; i < b.N; i++ {
+			_, _ = v.SeekTime(date)
+		}
+	})
+}
+
+// BenchmarkVulpo_Reindex measures rebuilding all tags of a copy of the table,
+// as is and enlarged to about 100,000 records
+func BenchmarkVulpo_Reindex(b *testing.B) {
+	for _, copies := range []int{1, 400} {
+		b.Run(fmt.Sprintf("Records=%d", 252*copies), func(b *testing.B) {
+			v := &Vulpo{}
+
+			err := v.Open(replicateTable(b, benchDBFPath, b.TempDir(), copies))
+			if err != nil {
+				b.Fatalf("Failed to open file: %v", err)
+			}
+			defer func() {
+				_ = v.Close()
+			}()
+
+			b.ResetTimer()
+
+			for i := 0; i < b.N; i++ {
+				if err := v.Reindex(nil); err != nil {
+					b.Fatalf("Reindex failed: %v", err)
+				}
+			}
+		})
+	}
+}
+
+// BenchmarkVulpo_CountDeleted measures counting the deleted records of a
+// table of about 100,000 records with every tenth one deleted, after a record
+// is deleted and recalled. The first count builds the table's deleted set;
+// the others read it.
+func BenchmarkVulpo_CountDeleted(b *testing.B) {
+	path, deleted := deletedTable(b, 400, 10)
+	v := &Vulpo{}
+	if err := v.Open(path); err != nil {
+		b.Fatalf("Failed to open file: %v", err)
+	}
+	defer func() {
+		_ = v.Close()
+	}()
+
+	b.ResetTimer()
+
+	for i := 0; i < b.N; i++ {
+		_ = v.Goto(2)
+		_ = v.Delete()
+		_ = v.Recall()
+		count, err := v.CountDeleted()
+		if err != nil || count != len(deleted) {
+			b.Fatalf("CountDeleted() = %d, %v, want %d", count, err, len(deleted))
+		}
+	}
+}
+
+// BenchmarkVulpo_CacheSeekDuringScan measures seeks on a table of about
+// 100,000 records with distinct keys while a sequential scan goes on between
+// them, with the buffer cache started under each policy. seek-ns/op is the
+// time of a seek alone, scan traffic excluded.
+func BenchmarkVulpo_CacheSeekDuringScan(b *testing.B) {
+	path, count := distinctNamesTable(b, 400)
+
+	for _, policy := range []CachePolicy{CacheLRU, CacheScanResistant} {
+		b.Run(fmt.Sprintf("Policy=%s", policy), func(b *testing.B) {
+			v := &Vulpo{}
+			if err := v.Open(path); err != nil {
+				b.Fatalf("Failed to open file: %v", err)
+			}
+			defer func() {
+				_ = v.Close()
+			}()
+			if err := v.StartCache(policy); err != nil {
+				b.Fatalf("StartCache failed: %v", err)
+			}
+
+			// The seeks keep coming back to a few hundred records
+			tag := v.TagByName("INF_NAME")
+			keys := make([]string, 300)
+			for i := range keys {
+				keys[i] = fmt.Sprintf("N%07d", i*(count/len(keys)))
+			}
+			scanPos := 1
+
+			var seeking time.Duration
+			b.ResetTimer()
+
+			for i := 0; i < b.N; i++ {
+				start := time.Now()
+				_ = v.SelectTag(tag)
+				if _, err := v.Seek(keys[i%len(keys)]); err != nil {
+					b.Fatalf("Seek failed: %v", err)
+				}
+				seeking += time.Since(start)
+
+				_ = v.SelectTag(nil)
+				_ = v.Goto(scanPos)
+				for k := 0; k < 100; k++ {
+					if err := v.Next(); err != nil || v.EOF() {
+						_ = v.First()
+					}
+				}
+				scanPos = v.Position()
+			}
+
+			b.ReportMetric(float64(seeking.Nanoseconds())/float64(b.N), "seek-ns/op")
+		})
+	}
+}
+
+// dropPageCache writes a file out and drops its pages from the page cache,
+// so that the next read of it goes to the disk.
+func dropPageCache(b *testing.B, path string) {
+	b.Helper()
+
+	f, err := os.Open(path)
+	if err != nil {
+		b.Fatalf("Failed to open %s: %v", path, err)
+	}
+	defer f.Close()
+	if err := f.Sync(); err != nil {
+		b.Fatalf("Failed to sync %s: %v", path, err)
+	}
+	const fadvDontNeed = 4
+	if _, _, errno := syscall.Syscall6(syscall.SYS_FADVISE64, f.Fd(), 0, 0, fadvDontNeed, 0, 0); errno != 0 {
+		b.Fatalf("Failed to drop %s from the page cache: %v", path, errno)
+	}
+}
+
+// BenchmarkVulpo_ReadAheadColdScan measures a scan in physical order of a
+// table of about 500,000 records that is not in the page cache, without and
+// with read-ahead
+func BenchmarkVulpo_ReadAheadColdScan(b *testing.B) {
+	path := replicateTable(b, benchDBFPath, b.TempDir(), 2000)
+
+	for _, window := range []int{0, 1 << 20} {
+		b.Run(fmt.Sprintf("Window=%d", window), func(b *testing.B) {
+			v := &Vulpo{}
+			if err := v.Open(path); err != nil {
+				b.Fatalf("Failed to open file: %v", err)
+			}
+			defer func() {
+				_ = v.Close()
+			}()
+			if err := v.SetReadAhead(window); err != nil {
+				b.Fatalf("SetReadAhead failed: %v", err)
+			}
+			age := v.FieldByName("AGE")
+
+			b.ResetTimer()
+
+			for i := 0; i < b.N; i++ {
+				b.StopTimer()
+				dropPageCache(b, path)
+				b.StartTimer()
+
+				sum := 0
+				for err := v.First(); err == nil && !v.EOF(); err = v.Next() {
+					n, _ := age.AsInt()
+					sum += n
+				}
+				if sum == 0 {
+					b.Fatal("Scan read no ages")
+				}
+			}
+		})
+	}
+}
+
 // BenchmarkCodepage_Methods measures the performance of codepage operations
 func BenchmarkCodepage_Methods(b *testing.B) {
 	cp := Codepage(0x03)
@@ -82,3 +751,134 @@ func BenchmarkCodepage_Methods(b *testing.B) {
 		_ = cp.Supported()
 	}
 }
+
+// BenchmarkVulpo_PackPause measures how long packing a table of about 50,000
+// records, a tenth of them deleted, keeps it locked: all of Pack, against
+// the Finish of an online pack whose steps have run.
+func BenchmarkVulpo_PackPause(b *testing.B) {
+	for _, online := range []bool{false, true} {
+		name := "Pack"
+		if online {
+			name = "Finish"
+		}
+		b.Run(name, func(b *testing.B) {
+			for i := 0; i < b.N; i++ {
+				b.StopTimer()
+				path, _ := deletedTable(b, 200, 10)
+				v := &Vulpo{}
+				if err := v.Open(path); err != nil {
+					b.Fatalf("Failed to open file: %v", err)
+				}
+				var p *Packer
+				if online {
+					var err error
+					if p, err = v.NewPacker(nil); err != nil {
+						b.Fatalf("NewPacker failed: %v", err)
+					}
+					for done := false; !done; {
+						if done, err = p.Step(packStepRecords); err != nil {
+							b.Fatalf("Step failed: %v", err)
+						}
+					}
+				}
+				b.StartTimer()
+
+				var err error
+				if online {
+					err = p.Finish()
+				} else {
+					err = v.Pack()
+				}
+				if err != nil {
+					b.Fatalf("Pack failed: %v", err)
+				}
+
+				b.StopTimer()
+				_ = v.Close()
+				b.StartTimer()
+			}
+		})
+	}
+}
+
+// BenchmarkVulpo_CompactMemos measures compacting a memo file of 2,000 memos,
+// half its blocks dead, in steps of a millisecond. max-step-ns is the
+// longest a step held the table.
+func BenchmarkVulpo_CompactMemos(b *testing.B) {
+	var longest time.Duration
+	for i := 0; i < b.N; i++ {
+		b.StopTimer()
+		path, _ := fragmentedMemoTable(b, 1000)
+		v := &Vulpo{}
+		if err := v.Open(path); err != nil {
+			b.Fatalf("Failed to open file: %v", err)
+		}
+		c, err := v.NewMemoCompactor()
+		if err != nil {
+			b.Fatalf("NewMemoCompactor failed: %v", err)
+		}
+		b.StartTimer()
+
+		for done := false; !done; {
+			start := time.Now()
+			if done, err = c.Step(time.Millisecond); err != nil {
+				b.Fatalf("Step failed: %v", err)
+			}
+			longest = max(longest, time.Since(start))
+		}
+
+		b.StopTimer()
+		_ = v.Close()
+		b.StartTimer()
+	}
+	b.ReportMetric(float64(longest.Nanoseconds()), "max-step-ns")
+}
+
+// BenchmarkVulpo_AppendBatch measures appending 20,000 records to a table
+// with three tags: one at a time with Append, and with AppendBatch onto a
+// table of about 100,000 records, which merges the sorted keys, and onto the
+// original 252, which rebuilds the tags.
+func BenchmarkVulpo_AppendBatch(b *testing.B) {
+	const records = 20000
+	for _, bench := range []struct {
+		name    string
+		copies  int
+		batched bool
+	}{
+		{"Append", 400, false},
+		{"Merge", 400, true},
+		{"Rebuild", 1, true},
+	} {
+		b.Run(bench.name, func(b *testing.B) {
+			for i := 0; i < b.N; i++ {
+				b.StopTimer()
+				v := &Vulpo{}
+				if err := v.Open(replicateTable(b, benchDBFPath, b.TempDir(), bench.copies)); err != nil {
+					b.Fatalf("Failed to open file: %v", err)
+				}
+				if bench.copies > 1 {
+					if err := v.Reindex(nil); err != nil {
+						b.Fatalf("Reindex failed: %v", err)
+					}
+				}
+				b.StartTimer()
+
+				if bench.batched {
+					if _, err := v.AppendBatch(records, func(i int) error { return fillInfo(v, i) }); err != nil {
+						b.Fatalf("AppendBatch failed: %v", err)
+					}
+				} else {
+					for j := 0; j < records; j++ {
+						if err := v.Append(func() error { return fillInfo(v, j) }); err != nil {
+							b.Fatalf("Append failed: %v", err)
+						}
+					}
+				}
+
+				b.StopTimer()
+				_ = v.Close()
+				b.StartTimer()
+			}
+		})
+	}
+}
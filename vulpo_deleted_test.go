@@ -4,6 +4,27 @@ import (
 	"testing"
 )
 
+// deletedTable writes a copy of the test table with every record repeated
+// copies times, as replicateTable does, and every every-th record from the
+// first marked deleted. It returns the path of the copy and the record
+// numbers of the deleted records.
+func deletedTable(t testing.TB, copies, every int) (string, []int) {
+	t.Helper()
+
+	rt := readRawTable(t, replicateTable(t, benchDBFPath, t.TempDir(), copies))
+	var deleted []int
+	for recNo := 1; recNo <= rt.count; recNo++ {
+		flag := byte(' ')
+		if (recNo-1)%every == 0 {
+			flag = '*'
+			deleted = append(deleted, recNo)
+		}
+		rt.record(recNo)[0] = flag
+	}
+	rt.write(t)
+	return rt.path, deleted
+}
+
 func TestBasicDeletedRecordFunctionality(t *testing.T) {
 	// Test the basic deleted record functions with an inactive database
 	v := &Vulpo{}
@@ -330,3 +351,248 @@ func TestDeletedRecordEdgeCases(t *testing.T) {
 		}
 	})
 }
+
+func TestVulpo_DeletedBitmap_NoDatabase(t *testing.T) {
+	v := &Vulpo{}
+
+	if _, err := v.DeletedBitmap(); err == nil {
+		t.Error("Expected error for DeletedBitmap with inactive database")
+	}
+	if _, err := v.CountDeleted(); err == nil {
+		t.Error("Expected error for CountDeleted with inactive database")
+	}
+}
+
+func TestVulpo_DeletedBitmap(t *testing.T) {
+	// 756 records, not a whole number of bitmap words, and 37,800 records
+	// of 32 bytes, more than one read of the data file
+	for _, tt := range []struct{ copies, every int }{{3, 7}, {150, 13}} {
+		path, want := deletedTable(t, tt.copies, tt.every)
+		count := 252 * tt.copies
+
+		v := &Vulpo{}
+		if err := v.Open(path); err != nil {
+			t.Fatalf("Failed to open test file: %v", err)
+		}
+		if err := v.SelectTag(v.TagByName("INF_NAME")); err != nil {
+			t.Fatalf("SelectTag failed: %v", err)
+		}
+		if err := v.Goto(5); err != nil {
+			t.Fatalf("Goto failed: %v", err)
+		}
+
+		deleted, err := v.DeletedBitmap()
+		if err != nil {
+			t.Fatalf("DeletedBitmap failed: %v", err)
+		}
+		var got []int
+		for recNo := deleted.Next(0); recNo >= 0; recNo = deleted.Next(recNo + 1) {
+			got = append(got, recNo)
+		}
+		if len(got) != len(want) || got[0] != want[0] || got[len(got)-1] != want[len(want)-1] {
+			t.Errorf("%d records: DeletedBitmap has %d records %v..., want %d", count, len(got), got[:min(3, len(got))], len(want))
+		}
+		for i := 0; i < min(len(got), len(want)); i++ {
+			if got[i] != want[i] {
+				t.Fatalf("%d records: deleted record %d is %d, want %d", count, i, got[i], want[i])
+			}
+		}
+
+		if n, err := v.CountDeleted(); err != nil || n != len(want) {
+			t.Errorf("CountDeleted() = %d, %v, want %d", n, err, len(want))
+		}
+		if n, err := v.CountActive(); err != nil || n != count-len(want) {
+			t.Errorf("CountActive() = %d, %v, want %d", n, err, count-len(want))
+		}
+		if list, err := v.ListDeletedRecords(); err != nil || len(list) != len(want) || list[len(list)-1].RecordNumber != want[len(want)-1] {
+			t.Errorf("ListDeletedRecords() has %d records, %v, want %d", len(list), err, len(want))
+		}
+		if v.Position() != 5 || v.SelectedTag() == nil {
+			t.Errorf("Position %d, tag %v after scans, want 5 and INF_NAME", v.Position(), v.SelectedTag())
+		}
+		_ = v.Close()
+	}
+}
+
+func TestVulpo_DeletedBitmap_Changes(t *testing.T) {
+	path, want := deletedTable(t, 1, 50)
+	v := &Vulpo{}
+	if err := v.Open(path); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	// A deletion still in the record buffer is counted
+	if err := v.Goto(2); err != nil {
+		t.Fatalf("Goto failed: %v", err)
+	}
+	if err := v.Delete(); err != nil {
+		t.Fatalf("Delete failed: %v", err)
+	}
+	if n, err := v.CountDeleted(); err != nil || n != len(want)+1 {
+		t.Errorf("CountDeleted() = %d, %v, want %d", n, err, len(want)+1)
+	}
+
+	// The callback sees each deleted record as the current one
+	visited := 0
+	err := v.ForEachDeletedRecord(func(recordNumber int) error {
+		visited++
+		if v.Position() != recordNumber || !v.Deleted() {
+			t.Errorf("Callback for record %d at position %d, deleted %v", recordNumber, v.Position(), v.Deleted())
+		}
+		return nil
+	})
+	if err != nil || visited != len(want)+1 {
+		t.Errorf("ForEachDeletedRecord visited %d records, %v, want %d", visited, err, len(want)+1)
+	}
+	if v.Position() != 2 {
+		t.Errorf("Position %d after ForEachDeletedRecord, want 2", v.Position())
+	}
+
+	if n, err := v.RecallAllDeleted(); err != nil || n != len(want)+1 {
+		t.Errorf("RecallAllDeleted() = %d, %v, want %d", n, err, len(want)+1)
+	}
+	if n, err := v.CountDeleted(); err != nil || n != 0 {
+		t.Errorf("CountDeleted() after RecallAllDeleted = %d, %v, want 0", n, err)
+	}
+}
+
+func TestVulpo_DeletedSet_Maintained(t *testing.T) {
+	path, want := deletedTable(t, 2, 9)
+	count := 504
+	v := &Vulpo{}
+	if err := v.Open(path); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	expect := func(what string, deleted int) {
+		t.Helper()
+		if n, err := v.CountDeleted(); err != nil || n != deleted {
+			t.Errorf("%s: CountDeleted() = %d, %v, want %d", what, n, err, deleted)
+		}
+		if n, err := v.CountActive(); err != nil || n != count-deleted {
+			t.Errorf("%s: CountActive() = %d, %v, want %d", what, n, err, count-deleted)
+		}
+		bits, err := v.DeletedBitmap()
+		if err != nil || bits.Count() != deleted {
+			t.Errorf("%s: DeletedBitmap has %d records, %v, want %d", what, bits.Count(), err, deleted)
+		}
+	}
+	expect("built", len(want))
+
+	// Delete and Recall, through the table and a cursor, update the set
+	if err := v.Goto(2); err != nil {
+		t.Fatalf("Goto failed: %v", err)
+	}
+	_ = v.Delete()
+	_ = v.Delete()
+	expect("deleted 2", len(want)+1)
+	c, err := v.NewCursor()
+	if err != nil {
+		t.Fatalf("NewCursor failed: %v", err)
+	}
+	defer c.Close()
+	if err := c.Goto(want[1]); err != nil {
+		t.Fatalf("Goto failed: %v", err)
+	}
+	_ = c.Recall()
+	expect("recalled through cursor", len(want))
+	if list, _ := v.ListDeletedRecords(); len(list) != len(want) || list[0].RecordNumber != 1 || list[1].RecordNumber != 2 {
+		t.Errorf("ListDeletedRecords() = %v..., want records 1, 2, ...", list[:min(2, len(list))])
+	}
+
+	// Records added to the file are scanned when the count grows
+	appendDeletedRecord(t, path)
+	count++
+	expect("appended", len(want)+1)
+
+	// Pack drops the set
+	if err := v.Pack(); err != nil {
+		t.Fatalf("Pack failed: %v", err)
+	}
+	count -= len(want) + 1
+	expect("packed", 0)
+}
+
+// appendDeletedRecord adds a copy of the first record, marked deleted, to the
+// end of the table behind CodeBase's back, as another program would.
+func appendDeletedRecord(t *testing.T, path string) {
+	t.Helper()
+
+	rt := readRawTable(t, path)
+	record := append([]byte(nil), rt.record(1)...)
+	record[0] = '*'
+	rt.setRecords(append(rt.records(), record...))
+	rt.write(t)
+}
+
+func TestVulpo_NextActive(t *testing.T) {
+	path, want := deletedTable(t, 2, 3)
+	isDeleted := make(map[int]bool)
+	for _, recNo := range want {
+		isDeleted[recNo] = true
+	}
+
+	for _, tagName := range []string{"", "INF_NAME"} {
+		v := &Vulpo{}
+		if err := v.Open(path); err != nil {
+			t.Fatalf("Failed to open test file: %v", err)
+		}
+		if tagName != "" {
+			_ = v.SelectTag(v.TagByName(tagName))
+		}
+
+		// The same records in the same order as Next, minus the deleted ones
+		var expected []int
+		for err := v.First(); err == nil && !v.EOF(); err = v.Next() {
+			if !isDeleted[v.Position()] {
+				expected = append(expected, v.Position())
+			}
+		}
+		var got []int
+		for err := v.FirstActive(); err == nil && !v.EOF(); err = v.NextActive() {
+			got = append(got, v.Position())
+		}
+		if len(got) != len(expected) {
+			t.Fatalf("Tag %q: NextActive visited %d records, want %d", tagName, len(got), len(expected))
+		}
+		for i := range got {
+			if got[i] != expected[i] {
+				t.Fatalf("Tag %q: record %d is %d, want %d", tagName, i, got[i], expected[i])
+			}
+		}
+		if err := v.NextActive(); err == nil || !v.EOF() {
+			t.Errorf("Tag %q: NextActive at EOF = %v, EOF %v", tagName, err, v.EOF())
+		}
+		_ = v.Close()
+	}
+}
+
+func TestVulpo_FirstActive_NoneActive(t *testing.T) {
+	path, _ := deletedTable(t, 1, 1)
+	v := &Vulpo{}
+	if err := v.Open(path); err != nil {
+		t.Fatalf("Failed to open test file: %v", err)
+	}
+	defer v.Close()
+
+	// Every record deleted, then none left at all
+	for _, table := range []string{"all deleted", "empty"} {
+		if table == "empty" {
+			if err := v.Pack(); err != nil {
+				t.Fatalf("Pack failed: %v", err)
+			}
+		}
+		for _, tagName := range []string{"", "INF_NAME"} {
+			var tag *Tag
+			if tagName != "" {
+				tag = v.TagByName(tagName)
+			}
+			_ = v.SelectTag(tag)
+			if err := v.FirstActive(); err != nil || !v.EOF() {
+				t.Errorf("%s, tag %q: FirstActive = %v, EOF %v, want nil and EOF", table, tagName, err, v.EOF())
+			}
+		}
+	}
+}